@@ -0,0 +1,80 @@
+/**
+ * Author: Jack Robbins
+ * The profile runtime is only linked into programs that were compiled with --profile-generate.
+ * It wraps main so that once main returns, every block counter gets written out to the profile
+ * file. The instrumented program itself defines where the counters and the file name are:
+ *
+ * __ostl_profile_data: the start of everything that gets written out
+ * __ostl_profile_data_end: one past the end of it
+ * __ostl_profile_file_name: the null terminated name of the profile
+ *
+ * NOTE: Only returning from main gets the counters written. A program that exits through its own
+ * syscall(in inline assembly) never comes back through here, so no profile is written for it
+ */
+
+	.text
+	.globl __ostl_profiled_main
+	.type __ostl_profiled_main, @function
+__ostl_profiled_main:
+	/* Save %rbx so that we can hold the exit code in it. This also keeps the stack 16 byte aligned */
+	pushq %rbx
+
+	/* argc, argv and envp are already where main wants them */
+	call main
+	movl %eax, %ebx
+
+	/* Write everything out */
+	call __ostl_profile_dump
+
+	/* Give back main's exit code */
+	movl %ebx, %eax
+	popq %rbx
+	ret
+
+
+	.type __ostl_profile_dump, @function
+__ostl_profile_dump:
+	/* open(__ostl_profile_file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644) */
+	movq $2, %rax
+	leaq __ostl_profile_file_name(%rip), %rdi
+	movq $577, %rsi
+	movq $420, %rdx
+	syscall
+
+	/* If we can't open the file there's nothing more that we can do */
+	testq %rax, %rax
+	js .Lprofile_dump_done
+
+	/* Hold onto the file descriptor */
+	movq %rax, %r8
+
+	/* Everything from __ostl_profile_data up to __ostl_profile_data_end is written */
+	leaq __ostl_profile_data(%rip), %rsi
+	leaq __ostl_profile_data_end(%rip), %rdx
+	subq %rsi, %rdx
+
+.Lprofile_dump_write:
+	/* write(fd, buffer, remaining) may not take everything at once, so we keep going until it has */
+	testq %rdx, %rdx
+	jz .Lprofile_dump_close
+	movq $1, %rax
+	movq %r8, %rdi
+	syscall
+
+	/* Bail out on an error */
+	testq %rax, %rax
+	jle .Lprofile_dump_close
+
+	/* Move past what was written */
+	addq %rax, %rsi
+	subq %rax, %rdx
+	jmp .Lprofile_dump_write
+
+.Lprofile_dump_close:
+	/* close(fd) */
+	movq $3, %rax
+	movq %r8, %rdi
+	syscall
+
+.Lprofile_dump_done:
+	ret
@@ -5,6 +5,10 @@
  */
 
 .globl _start
+
+/* Only defined when the profile runtime is linked in */
+.weak __ostl_profiled_main
+
 _start:
 	/* 0 out the frame pointer */
 	xorq %rbp, %rbp
@@ -22,8 +26,13 @@ _start:
 	pushq %rax
 	pushq %rsp
 
-	/* Function pointer to main */
+	/* Function pointer to main. An instrumented build links in the profile runtime, which wraps main so that the counters are written out */
+	leaq __ostl_profiled_main(%rip), %rdi
+	testq %rdi, %rdi
+	jnz .Lcall_start_main
 	leaq main(%rip), %rdi
+
+.Lcall_start_main:
 	
 	/* Invoke the actual call itself */
 	call __ostl_start_main
@@ -0,0 +1,911 @@
+/**
+ * Author: Jack Robbins
+ * This C file contains the implementations for APIs defined inside of the header file
+ * of the same name
+ */
+
+#include "alias_analysis.h"
+#include "../cfg/cfg.h"
+#include "../utils/constants.h"
+
+/**
+ * The stack pointer's record. This is set once before any queries
+ * are made and never written to again, so every worker can share it
+ */
+static symtab_variable_record_t* stack_pointer_record = NULL;
+
+/**
+ * An instruction can touch memory at most 2 different locations(memory copies
+ * read one and write another)
+ */
+#define MAX_MEMORY_ACCESSES_PER_INSTRUCTION 2
+
+/**
+ * How does an instruction touch memory?
+ */
+typedef enum {
+	//It doesn't
+	MEMORY_EFFECT_NONE = 0,
+	//Through the locations that we were able to find
+	MEMORY_EFFECT_ACCESSES,
+	//A function call reads and writes anything that the callee could reach
+	MEMORY_EFFECT_CALL,
+	//A call to a pure function only reads what the callee could reach
+	MEMORY_EFFECT_PURE_CALL,
+	//Inline assembly and the like. This could be doing anything at all
+	MEMORY_EFFECT_EVERYTHING
+} memory_effect_t;
+
+
+/**
+ * One memory access made by an instruction
+ */
+typedef struct {
+	memory_location_t location;
+	u_int8_t is_write;
+} memory_access_t;
+
+
+/**
+ * Let alias analysis know which variable is the stack pointer
+ */
+void set_alias_analysis_stack_pointer(three_addr_var_t* stack_pointer){
+	stack_pointer_record = stack_pointer->linked_var;
+}
+
+
+/**
+ * Get the integer value of a constant. Values are sign or zero extended out to 64 bits
+ * based on the constant's type. If this is not an integer constant(stack passed parameter
+ * offsets included, those aren't final yet), we return FALSE
+ */
+static u_int8_t get_constant_offset_value(three_addr_const_t* constant, int64_t* value){
+	switch(constant->const_type){
+		case BYTE_CONST:
+			*value = constant->constant_value.signed_byte_constant;
+			return TRUE;
+		case BYTE_CONST_FORCE_U:
+			*value = constant->constant_value.unsigned_byte_constant;
+			return TRUE;
+		case CHAR_CONST:
+			*value = constant->constant_value.char_constant;
+			return TRUE;
+		case SHORT_CONST:
+			*value = constant->constant_value.signed_short_constant;
+			return TRUE;
+		case SHORT_CONST_FORCE_U:
+			*value = constant->constant_value.unsigned_short_constant;
+			return TRUE;
+		case INT_CONST:
+			*value = constant->constant_value.signed_integer_constant;
+			return TRUE;
+		case INT_CONST_FORCE_U:
+			*value = constant->constant_value.unsigned_integer_constant;
+			return TRUE;
+		case LONG_CONST:
+		case LONG_CONST_FORCE_U:
+			*value = constant->constant_value.signed_long_constant;
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Find the constant value of an OIR index variable. Before instruction selection, constant
+ * offsets are kept in temps of their own(t4 <- 8; load (x, t4)) so that the selector can fold
+ * them in. Temps are only ever assigned once, so the first assignment that we find walking back
+ * through the block is the only one
+ */
+static u_int8_t get_oir_index_constant_value(instruction_t* instruction, three_addr_var_t* index, int64_t* value){
+	if(index->variable_type != VARIABLE_TYPE_TEMP){
+		return FALSE;
+	}
+
+	for(instruction_t* cursor = instruction->previous_statement; cursor != NULL; cursor = cursor->previous_statement){
+		if(variables_equal(cursor->operands.oir.assignee, index) == FALSE){
+			continue;
+		}
+
+		//Anything besides a constant assignment means that we don't know
+		if(cursor->statement_type != THREE_ADDR_CODE_ASSN_CONST_STMT){
+			return FALSE;
+		}
+
+		return get_constant_offset_value(cursor->operands.oir.constant_operand, value);
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Fill in the base of a location from the variable that holds the base address
+ */
+static void classify_memory_base(three_addr_var_t* base, memory_location_t* location){
+	//Nothing to go off of
+	if(base == NULL){
+		location->base_type = MEMORY_BASE_UNKNOWN;
+		return;
+	}
+
+	switch(base->variable_type){
+		/**
+		 * Memory address variables are the address of some variable's own memory. If that
+		 * is a global we go by the variable, otherwise it's a stack object and we go by its
+		 * stack region wherever we have one
+		 */
+		case VARIABLE_TYPE_MEMORY_ADDRESS:
+		case VARIABLE_TYPE_STACK_PARAM_MEMORY_ADDRESS:
+			if(base->linked_var == NULL){
+				location->base_type = MEMORY_BASE_UNKNOWN;
+				return;
+			}
+
+			if(base->linked_var->membership == GLOBAL_VARIABLE || base->linked_var->membership == STATIC_VARIABLE){
+				location->base_type = MEMORY_BASE_GLOBAL_OBJECT;
+				location->base = base->linked_var;
+				return;
+			}
+
+			location->base_type = MEMORY_BASE_STACK_OBJECT;
+			location->variable = base->linked_var;
+
+			if(base->associated_memory_region.stack_region != NULL){
+				location->base = base->associated_memory_region.stack_region;
+			} else if(base->linked_var->stack_region != NULL){
+				location->base = base->linked_var->stack_region;
+			} else {
+				location->base = base->linked_var;
+			}
+
+			return;
+
+		//These all sit in read-only memory
+		case VARIABLE_TYPE_LOCAL_CONSTANT:
+			location->base_type = MEMORY_BASE_READ_ONLY_CONSTANT;
+			location->base = base->associated_memory_region.local_constant;
+			return;
+
+		case VARIABLE_TYPE_FUNCTION_ADDRESS:
+			location->base_type = MEMORY_BASE_READ_ONLY_CONSTANT;
+			location->base = base->associated_memory_region.rip_relative_function;
+			return;
+
+		//This is the caller's memory, so it's as good as any other pointer
+		case VARIABLE_TYPE_RETURN_BY_COPY_ADDRESS:
+			location->base_type = MEMORY_BASE_POINTER;
+			location->base = base;
+			return;
+
+		default:
+			//A global variable named directly(rip-relative accesses)
+			if(base->linked_var != NULL
+				&& (base->linked_var->membership == GLOBAL_VARIABLE || base->linked_var->membership == STATIC_VARIABLE)){
+				location->base_type = MEMORY_BASE_GLOBAL_OBJECT;
+				location->base = base->linked_var;
+				return;
+			}
+
+			//Offsets off of the stack pointer could be anywhere in the frame
+			if(base->linked_var != NULL && base->linked_var == stack_pointer_record){
+				location->base_type = MEMORY_BASE_STACK_POINTER;
+				location->base = stack_pointer_record;
+				return;
+			}
+
+			//Otherwise it's just a pointer
+			location->base_type = MEMORY_BASE_POINTER;
+			location->base = base;
+			return;
+	}
+}
+
+
+/**
+ * Get the location that a load or store(OIR or x86) accesses. If the instruction does not access
+ * memory through an address, FALSE is given back
+ */
+u_int8_t get_memory_location_for_instruction(instruction_t* instruction, memory_location_t* location){
+	//Is this instruction selected yet? This decides which set of operands we look at
+	u_int8_t is_x86 = instruction->instruction_type != NO_INSTRUCTION_SELECTED;
+
+	if(is_x86 == TRUE){
+		if(instruction->memory_access_type == NO_MEMORY_ACCESS){
+			return FALSE;
+		}
+	} else if(instruction->statement_type != THREE_ADDR_CODE_LOAD_STATEMENT && instruction->statement_type != THREE_ADDR_CODE_STORE_STATEMENT){
+		return FALSE;
+	}
+
+	//Grab everything that the addressing mode could use
+	three_addr_var_t* base;
+	three_addr_var_t* index;
+	three_addr_var_t* rip_offset_var;
+	three_addr_const_t* address_offset;
+	u_int64_t multiplier;
+
+	if(is_x86 == TRUE){
+		base = instruction->operands.x86.address_register1;
+		index = instruction->operands.x86.address_register2;
+		rip_offset_var = instruction->operands.x86.rip_offset_var;
+		address_offset = instruction->operands.x86.address_offset;
+		multiplier = instruction->operands.x86.address_multiplier;
+	} else {
+		base = instruction->operands.oir.address_operand1;
+		index = instruction->operands.oir.address_operand2;
+		rip_offset_var = instruction->operands.oir.rip_offset_var;
+		address_offset = instruction->operands.oir.address_offset;
+		multiplier = instruction->operands.oir.address_multiplier;
+	}
+
+	//Wipe it out
+	location->base = NULL;
+	location->variable = NULL;
+	location->offset = 0;
+	location->offset_known = TRUE;
+	location->base_type = MEMORY_BASE_UNKNOWN;
+
+	//Loads and stores know how wide they are. Anything else we leave as unknown
+	location->size = 0;
+	if((instruction->statement_type == THREE_ADDR_CODE_LOAD_STATEMENT || instruction->statement_type == THREE_ADDR_CODE_STORE_STATEMENT)
+		&& instruction->type_storage.memory_read_write_type != NULL){
+		location->size = dealias_type(instruction->type_storage.memory_read_write_type)->type_size;
+	}
+
+	//Do we have a constant offset and an index to account for?
+	u_int8_t has_offset = FALSE;
+	u_int8_t has_index = FALSE;
+
+	switch(instruction->addressing_mode){
+		case ADDRESSING_MODE_BASE_ADDRESS_ONLY:
+			break;
+
+		case ADDRESSING_MODE_OFFSET_ONLY:
+			has_offset = TRUE;
+			break;
+
+		case ADDRESSING_MODE_REGISTERS_ONLY:
+			has_index = TRUE;
+			multiplier = 1;
+			break;
+
+		case ADDRESSING_MODE_REGISTERS_AND_OFFSET:
+			has_index = TRUE;
+			has_offset = TRUE;
+			multiplier = 1;
+			break;
+
+		case ADDRESSING_MODE_REGISTERS_AND_SCALE:
+			has_index = TRUE;
+			break;
+
+		case ADDRESSING_MODE_REGISTERS_OFFSET_AND_SCALE:
+			has_index = TRUE;
+			has_offset = TRUE;
+			break;
+
+		//The rip offset variable is the real base here
+		case ADDRESSING_MODE_RIP_RELATIVE:
+			base = rip_offset_var;
+			break;
+
+		case ADDRESSING_MODE_RIP_RELATIVE_WITH_OFFSET:
+			base = rip_offset_var;
+			has_offset = TRUE;
+			break;
+
+		//With no base register at all, the index is the address. We know nothing
+		default:
+			return TRUE;
+	}
+
+	classify_memory_base(base, location);
+
+	//Add in the constant offset
+	int64_t value;
+	if(has_offset == TRUE){
+		if(address_offset != NULL && get_constant_offset_value(address_offset, &value) == TRUE){
+			location->offset += value;
+		} else {
+			location->offset_known = FALSE;
+		}
+	}
+
+	/**
+	 * And the index. Selected instructions have their constants folded in already, so a
+	 * register index there is something that we can't know
+	 */
+	if(has_index == TRUE){
+		if(is_x86 == FALSE && index != NULL && get_oir_index_constant_value(instruction, index, &value) == TRUE){
+			location->offset += value * (int64_t)multiplier;
+		} else {
+			location->offset_known = FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Build the location for the entirety of a memory address variable's memory. This is what memory
+ * copies and region initializations touch
+ */
+static void get_memory_location_for_whole_region(three_addr_var_t* region, u_int64_t size, memory_location_t* location){
+	location->base = NULL;
+	location->variable = NULL;
+	location->offset = 0;
+	location->offset_known = TRUE;
+	location->size = size;
+
+	classify_memory_base(region, location);
+}
+
+
+/**
+ * Get the locations that a memory copy writes to and reads from. These are both
+ * the whole size of the copy
+ */
+void get_memory_locations_for_memory_copy(instruction_t* copy, memory_location_t* destination, memory_location_t* source){
+	get_memory_location_for_whole_region(copy->operands.oir.address_operand1, copy->optional_storage.byte_amount_to_copy, destination);
+	get_memory_location_for_whole_region(copy->operands.oir.address_operand2, copy->optional_storage.byte_amount_to_copy, source);
+}
+
+
+/**
+ * Work out every memory access that an instruction makes
+ */
+static memory_effect_t get_memory_accesses_for_instruction(instruction_t* instruction, memory_access_t* accesses, u_int32_t* access_count){
+	*access_count = 0;
+
+	//Selected instructions
+	if(instruction->instruction_type != NO_INSTRUCTION_SELECTED){
+		switch(instruction->instruction_type){
+			case CALL:
+			case INDIRECT_CALL:
+			case TAIL_CALL:
+				return MEMORY_EFFECT_CALL;
+
+			//We can't see into these
+			case ASM_INLINE:
+			case PUSH:
+			case PUSH_DIRECT_GP:
+			case PUSH_DIRECT_SSE:
+			case POP:
+				return MEMORY_EFFECT_EVERYTHING;
+
+			default:
+				break;
+		}
+
+		if(get_memory_location_for_instruction(instruction, &(accesses[0].location)) == FALSE){
+			return MEMORY_EFFECT_NONE;
+		}
+
+		accesses[0].is_write = instruction->memory_access_type == WRITE_TO_MEMORY;
+		*access_count = 1;
+
+		return MEMORY_EFFECT_ACCESSES;
+	}
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_LOAD_STATEMENT:
+		case THREE_ADDR_CODE_STORE_STATEMENT:
+			get_memory_location_for_instruction(instruction, &(accesses[0].location));
+			accesses[0].is_write = instruction->statement_type == THREE_ADDR_CODE_STORE_STATEMENT;
+			*access_count = 1;
+			return MEMORY_EFFECT_ACCESSES;
+
+		//We write to address operand 1 from address operand 2
+		case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+			get_memory_locations_for_memory_copy(instruction, &(accesses[0].location), &(accesses[1].location));
+			accesses[0].is_write = TRUE;
+			accesses[1].is_write = FALSE;
+			*access_count = 2;
+			return MEMORY_EFFECT_ACCESSES;
+
+		//This counts as writing the whole region
+		case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+			get_memory_location_for_whole_region(instruction->operands.oir.assignee, 0, &(accesses[0].location));
+			accesses[0].is_write = TRUE;
+			*access_count = 1;
+			return MEMORY_EFFECT_ACCESSES;
+
+		/**
+		 * Direct calls can go off of what we inferred about the callee. A const callee
+		 * never touches anything that we can see, and a pure one only ever reads it
+		 */
+		case THREE_ADDR_CODE_FUNC_CALL:
+			if(instruction->called_function != NULL && instruction->called_function->is_const == TRUE){
+				return MEMORY_EFFECT_NONE;
+			}
+
+			if(instruction->called_function != NULL && instruction->called_function->is_pure == TRUE){
+				return MEMORY_EFFECT_PURE_CALL;
+			}
+
+			return MEMORY_EFFECT_CALL;
+
+		case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+			return MEMORY_EFFECT_CALL;
+
+		case THREE_ADDR_CODE_ASM_INLINE_STMT:
+			return MEMORY_EFFECT_EVERYTHING;
+
+		default:
+			return MEMORY_EFFECT_NONE;
+	}
+}
+
+
+/**
+ * Is the stack object's address exposed? If we haven't worked it out,
+ * we need to assume that it is
+ */
+static inline u_int8_t is_stack_object_exposed(memory_location_t* location){
+	return location->variable == NULL || location->variable->address_exposure != ADDRESS_NOT_EXPOSED;
+}
+
+
+/**
+ * Could a called function reach the given location? It can reach anything that a pointer
+ * could, along with the stack passed parameters that sit right off of the stack pointer
+ */
+static u_int8_t can_call_access_memory_location(memory_location_t* location){
+	switch(location->base_type){
+		//Nobody can write these, so they never conflict
+		case MEMORY_BASE_READ_ONLY_CONSTANT:
+			return FALSE;
+
+		case MEMORY_BASE_STACK_OBJECT:
+			return is_stack_object_exposed(location);
+
+		default:
+			return TRUE;
+	}
+}
+
+
+/**
+ * Compare two locations that share a base by their offsets. The byte ranges
+ * need to be known and disjoint for there to be no alias
+ */
+static alias_result_t compare_memory_location_offsets(memory_location_t* a, memory_location_t* b){
+	if(a->offset_known == FALSE || b->offset_known == FALSE){
+		return MAY_ALIAS;
+	}
+
+	//We'd need to know how wide they are
+	if(a->size == 0 || b->size == 0){
+		return MAY_ALIAS;
+	}
+
+	if(a->offset + (int64_t)a->size <= b->offset || b->offset + (int64_t)b->size <= a->offset){
+		return NO_ALIAS;
+	}
+
+	if(a->offset == b->offset && a->size == b->size){
+		return MUST_ALIAS;
+	}
+
+	return MAY_ALIAS;
+}
+
+
+/**
+ * Could the two memory locations overlap?
+ *
+ * NOTE: pointer bases are compared by variable, so both locations need to be from a
+ * point where the pointer holds the same value. This is always true for SSA form OIR
+ */
+alias_result_t memory_locations_alias(memory_location_t* a, memory_location_t* b){
+	//Nothing can be said about these
+	if(a->base_type == MEMORY_BASE_UNKNOWN || b->base_type == MEMORY_BASE_UNKNOWN){
+		return MAY_ALIAS;
+	}
+
+	//Order these so that we only need to handle each pair once
+	if(a->base_type > b->base_type){
+		memory_location_t* temp = a;
+		a = b;
+		b = temp;
+	}
+
+	switch(a->base_type){
+		case MEMORY_BASE_STACK_OBJECT:
+			switch(b->base_type){
+				//Distinct stack objects never overlap
+				case MEMORY_BASE_STACK_OBJECT:
+					if(a->base != b->base){
+						return NO_ALIAS;
+					}
+
+					return compare_memory_location_offsets(a, b);
+
+				//The stack layout isn't final, so we can't say where the object is
+				case MEMORY_BASE_STACK_POINTER:
+					return MAY_ALIAS;
+
+				//A pointer can only ever get here if the address was exposed
+				case MEMORY_BASE_POINTER:
+					return is_stack_object_exposed(a) == TRUE ? MAY_ALIAS : NO_ALIAS;
+
+				default:
+					return NO_ALIAS;
+			}
+
+		case MEMORY_BASE_GLOBAL_OBJECT:
+			switch(b->base_type){
+				case MEMORY_BASE_GLOBAL_OBJECT:
+					if(a->base != b->base){
+						return NO_ALIAS;
+					}
+
+					return compare_memory_location_offsets(a, b);
+
+				case MEMORY_BASE_POINTER:
+					return MAY_ALIAS;
+
+				default:
+					return NO_ALIAS;
+			}
+
+		case MEMORY_BASE_READ_ONLY_CONSTANT:
+			switch(b->base_type){
+				case MEMORY_BASE_READ_ONLY_CONSTANT:
+					if(a->base != b->base){
+						return NO_ALIAS;
+					}
+
+					return compare_memory_location_offsets(a, b);
+
+				//A pointer could point at a constant(string literals)
+				case MEMORY_BASE_POINTER:
+					return MAY_ALIAS;
+
+				default:
+					return NO_ALIAS;
+			}
+
+		case MEMORY_BASE_STACK_POINTER:
+			switch(b->base_type){
+				case MEMORY_BASE_STACK_POINTER:
+					return compare_memory_location_offsets(a, b);
+
+				default:
+					return MAY_ALIAS;
+			}
+
+		//Two pointers only have a chance of being told apart if they are the same pointer
+		case MEMORY_BASE_POINTER:
+			if(variables_equal(a->base, b->base) == FALSE){
+				return MAY_ALIAS;
+			}
+
+			return compare_memory_location_offsets(a, b);
+
+		default:
+			return MAY_ALIAS;
+	}
+}
+
+
+/**
+ * Could the given instruction write to any of the memory in the location? Function calls
+ * and inline assembly are accounted for here
+ */
+u_int8_t may_instruction_write_memory_location(instruction_t* instruction, memory_location_t* location){
+	//Nothing can ever write to these
+	if(location->base_type == MEMORY_BASE_READ_ONLY_CONSTANT){
+		return FALSE;
+	}
+
+	memory_access_t accesses[MAX_MEMORY_ACCESSES_PER_INSTRUCTION];
+	u_int32_t access_count;
+
+	switch(get_memory_accesses_for_instruction(instruction, accesses, &access_count)){
+		case MEMORY_EFFECT_NONE:
+		case MEMORY_EFFECT_PURE_CALL:
+			return FALSE;
+
+		case MEMORY_EFFECT_CALL:
+			return can_call_access_memory_location(location);
+
+		case MEMORY_EFFECT_EVERYTHING:
+			return TRUE;
+
+		default:
+			break;
+	}
+
+	for(u_int32_t i = 0; i < access_count; i++){
+		if(accesses[i].is_write == TRUE && memory_locations_alias(&(accesses[i].location), location) != NO_ALIAS){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Could the given instruction read any of the memory in the location? Function calls
+ * and inline assembly are accounted for here
+ */
+u_int8_t may_instruction_read_memory_location(instruction_t* instruction, memory_location_t* location){
+	memory_access_t accesses[MAX_MEMORY_ACCESSES_PER_INSTRUCTION];
+	u_int32_t access_count;
+
+	switch(get_memory_accesses_for_instruction(instruction, accesses, &access_count)){
+		case MEMORY_EFFECT_NONE:
+			return FALSE;
+
+		case MEMORY_EFFECT_CALL:
+		case MEMORY_EFFECT_PURE_CALL:
+			return can_call_access_memory_location(location);
+
+		case MEMORY_EFFECT_EVERYTHING:
+			return TRUE;
+
+		default:
+			break;
+	}
+
+	for(u_int32_t i = 0; i < access_count; i++){
+		if(accesses[i].is_write == FALSE && memory_locations_alias(&(accesses[i].location), location) != NO_ALIAS){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Could the given instruction write to any memory that a called function could read? This
+ * is what decides whether a pure call gives back the same value before and after it
+ */
+u_int8_t may_instruction_write_call_visible_memory(instruction_t* instruction){
+	memory_access_t accesses[MAX_MEMORY_ACCESSES_PER_INSTRUCTION];
+	u_int32_t access_count;
+
+	switch(get_memory_accesses_for_instruction(instruction, accesses, &access_count)){
+		case MEMORY_EFFECT_NONE:
+		case MEMORY_EFFECT_PURE_CALL:
+			return FALSE;
+
+		case MEMORY_EFFECT_CALL:
+		case MEMORY_EFFECT_EVERYTHING:
+			return TRUE;
+
+		default:
+			break;
+	}
+
+	for(u_int32_t i = 0; i < access_count; i++){
+		if(accesses[i].is_write == TRUE && can_call_access_memory_location(&(accesses[i].location)) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Does the outer location cover every byte of the inner one? They need to have the same
+ * base with known offsets and widths for us to be able to tell
+ */
+u_int8_t does_memory_location_contain(memory_location_t* outer, memory_location_t* inner){
+	if(outer->base_type != inner->base_type || outer->base_type == MEMORY_BASE_UNKNOWN){
+		return FALSE;
+	}
+
+	if(outer->offset_known == FALSE || inner->offset_known == FALSE || outer->size == 0 || inner->size == 0){
+		return FALSE;
+	}
+
+	//Pointers are the same base if they're the same variable, everything else goes by identity
+	if(outer->base_type == MEMORY_BASE_POINTER){
+		if(variables_equal(outer->base, inner->base) == FALSE){
+			return FALSE;
+		}
+
+	} else if(outer->base != inner->base){
+		return FALSE;
+	}
+
+	return outer->offset <= inner->offset && inner->offset + (int64_t)inner->size <= outer->offset + (int64_t)outer->size;
+}
+
+
+/**
+ * Do the two instructions have a memory dependence? This is the case when they could access
+ * the same memory and at least one of them writes to it
+ */
+u_int8_t do_instructions_have_memory_conflict(instruction_t* a, instruction_t* b){
+	memory_access_t a_accesses[MAX_MEMORY_ACCESSES_PER_INSTRUCTION];
+	memory_access_t b_accesses[MAX_MEMORY_ACCESSES_PER_INSTRUCTION];
+	u_int32_t a_access_count;
+	u_int32_t b_access_count;
+
+	memory_effect_t a_effect = get_memory_accesses_for_instruction(a, a_accesses, &a_access_count);
+	memory_effect_t b_effect = get_memory_accesses_for_instruction(b, b_accesses, &b_access_count);
+
+	//If either doesn't touch memory, there's nothing to conflict over
+	if(a_effect == MEMORY_EFFECT_NONE || b_effect == MEMORY_EFFECT_NONE){
+		return FALSE;
+	}
+
+	//Assume the worst here
+	if(a_effect == MEMORY_EFFECT_EVERYTHING || b_effect == MEMORY_EFFECT_EVERYTHING){
+		return TRUE;
+	}
+
+	u_int8_t a_is_call = a_effect == MEMORY_EFFECT_CALL || a_effect == MEMORY_EFFECT_PURE_CALL;
+	u_int8_t b_is_call = b_effect == MEMORY_EFFECT_CALL || b_effect == MEMORY_EFFECT_PURE_CALL;
+
+	//Two calls could both write to the same global. Two pure calls are only ever reading
+	if(a_is_call == TRUE && b_is_call == TRUE){
+		return a_effect == MEMORY_EFFECT_CALL || b_effect == MEMORY_EFFECT_CALL;
+	}
+
+	/**
+	 * A call both reads and writes everything that it could reach, so any
+	 * access of the other instruction that the call could reach conflicts. A
+	 * pure call only conflicts with the writes
+	 */
+	if(a_is_call == TRUE || b_is_call == TRUE){
+		memory_effect_t call_effect = a_is_call == TRUE ? a_effect : b_effect;
+		memory_access_t* accesses = a_is_call == TRUE ? b_accesses : a_accesses;
+		u_int32_t access_count = a_is_call == TRUE ? b_access_count : a_access_count;
+
+		for(u_int32_t i = 0; i < access_count; i++){
+			if(call_effect == MEMORY_EFFECT_PURE_CALL && accesses[i].is_write == FALSE){
+				continue;
+			}
+
+			if(can_call_access_memory_location(&(accesses[i].location)) == TRUE){
+				return TRUE;
+			}
+		}
+
+		return FALSE;
+	}
+
+	//Otherwise it's pairwise. Two reads never conflict
+	for(u_int32_t i = 0; i < a_access_count; i++){
+		for(u_int32_t j = 0; j < b_access_count; j++){
+			if(a_accesses[i].is_write == FALSE && b_accesses[j].is_write == FALSE){
+				continue;
+			}
+
+			if(memory_locations_alias(&(a_accesses[i].location), &(b_accesses[j].location)) != NO_ALIAS){
+				return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Note that a stack object's memory address variable was used. Only stack objects that
+ * belong to the function are touched, anything else stays unknown
+ */
+static inline void note_memory_address_use(symtab_function_record_t* function, three_addr_var_t* variable, address_exposure_t exposure){
+	if(variable == NULL || variable->linked_var == NULL){
+		return;
+	}
+
+	if(variable->variable_type != VARIABLE_TYPE_MEMORY_ADDRESS && variable->variable_type != VARIABLE_TYPE_STACK_PARAM_MEMORY_ADDRESS){
+		return;
+	}
+
+	if(variable->linked_var->function_declared_in != function){
+		return;
+	}
+
+	variable->linked_var->address_exposure = exposure;
+}
+
+
+/**
+ * Run through every variable in the instruction. On the first pass, every memory address
+ * that we see is set to not exposed. On the second, any that are used as something other
+ * than the base address of a memory access are set to exposed
+ */
+static void note_memory_address_uses_in_instruction(symtab_function_record_t* function, instruction_t* instruction, u_int8_t first_pass){
+	//Which of the address operands are just the base address of an access?
+	u_int8_t address_operand1_is_base = FALSE;
+	u_int8_t address_operand2_is_base = FALSE;
+	u_int8_t assignee_is_base = FALSE;
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_LOAD_STATEMENT:
+		case THREE_ADDR_CODE_STORE_STATEMENT:
+			address_operand1_is_base = TRUE;
+			break;
+
+		case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+			address_operand1_is_base = TRUE;
+			address_operand2_is_base = TRUE;
+			break;
+
+		case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+			assignee_is_base = TRUE;
+			break;
+
+		default:
+			break;
+	}
+
+	if(first_pass == TRUE){
+		note_memory_address_use(function, instruction->operands.oir.assignee, ADDRESS_NOT_EXPOSED);
+		note_memory_address_use(function, instruction->operands.oir.operand1, ADDRESS_NOT_EXPOSED);
+		note_memory_address_use(function, instruction->operands.oir.operand2, ADDRESS_NOT_EXPOSED);
+		note_memory_address_use(function, instruction->operands.oir.address_operand1, ADDRESS_NOT_EXPOSED);
+		note_memory_address_use(function, instruction->operands.oir.address_operand2, ADDRESS_NOT_EXPOSED);
+		return;
+	}
+
+	//Everything here is exposing
+	note_memory_address_use(function, instruction->operands.oir.operand1, ADDRESS_EXPOSED);
+	note_memory_address_use(function, instruction->operands.oir.operand2, ADDRESS_EXPOSED);
+
+	if(assignee_is_base == FALSE){
+		note_memory_address_use(function, instruction->operands.oir.assignee, ADDRESS_EXPOSED);
+	}
+
+	if(address_operand1_is_base == FALSE){
+		note_memory_address_use(function, instruction->operands.oir.address_operand1, ADDRESS_EXPOSED);
+	}
+
+	if(address_operand2_is_base == FALSE){
+		note_memory_address_use(function, instruction->operands.oir.address_operand2, ADDRESS_EXPOSED);
+	}
+
+	//Function call parameters and phi functions
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_FUNC_CALL:
+		case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+		case THREE_ADDR_CODE_PHI_FUNC:
+			for(u_int16_t i = 0; i < instruction->parameters.current_index; i++){
+				note_memory_address_use(function, dynamic_array_get_at(&(instruction->parameters), i), ADDRESS_EXPOSED);
+			}
+
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+/**
+ * Work out which of the function's stack objects have their address exposed - used anywhere
+ * other than as the base of a load, store or memory copy. Pointers can only ever reach exposed
+ * objects
+ *
+ * We go over the function twice so that nothing is left over from the last time that this ran:
+ * 	1.) Every stack object that we see is set to not exposed
+ * 	2.) Every one that is used anywhere besides as a base address is set to exposed
+ */
+void compute_address_exposure(symtab_function_record_t* function){
+	for(u_int8_t first_pass = TRUE; ; first_pass = FALSE){
+		for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+			for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+				note_memory_address_uses_in_instruction(function, cursor, first_pass);
+			}
+		}
+
+		if(first_pass == FALSE){
+			break;
+		}
+	}
+}
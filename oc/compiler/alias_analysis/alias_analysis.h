@@ -0,0 +1,152 @@
+/**
+ * Author: Jack Robbins
+ * Alias analysis answers one question for the rest of the compiler: could these two memory
+ * accesses ever touch the same bytes? Both OIR(for the optimizer) and selected x86 instructions
+ * (for the scheduler) can be asked about.
+ *
+ * Every access is boiled down to a memory location - a base address and, when we know them, a
+ * constant offset and width. Bases come in a few kinds:
+ * 	1.) A stack object of this function, identified by its stack region
+ * 	2.) A global variable
+ * 	3.) A read-only local constant(.LC)
+ * 	4.) The stack pointer itself
+ * 	5.) A pointer value held in some variable
+ *
+ * Two different stack objects or globals can never overlap. A pointer can only reach a stack
+ * object whose address has been exposed somewhere in the function, which is worked out by
+ * compute_address_exposure. Accesses off of the same base with known offsets are disjoint when
+ * their byte ranges are
+ *
+ * NOTE: Ollie lets any pointer be cast to any other pointer type, so two accesses having different
+ * types says nothing about whether they overlap. Types are only used for how wide an access is
+ */
+
+//Include guards
+#ifndef ALIAS_ANALYSIS_H
+#define ALIAS_ANALYSIS_H
+
+#include <sys/types.h>
+#include "../instruction/instruction.h"
+#include "../symtab/symtab.h"
+
+//A memory location that an instruction reads or writes
+typedef struct memory_location_t memory_location_t;
+
+/**
+ * The answer to an alias query
+ */
+typedef enum {
+	//These can never touch the same memory
+	NO_ALIAS = 0,
+	//We can't rule it out
+	MAY_ALIAS,
+	//These are the exact same bytes
+	MUST_ALIAS
+} alias_result_t;
+
+
+/**
+ * What kind of base address does a memory location have?
+ */
+typedef enum {
+	//We know nothing about this. It may overlap with anything
+	MEMORY_BASE_UNKNOWN = 0,
+	//A stack allocated object(variable, array, struct) of the current function
+	MEMORY_BASE_STACK_OBJECT,
+	//A global or static variable
+	MEMORY_BASE_GLOBAL_OBJECT,
+	//A local constant(.LC). These live in read-only memory
+	MEMORY_BASE_READ_ONLY_CONSTANT,
+	//An offset directly off of the stack pointer
+	MEMORY_BASE_STACK_POINTER,
+	//Whatever a pointer held in a variable points to
+	MEMORY_BASE_POINTER
+} memory_base_type_t;
+
+
+/**
+ * A memory location is a base address plus an optional constant offset
+ * and width
+ */
+struct memory_location_t {
+	/**
+	 * What identifies the base. This is a stack_region_t* or symtab_variable_record_t*
+	 * for stack objects, a symtab_variable_record_t* for globals, a local_constant_t* for
+	 * local constants and the three_addr_var_t* itself for pointers
+	 */
+	void* base;
+	//The variable that owns a stack object. This is what address exposure is tracked on
+	symtab_variable_record_t* variable;
+	//The offset from the base in bytes. Only meaningful if offset_known is TRUE
+	int64_t offset;
+	//How many bytes are accessed. 0 means that we don't know
+	u_int64_t size;
+	//What kind of base do we have
+	memory_base_type_t base_type;
+	//Do we know the offset?
+	u_int8_t offset_known;
+};
+
+
+/**
+ * Let alias analysis know which variable is the stack pointer. Anything based off of
+ * it could be anywhere on the stack. This must be done before any queries are made
+ */
+void set_alias_analysis_stack_pointer(three_addr_var_t* stack_pointer);
+
+/**
+ * Work out which of the function's stack objects have their address exposed - used anywhere
+ * other than as the base of a load, store or memory copy. Pointers can only ever reach exposed
+ * objects. This runs on OIR, and needs to be rerun if the function changes in a way that could
+ * expose something new
+ */
+void compute_address_exposure(symtab_function_record_t* function);
+
+/**
+ * Get the location that a load or store(OIR or x86) accesses. If the instruction does not access
+ * memory through an address, FALSE is given back
+ */
+u_int8_t get_memory_location_for_instruction(instruction_t* instruction, memory_location_t* location);
+
+/**
+ * Get the locations that an OIR memory copy writes to and reads from
+ */
+void get_memory_locations_for_memory_copy(instruction_t* copy, memory_location_t* destination, memory_location_t* source);
+
+/**
+ * Could the two memory locations overlap?
+ */
+alias_result_t memory_locations_alias(memory_location_t* a, memory_location_t* b);
+
+/**
+ * Could the given instruction write to any of the memory in the location? Function calls
+ * and inline assembly are accounted for here
+ */
+u_int8_t may_instruction_write_memory_location(instruction_t* instruction, memory_location_t* location);
+
+/**
+ * Could the given instruction read any of the memory in the location? Function calls
+ * and inline assembly are accounted for here
+ */
+u_int8_t may_instruction_read_memory_location(instruction_t* instruction, memory_location_t* location);
+
+/**
+ * Could the given instruction write to any memory that a called function could read? Calls
+ * to pure functions never do
+ */
+u_int8_t may_instruction_write_call_visible_memory(instruction_t* instruction);
+
+/**
+ * Does the outer location cover every byte of the inner one? This needs both to be off of
+ * the same base with known offsets and widths
+ */
+u_int8_t does_memory_location_contain(memory_location_t* outer, memory_location_t* inner);
+
+/**
+ * Do the two instructions have a memory dependence? This is the case when they could access
+ * the same memory and at least one of them writes to it. Two instructions that don't touch
+ * memory never conflict
+ */
+u_int8_t do_instructions_have_memory_conflict(instruction_t* a, instruction_t* b);
+
+#endif /* ALIAS_ANALYSIS_H */
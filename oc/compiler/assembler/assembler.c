@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include "assembler.h"
+#include "../profiler/profiler.h"
 #include "../utils/constants.h"
 #include "../utils/error_management.h"
 #include "../utils/dynamic_string/dynamic_string.h"
@@ -48,6 +49,10 @@ static char info[ERROR_SIZE * 3];
 static u_int32_t* error_count;
 static u_int32_t* warning_count;
 
+//The file that functions are streamed into(if we're streaming), and its name
+static FILE* streamed_output = NULL;
+static dynamic_string_t streamed_assembly_file;
+
 /**
  * Simply prints a parse message in a nice formatted way
  */
@@ -77,6 +82,15 @@ static inline void print_assembly_block(FILE* fl, basic_block_t* block){
 	//If this is some kind of switch block, we first print the jump table
 	if(block->jump_table != NULL){
 		print_jump_table(fl, block->jump_table);
+
+		/**
+		 * The table went into .rodata. Function entries switch back to .text on
+		 * their own below, but a table in the middle of a function needs us to
+		 * do it here or the rest of the function would land in .rodata too
+		 */
+		if(block->block_type != BLOCK_TYPE_FUNC_ENTRY){
+			fprintf(fl, "\t.text\n");
+		}
 	}
 
 	//If it's a function entry block, we need to print this out
@@ -118,24 +132,32 @@ static inline void print_assembly_block(FILE* fl, basic_block_t* block){
 }
 
 
+/**
+ * Print all of the assembly blocks in a function in order
+ */
+static void print_function_assembly(FILE* fl, basic_block_t* function_entry){
+	//Start at the top
+	basic_block_t* current = function_entry;
+
+	//We can use the direct successor strategy here
+	while(current != NULL){
+		//Print it out
+		print_assembly_block(fl, current);
+
+		//Advance the pointer
+		current = current->direct_successor;
+	}
+}
+
+
 /**
  * Print all assembly blocks in a CFG in order. Remember, by the time that we reach
  * here, these blocks will all already be in order from the block ordering procedure
  */
 static void print_all_basic_blocks(FILE* fl, cfg_t* cfg){
-	//Run through all blocks here
+	//Run through all functions here
 	for(u_int16_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
-		//Grab the head block out
-		basic_block_t* current = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
-
-		//We can use the direct successor strategy here
-		while(current != NULL){
-			//Print it out
-			print_assembly_block(fl, current);
-
-			//Advance the pointer
-			current = current->direct_successor;
-		}
+		print_function_assembly(fl, dynamic_array_get_at(&(cfg->function_entry_blocks), i));
 	}
 }
 
@@ -152,6 +174,50 @@ static inline void print_start_section(char* file_name, FILE* fl, cfg_t* cfg){
 }
 
 
+/**
+ * Print everything that comes after the code - the global variables
+ * and the local constants
+ */
+static inline void print_data_section(FILE* fl, cfg_t* cfg){
+	//Handle all of the global vars first
+	print_all_global_variables(fl, &(cfg->global_variables));
+
+	//Print all of the local constants as well
+	print_local_constants(fl, &(cfg->local_string_constants), &(cfg->local_f32_constants), &(cfg->local_f64_constants), &(cfg->local_xmm128_constants));
+
+	//And the profile counters if this is an instrumented build
+	print_profile_data_section(fl, cfg);
+}
+
+
+/**
+ * Create a new temporary assembly file inside of /tmp/oc/ and open it for writing. The
+ * name of the file is stored in assembly_file
+ */
+static FILE* open_temp_assembly_file(dynamic_string_t* assembly_file){
+	//We need to create the name ourselves
+	char outputted_assembly_file[1000];
+	
+	//Output it like so, we need to set the dynamic string to be this
+	sprintf(outputted_assembly_file, "/tmp/oc/ollie_asm_tmp%d.s", increment_and_get_tmp_file_id());
+
+	//Set the dynamic string to be this
+	dynamic_string_set(assembly_file, outputted_assembly_file);
+
+	//Open the file for the purpose of writing
+	FILE* output = fopen(outputted_assembly_file, "w");
+
+	//If the file is null, we fail out here
+	if(output == NULL){
+		sprintf(info, "Failed to create the output file: %s\n", outputted_assembly_file);
+		print_assembler_message(MESSAGE_TYPE_ERROR, info);
+		error_count++;
+	}
+
+	return output;
+}
+
+
 /**
  * Assemble the program by writing it to a .s file. This is specifically intended for when the user
  * does *not* want to actually compile the program and requests that we output an assembly file only.
@@ -176,11 +242,8 @@ static u_int8_t output_generated_assembly_only(compiler_options_t* options, cfg_
 	//for this
 	print_start_section(basename(options->output_file), output, cfg);
 
-	//Handle all of the global vars first
-	print_all_global_variables(output, &(cfg->global_variables));
-
-	//Print all of the local constants as well
-	print_local_constants(output, &(cfg->local_string_constants), &(cfg->local_f32_constants), &(cfg->local_f64_constants), &(cfg->local_xmm128_constants));
+	//Then all of the data
+	print_data_section(output, cfg);
 
 	//Once we're done, close the file
 	fclose(output);
@@ -196,37 +259,19 @@ static u_int8_t output_generated_assembly_only(compiler_options_t* options, cfg_
  * into the file that we're after
  */
 static u_int8_t output_generated_assembly_to_temp_file(cfg_t* cfg, dynamic_string_t* assembly_file){
-	//The output file(Null initally)
-	FILE* output = NULL;
-
-	//We need to create the name ourselves
-	char outputted_assembly_file[1000];
-	
-	//Output it like so, we need to set the dynamic string to be this
-	sprintf(outputted_assembly_file, "/tmp/oc/ollie_asm_tmp%d.s", increment_and_get_tmp_file_id());
-
-	//Set the dynamic string to be this
-	dynamic_string_set(assembly_file, outputted_assembly_file);
-
-	//Open the file for the purpose of writing
-	output = fopen(outputted_assembly_file, "w");
+	//Let the helper make the file
+	FILE* output = open_temp_assembly_file(assembly_file);
 
 	//If the file is null, we fail out here
 	if(output == NULL){
-		sprintf(info, "Failed to create the output file: %s\n", outputted_assembly_file);
-		print_assembler_message(MESSAGE_TYPE_ERROR, info);
-		error_count++;
 		return FAILURE;
 	}
 
 	//We'll first print the text segment of the program
-	print_start_section(basename(outputted_assembly_file), output, cfg);
+	print_start_section(basename(assembly_file->string), output, cfg);
 
-	//Handle all of the global vars first
-	print_all_global_variables(output, &(cfg->global_variables));
-
-	//Print all of the local constants as well
-	print_local_constants(output, &(cfg->local_string_constants), &(cfg->local_f32_constants), &(cfg->local_f64_constants), &(cfg->local_xmm128_constants));
+	//Then all of the data
+	print_data_section(output, cfg);
 
 	//Once we're done, close the file
 	fclose(output);
@@ -496,7 +541,19 @@ static u_int8_t assemble_code(compiler_options_t* options, dynamic_string_t* ass
 	}
 
 	/**
-	 * Step 3: For everything in our list of temporary assembly files, assembly
+	 * Step 3: an instrumented build also needs the profile runtime, which is what
+	 * writes the counters out once main returns
+	 */
+	if(options->profile_generate_file != NULL){
+		result = run_file_through_assembler("./oc/builtins/precompiled_builtins/__ostl_profile_runtime.s", options->enable_debug_printing);
+
+		if(result == FAILURE){
+			return FAILURE;
+		}
+	}
+
+	/**
+	 * Step 4: For everything in our list of temporary assembly files, assembly
 	 * them into their own .o files respectively
 	 */
 	//Run it through the assembler
@@ -769,3 +826,114 @@ void assemble_and_link(compiler_options_t* options, cfg_t* cfg, u_int32_t* num_e
 			break;
 	}
 }
+
+
+/**
+ * Open up the assembly file that functions will be streamed into one at a time. For
+ * a test run, nothing is opened and every streamed function is just discarded
+ */
+u_int8_t begin_streamed_assembly(compiler_options_t* options, u_int32_t* num_errors, u_int32_t* num_warnings){
+	//Save these so we can update easily
+	error_count = num_errors;
+	warning_count = num_warnings;
+
+	switch(options->output_type){
+		//Nothing to open at all
+		case OUTPUT_TYPE_NO_OUTPUT:
+			return SUCCESS;
+
+		//The user gets the .s file directly
+		case OUTPUT_TYPE_ASSEMBLY_ONLY:
+			streamed_output = fopen(options->output_file, "w");
+
+			//If the file is null, we fail out here
+			if(streamed_output == NULL){
+				sprintf(info, "[ASSEMBLER ERROR]: Failed to create the output file: %s\n", options->output_file);
+				print_assembler_message(MESSAGE_TYPE_ERROR, info);
+				(*error_count)++;
+				return FAILURE;
+			}
+
+			//Declare the start of the new file to gas
+			fprintf(streamed_output, "\t.file\t\"%s\"\n", basename(options->output_file));
+
+			return SUCCESS;
+
+		//Otherwise this is going into a temp file that we'll assemble later
+		default:
+			//The /tmp/oc/ directory must exist and be empty
+			if(perform_tmp_directory_management() == FAILURE || perform_tmp_directory_cleanup() == FAILURE){
+				return FAILURE;
+			}
+
+			streamed_assembly_file = dynamic_string_alloc();
+
+			//Let the helper make the file
+			streamed_output = open_temp_assembly_file(&streamed_assembly_file);
+
+			//It didn't work so don't bother going on
+			if(streamed_output == NULL){
+				return FAILURE;
+			}
+
+			//Declare the start of the new file to gas
+			fprintf(streamed_output, "\t.file\t\"%s\"\n", basename(streamed_assembly_file.string));
+
+			return SUCCESS;
+	}
+}
+
+
+/**
+ * Write out the assembly for a single function that has been fully register allocated
+ */
+void emit_streamed_function(basic_block_t* function_entry){
+	//This is a test run so there's nowhere to put it
+	if(streamed_output == NULL){
+		return;
+	}
+
+	print_function_assembly(streamed_output, function_entry);
+}
+
+
+/**
+ * Once every function has been streamed, write out all of the data, close the file and
+ * then assemble/link it just like we would for a non-streamed compilation
+ */
+void finish_streamed_assembly(compiler_options_t* options, cfg_t* cfg){
+	//Nothing was ever opened
+	if(streamed_output == NULL){
+		return;
+	}
+
+	//All of the data goes at the very end
+	print_data_section(streamed_output, cfg);
+
+	//We're done writing
+	fclose(streamed_output);
+	streamed_output = NULL;
+
+	switch(options->output_type){
+		//The .s file was all that we needed
+		case OUTPUT_TYPE_ASSEMBLY_ONLY:
+			return;
+
+		//Assemble straight into the user's object file
+		case OUTPUT_TYPE_OBJECT_FILE:
+			run_file_through_assembler_custom_output(streamed_assembly_file.string, options->output_file, options->enable_debug_printing);
+			break;
+
+		//Full compilation - assemble and link it all
+		default:
+			if(assemble_code(options, &streamed_assembly_file) == FAILURE || link_and_produce_final_executable(options) == FAILURE){
+				fprintf(stderr, "Program Compilation Failed\n");
+				exit(1);
+			}
+
+			break;
+	}
+
+	//This is no longer needed
+	dynamic_string_dealloc(&streamed_assembly_file);
+}
@@ -16,4 +16,19 @@
  */
 void assemble_and_link(compiler_options_t* options, cfg_t* cfg, u_int32_t* num_errors, u_int32_t* num_warnings);
 
+/**
+ * Open up the assembly output that functions will be streamed into one at a time
+ */
+u_int8_t begin_streamed_assembly(compiler_options_t* options, u_int32_t* num_errors, u_int32_t* num_warnings);
+
+/**
+ * Write out a single fully allocated function to the streamed assembly output
+ */
+void emit_streamed_function(basic_block_t* function_entry);
+
+/**
+ * Write out all of the data, then assemble and link the streamed output
+ */
+void finish_streamed_assembly(compiler_options_t* options, cfg_t* cfg);
+
 #endif /* ASSEMBLER_H */
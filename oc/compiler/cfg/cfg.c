@@ -141,6 +141,60 @@ typedef enum{
 } variable_scope_type_t;
 
 
+/**
+ * When a switch is too sparse for a single jump table, we break its
+ * cases up into clusters. Each cluster is lowered in one of these ways
+ */
+typedef enum{
+	SWITCH_CLUSTER_SINGLE_CASE,
+	SWITCH_CLUSTER_JUMP_TABLE,
+	SWITCH_CLUSTER_BIT_TEST,
+} switch_cluster_type_t;
+
+
+/**
+ * A case value in a sparse switch along with the block that
+ * we need to land on when we see it
+ */
+typedef struct{
+	basic_block_t* target;
+	//Stored widened so that unsigned values sort properly
+	int64_t value;
+} switch_case_t;
+
+
+/**
+ * A run of consecutive(in sorted order) cases that are
+ * all lowered together
+ */
+typedef struct{
+	switch_cluster_type_t type;
+	//Indices into the sorted case array, both inclusive
+	u_int32_t first;
+	u_int32_t last;
+} switch_cluster_t;
+
+
+/**
+ * Everything that the sparse switch lowering needs to carry around
+ * while it builds the decision tree
+ */
+typedef struct{
+	//The cases sorted by value
+	switch_case_t* cases;
+	//The clusters that we've grouped those cases into
+	switch_cluster_t* clusters;
+	//The value that we are switching on
+	three_addr_var_t* input;
+	//Where we go when nothing matches
+	basic_block_t* default_block;
+	u_int32_t case_count;
+	u_int32_t cluster_count;
+	u_int32_t line_number;
+	u_int8_t is_signed;
+} sparse_switch_t;
+
+
 /**
  * Define a simple initializer for a blank CFG
  * result type. We usually stack allocate these
@@ -566,13 +620,46 @@ static inline u_int8_t does_type_require_copy_assignment(generic_type_t* type){
 }
 
 
+/**
+ * Add a block to the CFG's created blocks array, remembering where it
+ * went so that it can be pulled back out without a search
+ */
+static inline void add_to_created_blocks(cfg_t* cfg, basic_block_t* block){
+	block->created_blocks_index = cfg->created_blocks.current_index;
+	dynamic_array_add(&(cfg->created_blocks), block);
+}
+
+
+/**
+ * Take a block out of the CFG's created blocks array in constant time. The last block
+ * is moved into the hole, because nothing relies on the order of this array
+ */
+void remove_from_created_blocks(cfg_t* cfg, basic_block_t* block){
+	//Already gone, nothing to do
+	if(block->created_blocks_index == -1){
+		return;
+	}
+
+	//Grab the last block out
+	cfg->created_blocks.current_index--;
+	basic_block_t* last = cfg->created_blocks.internal_array[cfg->created_blocks.current_index];
+
+	//Move it into the hole and update where it lives
+	cfg->created_blocks.internal_array[block->created_blocks_index] = last;
+	last->created_blocks_index = block->created_blocks_index;
+
+	//This one is no longer owned by the CFG
+	block->created_blocks_index = -1;
+}
+
+
 /**
  * Delete a block, including all of the needed internal
  * bookkeeping
  */
 static inline void delete_block(basic_block_t* block){
 	//Remove it from the overall structure
-	dynamic_array_delete(&(cfg->created_blocks), block);
+	remove_from_created_blocks(cfg, block);
 
 	//And delete it from this function's blocks too
 	dynamic_array_delete(current_function_blocks, block);
@@ -923,6 +1010,9 @@ static basic_block_t* basic_block_alloc_and_estimate(){
 	//Allocate the block
 	basic_block_t* created = calloc(1, sizeof(basic_block_t));
 
+	//The analysis data lives out of line
+	created->analysis = calloc(1, sizeof(basic_block_analysis_t));
+
 	//Put the block ID in
 	created->block_id = increment_and_get();
 
@@ -936,8 +1026,14 @@ static basic_block_t* basic_block_alloc_and_estimate(){
 	//Let's add in what function this block came from
 	created->function_defined_in = current_function;
 
+	//Hand out the next dense index for this function
+	if(current_function != NULL){
+		created->function_block_index = current_function->number_of_block_indices;
+		current_function->number_of_block_indices++;
+	}
+
 	//Add this into the dynamic array
-	dynamic_array_add(&(cfg->created_blocks), created);
+	add_to_created_blocks(cfg, created);
 
 	//Add it into the function's block array
 	dynamic_array_add(current_function_blocks, created);
@@ -954,6 +1050,9 @@ static basic_block_t* labeled_block_alloc(symtab_label_record_t* label){
 	//Allocate the block
 	basic_block_t* created = calloc(1, sizeof(basic_block_t));
 
+	//The analysis data lives out of line
+	created->analysis = calloc(1, sizeof(basic_block_analysis_t));
+
 	//Put the block ID in even though it is a labeled block
 	created->block_id = increment_and_get();
 
@@ -967,6 +1066,12 @@ static basic_block_t* labeled_block_alloc(symtab_label_record_t* label){
 	//Let's add in what function this block came from
 	created->function_defined_in = current_function;
 
+	//Hand out the next dense index for this function
+	if(current_function != NULL){
+		created->function_block_index = current_function->number_of_block_indices;
+		current_function->number_of_block_indices++;
+	}
+
 	/**
 	 * We will store the block itself alongside with the label. This
 	 * will make lookup/cross reference easier when we have to
@@ -975,7 +1080,7 @@ static basic_block_t* labeled_block_alloc(symtab_label_record_t* label){
 	label->block = created;
 
 	//Add this into the dynamic array
-	dynamic_array_add(&(cfg->created_blocks), created);
+	add_to_created_blocks(cfg, created);
 
 	//Add it into the function's block array
 	dynamic_array_add(current_function_blocks, created);
@@ -985,6 +1090,46 @@ static basic_block_t* labeled_block_alloc(symtab_label_record_t* label){
 }
 
 
+/**
+ * Allocate a block inside of a function that has already been fully constructed. Unlike
+ * the allocators above, we have no nesting stack to lean on here, so the caller needs to
+ * tell us how often the block is going to run
+ */
+basic_block_t* basic_block_alloc_in_function(cfg_t* cfg, symtab_function_record_t* function, u_int32_t estimated_execution_frequency){
+	//Allocate the block
+	basic_block_t* created = calloc(1, sizeof(basic_block_t));
+
+	//The analysis data lives out of line
+	created->analysis = calloc(1, sizeof(basic_block_analysis_t));
+
+	//Put the block ID in
+	(cfg->block_id)++;
+	created->block_id = cfg->block_id;
+
+	//By default we're normal here
+	created->block_type = BLOCK_TYPE_NORMAL;
+
+	//Whatever we were given
+	created->estimated_execution_frequency = estimated_execution_frequency;
+
+	//Let's add in what function this block came from
+	created->function_defined_in = function;
+
+	//Hand out the next dense index for this function
+	created->function_block_index = function->number_of_block_indices;
+	function->number_of_block_indices++;
+
+	//Add this into the dynamic array
+	add_to_created_blocks(cfg, created);
+
+	//Add it into the function's block array
+	dynamic_array_add(&(function->function_blocks), created);
+
+	//Give it back
+	return created;
+}
+
+
 /**
  * Print a block our for reading
 */
@@ -1009,16 +1154,16 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 
 
 	//Now, we will print all of the active variables that this block has
-	if(block->used_before_definition.current_index != 0){
+	if(block->analysis->used_before_definition.current_index != 0){
 		printf("(");
 
 		//Run through all of the live variables and print them out
-		for(int32_t i = 0; i < block->used_before_definition.current_index; i++){
+		for(int32_t i = 0; i < block->analysis->used_before_definition.current_index; i++){
 			//Print it out
-			print_variable(stdout, block->used_before_definition.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
+			print_variable(stdout, block->analysis->used_before_definition.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->used_before_definition.current_index - 1){
+			if(i != block->analysis->used_before_definition.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -1077,14 +1222,14 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 	printf("}\n");
 
 	//If we have some assigned variables, we will dislay those for debugging
-	if(block->assigned_variables.current_index != 0){
+	if(block->analysis->assigned_variables.current_index != 0){
 		printf("Assigned: (");
 
-		for(int32_t i = 0; i < block->assigned_variables.current_index; i++){
-			print_variable(stdout, block->assigned_variables.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
+		for(int32_t i = 0; i < block->analysis->assigned_variables.current_index; i++){
+			print_variable(stdout, block->analysis->assigned_variables.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->assigned_variables.current_index - 1){
+			if(i != block->analysis->assigned_variables.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -1092,14 +1237,14 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 	}
 
 	//Now if we have LIVE_IN variables, we'll print those out
-	if(block->live_in.internal_array != NULL){
+	if(block->analysis->live_in.internal_array != NULL){
 		printf("LIVE_IN: (");
 
-		for(int32_t i = 0; i < block->live_in.current_index; i++){
-			print_variable(stdout, block->live_in.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
+		for(int32_t i = 0; i < block->analysis->live_in.current_index; i++){
+			print_variable(stdout, block->analysis->live_in.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
 
 			//If it isn't the very last one, print out a comma
-			if(i != block->live_in.current_index - 1){
+			if(i != block->analysis->live_in.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -1109,14 +1254,14 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 	}
 
 	//Now if we have LIVE_IN variables, we'll print those out
-	if(block->live_out.internal_array != NULL){
+	if(block->analysis->live_out.internal_array != NULL){
 		printf("LIVE_OUT: (");
 
-		for(int32_t i = 0; i < block->live_out.current_index; i++){
-			print_variable(stdout, block->live_out.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
+		for(int32_t i = 0; i < block->analysis->live_out.current_index; i++){
+			print_variable(stdout, block->analysis->live_out.internal_array[i], PRINTING_VAR_BLOCK_HEADER);
 
 			//If it isn't the very last one, print out a comma
-			if(i != block->live_out.current_index - 1){
+			if(i != block->analysis->live_out.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -1127,12 +1272,12 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 
 
 	//Print out the dominance frontier if we're in DEBUG mode
-	if(print_df == EMIT_DOMINANCE_FRONTIER && block->dominance_frontier.internal_array != NULL){
+	if(print_df == EMIT_DOMINANCE_FRONTIER && block->analysis->dominance_frontier.internal_array != NULL){
 		printf("Dominance frontier: {");
 
 		//Run through and print them all out
-		for(int32_t i = 0; i < block->dominance_frontier.current_index; i++){
-			basic_block_t* printing_block = block->dominance_frontier.internal_array[i];
+		for(int32_t i = 0; i < block->analysis->dominance_frontier.current_index; i++){
+			basic_block_t* printing_block = block->analysis->dominance_frontier.internal_array[i];
 
 			//Print the block's ID or the function name
 			if(printing_block->block_type == BLOCK_TYPE_FUNC_ENTRY){
@@ -1142,7 +1287,7 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 			}
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->dominance_frontier.current_index - 1){
+			if(i != block->analysis->dominance_frontier.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -1152,12 +1297,12 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 	}
 
 	//Print out the reverse dominance frontier if we're in DEBUG mode
-	if(print_df == EMIT_DOMINANCE_FRONTIER && block->reverse_dominance_frontier.internal_array != NULL){
+	if(print_df == EMIT_DOMINANCE_FRONTIER && block->analysis->reverse_dominance_frontier.internal_array != NULL){
 		printf("Reverse Dominance frontier: {");
 
 		//Run through and print them all out
-		for(int32_t i = 0; i < block->reverse_dominance_frontier.current_index; i++){
-			basic_block_t* printing_block = block->reverse_dominance_frontier.internal_array[i];
+		for(int32_t i = 0; i < block->analysis->reverse_dominance_frontier.current_index; i++){
+			basic_block_t* printing_block = block->analysis->reverse_dominance_frontier.internal_array[i];
 
 			//Print the block's ID or the function name
 			if(printing_block->block_type == BLOCK_TYPE_FUNC_ENTRY){
@@ -1167,7 +1312,7 @@ void print_block_three_addr_code(basic_block_t* block, emit_dominance_frontier_s
 			}
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->reverse_dominance_frontier.current_index - 1){
+			if(i != block->analysis->reverse_dominance_frontier.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -1280,6 +1425,10 @@ void move_statement(instruction_t* target, basic_block_t* destination){
 		next->previous_statement = previous;
 	}
 
+	//It's going on the end of the destination, so the old links can't be kept around
+	target->next_statement = NULL;
+	target->previous_statement = NULL;
+
 	/**
 	 * Once we've removed this statement from the source block, we will add it
 	 * into the target block with a regular add_statement call
@@ -1302,9 +1451,9 @@ void delete_statement(instruction_t* stmt){
 	 */
 	three_addr_var_t* local_constant_var = stmt->operands.oir.rip_offset_var;
 
-	//Knock one off of the reference count if it's valid
+	//Knock one off of the reference count if it's valid. Constants are shared between functions, so this must be atomic
 	if(local_constant_var != NULL && local_constant_var->variable_type == VARIABLE_TYPE_LOCAL_CONSTANT){
-		local_constant_var->associated_memory_region.local_constant->reference_count--;
+		__atomic_sub_fetch(&(local_constant_var->associated_memory_region.local_constant->reference_count), 1, __ATOMIC_RELAXED);
 	}
 
 	//No matter what, we are reducing the number of statements in this block
@@ -1345,21 +1494,27 @@ void delete_statement(instruction_t* stmt){
 
 	/**
 	 * Now we need to do all maintenance when it comes to used variables for these statements. All variables
-	 * in here that were used now have one less "use" instance, and we'll need to update accordingly
+	 * in here that were used now have one less "use" instance, and we'll need to update accordingly. The
+	 * stack and instruction pointers are shared by every function, and functions are handled in parallel,
+	 * so they are left out
 	 */
-	if(stmt->operands.oir.operand1 != NULL){
+	if(stmt->operands.oir.operand1 != NULL && stmt->operands.oir.operand1 != stack_pointer_variable
+		&& stmt->operands.oir.operand1 != instruction_pointer_var){
 		stmt->operands.oir.operand1->use_count--;
 	}
 
-	if(stmt->operands.oir.operand2 != NULL){
+	if(stmt->operands.oir.operand2 != NULL && stmt->operands.oir.operand2 != stack_pointer_variable
+		&& stmt->operands.oir.operand2 != instruction_pointer_var){
 		stmt->operands.oir.operand2->use_count--;
 	}
 
-	if(stmt->operands.oir.address_operand1 != NULL){
+	if(stmt->operands.oir.address_operand1 != NULL && stmt->operands.oir.address_operand1 != stack_pointer_variable
+		&& stmt->operands.oir.address_operand1 != instruction_pointer_var){
 		stmt->operands.oir.address_operand1->use_count--;
 	}
 
-	if(stmt->operands.oir.address_operand2 != NULL){
+	if(stmt->operands.oir.address_operand2 != NULL && stmt->operands.oir.address_operand2 != stack_pointer_variable
+		&& stmt->operands.oir.address_operand2 != instruction_pointer_var){
 		stmt->operands.oir.address_operand2->use_count--;
 	}
 }
@@ -1431,8 +1586,8 @@ static void add_variable_to_use_set(three_addr_var_t* variable, basic_block_t* b
 	}
 
 	//Extract the two sets we'll be working with
-	dynamic_array_t* def_set = &(block->assigned_variables);
-	dynamic_array_t* use_set = &(block->used_before_definition);
+	dynamic_array_t* def_set = &(block->analysis->assigned_variables);
+	dynamic_array_t* use_set = &(block->analysis->used_before_definition);
 
 	//Otherwise, let's make sure it's not also in DEF
 	for(int32_t i = 0; i < def_set->current_index; i++){
@@ -1493,7 +1648,7 @@ static inline void add_variable_to_def_set(three_addr_var_t* variable, basic_blo
 	}
 
 	//Extract the set that we'll be working with
-	dynamic_array_t* def_set = &(block->assigned_variables);
+	dynamic_array_t* def_set = &(block->analysis->assigned_variables);
 
 	//Otherwise, let's make sure it's not also in DEF
 	for(int32_t i = 0; i < def_set->current_index; i++){
@@ -1542,8 +1697,8 @@ static void compute_use_and_def_sets_for_function(dynamic_array_t* function_bloc
 		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
 
 		//Let's allocate the USE/DEF sets for each block
-		block->used_before_definition = dynamic_array_alloc();
-		block->assigned_variables = dynamic_array_alloc();
+		block->analysis->used_before_definition = dynamic_array_alloc();
+		block->analysis->assigned_variables = dynamic_array_alloc();
 
 		//Now grab a cursor for our instruction call
 		instruction_t* cursor = block->leader_statement;
@@ -1684,7 +1839,7 @@ static void calculate_liveness_sets(dynamic_array_t* function_blocks, basic_bloc
 	 * to get the reverse post order traversal over the reverse CFG
 	 */
 	dynamic_array_t reverse_post_order_reverse_cfg = dynamic_array_alloc_initial_size(function_blocks->current_max_size);
-	get_reverse_post_order_reverse_cfg_traversal(function_blocks, function_exit_block, &reverse_post_order_reverse_cfg);
+	get_reverse_post_order_reverse_cfg_traversal(function_exit_block, &reverse_post_order_reverse_cfg);
 
 	//The "Prime" blocks are just ways to hold the old dynamic arrays
 	dynamic_array_t in_prime;
@@ -1709,11 +1864,11 @@ static void calculate_liveness_sets(dynamic_array_t* function_blocks, basic_bloc
 			current = dynamic_array_get_at(&reverse_post_order_reverse_cfg, _);
 
 			//Transfer the pointers over
-			in_prime = current->live_in;
-			out_prime = current->live_out;
+			in_prime = current->analysis->live_in;
+			out_prime = current->analysis->live_out;
 
 			//Set live out to be a new array
-			current->live_out = dynamic_array_alloc();
+			current->analysis->live_out = dynamic_array_alloc();
 			
 			//Run through all of the successors
 			for(int32_t k = 0; k < current->successors.current_index; k++){
@@ -1721,13 +1876,13 @@ static void calculate_liveness_sets(dynamic_array_t* function_blocks, basic_bloc
 				basic_block_t* successor = dynamic_array_get_at(&(current->successors), k);
 
 				//If it has a live in set
-				if(successor->live_in.internal_array != NULL){
+				if(successor->analysis->live_in.internal_array != NULL){
 					//Add everything in his live_in set into the live_out set
-					for(int32_t l = 0; l < successor->live_in.current_index; l++){
+					for(int32_t l = 0; l < successor->analysis->live_in.current_index; l++){
 						//Let's check to make sure we haven't already added this
-						three_addr_var_t* successor_live_in_var = dynamic_array_get_at(&(successor->live_in), l);
+						three_addr_var_t* successor_live_in_var = dynamic_array_get_at(&(successor->analysis->live_in), l);
 
-						variable_dynamic_array_add(&(current->live_out), successor_live_in_var);
+						variable_dynamic_array_add(&(current->analysis->live_out), successor_live_in_var);
 					}
 				}
 			}
@@ -1742,17 +1897,17 @@ static void calculate_liveness_sets(dynamic_array_t* function_blocks, basic_bloc
 			 * Since we need all of the used variables, we'll just clone this
 			 * dynamic array so that we start off with them all
 			 */
-			current->live_in = clone_dynamic_array(&(current->used_before_definition));
+			current->analysis->live_in = clone_dynamic_array(&(current->analysis->used_before_definition));
 
 			//Now we need to add every variable that is in LIVE_OUT but NOT in assigned
-			for(int32_t j = 0; j < current->live_out.current_index; j++){
+			for(int32_t j = 0; j < current->analysis->live_out.current_index; j++){
 				//Grab a reference for our use
-				three_addr_var_t* live_out_var = dynamic_array_get_at(&(current->live_out), j);
+				three_addr_var_t* live_out_var = dynamic_array_get_at(&(current->analysis->live_out), j);
 
 				//Now we need this block to be not in "assigned" also. If it is in assigned we can't add it
-				if(variable_dynamic_array_contains(&(current->assigned_variables), live_out_var) == NOT_FOUND){
+				if(variable_dynamic_array_contains(&(current->analysis->assigned_variables), live_out_var) == NOT_FOUND){
 					//If this is true we can add
-					variable_dynamic_array_add(&(current->live_in), live_out_var);
+					variable_dynamic_array_add(&(current->analysis->live_in), live_out_var);
 				}
 			}
 		
@@ -1764,8 +1919,8 @@ static void calculate_liveness_sets(dynamic_array_t* function_blocks, basic_bloc
 			//For efficiency - if there was a difference in one block, it's already done - no use in comparing
 			if(difference_found == FALSE){
 				//So we haven't found a difference so far - let's see if we can find one now
-				if(variable_dynamic_arrays_equal(&in_prime, &(current->live_in)) == FALSE 
-				  || variable_dynamic_arrays_equal(&out_prime, &(current->live_out)) == FALSE){
+				if(variable_dynamic_arrays_equal(&in_prime, &(current->analysis->live_in)) == FALSE 
+				  || variable_dynamic_arrays_equal(&out_prime, &(current->analysis->live_out)) == FALSE){
 					//We have in fact found a difference
 					difference_found = TRUE;
 				}
@@ -7780,19 +7935,19 @@ static void emit_blocks_bfs(cfg_t* cfg, emit_dominance_frontier_selection_t prin
 			block = dequeue(&traversal_queue);
 
 			//If this wasn't visited, we'll print
-			if(block->visited == FALSE){
+			if(is_block_visited(block) == FALSE){
 				print_block_three_addr_code(block, print_df);	
 			}
 
 			//Now we'll mark this as visited
-			block->visited = TRUE;
+			mark_block_visited(block);
 
 			//And finally we'll add all of these onto the queue
 			for(int32_t j = 0; j < block->successors.current_index; j++){
 				//Add the successor into the queue, if it has not yet been visited
 				basic_block_t* successor = block->successors.internal_array[j];
 
-				if(successor->visited == FALSE){
+				if(is_block_visited(successor) == FALSE){
 					enqueue(&traversal_queue, successor);
 				}
 			}
@@ -7812,39 +7967,42 @@ void basic_block_dealloc(basic_block_t* block){
 	}
 
 	//Deallocate the live variable array
-	if(block->used_before_definition.internal_array != NULL){
-		dynamic_array_dealloc(&(block->used_before_definition));
+	if(block->analysis->used_before_definition.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->used_before_definition));
 	}
 
 	//Deallocate the assigned variable array
-	if(block->assigned_variables.internal_array != NULL){
-		dynamic_array_dealloc(&(block->assigned_variables));
+	if(block->analysis->assigned_variables.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->assigned_variables));
 	}
 
 	//Deallocate the domninance frontier
-	if(block->dominance_frontier.internal_array != NULL){
-		dynamic_array_dealloc(&(block->dominance_frontier));
+	if(block->analysis->dominance_frontier.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->dominance_frontier));
 	}
 
 	//Deallocate the reverse dominance frontier
-	if(block->reverse_dominance_frontier.internal_array != NULL){
-		dynamic_array_dealloc(&(block->reverse_dominance_frontier));
+	if(block->analysis->reverse_dominance_frontier.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->reverse_dominance_frontier));
 	}
 
 	//Deallocate the dominator children frontier
-	if(block->dominator_children.internal_array != NULL){
-		dynamic_array_dealloc(&(block->dominator_children));
+	if(block->analysis->dominator_children.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->dominator_children));
 	}
 
 	//Deallocate the liveness sets
-	if(block->live_out.internal_array != NULL){
-		dynamic_array_dealloc(&(block->live_out));
+	if(block->analysis->live_out.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->live_out));
 	}
 
-	if(block->live_in.internal_array != NULL){
-		dynamic_array_dealloc(&(block->live_in));
+	if(block->analysis->live_in.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->live_in));
 	}
 
+	//Now the analysis record itself can go
+	free(block->analysis);
+
 	//Deallocate the successors
 	if(block->successors.internal_array != NULL){
 		dynamic_array_dealloc(&(block->successors));
@@ -7879,6 +8037,48 @@ void basic_block_dealloc(basic_block_t* block){
 }
 
 
+/**
+ * Deallocate every block and instruction that belongs to the function at the given
+ * index. Once this is done, nothing in the function can be touched again
+ */
+void dealloc_function(cfg_t* cfg, u_int32_t function_index){
+	//Extract the entry block and the record
+	basic_block_t* function_entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), function_index);
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+
+	/**
+	 * Only blocks that the CFG still owns are deallocated. Blocks that were merged away
+	 * have already handed their statements over to another block, so those are skipped.
+	 * Blocks that the optimizer cut out as unreachable are no longer in this function's
+	 * array, so they stay around until the whole CFG goes
+	 */
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = function->function_blocks.internal_array[i];
+
+		//Merged away already
+		if(block->created_blocks_index == -1){
+			continue;
+		}
+
+		remove_from_created_blocks(cfg, block);
+		basic_block_dealloc(block);
+	}
+
+	//The register allocator's live ranges were only kept around for the emitter
+	for(int32_t i = 0; i < function->live_ranges.current_index; i++){
+		live_range_dealloc(function->live_ranges.internal_array[i]);
+	}
+
+	clear_dynamic_array(&(function->live_ranges));
+
+	//Nothing should be able to reach these blocks anymore
+	clear_dynamic_array(&(function->function_blocks));
+	function->function_entry_block = NULL;
+	cfg->function_entry_blocks.internal_array[function_index] = NULL;
+	cfg->function_exit_blocks.internal_array[function_index] = NULL;
+}
+
+
 /**
  * Memory management code that allows us to deallocate the entire CFG
  */
@@ -9499,6 +9699,480 @@ static cfg_result_package_t visit_exhaustive_c_style_switch_statement(generic_as
 }
 
 
+/**
+ * Add a case into a sparse switch that we're collecting. Unsigned values are widened
+ * without sign extension so that our sorted order matches the unsigned comparisons
+ * that we'll be emitting later on
+ */
+static inline void add_sparse_switch_case(sparse_switch_t* sparse_switch, int32_t case_value, basic_block_t* target){
+	//Grab the next open slot
+	switch_case_t* switch_case = &(sparse_switch->cases[sparse_switch->case_count]);
+
+	switch_case->target = target;
+
+	if(sparse_switch->is_signed == TRUE){
+		switch_case->value = case_value;
+	} else {
+		switch_case->value = (u_int32_t)case_value;
+	}
+
+	sparse_switch->case_count++;
+}
+
+
+/**
+ * Count up the cases of a switch that the parser has found to be too sparse for a jump table. If
+ * there are enough of them to be worth a decision tree, we'll allocate room for them and return
+ * TRUE. Otherwise we return FALSE and the caller should just emit a chain of comparisons
+ */
+static u_int8_t initialize_sparse_switch(sparse_switch_t* sparse_switch, generic_ast_node_t* case_default_cursor, ast_node_type_t case_node_type){
+	u_int32_t case_count = 0;
+
+	while(case_default_cursor != NULL){
+		if(case_default_cursor->ast_node_type == case_node_type){
+			case_count++;
+		}
+
+		case_default_cursor = case_default_cursor->next_sibling;
+	}
+
+	if(case_count < SWITCH_DECISION_TREE_MIN_CASES){
+		return FALSE;
+	}
+
+	sparse_switch->cases = calloc(case_count, sizeof(switch_case_t));
+
+	return TRUE;
+}
+
+
+/**
+ * Does a case or default statement have nothing of its own in it? These are the
+ * blocks that are made for cases that just fall through to the next one
+ */
+static inline u_int8_t is_switch_case_empty(cfg_result_package_t* case_results){
+	if(case_results->starting_block == case_results->final_block && case_results->starting_block->leader_statement == NULL){
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Ordering function for qsort. Cases are sorted by their value, and the parser has
+ * already guaranteed that there are no duplicates
+ */
+static int compare_switch_cases(const void* a, const void* b){
+	const switch_case_t* case_a = a;
+	const switch_case_t* case_b = b;
+
+	if(case_a->value < case_b->value){
+		return -1;
+	}
+
+	if(case_a->value > case_b->value){
+		return 1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Count how many distinct blocks the cases from first to last(inclusive) go to
+ */
+static u_int32_t count_switch_case_targets(sparse_switch_t* sparse_switch, u_int32_t first, u_int32_t last){
+	u_int32_t target_count = 0;
+
+	for(u_int32_t i = first; i <= last; i++){
+		//Only count a target the first time that we see it
+		u_int8_t seen_before = FALSE;
+
+		for(u_int32_t j = first; j < i; j++){
+			if(sparse_switch->cases[j].target == sparse_switch->cases[i].target){
+				seen_before = TRUE;
+				break;
+			}
+		}
+
+		if(seen_before == FALSE){
+			target_count++;
+		}
+	}
+
+	return target_count;
+}
+
+
+/**
+ * Group the sorted cases of a sparse switch into clusters. We go greedily from the lowest
+ * value upwards. At each position, we first look for the longest run that is dense enough
+ * to get its own jump table. If there is not one, we look for the longest run that fits inside
+ * of a bit test. If neither works out, the case stands on its own and the decision tree
+ * will deal with it
+ */
+static void build_sparse_switch_clusters(sparse_switch_t* sparse_switch){
+	u_int32_t current = 0;
+
+	while(current < sparse_switch->case_count){
+		switch_cluster_t* cluster = &(sparse_switch->clusters[sparse_switch->cluster_count]);
+		cluster->type = SWITCH_CLUSTER_SINGLE_CASE;
+		cluster->first = current;
+		cluster->last = current;
+
+		/**
+		 * Try for a jump table first. We go from the widest possible run down, so the first
+		 * one that we find that is dense enough is also the longest one
+		 */
+		for(int64_t last = sparse_switch->case_count - 1; last - current + 1 >= SWITCH_JUMP_TABLE_MIN_CASES; last--){
+			int64_t range = sparse_switch->cases[last].value - sparse_switch->cases[current].value + 1;
+			int64_t count = last - current + 1;
+
+			if(count * 100 >= range * SWITCH_JUMP_TABLE_MIN_DENSITY_PERCENT){
+				cluster->type = SWITCH_CLUSTER_JUMP_TABLE;
+				cluster->last = last;
+				break;
+			}
+		}
+
+		/**
+		 * If we couldn't get a jump table, we'll see if a bit test fits. Every distinct target
+		 * costs us one mask test, so we need more than two cases per target for this to beat
+		 * just comparing one at a time
+		 */
+		if(cluster->type == SWITCH_CLUSTER_SINGLE_CASE){
+			for(u_int32_t last = current + 1; last < sparse_switch->case_count; last++){
+				//Everything has to fit inside of the mask
+				if(sparse_switch->cases[last].value - sparse_switch->cases[current].value >= SWITCH_BIT_TEST_MAX_RANGE){
+					break;
+				}
+
+				//The target count can only grow from here, so once we're over there's no point in going on
+				u_int32_t target_count = count_switch_case_targets(sparse_switch, current, last);
+				if(target_count > SWITCH_BIT_TEST_MAX_TARGETS){
+					break;
+				}
+
+				if(last - current + 1 > 2 * target_count){
+					cluster->type = SWITCH_CLUSTER_BIT_TEST;
+					cluster->last = last;
+				}
+			}
+		}
+
+		//Move along to whatever comes after this cluster
+		current = cluster->last + 1;
+		sparse_switch->cluster_count++;
+	}
+}
+
+
+/**
+ * Emit whatever range checks are needed to guarantee that the input is inside of [low, high] before a
+ * jump table or bit test uses it. Anything outside of that goes to the default. If the decision tree
+ * above us already guarantees one side, we skip that check entirely. The block that we give back is
+ * the one where the input is known to be in range
+ */
+static basic_block_t* emit_sparse_switch_range_checks(sparse_switch_t* sparse_switch, basic_block_t* block, int64_t low, int64_t high, int64_t known_low, int64_t known_high){
+	//Grab the type out for convenience
+	generic_type_t* input_type = sparse_switch->input->type;
+
+	//If we're below the minimum, we go to the default
+	if(low > known_low){
+		basic_block_t* above_low_block = basic_block_alloc_and_estimate();
+
+		three_addr_var_t* lower_than_decider = emit_temp_var(input_type);
+		emit_binary_operation_with_constant(block, lower_than_decider, sparse_switch->input, L_THAN, emit_direct_integer_or_char_constant((int32_t)low, i32), sparse_switch->line_number);
+
+		branch_type_t branch_lower_than = select_appropriate_branch_statement(L_THAN, BRANCH_CATEGORY_NORMAL, sparse_switch->is_signed);
+		emit_branch_for_switch_statement(block, sparse_switch->default_block, above_low_block, branch_lower_than, lower_than_decider, sparse_switch->line_number);
+
+		block = above_low_block;
+	}
+
+	//Same idea if we're above the maximum
+	if(high < known_high){
+		basic_block_t* in_range_block = basic_block_alloc_and_estimate();
+
+		three_addr_var_t* higher_than_decider = emit_temp_var(input_type);
+		emit_binary_operation_with_constant(block, higher_than_decider, sparse_switch->input, G_THAN, emit_direct_integer_or_char_constant((int32_t)high, i32), sparse_switch->line_number);
+
+		branch_type_t branch_greater_than = select_appropriate_branch_statement(G_THAN, BRANCH_CATEGORY_NORMAL, sparse_switch->is_signed);
+		emit_branch_for_switch_statement(block, sparse_switch->default_block, in_range_block, branch_greater_than, higher_than_decider, sparse_switch->line_number);
+
+		block = in_range_block;
+	}
+
+	return block;
+}
+
+
+/**
+ * Emit a chain of equality checks for the single case clusters from first to last(inclusive). Anything
+ * that falls off of the end of the chain goes to the default
+ */
+static void emit_sparse_switch_equality_chain(sparse_switch_t* sparse_switch, basic_block_t* block, u_int32_t first_cluster, u_int32_t last_cluster){
+	for(u_int32_t i = first_cluster; i <= last_cluster; i++){
+		switch_case_t* switch_case = &(sparse_switch->cases[sparse_switch->clusters[i].first]);
+
+		//The very last check falls through to the default, everything else goes to the next check
+		basic_block_t* else_block;
+		if(i == last_cluster){
+			else_block = sparse_switch->default_block;
+		} else {
+			else_block = basic_block_alloc_and_estimate();
+		}
+
+		three_addr_var_t* equals_decider = emit_temp_var(u8);
+		emit_binary_operation_with_constant(block, equals_decider, sparse_switch->input, DOUBLE_EQUALS, emit_direct_integer_or_char_constant((int32_t)switch_case->value, i32), sparse_switch->line_number);
+
+		branch_type_t branch_equals = select_appropriate_branch_statement(DOUBLE_EQUALS, BRANCH_CATEGORY_NORMAL, sparse_switch->is_signed);
+		emit_branch_for_switch_statement(block, switch_case->target, else_block, branch_equals, equals_decider, sparse_switch->line_number);
+
+		block = else_block;
+	}
+}
+
+
+/**
+ * Emit a jump table for one dense cluster of a sparse switch. This is the same indirect jump
+ * that an eligible switch gets, just scoped down to the cluster's own range. Any holes in
+ * the range go to the default
+ */
+static void emit_sparse_switch_jump_table(sparse_switch_t* sparse_switch, basic_block_t* block, switch_cluster_t* cluster, int64_t known_low, int64_t known_high){
+	int64_t low = sparse_switch->cases[cluster->first].value;
+	int64_t high = sparse_switch->cases[cluster->last].value;
+
+	//Make sure that we're in range first
+	block = emit_sparse_switch_range_checks(sparse_switch, block, low, high, known_low, known_high);
+
+	//The table gets its own block, like any other switch
+	basic_block_t* jump_calculation_block = basic_block_alloc_and_estimate();
+	jump_calculation_block->block_type = BLOCK_TYPE_SWITCH;
+	jump_calculation_block->jump_table = jump_table_alloc(high - low + 1);
+
+	emit_jump(block, jump_calculation_block);
+
+	//Fill in all of the real entries, knocked down so that the lowest one is at 0
+	for(u_int32_t i = cluster->first; i <= cluster->last; i++){
+		add_jump_table_entry(jump_calculation_block->jump_table, sparse_switch->cases[i].value - low, sparse_switch->cases[i].target);
+		add_successor(jump_calculation_block, sparse_switch->cases[i].target);
+	}
+
+	//Any holes that are left over go to the default
+	u_int8_t has_default_jumps = FALSE;
+	for(int32_t i = 0; i < jump_calculation_block->jump_table->num_nodes; i++){
+		if(dynamic_array_get_at(&(jump_calculation_block->jump_table->nodes), i) == NULL){
+			dynamic_array_set_at(&(jump_calculation_block->jump_table->nodes), sparse_switch->default_block, i);
+			has_default_jumps = TRUE;
+		}
+	}
+
+	if(has_default_jumps == TRUE){
+		add_successor(jump_calculation_block, sparse_switch->default_block);
+	}
+
+	//To avoid violating SSA rules, we'll emit a temporary assignment here
+	instruction_t* temporary_variable_assignment = emit_assignment_instruction(emit_temp_var(sparse_switch->input->type), sparse_switch->input, sparse_switch->line_number);
+	add_statement(jump_calculation_block, temporary_variable_assignment);
+
+	//Knock the input down by the same amount as the entries
+	three_addr_var_t* input = emit_binary_operation_with_constant(jump_calculation_block,
+																   temporary_variable_assignment->operands.oir.assignee,
+																   temporary_variable_assignment->operands.oir.assignee,
+																   MINUS,
+																   emit_direct_integer_or_char_constant((int32_t)low, i32),
+																   sparse_switch->line_number);
+
+	//And now we can jump through the table(.JTx + input * 8)
+	instruction_t* indirect_jump = emit_indirect_jump_statement(jump_calculation_block->jump_table, input, 8);
+	add_statement(jump_calculation_block, indirect_jump);
+}
+
+
+/**
+ * Emit a bit test for a cluster of a sparse switch. Every case in the cluster gets a bit in a mask that
+ * belongs to its target, where bit 0 is the lowest value in the cluster. We then just shift the mask of each
+ * target down by the input and check the low bit:
+ *
+ * 	t1 <- x - low
+ * 	t2 <- mask >> t1
+ * 	t3 <- t2 & 1
+ * 	t3 != 0 -> target
+ *
+ * So something like case 'a': case 'e': case 'i': case 'o': case 'u' costs one test instead of five
+ */
+static void emit_sparse_switch_bit_test(sparse_switch_t* sparse_switch, basic_block_t* block, switch_cluster_t* cluster, int64_t known_low, int64_t known_high){
+	int64_t low = sparse_switch->cases[cluster->first].value;
+	int64_t high = sparse_switch->cases[cluster->last].value;
+
+	//The shift amount has to be inside of the mask, so the range checks are not optional here
+	block = emit_sparse_switch_range_checks(sparse_switch, block, low, high, known_low, known_high);
+
+	//To avoid violating SSA rules, we'll emit a temporary assignment here
+	instruction_t* temporary_variable_assignment = emit_assignment_instruction(emit_temp_var(sparse_switch->input->type), sparse_switch->input, sparse_switch->line_number);
+	add_statement(block, temporary_variable_assignment);
+
+	//Knock the input down so that the lowest value is bit 0
+	three_addr_var_t* bit_index = emit_binary_operation_with_constant(block,
+																	   temporary_variable_assignment->operands.oir.assignee,
+																	   temporary_variable_assignment->operands.oir.assignee,
+																	   MINUS,
+																	   emit_direct_integer_or_char_constant((int32_t)low, i32),
+																	   sparse_switch->line_number);
+
+	//We'll need to know when we're on the last target so that it can fall through to the default
+	u_int32_t remaining_targets = count_switch_case_targets(sparse_switch, cluster->first, cluster->last);
+
+	for(u_int32_t i = cluster->first; i <= cluster->last; i++){
+		basic_block_t* target = sparse_switch->cases[i].target;
+
+		//The first case that goes to a given target is the one that builds its mask
+		u_int8_t target_already_tested = FALSE;
+		for(u_int32_t j = cluster->first; j < i; j++){
+			if(sparse_switch->cases[j].target == target){
+				target_already_tested = TRUE;
+				break;
+			}
+		}
+
+		if(target_already_tested == TRUE){
+			continue;
+		}
+
+		u_int32_t mask = 0;
+		for(u_int32_t j = i; j <= cluster->last; j++){
+			if(sparse_switch->cases[j].target == target){
+				mask |= 1U << (sparse_switch->cases[j].value - low);
+			}
+		}
+
+		remaining_targets--;
+
+		basic_block_t* else_block;
+		if(remaining_targets == 0){
+			else_block = sparse_switch->default_block;
+		} else {
+			else_block = basic_block_alloc_and_estimate();
+		}
+
+		//Load the mask in
+		three_addr_var_t* mask_variable = emit_temp_var(u32);
+		add_statement(block, emit_assignment_with_const_instruction(mask_variable, emit_direct_integer_or_char_constant(mask, u32), sparse_switch->line_number));
+
+		//Shift our bit down to the bottom
+		three_addr_var_t* shifted_mask = emit_temp_var(u32);
+		add_statement(block, emit_binary_operation_instruction(shifted_mask, mask_variable, R_SHIFT, bit_index, sparse_switch->line_number));
+
+		//And pull it out
+		three_addr_var_t* selected_bit = emit_binary_operation_with_constant(block, emit_temp_var(u32), shifted_mask, SINGLE_AND, emit_direct_integer_or_char_constant(1, u32), sparse_switch->line_number);
+
+		three_addr_var_t* bit_set_decider = emit_temp_var(u8);
+		emit_binary_operation_with_constant(block, bit_set_decider, selected_bit, NOT_EQUALS, emit_direct_integer_or_char_constant(0, u32), sparse_switch->line_number);
+
+		branch_type_t branch_not_equals = select_appropriate_branch_statement(NOT_EQUALS, BRANCH_CATEGORY_NORMAL, FALSE);
+		emit_branch_for_switch_statement(block, target, else_block, branch_not_equals, bit_set_decider, sparse_switch->line_number);
+
+		block = else_block;
+	}
+}
+
+
+/**
+ * Emit the decision tree for the clusters from first to last(inclusive). The known low and high
+ * values are what the comparisons above us have already established about the input. A handful
+ * of single cases is just checked one after another. Anything bigger is split in half on the lowest
+ * value of the middle cluster, so we only need a logarithmic number of comparisons to get to any
+ * given cluster
+ */
+static void emit_sparse_switch_decision_tree(sparse_switch_t* sparse_switch, basic_block_t* block, u_int32_t first_cluster, u_int32_t last_cluster, int64_t known_low, int64_t known_high){
+	u_int32_t cluster_count = last_cluster - first_cluster + 1;
+
+	//Leaf case - we only have one cluster to deal with
+	if(cluster_count == 1){
+		switch_cluster_t* cluster = &(sparse_switch->clusters[first_cluster]);
+
+		switch(cluster->type){
+			case SWITCH_CLUSTER_SINGLE_CASE:
+				emit_sparse_switch_equality_chain(sparse_switch, block, first_cluster, last_cluster);
+				break;
+
+			case SWITCH_CLUSTER_JUMP_TABLE:
+				emit_sparse_switch_jump_table(sparse_switch, block, cluster, known_low, known_high);
+				break;
+
+			case SWITCH_CLUSTER_BIT_TEST:
+				emit_sparse_switch_bit_test(sparse_switch, block, cluster, known_low, known_high);
+				break;
+		}
+
+		return;
+	}
+
+	/**
+	 * If we're down to just a few single cases, a chain of comparisons is at least as cheap
+	 * as continuing to split
+	 */
+	if(cluster_count < SWITCH_DECISION_TREE_MIN_CASES){
+		u_int8_t all_single_cases = TRUE;
+
+		for(u_int32_t i = first_cluster; i <= last_cluster; i++){
+			if(sparse_switch->clusters[i].type != SWITCH_CLUSTER_SINGLE_CASE){
+				all_single_cases = FALSE;
+				break;
+			}
+		}
+
+		if(all_single_cases == TRUE){
+			emit_sparse_switch_equality_chain(sparse_switch, block, first_cluster, last_cluster);
+			return;
+		}
+	}
+
+	//Split on the lowest value of the middle cluster
+	u_int32_t middle_cluster = first_cluster + cluster_count / 2;
+	int64_t pivot = sparse_switch->cases[sparse_switch->clusters[middle_cluster].first].value;
+
+	basic_block_t* lower_half_block = basic_block_alloc_and_estimate();
+	basic_block_t* upper_half_block = basic_block_alloc_and_estimate();
+
+	//if x < pivot we go to the lower half, otherwise we go to the upper half
+	three_addr_var_t* lower_than_decider = emit_temp_var(sparse_switch->input->type);
+	emit_binary_operation_with_constant(block, lower_than_decider, sparse_switch->input, L_THAN, emit_direct_integer_or_char_constant((int32_t)pivot, i32), sparse_switch->line_number);
+
+	branch_type_t branch_lower_than = select_appropriate_branch_statement(L_THAN, BRANCH_CATEGORY_NORMAL, sparse_switch->is_signed);
+	emit_branch_for_switch_statement(block, lower_half_block, upper_half_block, branch_lower_than, lower_than_decider, sparse_switch->line_number);
+
+	//Each half now knows a bit more about the input than we did
+	emit_sparse_switch_decision_tree(sparse_switch, lower_half_block, first_cluster, middle_cluster - 1, known_low, pivot - 1);
+	emit_sparse_switch_decision_tree(sparse_switch, upper_half_block, middle_cluster, last_cluster, pivot, known_high);
+}
+
+
+/**
+ * Lower a switch that the parser has found to be too sparse for a single jump table. We sort the cases,
+ * group them into clusters and then emit a balanced decision tree over those clusters, starting in the
+ * given block. Dense clusters get their own jump tables and small clusters with few targets get bit tests.
+ * The case array is owned by us from here on out
+ */
+static void emit_sparse_switch(sparse_switch_t* sparse_switch, basic_block_t* block){
+	qsort(sparse_switch->cases, sparse_switch->case_count, sizeof(switch_case_t), compare_switch_cases);
+
+	//We can never have more clusters than we do cases
+	sparse_switch->clusters = calloc(sparse_switch->case_count, sizeof(switch_cluster_t));
+	build_sparse_switch_clusters(sparse_switch);
+
+	//Nothing is known about the input at the root, other than that unsigned values can't go below 0
+	int64_t known_low = sparse_switch->is_signed == TRUE ? INT64_MIN : 0;
+
+	emit_sparse_switch_decision_tree(sparse_switch, block, 0, sparse_switch->cluster_count - 1, known_low, INT64_MAX);
+
+	free(sparse_switch->clusters);
+	free(sparse_switch->cases);
+}
+
+
 /**
  * Take a c-style switch statement that has been determined to be non-switch eligible and convert it into
  * an if-else statement. This is more complex than the ollie switch example because we have concepts like 
@@ -9593,6 +10267,21 @@ static cfg_result_package_t convert_c_style_switch_to_if_statement(generic_ast_n
 	//The current block where our conditional will sit is the entry block
 	basic_block_t* current_conditional_block = entry_block;
 
+	/**
+	 * If we have enough cases, we'll collect them all up and lower them as a decision
+	 * tree once we're done instead of comparing against each one in a chain
+	 */
+	sparse_switch_t sparse_switch = {NULL, NULL, input_variable, NULL, 0, 0, root_node->line_number, is_type_signed(input_variable->type)};
+	u_int8_t use_decision_tree = initialize_sparse_switch(&sparse_switch, case_default_cursor, AST_NODE_TYPE_C_STYLE_CASE_STMT);
+
+	/**
+	 * Empty cases just fall into whatever comes next, so we'll point them straight at the first case
+	 * after them that actually does something. This is what lets stacked cases share a bit test
+	 */
+	u_int32_t first_unresolved_case = 0;
+	u_int8_t default_is_unresolved = FALSE;
+	basic_block_t* default_target = NULL;
+
 	/**
 	 * Crawl the subtree and emit everything in order. We will need special logic for
 	 * the default block when we get to it due to no conditional existing for it
@@ -9616,6 +10305,27 @@ static cfg_result_package_t convert_c_style_switch_to_if_statement(generic_ast_n
 				//Extract this value for our conditional
 				int32_t case_value = case_default_results.starting_block->case_stmt_val;
 
+				//The decision tree is emitted all at once at the very end
+				if(use_decision_tree == TRUE){
+					add_sparse_switch_case(&sparse_switch, case_value, case_default_results.starting_block);
+
+					//If this one does something, everything waiting on it now knows where it's going
+					if(is_switch_case_empty(&case_default_results) == FALSE){
+						for(u_int32_t i = first_unresolved_case; i < sparse_switch.case_count; i++){
+							sparse_switch.cases[i].target = case_default_results.starting_block;
+						}
+
+						if(default_is_unresolved == TRUE){
+							default_target = case_default_results.starting_block;
+							default_is_unresolved = FALSE;
+						}
+
+						first_unresolved_case = sparse_switch.case_count;
+					}
+
+					break;
+				}
+
 				//Create a new conditional block for us to jump to
 				basic_block_t* new_conditional_block = basic_block_alloc_and_estimate();
 
@@ -9651,6 +10361,7 @@ static cfg_result_package_t convert_c_style_switch_to_if_statement(generic_ast_n
 
 				//Save the default block for later processing
 				default_block = case_default_results.starting_block;
+				default_target = default_block;
 
 				/**
 				 * If the previous end block does not end in a terminal statement, we will need to simulate
@@ -9660,6 +10371,17 @@ static cfg_result_package_t convert_c_style_switch_to_if_statement(generic_ast_n
 					emit_jump(previous_end_block, default_block);
 				}
 
+				//Just like with the cases, an empty default goes wherever the next real statement is
+				if(is_switch_case_empty(&case_default_results) == FALSE){
+					for(u_int32_t i = first_unresolved_case; i < sparse_switch.case_count; i++){
+						sparse_switch.cases[i].target = default_block;
+					}
+
+					first_unresolved_case = sparse_switch.case_count;
+				} else {
+					default_is_unresolved = TRUE;
+				}
+
 				//Now update what the previous end block is
 				previous_end_block = case_default_results.final_block;
 
@@ -9683,15 +10405,35 @@ static cfg_result_package_t convert_c_style_switch_to_if_statement(generic_ast_n
 	}
 
 	/**
-	 * We now need to handle the default block case. If we have a default block,
-	 * then we'll just need to emit a jump from the current conditional block over
-	 * to the default block. If we don't, then we'll jump from the current conditional
-	 * block right to the exit
+	 * For a decision tree, anything still waiting on a real statement just falls out of
+	 * the bottom of the switch. Then we can emit the whole tree off of the entry block
 	 */
-	if(default_block != NULL){
-		emit_jump(current_conditional_block, default_block);
+	if(use_decision_tree == TRUE){
+		for(u_int32_t i = first_unresolved_case; i < sparse_switch.case_count; i++){
+			sparse_switch.cases[i].target = exit_block;
+		}
+
+		if(default_is_unresolved == TRUE){
+			default_target = exit_block;
+		}
+
+		//No default at all means that we go right to the exit
+		sparse_switch.default_block = default_target != NULL ? default_target : exit_block;
+
+		emit_sparse_switch(&sparse_switch, entry_block);
+
 	} else {
-		emit_jump(current_conditional_block, exit_block);
+		/**
+		 * We now need to handle the default block case. If we have a default block,
+		 * then we'll just need to emit a jump from the current conditional block over
+		 * to the default block. If we don't, then we'll jump from the current conditional
+		 * block right to the exit
+		 */
+		if(default_block != NULL){
+			emit_jump(current_conditional_block, default_block);
+		} else {
+			emit_jump(current_conditional_block, exit_block);
+		}
 	}
 
 	//Now that we're done this should not be on the break stack
@@ -9801,6 +10543,13 @@ static cfg_result_package_t convert_ollie_switch_to_if_statement(generic_ast_nod
 	//Seed the current conditional block as the if entry initially
 	basic_block_t* current_conditional_block = if_entry_block;
 
+	/**
+	 * If we have enough cases, we'll collect them all up and lower them as a decision
+	 * tree once we're done instead of comparing against each one in a chain
+	 */
+	sparse_switch_t sparse_switch = {NULL, NULL, switching_on_variable, NULL, 0, 0, root_node->line_number, is_type_signed(switching_on_variable->type)};
+	u_int8_t use_decision_tree = initialize_sparse_switch(&sparse_switch, switch_statement_expression->next_sibling, AST_NODE_TYPE_CASE_STMT);
+
 	/**
 	 * Run through every single case/one default statement and process
 	 * them accordingly. There is no need to worry about fall through/
@@ -9831,6 +10580,12 @@ static cfg_result_package_t convert_ollie_switch_to_if_statement(generic_ast_nod
 				//Extract the constant value from the head block
 				int32_t case_statement_constant = case_default_results.starting_block->case_stmt_val;
 
+				//The decision tree is emitted all at once at the very end
+				if(use_decision_tree == TRUE){
+					add_sparse_switch_case(&sparse_switch, case_statement_constant, case_default_results.starting_block);
+					break;
+				}
+
 				//Emit the comparison instruction - this is always an equals
 				instruction_t* comparsion_expression = emit_binary_operation_with_const_instruction(emit_temp_var(u8),
 																									switching_on_variable,
@@ -9904,8 +10659,13 @@ static cfg_result_package_t convert_ollie_switch_to_if_statement(generic_ast_nod
 	 *
 	 * If there is no default, then we'll just need to emit a jump from the
 	 * current conditional straight to the exit
+	 *
+	 * For a decision tree, the default is just wherever the tree goes when nothing matches
 	 */
-	if(default_block != NULL){
+	if(use_decision_tree == TRUE){
+		sparse_switch.default_block = default_block != NULL ? default_block : if_exit_block;
+		emit_sparse_switch(&sparse_switch, if_entry_block);
+	} else if(default_block != NULL){
 		emit_jump(current_conditional_block, default_block);
 	} else {
 		emit_jump(current_conditional_block, if_exit_block);
@@ -11546,6 +12306,9 @@ static inline void setup_function_parameters(symtab_function_record_t* function_
 			//Add this variable onto the stack now, since we know it is not already on it
 			parameter->stack_region = create_stack_region_for_type(&(current_function->local_stack), parameter->type_defined_as);
 
+			//Remember who owns this region
+			parameter->stack_region->variable_referenced = parameter;
+
 			//Copy the type over here
 			three_addr_var_t* parameter_var = emit_memory_address_var(parameter);
 
@@ -12196,6 +12959,9 @@ static void visit_declaration_statement(basic_block_t* current_block, generic_as
 		//Create a stack region for this variable
 		node->variable->stack_region = create_stack_region_for_type(&(current_function->local_stack), node->inferred_type);
 
+		//Remember who owns this region
+		node->variable->stack_region->variable_referenced = node->variable;
+
 		//Emit and add the synthetic initialization here
 		instruction_t* synthetic_initialization = emit_synthetic_memory_initialization(emit_var(node->variable), node->line_number);
 		add_statement(current_block, synthetic_initialization);
@@ -12701,6 +13467,9 @@ static cfg_result_package_t visit_let_statement(basic_block_t* starting_block, g
 			//Create a stack region for this variable and store it in the associated region
 			variable->stack_region = create_stack_region_for_type(&(current_function->local_stack), node->inferred_type);
 
+			//Remember who owns this region
+			variable->stack_region->variable_referenced = variable;
+
 			/**
 			 * Let's now emit the synthetic initialization for assignment
 			 * analysis purposes
@@ -12737,6 +13506,9 @@ static cfg_result_package_t visit_let_statement(basic_block_t* starting_block, g
 				//Create a stack region for this variable and store it in the associated region
 				variable->stack_region = create_stack_region_for_type(&(current_function->local_stack), node->inferred_type);
 
+				//Remember who owns this region
+				variable->stack_region->variable_referenced = variable;
+
 				//Now emit the synthetic initialization
 				instruction_t* synethtic_initialization = emit_synthetic_memory_initialization(emit_var(variable), node->line_number);
 				add_statement(current_block, synethtic_initialization);
@@ -12854,18 +13626,25 @@ void print_all_cfg_blocks(cfg_t* cfg){
  * Reset the visited status of the CFG
  */
 void reset_visited_status(cfg_t* cfg, u_int8_t reset_direct_successor){
+	//Every function gets a new visit epoch. This unvisits all of their blocks at once
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		basic_block_t* function_entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+
+		reset_block_visits_for_function(function_entry_block->function_defined_in);
+	}
+
+	//If we don't need to touch the direct successors, then we're done
+	if(reset_direct_successor == FALSE){
+		return;
+	}
+
 	//For each block in the CFG
 	for(int32_t _ = 0; _ < cfg->created_blocks.current_index; _++){
 		//Grab the block out
 		basic_block_t* block = dynamic_array_get_at(&(cfg->created_blocks), _);
 
-		//Set it's visited status to 0
-		block->visited = FALSE;
-
-		//If we want to reset this, we'll null it out
-		if(reset_direct_successor == TRUE){
-			block->direct_successor = NULL;
-		}
+		//Null out the direct successor
+		block->direct_successor = NULL;
 	}
 }
 
@@ -12874,33 +13653,88 @@ void reset_visited_status(cfg_t* cfg, u_int8_t reset_direct_successor){
  * Reset the visited status inside a particular function in the CFG
  */
 void reset_function_visited_status(basic_block_t* function_entry_block, u_int8_t reset_direct_successor){
+	//This happens regardless, and it's O(1)
+	reset_block_visits_for_function(function_entry_block->function_defined_in);
+
+	//If we don't need to touch the direct successors, then we're done
+	if(reset_direct_successor == FALSE){
+		return;
+	}
+
 	//Starts with our function entry
 	basic_block_t* current = function_entry_block;
 
 	//Run through every single block
 	while(current != NULL){
-		//This happens regardless
-		current->visited = FALSE;
-
-		//If this is the case then just push it up
-		if(reset_direct_successor == FALSE){
-			//Push it up
-			current = current->direct_successor;
-		
-		//Otherwise it's slighly more complex
-		} else {
-			//Hold onto it
-			basic_block_t* temp = current->direct_successor;
+		//Hold onto it
+		basic_block_t* temp = current->direct_successor;
 
-			//Null it out
-			current->direct_successor = NULL;
+		//Null it out
+		current->direct_successor = NULL;
 
-			//Push on
-			current = temp;
-		}
+		//Push on
+		current = temp;
 	}
 }
 
+
+/**
+ * Unvisit every block in the given function. This is O(1), no
+ * block is actually touched
+ */
+void reset_block_visits_for_function(symtab_function_record_t* function){
+	epoch_table_begin_new_epoch(&(function->visited_blocks), function->number_of_block_indices);
+}
+
+
+/**
+ * Flag a block as visited
+ */
+void mark_block_visited(basic_block_t* block){
+	epoch_table_mark(&(block->function_defined_in->visited_blocks), block->function_block_index);
+}
+
+
+/**
+ * Has this block been visited since the last reset?
+ */
+u_int8_t is_block_visited(basic_block_t* block){
+	return epoch_table_is_marked(&(block->function_defined_in->visited_blocks), block->function_block_index);
+}
+
+
+/**
+ * Unmark every block in the given function. This is O(1), no
+ * block is actually touched
+ */
+void reset_block_marks_for_function(symtab_function_record_t* function){
+	epoch_table_begin_new_epoch(&(function->marked_blocks), function->number_of_block_indices);
+}
+
+
+/**
+ * Flag that a block contains a mark
+ */
+void mark_block(basic_block_t* block){
+	epoch_table_mark(&(block->function_defined_in->marked_blocks), block->function_block_index);
+}
+
+
+/**
+ * Remove the mark from a block
+ */
+void unmark_block(basic_block_t* block){
+	epoch_table_unmark(&(block->function_defined_in->marked_blocks), block->function_block_index);
+}
+
+
+/**
+ * Does this block contain a mark since the last reset?
+ */
+u_int8_t does_block_contain_mark(basic_block_t* block){
+	return epoch_table_is_marked(&(block->function_defined_in->marked_blocks), block->function_block_index);
+}
+
 /**
  * Build a cfg from the ground up
 */
@@ -12941,6 +13775,7 @@ cfg_t* build_cfg(front_end_results_package_t* results, u_int32_t* num_errors, u_
 
 	//Store this along with it
 	cfg->type_symtab = type_symtab;
+	cfg->variable_symtab = variable_symtab;
 
 	//Create the dynamic arrays that we need
 	cfg->created_blocks = dynamic_array_alloc();
@@ -18,6 +18,8 @@
 typedef struct cfg_t cfg_t;
 //Basic blocks in our CFG
 typedef struct basic_block_t basic_block_t;
+//The analysis data(liveness, dominance) for a basic block
+typedef struct basic_block_analysis_t basic_block_analysis_t;
 //A memory tracking structure for freeing
 typedef struct cfg_node_holder_t cfg_node_holder_t;
 //A memory tracking structure for freeing
@@ -86,8 +88,14 @@ struct cfg_t{
 	//=====================================
 	//We'll want the type symtab too
 	type_symtab_t* type_symtab;
+	//Passes that need brand new variables(the inliner) add them in here
+	variable_symtab_t* variable_symtab;
 	//All global variables
 	dynamic_array_t global_variables;
+	//Every function that was given profile counters(--profile-generate)
+	dynamic_array_t profiled_functions;
+	//Where the instrumented program writes its counts out to
+	char* profile_file_name;
 	//Hang onto the block id
 	u_int32_t block_id;
 	//Result of the construction
@@ -96,23 +104,12 @@ struct cfg_t{
 
 
 /**
- * Define: a basic block is a sequence of consecutive 
- * intermediate language statements in which flow of 
- * control can only enter at the beginning and leave at the end 
- *
- * A basic block has ONE entrance and ONE exit. These points are referenced 
- * by the "leader" and "exit" references for quick access
-*/
-struct basic_block_t{
-	//There are consecutive statements(declare, define, let, assign, alias)
-	//in a node. These statements are a linked list
-	//Keep a reference to the "leader"(head) and "exit"(tail) statements
-	instruction_t* leader_statement;
-	instruction_t* exit_statement;
-	//Predecessor nodes
-	dynamic_array_t predecessors;
-	//Successor nodes
-	dynamic_array_t successors;
+ * Everything that a block owns purely for the sake of analysis(liveness, dominance, etc.)
+ * Traversals like block ordering and branch reduction only ever need the successors,
+ * predecessors and instructions. Keeping all of this out of line means that the block
+ * itself spans far fewer cache lines when we are just walking the CFG
+ */
+struct basic_block_analysis_t{
 	//The "LIVE_IN" variables for this node
 	dynamic_array_t live_in;
 	//The "LIVE_OUT" variables for this node
@@ -122,9 +119,6 @@ struct basic_block_t{
 	dynamic_array_t used_before_definition;
 	//The array of all assigned variables
 	dynamic_array_t assigned_variables;
-	//For convenience here. This is the successor that we use to
-	//"drill" to the bottom
-	basic_block_t* direct_successor;
 	//The blocks dominance frontier
 	dynamic_array_t dominance_frontier;
 	//The reverse dominance frontier(for analysis)
@@ -166,33 +160,65 @@ struct basic_block_t{
 		 */
 		basic_block_t* optimal_candidate;
 		/**
-		 * The worklist is a deferred work queue that we use. It will
-		 * store the list of all nodes that are semidominated by this
-		 * given node
+		 * How deep this block sits in the dominator tree. The function
+		 * entry is at depth 0. We keep these around so that the common
+		 * dominator of two blocks can be found after the CFG is edited
 		 */
-		dynamic_array_t worklist;
+		int32_t dominator_depth;
+		/**
+		 * How deep this block sits in the postdominator tree. The function
+		 * exit is at depth 0
+		 */
+		int32_t postdominator_depth;
 	} dominator_info;
+};
 
+
+/**
+ * Define: a basic block is a sequence of consecutive 
+ * intermediate language statements in which flow of 
+ * control can only enter at the beginning and leave at the end 
+ *
+ * A basic block has ONE entrance and ONE exit. These points are referenced 
+ * by the "leader" and "exit" references for quick access
+ *
+ * The fields that traversals touch the most come first so that they all
+ * share the block's first cache line. Everything that is only needed for
+ * analysis lives in the separately allocated analysis record
+*/
+struct basic_block_t{
+	//There are consecutive statements(declare, define, let, assign, alias)
+	//in a node. These statements are a linked list
+	//Keep a reference to the "leader"(head) and "exit"(tail) statements
+	instruction_t* leader_statement;
+	instruction_t* exit_statement;
+	//Predecessor nodes
+	dynamic_array_t predecessors;
+	//Successor nodes
+	dynamic_array_t successors;
+	//For convenience here. This is the successor that we use to
+	//"drill" to the bottom
+	basic_block_t* direct_successor;
+	//The function that we're defined in
+	symtab_function_record_t* function_defined_in;
+	//All of the liveness and dominance information for this block
+	basic_block_analysis_t* analysis;
 	//The reference to a jump table. This is often not used at all
 	jump_table_t* jump_table;
 	//The case statement value -- usually blank
 	int64_t case_stmt_val;
-	//The function that we're defined in
-	symtab_function_record_t* function_defined_in;
 	//An integer ID
 	int32_t block_id;
 	//The number of instructions that the given block has
 	u_int32_t number_of_instructions;
 	//The estimated execution frequency. This will change if a block is in a loop, etc.
 	u_int32_t estimated_execution_frequency;
+	//The dense index of this block within its function. Analyses use this to index into side tables
+	u_int32_t function_block_index;
+	//Where this block sits in the CFG's created blocks array, or -1 once it's been taken out
+	int32_t created_blocks_index;
 	//What is the general classification of this block
 	block_type_t block_type;
-	//Does this block contain a marked record?
-	u_int8_t contains_mark;
-	//Was this block visited by traverser?
-	u_int8_t visited;
-	//Does this block already have a phi function for the given variable?
-	u_int8_t already_has_phi_func;
 };
 
 
@@ -202,6 +228,13 @@ struct basic_block_t{
  */
 cfg_t* build_cfg(front_end_results_package_t* results, u_int32_t* num_errors, u_int32_t* num_warnings);
 
+/**
+ * Allocate a brand new block inside of an already constructed function. This
+ * is for passes that run after the CFG is built(the inliner) and need to
+ * make their own blocks
+ */
+basic_block_t* basic_block_alloc_in_function(cfg_t* cfg, symtab_function_record_t* function, u_int32_t estimated_execution_frequency);
+
 /**
  * Add a statement to the basic block
  */
@@ -255,6 +288,17 @@ void add_predecessor_only(basic_block_t* target, basic_block_t* predecessor);
  */
 void dealloc_cfg(cfg_t* cfg);
 
+/**
+ * Deallocate all of the blocks and instructions in the function at the given index
+ */
+void dealloc_function(cfg_t* cfg, u_int32_t function_index);
+
+/**
+ * Take a block out of the CFG's created blocks array in constant time. Once this
+ * is done, the CFG no longer owns the block
+ */
+void remove_from_created_blocks(cfg_t* cfg, basic_block_t* block);
+
 /**
  * Emit a jump statement directly into a block
  */
@@ -282,6 +326,43 @@ void reset_visited_status(cfg_t* cfg, u_int8_t reset_direct_successor);
  */
 void reset_function_visited_status(basic_block_t* function_entry_block, u_int8_t reset_direct_successor);
 
+/**
+ * Unvisit every block in the given function. This is O(1), no
+ * block is actually touched
+ */
+void reset_block_visits_for_function(symtab_function_record_t* function);
+
+/**
+ * Flag a block as visited
+ */
+void mark_block_visited(basic_block_t* block);
+
+/**
+ * Has this block been visited since the last reset?
+ */
+u_int8_t is_block_visited(basic_block_t* block);
+
+/**
+ * Unmark every block in the given function. This is O(1), no
+ * block is actually touched
+ */
+void reset_block_marks_for_function(symtab_function_record_t* function);
+
+/**
+ * Flag that a block contains a mark
+ */
+void mark_block(basic_block_t* block);
+
+/**
+ * Remove the mark from a block
+ */
+void unmark_block(basic_block_t* block);
+
+/**
+ * Does this block contain a mark since the last reset?
+ */
+u_int8_t does_block_contain_mark(basic_block_t* block);
+
 /**
  * Deallocate a block
  */
@@ -8,6 +8,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include "ast/ast.h"
 #include "build_system/build_system.h"
@@ -20,6 +21,7 @@
 #include "instruction_scheduler/instruction_scheduler.h"
 #include "assembler/assembler.h"
 #include "optimizer/optimizer.h"
+#include "profiler/profiler.h"
 #include "utils/compiler_output_type.h"
 #include "utils/constants.h"
 #include "utils/error_management.h"
@@ -30,6 +32,14 @@ u_int32_t num_warnings = 0;
 
 //Objectfile opt for getopt_long
 #define objectfile_opt 5
+//Streaming opt for getopt_long
+#define stream_opt 6
+//Loop unrolling factor opt for getopt_long
+#define unroll_opt 7
+//Profile generation opt for getopt_long
+#define profile_generate_opt 8
+//Profile use opt for getopt_long
+#define profile_use_opt 9
 
 
 /**
@@ -48,6 +58,11 @@ static void print_help(){
 	printf("-r: Print the result of the register allocation. This is done by default in -i\n");
 	printf("-t: Time execution of compiler. Can be used for performance testing\n");
 	printf("-m: Time each module of the compiler. This is used for even more granular performance testing\n");
+	printf("-j <count>: Use up to <count> threads for the optimizer, instruction selector, instruction scheduler and register allocator. Defaults to 1\n");
+	printf("--unroll-factor <n>: Unroll counted loops by up to <n> copies of the body. Defaults to %d, and 1 turns loop unrolling off\n", DEFAULT_LOOP_UNROLL_FACTOR);
+	printf("--profile-generate[=<filename>]: Build an instrumented program that counts how often each block runs. The counts are written to <filename>, or to <output file>.profile if none is given, when main returns. A program that exits any other way(such as an exit syscall in inline assembly) writes no profile\n");
+	printf("--profile-use=<filename>: Use the block counts in <filename>, written by a --profile-generate build of the same source, in place of estimated block frequencies\n");
+	printf("--stream: Optimize the whole program, then send each function through the back end on its own, freeing its blocks, instructions and live ranges once it's written out. The whole program is still parsed, turned into a CFG and optimized first, so this only keeps the back end from holding every function at once. -j is ignored when streaming\n");
 	printf("-@: Should only be used for CI runs. Avoids generating any assembly/object files\n");
 	printf("-i: Print intermediate representations. This will generate *a lot* of text, so be careful\n");
 	printf("-h: Show help\n");
@@ -77,12 +92,22 @@ static compiler_options_t* parse_and_store_options(int argc, char** argv){
 	//By default, assume we are requesting a full compilation
 	options->output_type = OUTPUT_TYPE_FULL_COMPILATION;
 
+	//By default everything is done on one thread
+	options->thread_count = 1;
+
+	//And loops get the default unrolling
+	options->loop_unroll_factor = DEFAULT_LOOP_UNROLL_FACTOR;
+
 	/**
-	 * Longopts for us to use. Currently we only have the objectfile
-	 * longopt here
+	 * Longopts for us to use. Currently we only have the objectfile,
+	 * streaming, loop unrolling and profiling longopts here
 	 */
 	const struct option long_opts[] = {
 		{"to-object-file", no_argument, NULL, objectfile_opt},
+		{"stream", no_argument, NULL, stream_opt},
+		{"unroll-factor", required_argument, NULL, unroll_opt},
+		{"profile-generate", optional_argument, NULL, profile_generate_opt},
+		{"profile-use", required_argument, NULL, profile_use_opt},
 		//Null terminator
 		{0,0,0,0}
 	};
@@ -91,7 +116,7 @@ static compiler_options_t* parse_and_store_options(int argc, char** argv){
 	int opt;
 
 	//Run through all of our options
-	while((opt = getopt_long(argc, argv, "rima@tdhsf:o:?", long_opts, NULL)) != -1){
+	while((opt = getopt_long(argc, argv, "rima@tdhsf:o:j:?", long_opts, NULL)) != -1){
 		//Switch based on opt
 		switch(opt){
 			//Invalid option
@@ -166,14 +191,65 @@ static compiler_options_t* parse_and_store_options(int argc, char** argv){
 						break;
 				}
 
+				break;
+			//Send functions through the back end one at a time
+			case stream_opt:
+				options->stream_functions = TRUE;
+				break;
+			//How far can loops be unrolled
+			case unroll_opt:
+				//A factor of 1 is no unrolling at all, anything less makes no sense
+				if(atoi(optarg) < 1){
+					printf("[COMPILER ERROR]: Invalid unroll factor \"%s\". The unroll factor must be at least 1\n", optarg);
+					exit(1);
+				}
+
+				options->loop_unroll_factor = atoi(optarg);
+				break;
+			//Build an instrumented program. The file name is optional
+			case profile_generate_opt:
+				options->profile_generate = TRUE;
+				options->profile_generate_file = optarg;
+				break;
+			//Read block counts in from a profile
+			case profile_use_opt:
+				options->profile_use_file = optarg;
 				break;
 			//Specific output file
 			case 'o':
 				options->output_file = optarg;
 				break;
+			//How many threads can we use
+			case 'j':
+				//We need at least one thread to do anything
+				if(atoi(optarg) < 1){
+					printf("[COMPILER ERROR]: Invalid thread count \"%s\". The thread count must be at least 1\n", optarg);
+					exit(1);
+				}
+
+				options->thread_count = atoi(optarg);
+				break;
 		}
 	}
 
+	/**
+	 * The intermediate representation and debug printers run function by function, so if
+	 * we had multiple threads going their output would be interleaved. If either
+	 * of these are on, we'll stick to just one thread
+	 */
+	if(options->print_irs == TRUE || options->enable_debug_printing == TRUE){
+		options->thread_count = 1;
+	}
+
+	/**
+	 * The intermediate representation and allocation printers show the whole program
+	 * between phases. That can't happen if functions are being freed as they go, so
+	 * streaming is turned off if either is requested
+	 */
+	if(options->print_irs == TRUE || options->print_post_allocation == TRUE){
+		options->stream_functions = FALSE;
+	}
+
 	//This is an error, so we'll fail out here
 	if(options->file_name == NULL){
 		printf("[COMPILER ERROR]: No input file name provided. Use -f <filename> to specify a .ol source file\n");
@@ -217,6 +293,17 @@ static compiler_options_t* parse_and_store_options(int argc, char** argv){
 		}
 	}
 
+	/**
+	 * If an instrumented build wasn't told where to put its profile, it goes right
+	 * next to the output file. Test runs have no output file at all
+	 */
+	if(options->profile_generate == TRUE && options->profile_generate_file == NULL){
+		char* output_file = options->output_file != NULL ? options->output_file : "a.out";
+
+		options->profile_generate_file = calloc(strlen(output_file) + sizeof(".profile"), sizeof(char));
+		sprintf(options->profile_generate_file, "%s.profile", output_file);
+	}
+
 	//Give back the options we got in the structure
 	return options;
 }
@@ -262,6 +349,91 @@ static void print_summary(compiler_options_t* options, module_times_t* times, u_
 }
 
 
+/**
+ * How many seconds have gone by since start? Start is then moved
+ * up to now, so that the next phase can be timed
+ */
+static inline double lap_time(clock_t* start){
+	clock_t now = clock();
+	double elapsed = (double)(now - *start) / CLOCKS_PER_SEC;
+	*start = now;
+	return elapsed;
+}
+
+
+/**
+ * Optimize every function, and then stream each one through the entire back end on its own. As
+ * soon as a function has been written out, all of its blocks, instructions and live ranges are
+ * freed. This means that we only ever have one function's worth of selected, scheduled and allocated
+ * instructions alive at once
+ *
+ * NOTE: This is not streaming from end to end. The parser, CFG construction and static analysis
+ * still run over the whole program beforehand, and every function's CFG is alive when we start.
+ * Unused function detection and the interprocedural passes need to see every function, so this is
+ * the earliest point where functions can be split apart. What we save is the memory that the
+ * back end would otherwise add on top of the whole program's optimized CFG
+ */
+static void compile_functions_streamed(compiler_options_t* options, cfg_t* cfg, module_times_t* times){
+	//Open up wherever the assembly is going
+	if(begin_streamed_assembly(options, &num_errors, &num_warnings) == FAILURE){
+		fprintf(stderr, "Program Compilation Failed\n");
+		exit(1);
+	}
+
+	//Every phase is timed for every function and added up
+	clock_t phase_start = clock();
+
+	//The interprocedural passes need every function's body, so they're done before anything is freed
+	run_interprocedural_passes(cfg);
+	times->optimizer_time += lap_time(&phase_start);
+
+	/**
+	 * Callees go through before their callers wherever possible. That way, the register allocator
+	 * already knows exactly what a call clobbers when it gets to the caller
+	 */
+	dynamic_integer_array_t function_order = get_bottom_up_function_order(cfg);
+
+	//Run every optimization pass on every function
+	for(int32_t order_index = 0; order_index < function_order.current_index; order_index++){
+		optimize_single_function(cfg, dynamic_integer_array_get_at(&function_order, order_index), options->loop_unroll_factor);
+	}
+
+	/**
+	 * Now that the optimizer is done, we can sweep up any unused local constants. This has to happen
+	 * before anything goes through the back end. Instruction selection folds constants into memory
+	 * operands and drops the loads that used them, so a constant can look unused when an emitted
+	 * function still refers to it
+	 */
+	sweep_local_constants(cfg);
+	times->optimizer_time += lap_time(&phase_start);
+
+	for(int32_t order_index = 0; order_index < function_order.current_index; order_index++){
+		int32_t i = dynamic_integer_array_get_at(&function_order, order_index);
+
+		//Simplify and select the instructions
+		select_instructions_in_function(cfg, i);
+		times->selector_time += lap_time(&phase_start);
+
+		//Schedule the instructions
+		schedule_instructions_in_single_function(cfg, options, i);
+		times->scheduler_time += lap_time(&phase_start);
+
+		//Allocate all registers and postprocess
+		allocate_registers_in_function(options, cfg, i);
+		times->allocator_time += lap_time(&phase_start);
+
+		//Now write it out and get rid of it
+		emit_streamed_function(dynamic_array_get_at(&(cfg->function_entry_blocks), i));
+		dealloc_function(cfg, i);
+	}
+
+	dynamic_integer_array_dealloc(&function_order);
+
+	//Write out the data and run the assembler/linker
+	finish_streamed_assembly(options, cfg);
+}
+
+
 /**
  * The compile function handles all of the compilation logic for us. Compilation
  * in oc requires the passing of data between one module and another. This function
@@ -452,6 +624,19 @@ static u_int8_t compile(compiler_options_t* options){
 		}
 	}
 
+	/**
+	 * Profile guided optimization happens right on the freshly built CFG. This is the only point
+	 * where an instrumented compile and a profile consuming compile are guaranteed to see the
+	 * exact same blocks, so it's the only point where the counts can be matched back up
+	 */
+	if(options->profile_use_file != NULL){
+		apply_profile_to_cfg(cfg, options->profile_use_file, &num_warnings);
+	}
+
+	if(options->profile_generate_file != NULL){
+		instrument_cfg_for_profiling(cfg, options->profile_generate_file, &num_warnings);
+	}
+
 	//If we're doing debug printing, then we'll print this
 	if(options->print_irs == TRUE){
 		printf("============================================= BEFORE OPTIMIZATION =======================================\n");
@@ -470,87 +655,95 @@ static u_int8_t compile(compiler_options_t* options){
 		times.cfg_time = (double)(cfg_end - parser_end) / CLOCKS_PER_SEC;
 	}
 
-	//Now we will run the optimizer
-	cfg = optimize(cfg);
-
-	//Again if we're doing debug printing, this is coming out
-	if(options->print_irs == TRUE){
-		printf("============================================= AFTER OPTIMIZATION =======================================\n");
-		print_all_cfg_blocks(cfg);
-		printf("============================================= AFTER OPTIMIZATION =======================================\n");
-	}
+	/**
+	 * In streaming mode, every function goes through the rest of the compiler on its own. Otherwise,
+	 * each phase runs over the entire program before the next one starts
+	 */
+	if(options->stream_functions == TRUE){
+		compile_functions_streamed(options, cfg, &times);
+	} else {
+		//Now we will run the optimizer
+		cfg = optimize(cfg, options->thread_count, options->loop_unroll_factor);
+
+		//Again if we're doing debug printing, this is coming out
+		if(options->print_irs == TRUE){
+			printf("============================================= AFTER OPTIMIZATION =======================================\n");
+			print_all_cfg_blocks(cfg);
+			printf("============================================= AFTER OPTIMIZATION =======================================\n");
+		}
 
-	//If we are doing module specific timing, store the optimizer time
-	if(options->module_specific_timing == TRUE){
-		//End the optimizer timer
-		optimizer_end = clock();
+		//If we are doing module specific timing, store the optimizer time
+		if(options->module_specific_timing == TRUE){
+			//End the optimizer timer
+			optimizer_end = clock();
 
-		//Crude time calculation. The optimizer starts when the cfg ends
-		times.optimizer_time = (double)(optimizer_end - cfg_end) / CLOCKS_PER_SEC;
-	}
+			//Crude time calculation. The optimizer starts when the cfg ends
+			times.optimizer_time = (double)(optimizer_end - cfg_end) / CLOCKS_PER_SEC;
+		}
 
-	//First we'll go through instruction selection
-	if(options->print_irs == TRUE){
-		printf("=============================== Instruction Selection ==================================\n");
-	}
+		//First we'll go through instruction selection
+		if(options->print_irs == TRUE){
+			printf("=============================== Instruction Selection ==================================\n");
+		}
 	
-	//Run the instruction selector. This simplifies and selects instructions
-	select_all_instructions(options, cfg);
+		//Run the instruction selector. This simplifies and selects instructions
+		select_all_instructions(options, cfg);
 
-	//If we are doing module specific timing, store the selector time
-	if(options->module_specific_timing == TRUE){
-		//End the selector timer
-		selector_end = clock();
+		//If we are doing module specific timing, store the selector time
+		if(options->module_specific_timing == TRUE){
+			//End the selector timer
+			selector_end = clock();
 
-		//Crude time calculation. The selector starts when the optimizer ends
-		times.selector_time = (double)(selector_end - optimizer_end) / CLOCKS_PER_SEC;
-	}
+			//Crude time calculation. The selector starts when the optimizer ends
+			times.selector_time = (double)(selector_end - optimizer_end) / CLOCKS_PER_SEC;
+		}
 
-	if(options->print_irs == TRUE){
-		printf("=============================== Instruction Selection ==================================\n");
-		printf("=============================== Instruction Scheduling =================================\n");
-	}
+		if(options->print_irs == TRUE){
+			printf("=============================== Instruction Selection ==================================\n");
+			printf("=============================== Instruction Scheduling =================================\n");
+		}
 
-	//Now we need to schedule all of the instructions
-	cfg = schedule_all_instructions(cfg, options);
+		//Now we need to schedule all of the instructions
+		cfg = schedule_all_instructions(cfg, options);
 	
-	//If we are doing module specific timing, store the selector time
-	if(options->module_specific_timing == TRUE){
-		//End the selector timer
-		scheduler_end = clock();
+		//If we are doing module specific timing, store the selector time
+		if(options->module_specific_timing == TRUE){
+			//End the selector timer
+			scheduler_end = clock();
 
-		//Crude time calculation. The scheduler starts when the selector ends
-		times.scheduler_time = (double)(scheduler_end - selector_end) / CLOCKS_PER_SEC;
-	}
+			//Crude time calculation. The scheduler starts when the selector ends
+			times.scheduler_time = (double)(scheduler_end - selector_end) / CLOCKS_PER_SEC;
+		}
 
-	if(options->print_irs == TRUE){
-		printf("=============================== Instruction Scheduling =================================\n");
-		printf("=============================== Register Allocation ====================================\n");
-	}
+		if(options->print_irs == TRUE){
+			printf("=============================== Instruction Scheduling =================================\n");
+			printf("=============================== Register Allocation ====================================\n");
+		}
 
-	//Run the register allocator. This will take the OIR version and truly put it into assembler-ready code
-	allocate_all_registers(options, cfg);
+		//Run the register allocator. This will take the OIR version and truly put it into assembler-ready code
+		allocate_all_registers(options, cfg);
 
-	//If we are doing module specific timing, store the selector time
-	if(options->module_specific_timing == TRUE){
-		//End the selector timer
-		allocator_end = clock();
+		//If we are doing module specific timing, store the selector time
+		if(options->module_specific_timing == TRUE){
+			//End the selector timer
+			allocator_end = clock();
 
-		//Crude time calculation. The allocator starts when the selector ends
-		times.allocator_time = (double)(allocator_end - scheduler_end) / CLOCKS_PER_SEC;
-	}
+			//Crude time calculation. The allocator starts when the selector ends
+			times.allocator_time = (double)(allocator_end - scheduler_end) / CLOCKS_PER_SEC;
+		}
 
-	if(options->print_irs == TRUE){
-		printf("=============================== Register Allocation  ===================================\n");
-	}
+		if(options->print_irs == TRUE){
+			printf("=============================== Register Allocation  ===================================\n");
+		}
 
-	/**
-	 * Note that if we are doing a test run, we will not do any file outputting at all. Our
-	 * guard against that is here
-	 */
-	if(options->output_type != OUTPUT_TYPE_NO_OUTPUT){
-		//Run the assembler/linker. This will update errors if we have them
-		assemble_and_link(options, cfg, &num_errors, &num_warnings);
+		/**
+		 * Note that if we are doing a test run, we will not do any file outputting at all. Our
+		 * guard against that is here
+		 */
+		if(options->output_type != OUTPUT_TYPE_NO_OUTPUT){
+			//Run the assembler/linker. This will update errors if we have them
+			assemble_and_link(options, cfg, &num_errors, &num_warnings);
+		}
 	}
 
 	//Finish the timer here if we need to
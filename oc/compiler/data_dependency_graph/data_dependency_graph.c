@@ -959,6 +959,82 @@ void add_dependence(data_dependency_graph_t* graph, instruction_t* target, instr
 }
 
 
+/**
+ * Is the base register of the given instruction's address written to by any of the nodes in
+ * [start, end)? Alias analysis compares pointer bases by variable, which only holds up so long
+ * as nothing in between gave that variable a new value
+ */
+static u_int8_t is_address_register_redefined(data_dependency_graph_t* graph, instruction_t* instruction, u_int16_t start, u_int16_t end){
+	three_addr_var_t* base = instruction->operands.x86.address_register1;
+
+	//Nothing to redefine
+	if(base == NULL){
+		return FALSE;
+	}
+
+	for(u_int16_t i = start; i < end; i++){
+		instruction_t* current = graph->nodes[i]->instruction;
+
+		if(variables_equal(current->operands.x86.destination_register, base) == TRUE
+			|| variables_equal(current->operands.x86.destination_register2, base) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Add a dependence between every pair of instructions that could touch the same memory where
+ * at least one of them writes to it. The later instruction always depends on the earlier one,
+ * so this must be done while the nodes are still in program order
+ */
+void add_memory_dependences(data_dependency_graph_t* graph){
+	memory_location_t later_location;
+	memory_location_t earlier_location;
+
+	for(u_int16_t i = 1; i < graph->current_index; i++){
+		instruction_t* later = graph->nodes[i]->instruction;
+
+		//Where does the later one go? This is only needed for pointer bases
+		u_int8_t later_has_pointer_base = get_memory_location_for_instruction(later, &later_location) == TRUE
+											&& later_location.base_type == MEMORY_BASE_POINTER;
+
+		for(int32_t j = i - 1; j >= 0; j--){
+			instruction_t* earlier = graph->nodes[j]->instruction;
+
+			//The easy case - alias analysis says that these could overlap
+			if(do_instructions_have_memory_conflict(earlier, later) == TRUE){
+				add_dependence(graph, later, earlier);
+				continue;
+			}
+
+			/**
+			 * Two accesses through the same pointer variable can only be told apart if it is
+			 * the same pointer value at both of them. If it was redefined in between(the earlier
+			 * instruction included), we can't trust what alias analysis said
+			 */
+			if(later_has_pointer_base == FALSE
+				|| get_memory_location_for_instruction(earlier, &earlier_location) == FALSE
+				|| earlier_location.base_type != MEMORY_BASE_POINTER
+				|| variables_equal(earlier_location.base, later_location.base) == FALSE){
+				continue;
+			}
+
+			//Two reads can never conflict
+			if(earlier->memory_access_type != WRITE_TO_MEMORY && later->memory_access_type != WRITE_TO_MEMORY){
+				continue;
+			}
+
+			if(is_address_register_redefined(graph, later, j, i) == TRUE){
+				add_dependence(graph, later, earlier);
+			}
+		}
+	}
+}
+
+
 /**
  * A utility that will print an N x N adjacency matrix out to the console for debug reasons
  */
@@ -14,6 +14,7 @@
 #include "../utils/constants.h"
 #include "../utils/dynamic_array/dynamic_array.h"
 #include "../instruction/instruction.h"
+#include "../alias_analysis/alias_analysis.h"
 
 //Top level type definition
 typedef struct data_dependency_graph_t data_dependency_graph_t;
@@ -137,6 +138,14 @@ void finalize_data_dependency_graph(data_dependency_graph_t* graph);
  */
 void add_dependence(data_dependency_graph_t* graph, instruction_t* target, instruction_t* depends_on);
 
+/**
+ * Add a dependence between every pair of instructions that could touch the same memory where
+ * at least one of them writes to it. Alias analysis decides what could overlap
+ *
+ * NOTE: This must be done *before* the graph is finalized, while the nodes are still in program order
+ */
+void add_memory_dependences(data_dependency_graph_t* graph);
+
 /**
  * Construct the adjacency matrix for a given graph
  *
@@ -6,6 +6,7 @@
 
 #include "graph_analyzer.h"
 #include <stdint.h>
+#include <stdlib.h>
 #include <sys/types.h>
 
 /**
@@ -14,21 +15,15 @@
 #define LT_UNNUMBERED (-1)
 
 /**
- * Run through an entire array of function blocks and reset the status for
- * every single one. We assume that the caller knows what they are doing, and
- * that the blocks inside of the array are really the correct blocks
+ * Blocks that have been removed from a function are flagged with this DFS number
+ * while we are incrementally updating the control relations
  */
-static inline void reset_visit_status_for_function(dynamic_array_t* function_blocks){
-	//Run through all of the blocks
-	for(int32_t i = 0; i < function_blocks->current_index; i++){
-		//Extract the current block
-		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
-
-		//Flag it as false
-		current->visited = FALSE;
-	}
-}
+#define LT_REMOVED (-2)
 
+/**
+ * The starting size for a control flow update log
+ */
+#define DEFAULT_CONTROL_FLOW_UPDATE_LOG_SIZE 16
 
 /**
  * Initialize a block for idom computation. Remember that we may compute the immediate
@@ -36,22 +31,14 @@ static inline void reset_visit_status_for_function(dynamic_array_t* function_blo
  * the slate clean every time
  */
 static inline void initialize_block_for_idom_computation(basic_block_t* block){
-	block->dominator_info.ancestor = NULL;
-	block->dominator_info.immediate_dominator = NULL;
-	block->dominator_info.optimal_candidate = NULL;
-	block->dominator_info.semidominator_number = LT_UNNUMBERED;
-	block->dominator_info.parent = NULL;
-	block->dominator_info.dfs_number = LT_UNNUMBERED;
+	block->analysis->dominator_info.ancestor = NULL;
+	block->analysis->dominator_info.immediate_dominator = NULL;
+	block->analysis->dominator_info.optimal_candidate = NULL;
+	block->analysis->dominator_info.semidominator_number = LT_UNNUMBERED;
+	block->analysis->dominator_info.parent = NULL;
+	block->analysis->dominator_info.dfs_number = LT_UNNUMBERED;
+	block->analysis->dominator_info.dominator_depth = LT_UNNUMBERED;
 
-	/**
-	 * If we already have a dynamic array we'll just wipe it, otherwise
-	 * we've got to allocate
-	 */
-	if(block->dominator_info.worklist.internal_array != NULL){
-		clear_dynamic_array(&(block->dominator_info.worklist));
-	} else {
-		block->dominator_info.worklist = dynamic_array_alloc();
-	}
 }
 
 
@@ -63,22 +50,124 @@ static inline void initialize_block_for_idom_computation(basic_block_t* block){
  * NOTE: this *must* be used for ipdom calculation because it does not clear the IDOM
  */
 static inline void initialize_block_for_ipdom_computation(basic_block_t* block){
-	block->dominator_info.ancestor = NULL;
-	block->dominator_info.immediate_postdominator = NULL;
-	block->dominator_info.optimal_candidate = NULL;
-	block->dominator_info.semidominator_number = LT_UNNUMBERED;
-	block->dominator_info.parent = NULL;
-	block->dominator_info.dfs_number = LT_UNNUMBERED;
+	block->analysis->dominator_info.ancestor = NULL;
+	block->analysis->dominator_info.immediate_postdominator = NULL;
+	block->analysis->dominator_info.optimal_candidate = NULL;
+	block->analysis->dominator_info.semidominator_number = LT_UNNUMBERED;
+	block->analysis->dominator_info.parent = NULL;
+	block->analysis->dominator_info.dfs_number = LT_UNNUMBERED;
+	block->analysis->dominator_info.postdominator_depth = LT_UNNUMBERED;
 
-	/**
-	 * If we already have a dynamic array we'll just wipe it, otherwise
-	 * we've got to allocate
-	 */
-	if(block->dominator_info.worklist.internal_array != NULL){
-		clear_dynamic_array(&(block->dominator_info.worklist));
-	} else {
-		block->dominator_info.worklist = dynamic_array_alloc();
+}
+
+
+/**
+ * Has this block been given a DFS number in the traversal that we are currently running?
+ *
+ * We can't just check for LT_UNNUMBERED here because when only a piece of the tree is recomputed,
+ * blocks outside of that piece keep the DFS numbers from older runs. A block is only really numbered
+ * if the number to vertex mapping agrees with it
+ */
+static inline u_int8_t is_block_numbered(basic_block_t* block, basic_block_t** dfs_number_to_vertex_mapping, int32_t current_dfs_number){
+	int32_t dfs_number = block->analysis->dominator_info.dfs_number;
+
+	if(dfs_number < 0 || dfs_number >= current_dfs_number){
+		return FALSE;
+	}
+
+	return dfs_number_to_vertex_mapping[dfs_number] == block ? TRUE : FALSE;
+}
+
+
+/**
+ * Is the given block inside of the dominator subtree rooted at subtree_root? We climb
+ * from the block towards the root of the tree until we are no deeper than the subtree root. If
+ * we land on the subtree root, then it dominates the block
+ */
+static inline u_int8_t is_in_dominator_subtree(basic_block_t* block, basic_block_t* subtree_root){
+	int32_t subtree_root_depth = subtree_root->analysis->dominator_info.dominator_depth;
+
+	while(block != NULL && block->analysis->dominator_info.dominator_depth > subtree_root_depth){
+		block = block->analysis->dominator_info.immediate_dominator;
+	}
+
+	return block == subtree_root ? TRUE : FALSE;
+}
+
+
+/**
+ * Is the given block inside of the postdominator subtree rooted at subtree_root? Works
+ * exactly like the dominator version above, just on the postdominator tree
+ */
+static inline u_int8_t is_in_postdominator_subtree(basic_block_t* block, basic_block_t* subtree_root){
+	int32_t subtree_root_depth = subtree_root->analysis->dominator_info.postdominator_depth;
+
+	while(block != NULL && block->analysis->dominator_info.postdominator_depth > subtree_root_depth){
+		block = block->analysis->dominator_info.immediate_postdominator;
+	}
+
+	return block == subtree_root ? TRUE : FALSE;
+}
+
+
+/**
+ * Find the nearest common dominator of two blocks. Both blocks must already be
+ * inside of the dominator tree
+ *
+ * Algorithm nearest_common_dominator(a, b):
+ * 	while depth(a) > depth(b):
+ * 		a = IDOM(a)
+ *
+ * 	while depth(b) > depth(a):
+ * 		b = IDOM(b)
+ *
+ * 	while a != b:
+ * 		a = IDOM(a)
+ * 		b = IDOM(b)
+ *
+ * 	return a
+ */
+static basic_block_t* nearest_common_dominator(basic_block_t* a, basic_block_t* b){
+	//Get them level with one another first
+	while(a->analysis->dominator_info.dominator_depth > b->analysis->dominator_info.dominator_depth){
+		a = a->analysis->dominator_info.immediate_dominator;
+	}
+
+	while(b->analysis->dominator_info.dominator_depth > a->analysis->dominator_info.dominator_depth){
+		b = b->analysis->dominator_info.immediate_dominator;
+	}
+
+	//Now climb in lockstep until we meet
+	while(a != b){
+		a = a->analysis->dominator_info.immediate_dominator;
+		b = b->analysis->dominator_info.immediate_dominator;
+	}
+
+	return a;
+}
+
+
+/**
+ * Find the nearest common postdominator of two blocks. Both blocks must already be
+ * inside of the postdominator tree. This is the same algorithm as the dominator version
+ */
+static basic_block_t* nearest_common_postdominator(basic_block_t* a, basic_block_t* b){
+	//Get them level with one another first
+	while(a->analysis->dominator_info.postdominator_depth > b->analysis->dominator_info.postdominator_depth){
+		a = a->analysis->dominator_info.immediate_postdominator;
 	}
+
+	while(b->analysis->dominator_info.postdominator_depth > a->analysis->dominator_info.postdominator_depth){
+		b = b->analysis->dominator_info.immediate_postdominator;
+	}
+
+	//Now climb in lockstep until we meet
+	while(a != b){
+		a = a->analysis->dominator_info.immediate_postdominator;
+		b = b->analysis->dominator_info.immediate_postdominator;
+	}
+
+	return a;
 }
 
 
@@ -111,22 +200,25 @@ static inline void initialize_block_for_ipdom_computation(basic_block_t* block){
  * 		if b->dfs_number == -1:
  * 			s->parent = b
  * 			IDOM_DFS(s)
+ *
+ * If we are given a subtree root, the traversal will never leave the (old) dominator
+ * subtree of that root. This is what lets us recompute just one piece of the tree
  */
-static void dfs_number_block(basic_block_t* block, basic_block_t** dfs_number_to_vertex_mapping, int32_t* current_dfs_number){
+static void dfs_number_block(basic_block_t* block, basic_block_t** dfs_number_to_vertex_mapping, int32_t* current_dfs_number, basic_block_t* subtree_root){
 	//Assign this to be the current DFS number
-	block->dominator_info.dfs_number = *current_dfs_number;
+	block->analysis->dominator_info.dfs_number = *current_dfs_number;
 
 	//We'll also have a reverse mapping from number to block
 	dfs_number_to_vertex_mapping[*current_dfs_number] = block;
 
 	//Initialize the semidominator number to be this
-	block->dominator_info.semidominator_number = *current_dfs_number;
+	block->analysis->dominator_info.semidominator_number = *current_dfs_number;
 
 	//By default our optimal candidate so far is just this block
-	block->dominator_info.optimal_candidate = block;
+	block->analysis->dominator_info.optimal_candidate = block;
 
 	//As of right now we don't have a union-find ancestor so just make it NULL
-	block->dominator_info.ancestor = NULL;
+	block->analysis->dominator_info.ancestor = NULL;
 
 	//Bump the current number up
 	(*current_dfs_number)++;
@@ -142,12 +234,17 @@ static void dfs_number_block(basic_block_t* block, basic_block_t** dfs_number_to
 		 * If our successor does not yet have a DFS number, then we'll need to 
 		 * give it one now
 		 */
-		if(successor->dominator_info.dfs_number == LT_UNNUMBERED){
+		if(is_block_numbered(successor, dfs_number_to_vertex_mapping, *current_dfs_number) == FALSE){
+			//If we're confined to a subtree, we can't leave it
+			if(subtree_root != NULL && is_in_dominator_subtree(successor, subtree_root) == FALSE){
+				continue;
+			}
+
 			//Simple parent is just this block
-			successor->dominator_info.parent = block;
+			successor->analysis->dominator_info.parent = block;
 
 			//Recursively call out to have this block populated
-			dfs_number_block(successor, dfs_number_to_vertex_mapping, current_dfs_number);
+			dfs_number_block(successor, dfs_number_to_vertex_mapping, current_dfs_number, subtree_root);
 		}
 	}
 }
@@ -182,22 +279,25 @@ static void dfs_number_block(basic_block_t* block, basic_block_t** dfs_number_to
  * 		if b->dfs_number == -1:
  * 			p->parent = b
  * 			IDOM_REVERSE_DFS(p)
+ *
+ * If we are given a subtree root, the traversal will never leave the (old) postdominator
+ * subtree of that root
  */
-static void reverse_dfs_number_block(basic_block_t* block, basic_block_t** reverse_dfs_number_to_vertex_mapping, int32_t* current_reverse_dfs_number){
+static void reverse_dfs_number_block(basic_block_t* block, basic_block_t** reverse_dfs_number_to_vertex_mapping, int32_t* current_reverse_dfs_number, basic_block_t* subtree_root){
 	//Assign this to be the current DFS number
-	block->dominator_info.dfs_number = *current_reverse_dfs_number;
+	block->analysis->dominator_info.dfs_number = *current_reverse_dfs_number;
 
 	//We'll also have a reverse mapping from number to block
 	reverse_dfs_number_to_vertex_mapping[*current_reverse_dfs_number] = block;
 
 	//Initialize the semidominator number to be this
-	block->dominator_info.semidominator_number = *current_reverse_dfs_number;
+	block->analysis->dominator_info.semidominator_number = *current_reverse_dfs_number;
 
 	//By default our optimal candidate so far is just this block
-	block->dominator_info.optimal_candidate = block;
+	block->analysis->dominator_info.optimal_candidate = block;
 
 	//As of right now we don't have a union-find ancestor so just make it NULL
-	block->dominator_info.ancestor = NULL;
+	block->analysis->dominator_info.ancestor = NULL;
 
 	//Bump the current number up
 	(*current_reverse_dfs_number)++;
@@ -213,12 +313,17 @@ static void reverse_dfs_number_block(basic_block_t* block, basic_block_t** rever
 		 * If our predecessor does not yet have a DFS number, then we'll need to 
 		 * give it one now
 		 */
-		if(predecessor->dominator_info.dfs_number == LT_UNNUMBERED){
+		if(is_block_numbered(predecessor, reverse_dfs_number_to_vertex_mapping, *current_reverse_dfs_number) == FALSE){
+			//If we're confined to a subtree, we can't leave it
+			if(subtree_root != NULL && is_in_postdominator_subtree(predecessor, subtree_root) == FALSE){
+				continue;
+			}
+
 			//Simple parent is just this block
-			predecessor->dominator_info.parent = block;
+			predecessor->analysis->dominator_info.parent = block;
 
 			//Recursively call out to have this block populated
-			reverse_dfs_number_block(predecessor, reverse_dfs_number_to_vertex_mapping, current_reverse_dfs_number);
+			reverse_dfs_number_block(predecessor, reverse_dfs_number_to_vertex_mapping, current_reverse_dfs_number, subtree_root);
 		}
 	}
 }
@@ -264,7 +369,7 @@ static void reverse_dfs_number_block(basic_block_t* block, basic_block_t** rever
  */
 static void path_compression(basic_block_t* block){
 	//Extract the current ancestor for our block
-	basic_block_t* ancestor = block->dominator_info.ancestor;
+	basic_block_t* ancestor = block->analysis->dominator_info.ancestor;
 
 	/**
 	 * Base case 1: we have no ancestor so we bail out
@@ -277,7 +382,7 @@ static void path_compression(basic_block_t* block){
 	 * Base case 2: the ancestor itself has no ancestor, so we
 	 * also bail out
 	 */
-	if(ancestor->dominator_info.ancestor == NULL){
+	if(ancestor->analysis->dominator_info.ancestor == NULL){
 		return;
 	}
 
@@ -300,11 +405,11 @@ static void path_compression(basic_block_t* block){
 	 * This is how we "remember" what the best semidominator candidate is along our path for use down 
 	 * the road
 	 */
-	int32_t ancestor_semidominator = ancestor->dominator_info.optimal_candidate->dominator_info.semidominator_number;
-	int32_t block_semidominator = block->dominator_info.optimal_candidate->dominator_info.semidominator_number;
+	int32_t ancestor_semidominator = ancestor->analysis->dominator_info.optimal_candidate->analysis->dominator_info.semidominator_number;
+	int32_t block_semidominator = block->analysis->dominator_info.optimal_candidate->analysis->dominator_info.semidominator_number;
 
 	if(ancestor_semidominator < block_semidominator){
-		block->dominator_info.optimal_candidate = ancestor->dominator_info.optimal_candidate;
+		block->analysis->dominator_info.optimal_candidate = ancestor->analysis->dominator_info.optimal_candidate;
 	}
 
 	/**
@@ -312,7 +417,7 @@ static void path_compression(basic_block_t* block){
 	 * what comes before this ancestor. This makes all future
 	 * walks between the block and it's ancestor much shorter
 	 */
-	block->dominator_info.ancestor = ancestor->dominator_info.ancestor;
+	block->analysis->dominator_info.ancestor = ancestor->analysis->dominator_info.ancestor;
 }
 
 
@@ -331,8 +436,8 @@ static inline basic_block_t* evaluate(basic_block_t* block){
 	 * If we have no ancestor then path compression is useless
 	 * anyways, we'll just return our current best guess
 	 */
-	if(block->dominator_info.ancestor == NULL){
-		return block->dominator_info.optimal_candidate;
+	if(block->analysis->dominator_info.ancestor == NULL){
+		return block->analysis->dominator_info.optimal_candidate;
 	}
 
 	/**
@@ -342,7 +447,7 @@ static inline basic_block_t* evaluate(basic_block_t* block){
 	path_compression(block);
 
 	//Give back the optimal candidate that we've found during compression
-	return block->dominator_info.optimal_candidate;
+	return block->analysis->dominator_info.optimal_candidate;
 }
 
 
@@ -353,7 +458,7 @@ static inline basic_block_t* evaluate(basic_block_t* block){
  * calculation, it's just context-dependant as to what the ancestor is
  */
 static inline void link_ancestor(basic_block_t* ancestor, basic_block_t* descendant){
-	descendant->dominator_info.ancestor = ancestor;
+	descendant->analysis->dominator_info.ancestor = ancestor;
 }
 
 
@@ -432,19 +537,14 @@ static inline void link_ancestor(basic_block_t* ancestor, basic_block_t* descend
  *			set b's IDOM to be IDOM(IDOM(b))
  *
  * Property: Every node *except* the entry node has exactly one immediate dominator
+ *
+ * The root that we're given does not need to be the function entry. If we are confining
+ * ourselves to the root's subtree, then only the immediate dominators of blocks that are
+ * strictly dominated by the root are recomputed. This is valid because every edge into that
+ * subtree must come in through the root itself. The root's own immediate dominator is never
+ * touched. Once we're done, the dominator tree depths are refreshed for everything that we visited
  */
-static void compute_immediate_dominators(basic_block_t* function_entry_block, dynamic_array_t* function_blocks){
-	//The number of blocks is static
-	const int32_t number_of_blocks = function_blocks->current_index;
-
-	/**
-	 * Wipe every block's existing dominator info completely clean
-	 */
-	for(int32_t i = 0; i < number_of_blocks; i++){
-		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
-		initialize_block_for_idom_computation(block);
-	}
-
+static void compute_immediate_dominators_from_root(basic_block_t* root, u_int8_t confine_to_subtree, int32_t number_of_blocks){
 	/**
 	 * Run the DFS numbering algorithm to populate
 	 * the DFS numbers for every block. This also
@@ -458,7 +558,16 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 	 */
 	int32_t current_dfs_number = 0;
 	basic_block_t** dfs_number_to_vertex_mapping = calloc(number_of_blocks, sizeof(basic_block_t*));
-	dfs_number_block(function_entry_block, dfs_number_to_vertex_mapping, &current_dfs_number);
+	dfs_number_block(root, dfs_number_to_vertex_mapping, &current_dfs_number, confine_to_subtree == TRUE ? root : NULL);
+
+	/**
+	 * The buckets(the set of blocks that each block semidominates) live in side arrays
+	 * that are indexed by DFS number. Each bucket is a singly linked list that is threaded
+	 * through the "next" array. A block only ever sits in one bucket, and the root(DFS number 0)
+	 * never sits in any, so 0 doubles as the end of list marker
+	 */
+	int32_t* bucket_heads = calloc(number_of_blocks, sizeof(int32_t));
+	int32_t* bucket_next = calloc(number_of_blocks, sizeof(int32_t));
 
 	/**
 	 * Now that we have the DFS numbers in place, we will run through
@@ -483,7 +592,7 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 			 * we skip ahead. This in theory should never happen but we don't
 			 * want to go down this road if it does so best to be safe
 			 */
-			if(predecessor->dominator_info.dfs_number == LT_UNNUMBERED){
+			if(is_block_numbered(predecessor, dfs_number_to_vertex_mapping, current_dfs_number) == FALSE){
 				continue;
 			}
 
@@ -493,7 +602,7 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 			 * run evaluate on the predecessor which will walk the graph, compress the path,
 			 * and return what it thinks the best semidominator is
 			 */
-			if(predecessor->dominator_info.dfs_number < working_block->dominator_info.dfs_number){
+			if(predecessor->analysis->dominator_info.dfs_number < working_block->analysis->dominator_info.dfs_number){
 				candidate = predecessor;
 			} else {
 				candidate = evaluate(predecessor);
@@ -503,8 +612,8 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 			 * If this candidate has a superior(lower DFS numbered) semidominator, then we will
 			 * replace the one that we currently have in the working block with it's number
 			 */
-			if(candidate->dominator_info.semidominator_number < working_block->dominator_info.semidominator_number){
-				working_block->dominator_info.semidominator_number = candidate->dominator_info.semidominator_number;
+			if(candidate->analysis->dominator_info.semidominator_number < working_block->analysis->dominator_info.semidominator_number){
+				working_block->analysis->dominator_info.semidominator_number = candidate->analysis->dominator_info.semidominator_number;
 			}
 		}
 
@@ -513,18 +622,19 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 		 * add the working block into our processing bucket for this given semidominator block.
 		 * First we'll need to use the DFS number to block mapping to get the actual semidominator
 		 */
-		basic_block_t* semidominator = dfs_number_to_vertex_mapping[working_block->dominator_info.semidominator_number];
+		basic_block_t* semidominator = dfs_number_to_vertex_mapping[working_block->analysis->dominator_info.semidominator_number];
 
 		/**
-		 * Add the working block into the semidominator's worklist
+		 * Add the working block into the semidominator's bucket
 		 *
-		 * Remember: the "worklist" of the semidominator "x" contains all blocks
+		 * Remember: the bucket of the semidominator "x" contains all blocks
 		 * whose semidominator is "x"
 		 */
-		dynamic_array_add(&(semidominator->dominator_info.worklist), working_block);
+		bucket_next[i] = bucket_heads[semidominator->analysis->dominator_info.dfs_number];
+		bucket_heads[semidominator->analysis->dominator_info.dfs_number] = i;
 
 		//We'll need the parent p of this block going forward
-		basic_block_t* dominator_parent = working_block->dominator_info.parent;
+		basic_block_t* dominator_parent = working_block->analysis->dominator_info.parent;
 
 		/**
 		 * The parent of the working block is it's union-find ancestor
@@ -536,7 +646,7 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 		 * to determine the *potential* IDOMs for all node's whose semidominator
 		 * is our working block's parent.
 		 *
-		 * The worklist is essentially a deferred work queue that allows our algorithm
+		 * The bucket is essentially a deferred work queue that allows our algorithm
 		 * to postpone any/all IDOM processing until the ancestor structure
 		 * has enough info to make the decision
 		 *
@@ -547,13 +657,13 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 		 * needed after this. This only computes a provisional(or potential/best guess)
 		 * IDOM
 		 */
-		dynamic_array_t* parent_worklist = &(dominator_parent->dominator_info.worklist);
-		for(int32_t k = 0; k < parent_worklist->current_index; k++){
+		int32_t parent_dfs_number = dominator_parent->analysis->dominator_info.dfs_number;
+		for(int32_t k = bucket_heads[parent_dfs_number]; k != 0; k = bucket_next[k]){
 			/**
 			 * Extract our bucket block and use evaluate to perform path compression
 			 * and get compute the smallest semidominator number along this path
 			 */
-			basic_block_t* semidominated_block = dynamic_array_get_at(parent_worklist, k);
+			basic_block_t* semidominated_block = dfs_number_to_vertex_mapping[k];
 			basic_block_t* candidate = evaluate(semidominated_block);
 
 			/**
@@ -561,15 +671,15 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 			 * the bucket block, we will set the candidate as this block's IDOM. Otherwise,
 			 * we will set this block's IDOM to be the parent block
 			 */
-			if(candidate->dominator_info.semidominator_number < semidominated_block->dominator_info.semidominator_number){
-				semidominated_block->dominator_info.immediate_dominator = candidate;
+			if(candidate->analysis->dominator_info.semidominator_number < semidominated_block->analysis->dominator_info.semidominator_number){
+				semidominated_block->analysis->dominator_info.immediate_dominator = candidate;
 			} else {
-				semidominated_block->dominator_info.immediate_dominator = dominator_parent;
+				semidominated_block->analysis->dominator_info.immediate_dominator = dominator_parent;
 			}
 		}
 
 		//Clear out the bucket now that we've processed
-		clear_dynamic_array(parent_worklist);
+		bucket_heads[parent_dfs_number] = 0;
 	}
 
 	/**
@@ -588,22 +698,56 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
 		basic_block_t* working_block = dfs_number_to_vertex_mapping[i];
 
 		//Extract this block's semidominator
-		basic_block_t* semidominator = dfs_number_to_vertex_mapping[working_block->dominator_info.semidominator_number];
+		basic_block_t* semidominator = dfs_number_to_vertex_mapping[working_block->analysis->dominator_info.semidominator_number];
 
 		/**
 		 * If the IDOM is not the semidominator, then the real IDOM is
 		 * the immediate dominator of said candidate
 		 */
-		if(working_block->dominator_info.immediate_dominator != semidominator){
-			working_block->dominator_info.immediate_dominator = working_block->dominator_info.immediate_dominator->dominator_info.immediate_dominator;
+		if(working_block->analysis->dominator_info.immediate_dominator != semidominator){
+			working_block->analysis->dominator_info.immediate_dominator = working_block->analysis->dominator_info.immediate_dominator->analysis->dominator_info.immediate_dominator;
 		}
 	}
 
-	//The function entry block itself never has an immediate dominator
-	function_entry_block->dominator_info.immediate_dominator = NULL;
+	/**
+	 * A block's immediate dominator is always a DFS ancestor of it, so going in DFS
+	 * order guarantees that the dominator's depth is already correct
+	 */
+	for(int32_t i = 1; i < current_dfs_number; i++){
+		basic_block_t* working_block = dfs_number_to_vertex_mapping[i];
+		working_block->analysis->dominator_info.dominator_depth = working_block->analysis->dominator_info.immediate_dominator->analysis->dominator_info.dominator_depth + 1;
+	}
 
-	//We're done with this now so release it
+	//We're done with these now so release them
 	free(dfs_number_to_vertex_mapping);
+	free(bucket_heads);
+	free(bucket_next);
+}
+
+
+/**
+ * Compute the immediate dominators for every block in the function from scratch
+ */
+static void compute_immediate_dominators(basic_block_t* function_entry_block, dynamic_array_t* function_blocks){
+	//The number of blocks is static
+	const int32_t number_of_blocks = function_blocks->current_index;
+
+	/**
+	 * Wipe every block's existing dominator info completely clean
+	 */
+	for(int32_t i = 0; i < number_of_blocks; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+		initialize_block_for_idom_computation(block);
+	}
+
+	//The entry is the root of the tree
+	function_entry_block->analysis->dominator_info.dominator_depth = 0;
+
+	//Let the helper compute everything
+	compute_immediate_dominators_from_root(function_entry_block, FALSE, number_of_blocks);
+
+	//The function entry block itself never has an immediate dominator
+	function_entry_block->analysis->dominator_info.immediate_dominator = NULL;
 }
 
 
@@ -684,19 +828,11 @@ static void compute_immediate_dominators(basic_block_t* function_entry_block, dy
  *			set b's IPDOM to be IPDOM(IPDOM(b))
  *
  * Property: Every node *except* the entry node has exactly one immediate dominator
+ *
+ * Just like with dominators, the root may be any block in the postdominator tree. If we're
+ * confining ourselves to its subtree, only the blocks that it strictly postdominates are recomputed
  */
-static void compute_immediate_postdominators(basic_block_t* function_exit_block, dynamic_array_t* function_blocks){
-	//Extract the number of blocks that we have 
-	const int32_t number_of_blocks = function_blocks->current_index;
-
-	/**
-	 * The first thing that we need to do is initialize every block for IPDOM calculation
-	 */
-	for(int32_t i = 0; i < number_of_blocks; i++){
-		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
-		initialize_block_for_ipdom_computation(block);
-	}
-
+static void compute_immediate_postdominators_from_root(basic_block_t* root, u_int8_t confine_to_subtree, int32_t number_of_blocks){
 	/**
 	 * Let the reverse DFS numbering algorithm recursively give
 	 * every block a reverse DFS number. We'll need this number 
@@ -709,7 +845,16 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 	 */
 	int32_t current_reverse_dfs_number = 0;
 	basic_block_t** reverse_dfs_number_to_vertex_mapping = calloc(number_of_blocks, sizeof(basic_block_t*));
-	reverse_dfs_number_block(function_exit_block, reverse_dfs_number_to_vertex_mapping, &current_reverse_dfs_number);
+	reverse_dfs_number_block(root, reverse_dfs_number_to_vertex_mapping, &current_reverse_dfs_number, confine_to_subtree == TRUE ? root : NULL);
+
+	/**
+	 * The buckets(the set of blocks that each block semidominates) live in side arrays
+	 * that are indexed by DFS number. Each bucket is a singly linked list that is threaded
+	 * through the "next" array. A block only ever sits in one bucket, and the root(DFS number 0)
+	 * never sits in any, so 0 doubles as the end of list marker
+	 */
+	int32_t* bucket_heads = calloc(number_of_blocks, sizeof(int32_t));
+	int32_t* bucket_next = calloc(number_of_blocks, sizeof(int32_t));
 
 	/**
 	 * Work our way through the graph from top to bottom(reverse traversal
@@ -733,7 +878,7 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 			 * Rare case but something we will account for just to be safe - we will
 			 * skip a block if it has an unreachable DFS number
 			 */
-			if(successor->dominator_info.dfs_number == LT_UNNUMBERED){
+			if(is_block_numbered(successor, reverse_dfs_number_to_vertex_mapping, current_reverse_dfs_number) == FALSE){
 				continue;
 			}
 
@@ -742,7 +887,7 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 			 * the successor is our candidate. Otherwise, we will find our candidate by running
 			 * the union-find + path compression algorihtm on the successor
 			 */
-			if(successor->dominator_info.dfs_number < working_block->dominator_info.dfs_number){
+			if(successor->analysis->dominator_info.dfs_number < working_block->analysis->dominator_info.dfs_number){
 				candidate = successor;
 			} else {
 				candidate = evaluate(successor);
@@ -753,21 +898,22 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 			 * replace the current semipostdominator number of our current working block with this
 			 * candidate
 			 */
-			if(candidate->dominator_info.semidominator_number < working_block->dominator_info.semidominator_number){
-				working_block->dominator_info.semidominator_number = candidate->dominator_info.semidominator_number;
+			if(candidate->analysis->dominator_info.semidominator_number < working_block->analysis->dominator_info.semidominator_number){
+				working_block->analysis->dominator_info.semidominator_number = candidate->analysis->dominator_info.semidominator_number;
 			}
 		}
 
 		/**
 		 * Now that we've found our best semipostdominator candidate, we are going to add this block
-		 * into said semipostdominators "worklist" that we'll use for deferred processing when
+		 * into said semipostdominators bucket that we'll use for deferred processing when
 		 * the time comes
 		 */
-		basic_block_t* semipostdominator = reverse_dfs_number_to_vertex_mapping[working_block->dominator_info.semidominator_number];
-		dynamic_array_add(&(semipostdominator->dominator_info.worklist), working_block);
+		basic_block_t* semipostdominator = reverse_dfs_number_to_vertex_mapping[working_block->analysis->dominator_info.semidominator_number];
+		bucket_next[i] = bucket_heads[semipostdominator->analysis->dominator_info.dfs_number];
+		bucket_heads[semipostdominator->analysis->dominator_info.dfs_number] = i;
 
 		//We'll need the postdominator parent p of this block going forward
-		basic_block_t* postdominator_parent = working_block->dominator_info.parent;
+		basic_block_t* postdominator_parent = working_block->analysis->dominator_info.parent;
 
 		/**
 		 * The parent of the working block is it's union-find ancestor
@@ -779,7 +925,7 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 		 * to determine the *potential* IPDOMs for all node's whose semipostdominator
 		 * is our working block's parent.
 		 *
-		 * The worklist is essentially a deferred work queue that allows our algorithm
+		 * The bucket is essentially a deferred work queue that allows our algorithm
 		 * to postpone any/all IPDOM processing until the ancestor structure
 		 * has enough info to make the decision
 		 *
@@ -790,13 +936,13 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 		 * needed after this. This only computes a provisional(or potential/best guess)
 		 * IPDOM
 		 */
-		dynamic_array_t* parent_worklist = &(postdominator_parent->dominator_info.worklist);
-		for(int32_t k = 0; k < parent_worklist->current_index; k++){
+		int32_t parent_dfs_number = postdominator_parent->analysis->dominator_info.dfs_number;
+		for(int32_t k = bucket_heads[parent_dfs_number]; k != 0; k = bucket_next[k]){
 			/**
 			 * Extract our semipostdominated block and use evaluate to perform path compression
 			 * and get compute the smallest semidominator number along this path
 			 */
-			basic_block_t* semipostdominated_block = dynamic_array_get_at(parent_worklist, k);
+			basic_block_t* semipostdominated_block = reverse_dfs_number_to_vertex_mapping[k];
 			basic_block_t* candidate = evaluate(semipostdominated_block);
 
 			/**
@@ -804,15 +950,15 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 			 * the bucket block, we will set the candidate as this block's IPDOM. Otherwise,
 			 * we will set this block's IPDOM to be the parent block
 			 */
-			if(candidate->dominator_info.semidominator_number < semipostdominated_block->dominator_info.semidominator_number){
-				semipostdominated_block->dominator_info.immediate_postdominator = candidate;
+			if(candidate->analysis->dominator_info.semidominator_number < semipostdominated_block->analysis->dominator_info.semidominator_number){
+				semipostdominated_block->analysis->dominator_info.immediate_postdominator = candidate;
 			} else {
-				semipostdominated_block->dominator_info.immediate_postdominator = postdominator_parent;
+				semipostdominated_block->analysis->dominator_info.immediate_postdominator = postdominator_parent;
 			}
 		}
 
 		//Clear out the bucket now that we've processed
-		clear_dynamic_array(parent_worklist);
+		bucket_heads[parent_dfs_number] = 0;
 	}
 
 	/**
@@ -831,24 +977,58 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
 		basic_block_t* working_block = reverse_dfs_number_to_vertex_mapping[i];
 
 		//Extract this block's semipostdominator
-		basic_block_t* semipostdominator = reverse_dfs_number_to_vertex_mapping[working_block->dominator_info.semidominator_number];
+		basic_block_t* semipostdominator = reverse_dfs_number_to_vertex_mapping[working_block->analysis->dominator_info.semidominator_number];
 
 		/**
 		 * If the IPDOM is not the semidominator, then the real IPDOM is
 		 * the immediate postdominator dominator of said candidate
 		 */
-		if(working_block->dominator_info.immediate_postdominator != semipostdominator){
-			working_block->dominator_info.immediate_postdominator = working_block->dominator_info.immediate_postdominator->dominator_info.immediate_postdominator;
+		if(working_block->analysis->dominator_info.immediate_postdominator != semipostdominator){
+			working_block->analysis->dominator_info.immediate_postdominator = working_block->analysis->dominator_info.immediate_postdominator->analysis->dominator_info.immediate_postdominator;
 		}
 	}
 
 	/**
-	 * By definition, the exit block may have no immediate postdominator
+	 * Refresh the postdominator tree depths in reverse DFS order. The immediate postdominator
+	 * always comes first so its depth is already correct
 	 */
-	function_exit_block->dominator_info.immediate_postdominator = NULL;
+	for(int32_t i = 1; i < current_reverse_dfs_number; i++){
+		basic_block_t* working_block = reverse_dfs_number_to_vertex_mapping[i];
+		working_block->analysis->dominator_info.postdominator_depth = working_block->analysis->dominator_info.immediate_postdominator->analysis->dominator_info.postdominator_depth + 1;
+	}
 
 	//Release the memory now that we're done
 	free(reverse_dfs_number_to_vertex_mapping);
+	free(bucket_heads);
+	free(bucket_next);
+}
+
+
+/**
+ * Compute the immediate postdominators for every block in the function from scratch
+ */
+static void compute_immediate_postdominators(basic_block_t* function_exit_block, dynamic_array_t* function_blocks){
+	//Extract the number of blocks that we have 
+	const int32_t number_of_blocks = function_blocks->current_index;
+
+	/**
+	 * The first thing that we need to do is initialize every block for IPDOM calculation
+	 */
+	for(int32_t i = 0; i < number_of_blocks; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+		initialize_block_for_ipdom_computation(block);
+	}
+
+	//The exit is the root of the tree
+	function_exit_block->analysis->dominator_info.postdominator_depth = 0;
+
+	//Let the helper compute everything
+	compute_immediate_postdominators_from_root(function_exit_block, FALSE, number_of_blocks);
+
+	/**
+	 * By definition, the exit block may have no immediate postdominator
+	 */
+	function_exit_block->analysis->dominator_info.immediate_postdominator = NULL;
 }
 
 
@@ -857,13 +1037,13 @@ static void compute_immediate_postdominators(basic_block_t* function_exit_block,
  */
 static inline void add_dominator_child(basic_block_t* dominator, basic_block_t* dominated){
 	//If this is NULL, then we'll allocate it right now
-	if(dominator->dominator_children.internal_array == NULL){
-		dominator->dominator_children = dynamic_array_alloc();
+	if(dominator->analysis->dominator_children.internal_array == NULL){
+		dominator->analysis->dominator_children = dynamic_array_alloc();
 	}
 
 	//If we do not already have this in the dominator children, then we will add it
-	if(dynamic_array_contains(&(dominator->dominator_children), dominated) == NOT_FOUND){
-		dynamic_array_add(&(dominator->dominator_children), dominated);
+	if(dynamic_array_contains(&(dominator->analysis->dominator_children), dominated) == NOT_FOUND){
+		dynamic_array_add(&(dominator->analysis->dominator_children), dominated);
 	}
 }
 
@@ -891,7 +1071,7 @@ static inline void build_dominator_trees(dynamic_array_t* function_blocks){
 		 * we will add this block to the "dominator children" set of said immediate
 		 * dominator
 		 */
-		basic_block_t* immediate_dominator = current->dominator_info.immediate_dominator;
+		basic_block_t* immediate_dominator = current->analysis->dominator_info.immediate_dominator;
 
 		/**
 		 * Now we'll go to the immediate dominator's list and add the dominated block in. Of course,
@@ -910,20 +1090,20 @@ static inline void build_dominator_trees(dynamic_array_t* function_blocks){
  */
 static inline void add_block_to_dominance_frontier(basic_block_t* block, basic_block_t* df_block){
 	//If the dominance frontier hasn't been allocated yet, we'll do that here
-	if(block->dominance_frontier.internal_array == NULL){
-		block->dominance_frontier = dynamic_array_alloc();
+	if(block->analysis->dominance_frontier.internal_array == NULL){
+		block->analysis->dominance_frontier = dynamic_array_alloc();
 	}
 
 	//Let's just check - is this already in there. If it is, we will not add it
-	for(int32_t i = 0; i < block->dominance_frontier.current_index; i++){
+	for(int32_t i = 0; i < block->analysis->dominance_frontier.current_index; i++){
 		//This is not a problem at all, we just won't add it
-		if(block->dominance_frontier.internal_array[i] == df_block){
+		if(block->analysis->dominance_frontier.internal_array[i] == df_block){
 			return;
 		}
 	}
 
 	//Add this into the dominance frontier
-	dynamic_array_add(&(block->dominance_frontier), df_block);
+	dynamic_array_add(&(block->analysis->dominance_frontier), df_block);
 }
 
 
@@ -965,7 +1145,7 @@ static inline void calculate_dominance_frontiers(dynamic_array_t* function_block
 			basic_block_t* cursor = dynamic_array_get_at(&(block->predecessors), j);
 
 			//While cursor is not the immediate dominator of block
-			while(cursor != block->dominator_info.immediate_dominator){
+			while(cursor != block->analysis->dominator_info.immediate_dominator){
 				//Add block to cursor's dominance frontier set
 				add_block_to_dominance_frontier(cursor, block);
 				
@@ -973,7 +1153,7 @@ static inline void calculate_dominance_frontiers(dynamic_array_t* function_block
 				 * Cursor now becomes it's own immediate dominator, and
 				 * we crawl our way up the CFG
 				 */
-				cursor = cursor->dominator_info.immediate_dominator;
+				cursor = cursor->analysis->dominator_info.immediate_dominator;
 			}
 		}
 	}
@@ -985,19 +1165,19 @@ static inline void calculate_dominance_frontiers(dynamic_array_t* function_block
  */
 static inline void add_block_to_reverse_dominance_frontier(basic_block_t* block, basic_block_t* rdf_block){
 	//If the dominance frontier hasn't been allocated yet, we'll do that here
-	if(block->reverse_dominance_frontier.internal_array == NULL){
-		block->reverse_dominance_frontier = dynamic_array_alloc();
+	if(block->analysis->reverse_dominance_frontier.internal_array == NULL){
+		block->analysis->reverse_dominance_frontier = dynamic_array_alloc();
 	}
 
 	//Let's just check - is this already in there. If it is, we will not add it
-	for(int32_t i = 0; i < block->reverse_dominance_frontier.current_index; i++){
-		if(block->reverse_dominance_frontier.internal_array[i] == rdf_block){
+	for(int32_t i = 0; i < block->analysis->reverse_dominance_frontier.current_index; i++){
+		if(block->analysis->reverse_dominance_frontier.internal_array[i] == rdf_block){
 			return;
 		}
 	}
 
 	//Add this into the dominance frontier
-	dynamic_array_add(&(block->reverse_dominance_frontier), rdf_block);
+	dynamic_array_add(&(block->analysis->reverse_dominance_frontier), rdf_block);
 }
 
 
@@ -1040,7 +1220,7 @@ static inline void calculate_reverse_dominance_frontiers(dynamic_array_t* functi
 			basic_block_t* cursor = dynamic_array_get_at(&(block->successors), j);
 
 			//While cursor is not the immediate postdominator of block
-			while(cursor != block->dominator_info.immediate_postdominator){
+			while(cursor != block->analysis->dominator_info.immediate_postdominator){
 				//Add block to cursor's reverse dominance frontier set
 				add_block_to_reverse_dominance_frontier(cursor, block);
 				
@@ -1048,7 +1228,7 @@ static inline void calculate_reverse_dominance_frontiers(dynamic_array_t* functi
 				 * Cursor now becomes it's own immediate postdominator, and
 				 * we crawl our way down the CFG
 				 */
-				cursor = cursor->dominator_info.immediate_postdominator;
+				cursor = cursor->analysis->dominator_info.immediate_postdominator;
 			}
 		}
 	}
@@ -1060,12 +1240,12 @@ static inline void calculate_reverse_dominance_frontiers(dynamic_array_t* functi
  */
 static void post_order_traversal_rec(dynamic_array_t* post_order_traversal, basic_block_t* entry){
 	//If we've visited this one before, skip
-	if(entry->visited == TRUE){
+	if(is_block_visited(entry) == TRUE){
 		return;
 	}
 
 	//Otherwise mark that we've visited
-	entry->visited = TRUE;
+	mark_block_visited(entry);
 
 	//Run through every successor
 	for(int32_t i = 0; i < entry->successors.current_index; i++){
@@ -1083,9 +1263,9 @@ static void post_order_traversal_rec(dynamic_array_t* post_order_traversal, basi
  * specifically in branch reduction in the optimizer/postprocessor. In this case,
  * we'll need a pre-allocated dynamic array to be passed in
  */
-void get_post_order_traversal(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, dynamic_array_t* post_order_traversal){
+void get_post_order_traversal(basic_block_t* function_entry_block, dynamic_array_t* post_order_traversal){
 	//Reset the visited status
-	reset_visit_status_for_function(function_blocks);
+	reset_block_visits_for_function(function_entry_block->function_defined_in);
 
 	//Seed the recursive helper with the entry block and let it do the rest
 	post_order_traversal_rec(post_order_traversal, function_entry_block);
@@ -1099,12 +1279,12 @@ void get_post_order_traversal(dynamic_array_t* function_blocks, basic_block_t* f
  */
 static void reverse_post_order_traversal_reverse_cfg_rec(heap_stack_t* stack, basic_block_t* block){
 	//If we've already seen this then we're done
-	if(block->visited == TRUE){
+	if(is_block_visited(block) == TRUE){
 		return;
 	}
 
 	//Mark it as visited
-	block->visited = TRUE;
+	mark_block_visited(block);
 
 	//For every child(predecessor-it's reverse), we visit it as well
 	for(int32_t i = 0; i < block->predecessors.current_index; i++){
@@ -1120,12 +1300,12 @@ static void reverse_post_order_traversal_reverse_cfg_rec(heap_stack_t* stack, ba
  * Get the reverse post order traversal over the reverse CFG(successors are predecessors and vice versa). This on-demand traversal
  * grabber requires a pre-allocated array to be passed in that will store the traversal
  */
-void get_reverse_post_order_reverse_cfg_traversal(dynamic_array_t* function_blocks, basic_block_t* function_exit_block, dynamic_array_t* reverse_post_order_traversal){
+void get_reverse_post_order_reverse_cfg_traversal(basic_block_t* function_exit_block, dynamic_array_t* reverse_post_order_traversal){
 	//Relies on a stack for traversal
 	heap_stack_t stack = heap_stack_alloc();
 
 	//Wipe the status for all of these blocks
-	reset_visit_status_for_function(function_blocks);
+	reset_block_visits_for_function(function_exit_block->function_defined_in);
 
 	//Seed the recursive traversal with the exit block and let it run
 	reverse_post_order_traversal_reverse_cfg_rec(&stack, function_exit_block);
@@ -1180,16 +1360,16 @@ void get_reverse_post_order_reverse_cfg_traversal(dynamic_array_t* function_bloc
  */
 basic_block_t* get_nearest_marked_postdominator(basic_block_t* block){
 	//We seed the search with the first(closest) dominator that we have
-	basic_block_t* cursor = block->dominator_info.immediate_postdominator;
+	basic_block_t* cursor = block->analysis->dominator_info.immediate_postdominator;
 
 	while(cursor != NULL){
 		//This block contains a mark, so we give it back
-		if(cursor->contains_mark == TRUE){
+		if(does_block_contain_mark(cursor) == TRUE){
 			return cursor;
 		}
 
 		//Otherwise, climb the tree by going up to this one's IPDOM
-		cursor = cursor->dominator_info.immediate_postdominator;
+		cursor = cursor->analysis->dominator_info.immediate_postdominator;
 	}
 
 	/**
@@ -1200,6 +1380,15 @@ basic_block_t* get_nearest_marked_postdominator(basic_block_t* block){
 }
 
 
+/**
+ * Does the dominator block dominate the given block? This is the same subtree check
+ * that the incremental updater uses, we just expose it for the optimizer
+ */
+u_int8_t does_block_dominate(basic_block_t* dominator, basic_block_t* block){
+	return is_in_dominator_subtree(block, dominator);
+}
+
+
 /**
  * We will calculate:
  *  1.) Immediate dominators
@@ -1258,6 +1447,24 @@ void calculate_all_control_flow_relations_for_function(basic_block_t* function_e
 }
 
 
+/**
+ * Get rid of a block's dominator children and both of its frontiers
+ */
+static inline void reset_dominator_tree_and_frontiers(basic_block_t* block){
+	if(block->analysis->dominance_frontier.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->dominance_frontier));
+	}
+
+	if(block->analysis->reverse_dominance_frontier.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->reverse_dominance_frontier));
+	}
+
+	if(block->analysis->dominator_children.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->dominator_children));
+	}
+}
+
+
 /**
  * Destroy all old control relations in anticipation of new ones coming in. This 
  * operates on a per-function level
@@ -1273,16 +1480,916 @@ void cleanup_all_control_relations(dynamic_array_t* function_blocks){
 		//Wipe the immediate dominator slate clean
 		initialize_block_for_idom_computation(block);
 
-		if(block->dominance_frontier.internal_array != NULL){
-			dynamic_array_dealloc(&(block->dominance_frontier));
+		//And get rid of everything derived from it
+		reset_dominator_tree_and_frontiers(block);
+	}
+}
+
+
+/**
+ * Allocate an empty control flow update log
+ */
+control_flow_update_log_t control_flow_update_log_alloc(){
+	control_flow_update_log_t log;
+
+	log.current_index = 0;
+	log.current_max_size = DEFAULT_CONTROL_FLOW_UPDATE_LOG_SIZE;
+	log.updates = calloc(log.current_max_size, sizeof(control_flow_update_t));
+
+	return log;
+}
+
+
+/**
+ * Record an edit that has been made to the CFG. A NULL log is allowed, and
+ * in that case nothing is recorded
+ */
+void record_control_flow_update(control_flow_update_log_t* log, basic_block_t* source, basic_block_t* target, control_flow_update_type_t update_type){
+	//Nobody is tracking the edits so we're done
+	if(log == NULL){
+		return;
+	}
+
+	//Double the size if we're out of room
+	if(log->current_index == log->current_max_size){
+		log->current_max_size *= 2;
+		log->updates = realloc(log->updates, log->current_max_size * sizeof(control_flow_update_t));
+	}
+
+	control_flow_update_t* update = &(log->updates[log->current_index]);
+	update->source = source;
+	update->target = target;
+	update->update_type = update_type;
+
+	log->current_index++;
+}
+
+
+/**
+ * Was this block removed from the function since the last time the
+ * control relations were computed?
+ */
+static inline u_int8_t is_block_removed(basic_block_t* block){
+	return block->analysis->dominator_info.dfs_number == LT_REMOVED ? TRUE : FALSE;
+}
+
+
+/**
+ * Add a root into our list of subtrees that need to be recomputed. We
+ * don't want to see the same one twice
+ */
+static inline void add_subtree_root(dynamic_array_t* subtree_roots, basic_block_t* root){
+	if(dynamic_array_contains(subtree_roots, root) == NOT_FOUND){
+		dynamic_array_add(subtree_roots, root);
+	}
+}
+
+
+/**
+ * If one subtree root is inside of another root's subtree, then recomputing the outer
+ * subtree already covers it. We get rid of all of these nested roots here, so that no part
+ * of the tree is done twice and the remaining subtrees are all disjoint
+ */
+static void remove_nested_subtree_roots(dynamic_array_t* subtree_roots, u_int8_t is_postdominator_tree){
+	for(int32_t i = subtree_roots->current_index - 1; i >= 0; i--){
+		basic_block_t* root = dynamic_array_get_at(subtree_roots, i);
+
+		for(int32_t j = 0; j < subtree_roots->current_index; j++){
+			basic_block_t* other_root = dynamic_array_get_at(subtree_roots, j);
+
+			//Don't compare against ourselves
+			if(other_root == root){
+				continue;
+			}
+
+			u_int8_t is_nested = is_postdominator_tree == TRUE ? is_in_postdominator_subtree(root, other_root) : is_in_dominator_subtree(root, other_root);
+
+			//This one is covered by the other, so it's out
+			if(is_nested == TRUE){
+				dynamic_array_delete_at(subtree_roots, i);
+				break;
+			}
 		}
+	}
+}
+
+
+/**
+ * Patch up the immediate dominators after the edits in the log have been made
+ *
+ * For an edge x -> y being inserted or deleted, the only blocks whose immediate dominators
+ * can change are those inside of the dominator subtree of NCD(x, y), the nearest common dominator
+ * of x and y. If NCD(x, y) is y itself, then the edge is a back edge to a dominator and nothing
+ * changes at all. When a block is removed, we treat that as every edge out of it to a block that is
+ * still around being deleted
+ *
+ * Since every edge into a dominator subtree has to come in through its root, we can rerun Lengauer-Tarjan
+ * on just that subtree with the root standing in for the entry
+ *
+ * Algorithm update_immediate_dominators(log):
+ * 	for each edit x -> y in the log:
+ * 		if the edit doesn't touch the reachable part of the CFG:
+ * 			continue
+ *
+ * 		if y was unreachable and now isn't:
+ * 			give up and recompute everything
+ *
+ * 		root = NCD(x, y)
+ * 		if root != y:
+ * 			add root to the subtree roots
+ *
+ * 	remove all subtree roots that are nested inside of other ones
+ *
+ * 	for each subtree root:
+ * 		rerun Lengauer-Tarjan over the root's subtree
+ *
+ * This returns TRUE if we need to fall back to recomputing everything
+ */
+static u_int8_t update_immediate_dominators(basic_block_t* function_entry_block, int32_t number_of_blocks, control_flow_update_log_t* log){
+	//Do we need to give up and recompute everything?
+	u_int8_t requires_full_recomputation = FALSE;
+
+	//All of the roots of subtrees that we need to recompute
+	dynamic_array_t subtree_roots = dynamic_array_alloc();
+
+	for(u_int32_t i = 0; i < log->current_index; i++){
+		control_flow_update_t* update = &(log->updates[i]);
+		basic_block_t* source = update->source;
+		basic_block_t* target = update->target;
+
+		/**
+		 * Any block that is not the entry and has no immediate dominator
+		 * was unreachable the last time we computed this
+		 */
+		u_int8_t source_in_tree = (source == function_entry_block || source->analysis->dominator_info.immediate_dominator != NULL) ? TRUE : FALSE;
+
+		switch(update->update_type){
+			/**
+			 * Every edge from this block out to a block that's still around
+			 * is effectively deleted
+			 */
+			case CONTROL_FLOW_BLOCK_REMOVED:
+				if(source_in_tree == FALSE){
+					break;
+				}
+
+				for(int32_t j = 0; j < source->successors.current_index; j++){
+					basic_block_t* successor = dynamic_array_get_at(&(source->successors), j);
+
+					if(is_block_removed(successor) == TRUE){
+						continue;
+					}
+
+					add_subtree_root(&subtree_roots, nearest_common_dominator(source, successor));
+				}
 
-		if(block->reverse_dominance_frontier.internal_array != NULL){
-			dynamic_array_dealloc(&(block->reverse_dominance_frontier));
+				break;
+
+			/**
+			 * If the target is gone, then the block removal entries will account for
+			 * everything that it used to lead to
+			 */
+			case CONTROL_FLOW_EDGE_DELETED:
+				if(source_in_tree == FALSE || is_block_removed(target) == TRUE
+					|| (target != function_entry_block && target->analysis->dominator_info.immediate_dominator == NULL)){
+					break;
+				}
+
+				//Back edges to a dominator have no effect
+				if(nearest_common_dominator(source, target) != target){
+					add_subtree_root(&subtree_roots, nearest_common_dominator(source, target));
+				}
+
+				break;
+
+			case CONTROL_FLOW_EDGE_INSERTED:
+				//An edge out of an unreachable block changes nothing
+				if(source_in_tree == FALSE || is_block_removed(source) == TRUE || is_block_removed(target) == TRUE){
+					break;
+				}
+
+				//We've made something reachable that was not before. This is rare enough that we don't handle it
+				if(target != function_entry_block && target->analysis->dominator_info.immediate_dominator == NULL){
+					requires_full_recomputation = TRUE;
+					break;
+				}
+
+				//Back edges to a dominator have no effect
+				if(nearest_common_dominator(source, target) != target){
+					add_subtree_root(&subtree_roots, nearest_common_dominator(source, target));
+				}
+
+				break;
 		}
+	}
 
-		if(block->dominator_children.internal_array != NULL){
-			dynamic_array_dealloc(&(block->dominator_children));
+	/**
+	 * Now recompute each disjoint subtree on its own. The subtree roots
+	 * have to be pruned before any of them is recomputed because pruning
+	 * relies on the old tree
+	 */
+	if(requires_full_recomputation == FALSE){
+		remove_nested_subtree_roots(&subtree_roots, FALSE);
+
+		for(int32_t i = 0; i < subtree_roots.current_index; i++){
+			basic_block_t* root = dynamic_array_get_at(&subtree_roots, i);
+
+			//Should never happen, but a removed root would lead us into blocks that are gone
+			if(is_block_removed(root) == TRUE){
+				requires_full_recomputation = TRUE;
+				break;
+			}
+
+			compute_immediate_dominators_from_root(root, TRUE, number_of_blocks);
 		}
 	}
+
+	dynamic_array_dealloc(&subtree_roots);
+
+	return requires_full_recomputation;
+}
+
+
+/**
+ * Patch up the immediate postdominators after the edits in the log have been made
+ *
+ * This is the same idea as the dominator version, just on the reverse CFG with the exit as the root. An
+ * edge x -> y is y -> x in the reverse CFG, so the subtree that we need is the one rooted at NCPD(x, y), and
+ * the edge has no effect if NCPD(x, y) is x
+ *
+ * Removed blocks can't reach anything that's still reachable from the entry, so they have no say in the
+ * postdominators of what's left. What we do need to watch out for is a deleted edge that cuts a block off from
+ * the exit(think of a loop that can now never be left). If every deleted edge's source can still reach the
+ * exit, then so can everything else. We check for that after the fact, and fall back to recomputing everything
+ * if any source has been cut off
+ *
+ * This returns TRUE if we need to fall back to recomputing everything
+ */
+static u_int8_t update_immediate_postdominators(basic_block_t* function_exit_block, int32_t number_of_blocks, control_flow_update_log_t* log){
+	//Do we need to give up and recompute everything?
+	u_int8_t requires_full_recomputation = FALSE;
+
+	//All of the roots of subtrees that we need to recompute
+	dynamic_array_t subtree_roots = dynamic_array_alloc();
+
+	//All of the blocks that must still be able to reach the exit
+	dynamic_array_t deleted_edge_sources = dynamic_array_alloc();
+
+	for(u_int32_t i = 0; i < log->current_index; i++){
+		control_flow_update_t* update = &(log->updates[i]);
+		basic_block_t* source = update->source;
+		basic_block_t* target = update->target;
+
+		//Removed blocks have nothing to do with the postdominators of everything else
+		if(update->update_type == CONTROL_FLOW_BLOCK_REMOVED || is_block_removed(source) == TRUE){
+			continue;
+		}
+
+		/**
+		 * Any block that is not the exit and has no immediate postdominator
+		 * could not reach the exit the last time we computed this
+		 */
+		u_int8_t source_in_tree = (source == function_exit_block || source->analysis->dominator_info.immediate_postdominator != NULL) ? TRUE : FALSE;
+		u_int8_t target_in_tree = (target == function_exit_block || target->analysis->dominator_info.immediate_postdominator != NULL) ? TRUE : FALSE;
+
+		//If the target can't reach the exit, this edge is meaningless in the reverse CFG
+		if(target_in_tree == FALSE){
+			continue;
+		}
+
+		//We've allowed a block to reach the exit when it could not before. This is rare so we don't handle it
+		if(source_in_tree == FALSE){
+			if(update->update_type == CONTROL_FLOW_EDGE_INSERTED){
+				requires_full_recomputation = TRUE;
+			}
+
+			continue;
+		}
+
+		basic_block_t* root = nearest_common_postdominator(source, target);
+
+		//This is the reverse CFG version of a back edge to a dominator, so it has no effect
+		if(root == source){
+			continue;
+		}
+
+		add_subtree_root(&subtree_roots, root);
+
+		//We'll need to verify that these can still reach the exit
+		if(update->update_type == CONTROL_FLOW_EDGE_DELETED){
+			dynamic_array_add(&deleted_edge_sources, source);
+		}
+	}
+
+	if(requires_full_recomputation == FALSE){
+		remove_nested_subtree_roots(&subtree_roots, TRUE);
+
+		/**
+		 * Every deleted edge source is inside of some subtree that we're about to recompute, so if it
+		 * can still reach the exit it's going to be given a DFS number. We wipe the numbers out
+		 * now so that we can tell afterwards
+		 */
+		for(int32_t i = 0; i < deleted_edge_sources.current_index; i++){
+			basic_block_t* source = dynamic_array_get_at(&deleted_edge_sources, i);
+			source->analysis->dominator_info.dfs_number = LT_UNNUMBERED;
+		}
+
+		for(int32_t i = 0; i < subtree_roots.current_index; i++){
+			basic_block_t* root = dynamic_array_get_at(&subtree_roots, i);
+
+			//A removed root would lead us into blocks that are gone
+			if(is_block_removed(root) == TRUE){
+				requires_full_recomputation = TRUE;
+				break;
+			}
+
+			compute_immediate_postdominators_from_root(root, TRUE, number_of_blocks);
+		}
+
+		//If any one of these never got numbered, it's been cut off from the exit
+		for(int32_t i = 0; i < deleted_edge_sources.current_index; i++){
+			basic_block_t* source = dynamic_array_get_at(&deleted_edge_sources, i);
+
+			if(source->analysis->dominator_info.dfs_number == LT_UNNUMBERED){
+				requires_full_recomputation = TRUE;
+				break;
+			}
+		}
+	}
+
+	dynamic_array_dealloc(&subtree_roots);
+	dynamic_array_dealloc(&deleted_edge_sources);
+
+	return requires_full_recomputation;
+}
+
+
+/**
+ * Bring all control relations for a function up to date after the edits in the log
+ * have been made. Only the parts of the dominator and postdominator trees that
+ * the edits could have touched are recomputed. The log is emptied once we're done
+ *
+ * The dominator trees and both frontiers are cheap to derive from the immediate
+ * dominators and postdominators, so those are simply rebuilt
+ */
+void update_all_control_flow_relations_for_function(basic_block_t* function_entry_block, basic_block_t* function_exit_block, dynamic_array_t* function_blocks, control_flow_update_log_t* log){
+	//Nothing changed, so nothing to do
+	if(log->current_index == 0){
+		return;
+	}
+
+	const int32_t number_of_blocks = function_blocks->current_index;
+
+	/**
+	 * Flag all of the removed blocks so that we can recognize them. Removed blocks are
+	 * no longer connected to anything so they will never be renumbered
+	 */
+	for(u_int32_t i = 0; i < log->current_index; i++){
+		if(log->updates[i].update_type == CONTROL_FLOW_BLOCK_REMOVED){
+			log->updates[i].source->analysis->dominator_info.dfs_number = LT_REMOVED;
+		}
+	}
+
+	/**
+	 * Patch up the immediate dominators, and if the helper can't handle
+	 * it we'll recompute them all
+	 */
+	if(update_immediate_dominators(function_entry_block, number_of_blocks, log) == TRUE){
+		compute_immediate_dominators(function_entry_block, function_blocks);
+	}
+
+	/**
+	 * Same thing for the immediate postdominators
+	 */
+	if(update_immediate_postdominators(function_exit_block, number_of_blocks, log) == TRUE){
+		compute_immediate_postdominators(function_exit_block, function_blocks);
+	}
+
+	//Wipe out the old dominator trees and frontiers
+	for(int32_t i = 0; i < number_of_blocks; i++){
+		reset_dominator_tree_and_frontiers(dynamic_array_get_at(function_blocks, i));
+	}
+
+	//Now rebuild them from the updated immediate dominators and postdominators
+	build_dominator_trees(function_blocks);
+	calculate_dominance_frontiers(function_blocks);
+	calculate_reverse_dominance_frontiers(function_blocks);
+
+	//Everything in the log has now been accounted for
+	log->current_index = 0;
+}
+
+
+/**
+ * Throw away everything in the log. This is for when the control relations
+ * are about to be recomputed from scratch anyways
+ */
+void reset_control_flow_update_log(control_flow_update_log_t* log){
+	log->current_index = 0;
+}
+
+
+/**
+ * Deallocate a control flow update log
+ */
+void control_flow_update_log_dealloc(control_flow_update_log_t* log){
+	free(log->updates);
+	log->updates = NULL;
+	log->current_index = 0;
+	log->current_max_size = 0;
+}
+
+
+/**
+ * Sort comparator that puts larger loops first. A loop that contains another
+ * loop always has strictly more blocks than it, so this puts every loop ahead
+ * of the loops that it contains
+ */
+static int compare_loops_by_size(const void* a, const void* b){
+	const natural_loop_t* loop_a = *(natural_loop_t* const*)a;
+	const natural_loop_t* loop_b = *(natural_loop_t* const*)b;
+
+	return loop_b->blocks.current_index - loop_a->blocks.current_index;
+}
+
+
+/**
+ * Find the body of the natural loop for the given back edge. We crawl backwards from
+ * the back edge source until we run into the header. The header is already in the loop
+ * before we start, so the crawl can never escape past it
+ */
+static void collect_natural_loop_blocks(natural_loop_t* loop, basic_block_t* back_edge_source, u_int8_t* in_loop, dynamic_array_t* worklist){
+	dynamic_array_add(worklist, back_edge_source);
+
+	while(dynamic_array_is_empty(worklist) == FALSE){
+		basic_block_t* block = dynamic_array_delete_from_back(worklist);
+
+		//Already seen this one
+		if(in_loop[block->function_block_index] == TRUE){
+			continue;
+		}
+
+		in_loop[block->function_block_index] = TRUE;
+		dynamic_array_add(&(loop->blocks), block);
+
+		//Everything that leads into a loop block(besides the header) is in the loop too
+		for(int32_t i = 0; i < block->predecessors.current_index; i++){
+			dynamic_array_add(worklist, dynamic_array_get_at(&(block->predecessors), i));
+		}
+	}
+}
+
+
+/**
+ * Find every natural loop in a function and nest them.
+ *
+ * Algorithm build_loop_nest_forest:
+ * 	for each block H:
+ * 		for each predecessor B of H:
+ * 			if H dominates B then:
+ * 				B -> H is a back edge, add the natural loop of B -> H into H's loop
+ *
+ * 	sort the loops from largest to smallest
+ *
+ * 	for each loop L in that order:
+ * 		parent(L) = innermost loop seen so far that holds the header of L
+ * 		for each block B in L:
+ * 			innermost(B) = L
+ *
+ * Because we go from largest to smallest, by the time we get to a loop the innermost
+ * loop of its header is always the closest loop that contains it
+ */
+loop_nest_forest_t build_loop_nest_forest(dynamic_array_t* function_blocks, u_int32_t number_of_block_indices){
+	loop_nest_forest_t forest;
+	forest.loops = dynamic_array_alloc();
+	forest.number_of_block_indices = number_of_block_indices;
+	forest.innermost_loops = calloc(number_of_block_indices, sizeof(natural_loop_t*));
+
+	//Scratch space for the crawls
+	u_int8_t* in_loop = calloc(number_of_block_indices, sizeof(u_int8_t));
+	dynamic_array_t worklist = dynamic_array_alloc();
+
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* header = dynamic_array_get_at(function_blocks, i);
+		natural_loop_t* loop = NULL;
+
+		for(int32_t j = 0; j < header->predecessors.current_index; j++){
+			basic_block_t* predecessor = dynamic_array_get_at(&(header->predecessors), j);
+
+			//Not a back edge
+			if(does_block_dominate(header, predecessor) == FALSE){
+				continue;
+			}
+
+			//First back edge into this header, so we make the loop
+			if(loop == NULL){
+				loop = calloc(1, sizeof(natural_loop_t));
+				loop->header = header;
+				loop->blocks = dynamic_array_alloc();
+				loop->latches = dynamic_array_alloc();
+
+				in_loop[header->function_block_index] = TRUE;
+				dynamic_array_add(&(loop->blocks), header);
+			}
+
+			dynamic_array_add(&(loop->latches), predecessor);
+			collect_natural_loop_blocks(loop, predecessor, in_loop, &worklist);
+		}
+
+		if(loop == NULL){
+			continue;
+		}
+
+		//Wipe the scratch flags for the next header
+		for(int32_t j = 0; j < loop->blocks.current_index; j++){
+			basic_block_t* block = dynamic_array_get_at(&(loop->blocks), j);
+			in_loop[block->function_block_index] = FALSE;
+		}
+
+		dynamic_array_add(&(forest.loops), loop);
+	}
+
+	//Largest first
+	if(forest.loops.current_index > 1){
+		qsort(forest.loops.internal_array, forest.loops.current_index, sizeof(natural_loop_t*), compare_loops_by_size);
+	}
+
+	//Now nest them
+	for(int32_t i = 0; i < forest.loops.current_index; i++){
+		natural_loop_t* loop = dynamic_array_get_at(&(forest.loops), i);
+
+		loop->parent = forest.innermost_loops[loop->header->function_block_index];
+		loop->depth = loop->parent == NULL ? 1 : loop->parent->depth + 1;
+
+		for(int32_t j = 0; j < loop->blocks.current_index; j++){
+			basic_block_t* block = dynamic_array_get_at(&(loop->blocks), j);
+			forest.innermost_loops[block->function_block_index] = loop;
+		}
+	}
+
+	free(in_loop);
+	dynamic_array_dealloc(&worklist);
+
+	return forest;
+}
+
+
+/**
+ * Is the given block inside of the given loop? We climb from the innermost
+ * loop of the block out until we find the loop or run out of parents
+ */
+u_int8_t is_block_in_loop(loop_nest_forest_t* forest, natural_loop_t* loop, basic_block_t* block){
+	//This block came after the forest was built, so it can't be in it
+	if(block->function_block_index >= forest->number_of_block_indices){
+		return FALSE;
+	}
+
+	natural_loop_t* cursor = forest->innermost_loops[block->function_block_index];
+
+	while(cursor != NULL){
+		if(cursor == loop){
+			return TRUE;
+		}
+
+		cursor = cursor->parent;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Deallocate a loop nest forest and every loop inside of it
+ */
+void loop_nest_forest_dealloc(loop_nest_forest_t* forest){
+	for(int32_t i = 0; i < forest->loops.current_index; i++){
+		natural_loop_t* loop = dynamic_array_get_at(&(forest->loops), i);
+
+		dynamic_array_dealloc(&(loop->blocks));
+		dynamic_array_dealloc(&(loop->latches));
+		free(loop);
+	}
+
+	dynamic_array_dealloc(&(forest->loops));
+	free(forest->innermost_loops);
+	forest->innermost_loops = NULL;
+}
+
+
+/**
+ * A control flow edge that the block layout may try to turn into
+ * a fall through
+ */
+typedef struct{
+	basic_block_t* source;
+	basic_block_t* target;
+	//How often we think that this edge is taken
+	u_int64_t weight;
+	//When we found this edge. Ties go to the edge found first
+	u_int32_t discovery_order;
+} layout_edge_t;
+
+
+/**
+ * Which successor would this block like to fall through to? This is the target of
+ * the unconditional jump that the block ends in. For a branch that's the else block,
+ * since the if block is reached by the conditional jump
+ */
+static basic_block_t* get_preferred_fall_through(basic_block_t* block, block_layout_stage_t stage){
+	instruction_t* exit_statement = block->exit_statement;
+
+	if(exit_statement == NULL){
+		return NULL;
+	}
+
+	if(stage == BLOCK_LAYOUT_BEFORE_INSTRUCTION_SELECTION){
+		switch(exit_statement->statement_type){
+			case THREE_ADDR_CODE_JUMP_STMT:
+				return exit_statement->if_block;
+			case THREE_ADDR_CODE_BRANCH_STMT:
+				return exit_statement->else_block;
+			default:
+				return NULL;
+		}
+	}
+
+	//After selection, the jump to the else block has already been split off
+	if(exit_statement->instruction_type == JMP){
+		return exit_statement->if_block;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Does this block raise an error out of the function? Those are the paths that
+ * we assume are never taken
+ */
+static inline u_int8_t does_block_raise_error(basic_block_t* block, block_layout_stage_t stage){
+	instruction_t* exit_statement = block->exit_statement;
+
+	if(exit_statement == NULL){
+		return FALSE;
+	}
+
+	if(stage == BLOCK_LAYOUT_BEFORE_INSTRUCTION_SELECTION){
+		return exit_statement->statement_type == THREE_ADDR_CODE_RAISE_STMT ? TRUE : FALSE;
+	}
+
+	return exit_statement->instruction_type == RAISE_INSTRUCTION ? TRUE : FALSE;
+}
+
+
+/**
+ * Ordering function for qsort. Heavier edges come first, and edges of the
+ * same weight stay in the order that we found them
+ */
+static int compare_layout_edges(const void* a, const void* b){
+	const layout_edge_t* edge_a = a;
+	const layout_edge_t* edge_b = b;
+
+	if(edge_a->weight != edge_b->weight){
+		return edge_a->weight > edge_b->weight ? -1 : 1;
+	}
+
+	if(edge_a->discovery_order != edge_b->discovery_order){
+		return edge_a->discovery_order < edge_b->discovery_order ? -1 : 1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Lay out every block that is reachable from the function entry into one chain through the
+ * direct successor field. This is a bottom-up Pettis-Hansen style layout:
+ *
+ * 1.) Find every block with a breadth first search. This order is what breaks all ties, so when
+ * 	   we know nothing about frequencies we lay things out just like a plain breadth first search would
+ * 2.) Flag the cold blocks. A block that raises an error is cold, and so is any block whose every
+ * 	   successor is cold
+ * 3.) Weigh every edge by how often we think it's taken. We only have block frequencies, so an edge
+ * 	   is taken as often as the less frequent of its two ends. Edges into cold blocks weigh nothing
+ * 4.) Going from the heaviest edge down, glue the source's chain onto the target's chain whenever the
+ * 	   source ends its chain and the target starts its own. Loop bodies are the heaviest edges in the
+ * 	   function, so they always end up contiguous
+ * 5.) Place the chains. We start with the entry's chain, and then keep taking the chain with the heaviest
+ * 	   edge coming in from what we've already placed. Cold chains always go last
+ */
+void lay_out_function_blocks(basic_block_t* function_entry_block, block_layout_stage_t stage){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+
+	//Every side table is indexed by the function block index
+	u_int32_t number_of_block_indices = function->number_of_block_indices;
+	basic_block_t** chain_heads = calloc(number_of_block_indices, sizeof(basic_block_t*));
+	basic_block_t** chain_tails = calloc(number_of_block_indices, sizeof(basic_block_t*));
+	u_int8_t* cold_blocks = calloc(number_of_block_indices, sizeof(u_int8_t));
+	u_int8_t* placed_chains = calloc(number_of_block_indices, sizeof(u_int8_t));
+
+	/**
+	 * Step 1: find everything with a breadth first search. The block array doubles as our queue. Just like
+	 * the old ordering, the preferred fall through goes in first and completely empty successors(the function
+	 * exit) are never laid out
+	 */
+	dynamic_array_t blocks = dynamic_array_alloc();
+	u_int32_t number_of_edges = 0;
+
+	reset_block_visits_for_function(function);
+
+	dynamic_array_add(&blocks, function_entry_block);
+	mark_block_visited(function_entry_block);
+
+	for(int32_t i = 0; i < blocks.current_index; i++){
+		basic_block_t* current = dynamic_array_get_at(&blocks, i);
+
+		//Whatever ordering this block had before is gone
+		current->direct_successor = NULL;
+		chain_heads[current->function_block_index] = current;
+		chain_tails[current->function_block_index] = current;
+
+		basic_block_t* preferred = get_preferred_fall_through(current, stage);
+		if(preferred != NULL && is_block_visited(preferred) == FALSE){
+			dynamic_array_add(&blocks, preferred);
+			mark_block_visited(preferred);
+		}
+
+		for(int32_t j = 0; j < current->successors.current_index; j++){
+			basic_block_t* successor = dynamic_array_get_at(&(current->successors), j);
+
+			if(successor->leader_statement == NULL || is_block_visited(successor) == TRUE){
+				continue;
+			}
+
+			dynamic_array_add(&blocks, successor);
+			mark_block_visited(successor);
+		}
+
+		//The preferred fall through is not always in the successor list(infinite loops), so it gets its own slot
+		number_of_edges += current->successors.current_index + 1;
+	}
+
+	/**
+	 * Step 2: flag the cold blocks. We go backwards so that most of the propagation
+	 * happens in one pass, but we still need to go until nothing changes
+	 */
+	for(int32_t i = 0; i < blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&blocks, i);
+		/**
+		 * A frequency of 0 only ever comes from a profile(--profile-use), and means that the
+		 * block never ran. The estimates never go that low on their own
+		 */
+		if(does_block_raise_error(block, stage) == TRUE || block->estimated_execution_frequency == 0){
+			cold_blocks[block->function_block_index] = TRUE;
+		} else {
+			cold_blocks[block->function_block_index] = FALSE;
+		}
+	}
+
+	u_int8_t changed;
+	do {
+		changed = FALSE;
+
+		//The entry can never be moved, so there's no point in it being cold
+		for(int32_t i = blocks.current_index - 1; i > 0; i--){
+			basic_block_t* block = dynamic_array_get_at(&blocks, i);
+
+			if(cold_blocks[block->function_block_index] == TRUE || block->successors.current_index == 0){
+				continue;
+			}
+
+			u_int8_t all_successors_cold = TRUE;
+			for(int32_t j = 0; j < block->successors.current_index; j++){
+				basic_block_t* successor = dynamic_array_get_at(&(block->successors), j);
+
+				if(is_block_visited(successor) == FALSE || cold_blocks[successor->function_block_index] == FALSE){
+					all_successors_cold = FALSE;
+					break;
+				}
+			}
+
+			if(all_successors_cold == TRUE){
+				cold_blocks[block->function_block_index] = TRUE;
+				changed = TRUE;
+			}
+		}
+	} while(changed == TRUE);
+
+	/**
+	 * Step 3: weigh every edge that could become a fall through. A block that ends in an indirect
+	 * jump can't fall through to anything, so it has none
+	 */
+	layout_edge_t* edges = calloc(number_of_edges, sizeof(layout_edge_t));
+	u_int32_t edge_count = 0;
+
+	for(int32_t i = 0; i < blocks.current_index; i++){
+		basic_block_t* source = dynamic_array_get_at(&blocks, i);
+
+		if(source->jump_table != NULL){
+			continue;
+		}
+
+		basic_block_t* preferred = get_preferred_fall_through(source, stage);
+
+		for(int32_t j = -1; j < source->successors.current_index; j++){
+			//The preferred fall through is always considered first
+			basic_block_t* target = j == -1 ? preferred : dynamic_array_get_at(&(source->successors), j);
+
+			if(target == NULL || (j != -1 && target == preferred) || is_block_visited(target) == FALSE){
+				continue;
+			}
+
+			layout_edge_t* edge = &(edges[edge_count]);
+			edge->source = source;
+			edge->target = target;
+			edge->discovery_order = edge_count;
+
+			if(cold_blocks[target->function_block_index] == TRUE && cold_blocks[source->function_block_index] == FALSE){
+				edge->weight = 0;
+			} else if(source->successors.current_index == 1 || target->estimated_execution_frequency > source->estimated_execution_frequency){
+				edge->weight = source->estimated_execution_frequency;
+			} else {
+				edge->weight = target->estimated_execution_frequency;
+			}
+
+			edge_count++;
+		}
+	}
+
+	qsort(edges, edge_count, sizeof(layout_edge_t), compare_layout_edges);
+
+	//Step 4: glue the chains together along the heaviest edges
+	for(u_int32_t i = 0; i < edge_count; i++){
+		basic_block_t* source = edges[i].source;
+		basic_block_t* target = edges[i].target;
+
+		basic_block_t* source_head = chain_heads[source->function_block_index];
+
+		//The source must end its chain, the target must start its own, and they can't be the same chain
+		if(chain_tails[source_head->function_block_index] != source
+			|| chain_heads[target->function_block_index] != target
+			|| source_head == target
+			|| target == function_entry_block){
+			continue;
+		}
+
+		source->direct_successor = target;
+		chain_tails[source_head->function_block_index] = chain_tails[target->function_block_index];
+
+		//Everything in the target's chain now belongs to the source's chain
+		for(basic_block_t* cursor = target; cursor != NULL; cursor = cursor->direct_successor){
+			chain_heads[cursor->function_block_index] = source_head;
+		}
+	}
+
+	/**
+	 * Step 5: place the chains. The entry's chain is always first. After that, the first edge in sorted
+	 * order that goes from a placed chain into an unplaced one is the heaviest connection that we have
+	 */
+	basic_block_t* current_tail = chain_tails[function_entry_block->function_block_index];
+	placed_chains[function_entry_block->function_block_index] = TRUE;
+
+	while(TRUE){
+		basic_block_t* next_head = NULL;
+
+		for(u_int32_t i = 0; i < edge_count; i++){
+			basic_block_t* source_head = chain_heads[edges[i].source->function_block_index];
+			basic_block_t* target_head = chain_heads[edges[i].target->function_block_index];
+
+			if(placed_chains[source_head->function_block_index] == TRUE
+				&& placed_chains[target_head->function_block_index] == FALSE
+				&& cold_blocks[target_head->function_block_index] == FALSE){
+				next_head = target_head;
+				break;
+			}
+		}
+
+		//Nothing hot is connected to us, so we take whatever we found first. Hot chains go before cold ones
+		for(int32_t pass = 0; pass < 2 && next_head == NULL; pass++){
+			for(int32_t i = 0; i < blocks.current_index; i++){
+				basic_block_t* head = chain_heads[((basic_block_t*)dynamic_array_get_at(&blocks, i))->function_block_index];
+
+				if(placed_chains[head->function_block_index] == FALSE && (pass == 1 || cold_blocks[head->function_block_index] == FALSE)){
+					next_head = head;
+					break;
+				}
+			}
+		}
+
+		//Everything has been placed
+		if(next_head == NULL){
+			break;
+		}
+
+		placed_chains[next_head->function_block_index] = TRUE;
+		current_tail->direct_successor = next_head;
+		current_tail = chain_tails[next_head->function_block_index];
+	}
+
+	free(edges);
+	free(placed_chains);
+	free(cold_blocks);
+	free(chain_tails);
+	free(chain_heads);
+	dynamic_array_dealloc(&blocks);
 }
@@ -11,18 +11,105 @@
 //Link to the CFG
 #include "../cfg/cfg.h"
 
+//The log of control flow edits
+typedef struct control_flow_update_log_t control_flow_update_log_t;
+//An individual control flow edit
+typedef struct control_flow_update_t control_flow_update_t;
+//A natural loop inside of a function
+typedef struct natural_loop_t natural_loop_t;
+//Every natural loop inside of a function
+typedef struct loop_nest_forest_t loop_nest_forest_t;
+
+/**
+ * What kind of edit did a pass make to the CFG? Passes
+ * that rewrite branches report these so that the dominance
+ * relations can be patched up instead of being rebuilt
+ */
+typedef enum{
+	CONTROL_FLOW_EDGE_INSERTED,
+	CONTROL_FLOW_EDGE_DELETED,
+	//The source block was removed from the function entirely
+	CONTROL_FLOW_BLOCK_REMOVED,
+} control_flow_update_type_t;
+
+
+/**
+ * Where in the pipeline are we laying blocks out? Before instruction selection
+ * blocks end in OIR branches and jumps, afterwards they end in x86 jumps
+ */
+typedef enum{
+	BLOCK_LAYOUT_BEFORE_INSTRUCTION_SELECTION,
+	BLOCK_LAYOUT_AFTER_INSTRUCTION_SELECTION,
+} block_layout_stage_t;
+
+
+/**
+ * One edit to the CFG. For a removed block, the target
+ * is always NULL
+ */
+struct control_flow_update_t{
+	basic_block_t* source;
+	basic_block_t* target;
+	control_flow_update_type_t update_type;
+};
+
+
+/**
+ * The log of all edits that have been made to a function's CFG
+ * since the last time that its control relations were brought
+ * up to date
+ */
+struct control_flow_update_log_t{
+	control_flow_update_t* updates;
+	u_int32_t current_index;
+	u_int32_t current_max_size;
+};
+
+/**
+ * A natural loop. Every back edge into the same header is merged into one
+ * loop, so each header has exactly one loop
+ */
+struct natural_loop_t{
+	//The header dominates every block in the loop
+	basic_block_t* header;
+	//The closest enclosing loop, NULL for an outermost loop
+	natural_loop_t* parent;
+	//Every block in the loop, nested loops included. The header is always first
+	dynamic_array_t blocks;
+	//The source of every back edge into the header
+	dynamic_array_t latches;
+	//How deep in the nest we are. Outermost loops are at depth 1
+	u_int32_t depth;
+};
+
+
+/**
+ * The loop nest forest for one function. The loops are stored from largest
+ * to smallest, so walking the array backwards is guaranteed to see every
+ * inner loop before any loop that contains it
+ */
+struct loop_nest_forest_t{
+	//Every loop in the function
+	dynamic_array_t loops;
+	//The innermost loop that a block is in, by function block index. NULL if it's in no loop
+	natural_loop_t** innermost_loops;
+	//How many blocks the innermost loop array covers
+	u_int32_t number_of_block_indices;
+};
+
+
 /**
  * Special exposes post order traversal API. The postorder traversal is needed
  * specifically in branch reduction in the optimizer/postprocessor. In this case,
  * we'll need a pre-allocated dynamic array to be passed in
  */
-void get_post_order_traversal(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, dynamic_array_t* post_order_traversal);
+void get_post_order_traversal(basic_block_t* function_entry_block, dynamic_array_t* post_order_traversal);
 
 /**
  * Get the reverse post order traversal over the reverse CFG(successors are predecessors and vice versa). This on-demand traversal
  * grabber requires a pre-allocated array to be passed in that will store the traversal
  */
-void get_reverse_post_order_reverse_cfg_traversal(dynamic_array_t* function_blocks, basic_block_t* function_exit_block, dynamic_array_t* reverse_post_order_traversal);
+void get_reverse_post_order_reverse_cfg_traversal(basic_block_t* function_exit_block, dynamic_array_t* reverse_post_order_traversal);
 
 /**
  * Get the nearest marked postdominator of a given block
@@ -46,11 +133,73 @@ basic_block_t* get_nearest_marked_postdominator(basic_block_t* block);
  */
 void calculate_all_control_flow_relations_for_function(basic_block_t* function_entry_block, basic_block_t* function_exit_block, dynamic_array_t* function_blocks);
 
+/**
+ * Does the dominator block dominate the given block? Every block dominates itself.
+ * The dominator tree must be up to date for this to be accurate
+ */
+u_int8_t does_block_dominate(basic_block_t* dominator, basic_block_t* block);
+
+/**
+ * Find every natural loop in a function and nest them. A back edge is any edge
+ * whose target dominates its source, so the dominators must already be computed
+ */
+loop_nest_forest_t build_loop_nest_forest(dynamic_array_t* function_blocks, u_int32_t number_of_block_indices);
+
+/**
+ * Is the given block inside of the given loop(or any loop nested inside of it)?
+ */
+u_int8_t is_block_in_loop(loop_nest_forest_t* forest, natural_loop_t* loop, basic_block_t* block);
+
+/**
+ * Deallocate a loop nest forest and every loop inside of it
+ */
+void loop_nest_forest_dealloc(loop_nest_forest_t* forest);
+
 /**
  * Destroy all old control relations in anticipation of new ones coming in. This
  * operates on a per-function level
  */
 void cleanup_all_control_relations(dynamic_array_t* function_blocks);
 
+/**
+ * Allocate an empty control flow update log
+ */
+control_flow_update_log_t control_flow_update_log_alloc();
+
+/**
+ * Record an edit that has been made to the CFG. A NULL log is allowed, and
+ * in that case nothing is recorded
+ */
+void record_control_flow_update(control_flow_update_log_t* log, basic_block_t* source, basic_block_t* target, control_flow_update_type_t update_type);
+
+/**
+ * Bring all control relations for a function up to date after the edits in the log
+ * have been made. Only the parts of the dominator and postdominator trees that
+ * the edits could have touched are recomputed. The log is emptied once we're done
+ *
+ * NOTE: the log must contain *every* edge edit made since the relations were last
+ * computed, and all unreachable blocks must already be removed from the function
+ */
+void update_all_control_flow_relations_for_function(basic_block_t* function_entry_block, basic_block_t* function_exit_block, dynamic_array_t* function_blocks, control_flow_update_log_t* log);
+
+/**
+ * Throw away everything in the log. This is for when the control relations
+ * are about to be recomputed from scratch anyways
+ */
+void reset_control_flow_update_log(control_flow_update_log_t* log);
+
+/**
+ * Deallocate a control flow update log
+ */
+void control_flow_update_log_dealloc(control_flow_update_log_t* log);
+
+/**
+ * Lay out every block that is reachable from the function entry into one chain through the
+ * direct successor field. Blocks are chained along their most frequently taken edges first so
+ * that hot paths and loop bodies fall through, and cold blocks(ones that only lead to a raise, or
+ * that a profile says never ran) are moved to the very end of the function
+ */
+void lay_out_function_blocks(basic_block_t* function_entry_block, block_layout_stage_t stage);
+
 
 #endif /* GRAPH_ANALYZER_H */
@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include "../cfg/cfg.h"
 #include "../jump_table/jump_table.h"
+#include "../profiler/profiler.h"
 #include "../utils/dynamic_string/dynamic_string.h"
 #include "../utils/constants.h"
 
@@ -50,10 +51,28 @@
 //The atomically increasing temp name id
 static int32_t current_temp_id = 0;
 
-//All created vars
-dynamic_array_t emitted_vars;
-//All created constants
-dynamic_array_t emitted_consts;
+/**
+ * Every thread that creates vars or constants gets its own list of them, so that
+ * workers never have to wait on one another just to allocate. The lists are chained
+ * together when they're first made and only ever walked again at teardown
+ */
+typedef struct emitted_memory_list_t emitted_memory_list_t;
+
+struct emitted_memory_list_t{
+	//Everything that this thread has created
+	dynamic_array_t allocations;
+	//The next thread's list
+	emitted_memory_list_t* next;
+};
+
+//Every list of created vars, one per thread that has made any
+static emitted_memory_list_t* emitted_vars = NULL;
+//Every list of created constants, one per thread that has made any
+static emitted_memory_list_t* emitted_consts = NULL;
+
+//The calling thread's own lists
+static __thread emitted_memory_list_t* thread_emitted_vars = NULL;
+static __thread emitted_memory_list_t* thread_emitted_consts = NULL;
 
 
 /**
@@ -114,20 +133,89 @@ const char* addressing_mode_to_string(memory_addressing_mode_t mode){
 }
 
 /**
- * Initialize the memory management system
+ * Initialize the memory management system. The lists themselves are made
+ * by whichever threads end up needing them
  */
 void initialize_varible_and_constant_system(){
-	emitted_consts = dynamic_array_alloc();
-	emitted_vars = dynamic_array_alloc();
+	emitted_vars = NULL;
+	emitted_consts = NULL;
+	thread_emitted_vars = NULL;
+	thread_emitted_consts = NULL;
+}
+
+
+/**
+ * Make a new list for the calling thread and chain it onto the given set of lists. This is the
+ * only time that threads touch anything shared, and it only happens once per thread
+ */
+static emitted_memory_list_t* emitted_memory_list_alloc(emitted_memory_list_t** all_lists){
+	emitted_memory_list_t* list = calloc(1, sizeof(emitted_memory_list_t));
+	list->allocations = dynamic_array_alloc();
+
+	//Push onto the front. If another thread beats us to it, list->next is refreshed and we go again
+	list->next = __atomic_load_n(all_lists, __ATOMIC_RELAXED);
+	while(__atomic_compare_exchange_n(all_lists, &(list->next), list, FALSE, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == FALSE);
+
+	return list;
+}
+
+
+/**
+ * Free everything in every one of the given lists, along with the lists themselves
+ */
+static void emitted_memory_lists_dealloc(emitted_memory_list_t** all_lists){
+	emitted_memory_list_t* list = *all_lists;
+
+	while(list != NULL){
+		//Until we're empty
+		while(dynamic_array_is_empty(&(list->allocations)) == FALSE){
+			//O(1) removal
+			free(dynamic_array_delete_from_back(&(list->allocations)));
+		}
+
+		dynamic_array_dealloc(&(list->allocations));
+
+		emitted_memory_list_t* next = list->next;
+		free(list);
+		list = next;
+	}
+
+	*all_lists = NULL;
+}
+
+
+/**
+ * Add a variable(or anything else that we free along with the variables) into the
+ * calling thread's memory management array
+ */
+static inline void track_emitted_var(void* var){
+	if(thread_emitted_vars == NULL){
+		thread_emitted_vars = emitted_memory_list_alloc(&emitted_vars);
+	}
+
+	dynamic_array_add(&(thread_emitted_vars->allocations), var);
+}
+
+
+/**
+ * Add a constant into the calling thread's memory management array
+ */
+static inline void track_emitted_const(three_addr_const_t* constant){
+	if(thread_emitted_consts == NULL){
+		thread_emitted_consts = emitted_memory_list_alloc(&emitted_consts);
+	}
+
+	dynamic_array_add(&(thread_emitted_consts->allocations), constant);
 }
 
 
 /**
- * A helper function for our atomically increasing temp id
+ * A helper function for our atomically increasing temp id. Temp ids
+ * only ever need to be unique, so worker threads may grab these in
+ * any order
  */
 int32_t increment_and_get_temp_id(){
-	current_temp_id++;
-	return current_temp_id;
+	return __atomic_add_fetch(&current_temp_id, 1, __ATOMIC_RELAXED);
 }
 
 
@@ -139,7 +227,7 @@ global_variable_t* create_global_variable(symtab_variable_record_t* variable, th
 	global_variable_t* var = calloc(1, sizeof(global_variable_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, var);
+	track_emitted_var(var);
 
 	//Copy these over
 	var->variable = variable;
@@ -801,7 +889,7 @@ three_addr_var_t* emit_temp_var(generic_type_t* type){
 	three_addr_var_t* var = calloc(1, sizeof(three_addr_var_t)); 
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, var);
+	track_emitted_var(var);
 
 	//Mark this as temporary
 	var->variable_type = VARIABLE_TYPE_TEMP;
@@ -826,7 +914,7 @@ three_addr_var_t* emit_local_constant_temp_var(local_constant_t* local_constant)
 	three_addr_var_t* var = calloc(1, sizeof(three_addr_var_t)); 
 
 	//Add here for memory management
-	dynamic_array_add(&emitted_vars, var);
+	track_emitted_var(var);
 
 	//This is a special kind of variable that is a local constant variable
 	var->variable_type = VARIABLE_TYPE_LOCAL_CONSTANT;
@@ -834,8 +922,8 @@ three_addr_var_t* emit_local_constant_temp_var(local_constant_t* local_constant)
 	//Store the local constant inside of the memory region slot
 	var->associated_memory_region.local_constant = local_constant;
 
-	//We've used this more than one time
-	(local_constant->reference_count)++;
+	//We've used this more than one time. Constants are shared between functions, so this must be atomic
+	__atomic_add_fetch(&(local_constant->reference_count), 1, __ATOMIC_RELAXED);
 
 	//Store the type
 	var->type = local_constant->type;
@@ -856,7 +944,7 @@ three_addr_var_t* emit_function_pointer_temp_var(symtab_function_record_t* funct
 	three_addr_var_t* var = calloc(1, sizeof(three_addr_var_t)); 
 
 	//Add here for memory management
-	dynamic_array_add(&emitted_vars, var);
+	track_emitted_var(var);
 
 	//This is a special kind of variable that is a local constant variable
 	var->variable_type = VARIABLE_TYPE_FUNCTION_ADDRESS;
@@ -886,7 +974,7 @@ three_addr_var_t* emit_var(symtab_variable_record_t* var){
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//If we have an aliased variable(almost exclusively function
 	//parameters), we will instead emit the alias of that variable instead
@@ -928,7 +1016,7 @@ three_addr_var_t* emit_memory_address_var(symtab_variable_record_t* var){
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	/**
 	 * If we have an aliased variable(almost exclusively function
@@ -984,7 +1072,7 @@ three_addr_var_t* emit_memory_address_temp_var(generic_type_t* type, stack_regio
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//This is a memory address variable. We will flag this for special
 	//printing
@@ -1017,7 +1105,7 @@ three_addr_var_t* emit_stack_param_memory_address_temp_var(generic_type_t* type,
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//This is a memory address variable. We will flag this for special
 	//printing
@@ -1049,7 +1137,7 @@ three_addr_var_t* emit_return_by_copy_var(generic_type_t* type){
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//Flag this as a return by copy varialbe
 	emitted_var->variable_type = VARIABLE_TYPE_RETURN_BY_COPY_ADDRESS;
@@ -1078,7 +1166,7 @@ three_addr_var_t* emit_var_from_identifier(symtab_variable_record_t* var, generi
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//This is not temporary
 	emitted_var->variable_type = VARIABLE_TYPE_NON_TEMP;
@@ -1105,7 +1193,7 @@ three_addr_var_t* emit_temp_var_from_live_range(live_range_t* range){
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//This is a temp var
 	emitted_var->variable_type = VARIABLE_TYPE_TEMP;
@@ -1130,7 +1218,7 @@ three_addr_var_t* emit_var_copy(three_addr_var_t* var){
 	three_addr_var_t* emitted_var = calloc(1, sizeof(three_addr_var_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_vars, emitted_var);
+	track_emitted_var(emitted_var);
 
 	//Copy the memory
 	memcpy(emitted_var, var, sizeof(three_addr_var_t));
@@ -2838,6 +2926,10 @@ void print_three_addr_code_stmt(FILE* fl, instruction_t* stmt){
 			fprintf(fl, "%s\n", stmt->optional_storage.inlined_assembly.string);
 			break;
 
+		case THREE_ADDR_CODE_PROFILE_COUNTER_STMT:
+			fprintf(fl, "profile_counter %s+%lu\n", PROFILE_DATA_SYMBOL, stmt->optional_storage.profile_counter_offset);
+			break;
+
 		case THREE_ADDR_CODE_IDLE_STMT:
 			//Just print a nop
 			fprintf(fl, "nop\n");
@@ -4837,6 +4929,10 @@ void print_instruction(FILE* fl, instruction_t* instruction, variable_printing_m
 			//Final newline
 			fprintf(fl, "\n");
 			break;
+		//Tail calls never come back, so there's no result to speak of
+		case TAIL_CALL:
+			fprintf(fl, "jmp %s\n", instruction->called_function->func_name.string);
+			break;
 		case INDIRECT_CALL:
 			//Indirect function calls store the location of the call in op1
 			fprintf(fl, "call *");
@@ -5444,7 +5540,7 @@ three_addr_const_t* emit_constant(generic_ast_node_t* const_node){
 	three_addr_const_t* constant = calloc(1, sizeof(three_addr_const_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_consts, constant);
+	track_emitted_const(constant);
 
 	//Now we'll assign the appropriate values
 	constant->const_type = const_node->constant_type; 
@@ -5507,7 +5603,7 @@ three_addr_const_t* emit_stack_passed_parameter_offset_constant(stack_region_t*
 	three_addr_const_t* constant = calloc(1, sizeof(three_addr_const_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_consts, constant);
+	track_emitted_const(constant);
 
 	//This is a special kind of constant
 	constant->const_type = STACK_PASSED_PARAM_OFFSET;
@@ -6275,7 +6371,7 @@ three_addr_const_t* emit_direct_integer_or_char_constant(int64_t value, generic_
 	three_addr_const_t* constant = calloc(1, sizeof(three_addr_const_t));
 
 	//Add into here for memory management
-	dynamic_array_add(&emitted_consts, constant);
+	track_emitted_const(constant);
 
 	//Store the type here
 	constant->type = type;
@@ -6437,6 +6533,26 @@ instruction_t* emit_asm_inline_instruction(generic_ast_node_t* asm_inline_node,
 }
 
 
+/**
+ * Emit a profile counter statement. The counter that gets bumped lives at the given
+ * byte offset inside of the profile data
+ */
+instruction_t* emit_profile_counter_instruction(u_int64_t profile_counter_offset, u_int32_t line_number){
+	//First we allocate it
+	instruction_t* stmt = calloc(1, sizeof(instruction_t));
+
+	//Store the class
+	stmt->statement_type = THREE_ADDR_CODE_PROFILE_COUNTER_STMT;
+
+	//Store where the counter is
+	stmt->optional_storage.profile_counter_offset = profile_counter_offset;
+
+	//And we're done
+	stmt->line_number = line_number;
+	return stmt;
+}
+
+
 /**
  * Emit a "test if not 0 three address code statement"
  */
@@ -9116,6 +9232,21 @@ u_int8_t variables_equal_no_ssa(three_addr_var_t* a, three_addr_var_t* b){
 }
 
 
+/**
+ * Free all the memory that's reserved by a live range
+ */
+void live_range_dealloc(live_range_t* live_range){
+	//First we'll destroy the array that it has
+	dynamic_array_dealloc((&live_range->variables));
+
+	//Destroy the neighbors array as well
+	dynamic_array_dealloc((&live_range->neighbors));
+
+	//Then we can destroy the live range itself
+	free(live_range);
+}
+
+
 /**
  * Deallocate the variable portion of a three address code
 */
@@ -9160,17 +9291,9 @@ void instruction_dealloc(instruction_t* stmt){
  * Deallocate all variables using our global list strategy
 */
 void deallocate_all_vars(){
-	//Until we're empty
-	while(dynamic_array_is_empty(&emitted_vars) == FALSE){
-		//O(1) removal
-		three_addr_var_t* variable = dynamic_array_delete_from_back(&emitted_vars);
-
-		//Free it
-		free(variable);
-	}
-
-	//Finally scrap the array
-	dynamic_array_dealloc(&emitted_vars);
+	//Every worker is done by now, so all of their lists can go
+	emitted_memory_lists_dealloc(&emitted_vars);
+	thread_emitted_vars = NULL;
 }
 
 
@@ -9178,15 +9301,7 @@ void deallocate_all_vars(){
  * Deallocate all constants using our global list strategy
 */
 void deallocate_all_consts(){
-	//Until we're empty
-	while(dynamic_array_is_empty(&emitted_consts) == FALSE){
-		//O(1) removal
-		three_addr_const_t* constant = dynamic_array_delete_from_back(&emitted_consts);
-
-		//Free it
-		free(constant);
-	}
-
-	//Finally scrap the array
-	dynamic_array_dealloc(&emitted_consts);
+	//Every worker is done by now, so all of their lists can go
+	emitted_memory_lists_dealloc(&emitted_consts);
+	thread_emitted_consts = NULL;
 }
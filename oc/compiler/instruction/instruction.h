@@ -403,6 +403,8 @@ struct instruction_t{
 		forced_signedness_type_t forced_signedness;
 		//The label that we are jumping to
 		symtab_label_record_t* jumping_to_label;
+		//Where this block's profile counter sits inside of the profile data
+		u_int64_t profile_counter_offset;
 	} optional_storage;
 
 	/**
@@ -907,6 +909,12 @@ instruction_t* emit_indirect_function_call_instruction(three_addr_var_t* functio
  */
 instruction_t* emit_asm_inline_instruction(generic_ast_node_t* asm_inline_node, u_int32_t line_number);
 
+/**
+ * Emit a profile counter statement. The counter that gets bumped lives at the given
+ * byte offset inside of the profile data
+ */
+instruction_t* emit_profile_counter_instruction(u_int64_t profile_counter_offset, u_int32_t line_number);
+
 /**
  * Emit a "test if not 0 three address code statement"
  */
@@ -1071,6 +1079,11 @@ void print_all_global_variables(FILE* fl, dynamic_array_t* global_variables);
  */
 void print_live_range(FILE* fl, live_range_t* live_range);
 
+/**
+ * Destroy a live range
+ */
+void live_range_dealloc(live_range_t* live_range);
+
 /**
  * Destroy a three address variable
 */
@@ -6,16 +6,29 @@
 
 #include "instruction_scheduler.h"
 #include "../data_dependency_graph/data_dependency_graph.h"
+#include "../utils/thread_pool/thread_pool.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <sys/types.h>
 
 /**
- * Hang onto these two for later use
+ * Hang onto these two for later use. They are never written to
+ * once scheduling starts, so every worker is able to share them
  */
 static three_addr_var_t* stack_pointer_var;
 static three_addr_var_t* instruction_pointer_var;
 
+/**
+ * Everything that the function-level scheduling jobs
+ * need to know about
+ */
+typedef struct{
+	//The CFG that we're scheduling
+	cfg_t* cfg;
+	//Are we debug printing?
+	u_int8_t debug_printing;
+} scheduler_work_t;
+
 
 /**
  * Does the given instruction have a *Data Dependence* on the candidate. We will know
@@ -320,6 +333,12 @@ static void schedule_instructions_in_block(basic_block_t* block, u_int8_t debug_
 	 */
 	build_dependency_graph_for_block(&dependency_graph, block, instructions);
 
+	/**
+	 * Step 2.5: memory has dependences of its own. Any two instructions that could
+	 * touch the same memory(with at least one write) need to stay in their order
+	 */
+	add_memory_dependences(&dependency_graph);
+
 	/**
 	 * Step 3: Finalize the graph by sorting it and constructing the appropriate
 	 * adjacency matrix
@@ -369,39 +388,66 @@ static void schedule_instructions_in_block(basic_block_t* block, u_int8_t debug_
 }
 
 
+/**
+ * Schedule every block inside of a given function. This is
+ * the unit of work that we hand off to the thread pool
+ */
+static void schedule_instructions_in_function(void* shared_state, u_int32_t function_index){
+	scheduler_work_t* work = shared_state;
+
+	//Grab the function entry
+	basic_block_t* cursor = dynamic_array_get_at(&(work->cfg->function_entry_blocks), function_index);
+
+	//Run through everything in here
+	while(cursor != NULL){
+		//Invoke the block scheduler itself
+		schedule_instructions_in_block(cursor, work->debug_printing);
+
+		//Advance it up using the direct successor
+		cursor = cursor->direct_successor;
+	}
+}
+
+
+/**
+ * Schedule a single function all on its own
+ */
+void schedule_instructions_in_single_function(cfg_t* cfg, compiler_options_t* options, u_int32_t function_index){
+	//Extract the stack and instruction pointer so that we know what to skip
+	stack_pointer_var = cfg->stack_pointer;
+	instruction_pointer_var = cfg->instruction_pointer;
+	set_alias_analysis_stack_pointer(cfg->stack_pointer);
+
+	//Package up what the job needs
+	scheduler_work_t work = {cfg, options->enable_debug_printing};
+
+	//And run it right here
+	schedule_instructions_in_function(&work, function_index);
+}
+
+
 /**
  * Root level function that is exposed via the API
  */
 cfg_t* schedule_all_instructions(cfg_t* cfg, compiler_options_t* options){
 	//Grab these flags for later
-	u_int8_t debug_printing = options->enable_debug_printing;
 	u_int8_t print_irs = options->print_irs;
 
 	//Extract the stack and instruction pointer so that we know what to skip
 	stack_pointer_var = cfg->stack_pointer;
 	instruction_pointer_var = cfg->instruction_pointer;
+	set_alias_analysis_stack_pointer(cfg->stack_pointer);
+
+	//Package up what every job needs
+	scheduler_work_t work = {cfg, options->enable_debug_printing};
 
 	/**
 	 * Really all that we'll do here is invoke the block
 	 * schedule for each basic block in the graph. Blocks
-	 * are scheduled independent of other blocks, so we
-	 * don't need to worry about our current function or
-	 * anything like that here
+	 * are scheduled independent of other blocks, so every
+	 * function can be handed off to its own worker
 	*/
-	//For every single function
-	for(u_int16_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
-		//Grab the function entry
-		basic_block_t* cursor = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
-
-		//Run through everything in here
-		while(cursor != NULL){
-			//Invoke the block scheduler itself
-			schedule_instructions_in_block(cursor, debug_printing);
-
-			//Advance it up using the direct successor
-			cursor = cursor->direct_successor;
-		}
-	}
+	thread_pool_run(options->thread_count, cfg->function_entry_blocks.current_index, schedule_instructions_in_function, &work);
 
 	//If we want to print our IR's we will display what we look like post-scheduling
 	if(print_irs == TRUE){
@@ -15,4 +15,10 @@
  */
 cfg_t* schedule_all_instructions(cfg_t* cfg, compiler_options_t* options);
 
+/**
+ * Schedule only the function at the given index. This is used when functions
+ * are streamed through the back end one at a time
+ */
+void schedule_instructions_in_single_function(cfg_t* cfg, compiler_options_t* options, u_int32_t function_index);
+
 #endif /* INSTRUCTION_SCHEDULER_H */
@@ -11,13 +11,16 @@
 #include "instruction_selector.h"
 #include "../utils/queue/heap_queue.h"
 #include "../utils/value_numbering_table/value_numbering_table.h"
+#include "../utils/thread_pool/thread_pool.h"
 #include "../graph_analyzer/graph_analyzer.h"
+#include "../profiler/profiler.h"
 #include "../utils/constants.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
 #include <sys/types.h>
 #include <threads.h>
+#include <pthread.h>
 
 //We'll need this a lot, so we may as well have it here
 static generic_type_t* double_quad_word;
@@ -31,8 +34,6 @@ static generic_type_t* u16;
 static generic_type_t* i16;
 static generic_type_t* u8;
 
-//The dynamic string that we reuse for searching
-static dynamic_string_t value_name_searcher_string;
 //A holder for the stack pointer
 static three_addr_var_t* stack_pointer_variable;
 //A holder for the instruction pointer
@@ -40,6 +41,9 @@ static three_addr_var_t* instruction_pointer_variable;
 //A reference to our CFG
 static cfg_t* cfg_reference;
 
+//Functions are selected in parallel, and the local constants are shared by all of them
+static pthread_mutex_t local_constants_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static instruction_t* emit_register_movement_instruction_directly(three_addr_var_t* destination_register, three_addr_var_t* source_register);
 static inline three_addr_var_t* create_and_insert_converting_move_instruction(instruction_t* after_instruction, three_addr_var_t* source, generic_type_t* destination_type);
 
@@ -469,33 +473,6 @@ static inline u_int8_t does_load_operation_require_converting_move(instruction_t
 }
 
 
-/**
- * Does the block that we're passing in end in a direct(jmp) jump to
- * the very next block. If so, we'll return what block the jump goes to.
- * If not, we'll return null.
- */
-static inline basic_block_t* does_block_end_in_jump(basic_block_t* block){
-	//If it's null then leave
-	if(block->exit_statement == NULL){
-		return NULL;
-	}
-
-	switch(block->exit_statement->statement_type){
-		//Direct jump, just use the if block
-		case THREE_ADDR_CODE_JUMP_STMT:
-			return block->exit_statement->if_block;
-
-		//In a branch statement, the else block is the direct jump
-		case THREE_ADDR_CODE_BRANCH_STMT:
-			return block->exit_statement->else_block;
-
-		//By default no
-		default:
-			return NULL;
-	}
-}
-
-
 /**
  * Is the given expression eligible for value numbering? Note that all
  * expressions will have the algorithm run, but only expressions that
@@ -638,102 +615,38 @@ static inline u_int8_t is_integer_to_sse_conversion_instruction(instruction_type
 
 /**
  * The first step in our instruction selector is to get the instructions stored in
- * a straight line in the exact way that we want them to be. This is done with a breadth-first
- * search traversal of the simplified CFG that has been optimized. 
+ * a straight line in the exact way that we want them to be. The layout chains blocks
+ * together along their most frequently taken edges, so loop bodies and likely branch
+ * targets fall through and blocks that only lead to a raise end up at the very end.
  *
- * One special consideration we'll take is ordering nodes with a given jump next to eachother.
- * For example, if block .L15 ends in a direct jump to .L16, we'll endeavor to have .L16 right
- * after .L15 so that in a later stage, we can eliminate that jump.
+ * When there's nothing to choose between, we still keep a block's jump target right
+ * after it. For example, if block .L15 ends in a direct jump to .L16, we'll endeavor to
+ * have .L16 right after .L15 so that in a later stage, we can eliminate that jump.
  */
-static void order_blocks(cfg_t* cfg){
-	//We'll first wipe the visited status on this CFG
-	reset_visited_status(cfg, TRUE);
-	
-	/**
-	 * We will perform a breadth first search and use the "direct successor" area
-	 * of the blocks to store them all in one chain per function. The functions themselves
-	 * are separated and stored individually, because in ollie a function is the smallest unit
-	 * of procedures
-	 */
-	
-	//We'll need to use a queue every time, we may as well just have one big one
-	heap_queue_t queue = heap_queue_alloc();
-
-	//For each function
-	for(u_int16_t _ = 0; _ < cfg->function_entry_blocks.current_index; _++){
-		//Grab the function block out
-		basic_block_t* func_block = dynamic_array_get_at(&(cfg->function_entry_blocks), _);
-
-		//These get reset for every function because each function has its own
-		//separate ordering
-		basic_block_t* previous = NULL;
-
-		//This function start block is the begging of our BFS	
-		enqueue(&queue, func_block);
-		
-		//So long as the queue is not empty
-		while(queue_is_empty(&queue) == FALSE){
-			//Grab this block off of the queue
-			basic_block_t* current = dequeue(&queue);
-
-			//If previous is NULL, this is the first block
-			if(previous == NULL){
-				//Keep track of what previous is
-				previous = current;
-
-			//We need to handle the rare case where we reach two of the same blocks(maybe the block points
-			//to itself) but neither have been visited. We make sure that, in this event, we do not set the
-			//block to be it's own direct successor
-			} else if(previous != current && current->visited == FALSE){
-				//We'll add this in as a direct successor
-				previous->direct_successor = current;
-
-				//Add this in as well
-				previous = current;
-			}
+static void order_function_blocks(basic_block_t* function_entry){
+	//Extract the function's record
+	symtab_function_record_t* function = function_entry->function_defined_in;
 
-			//Make sure that we flag this as visited
-			current->visited = TRUE;
-
-			//Let's first check for our special case - us jumping to a given block as the very last statement. If
-			//this turns back something that isn't null, it'll be the first thing we add in
-			basic_block_t* direct_end_jump = does_block_end_in_jump(current);
-
-			//If this is the case, we'll add it in first
-			if(direct_end_jump != NULL && direct_end_jump->visited == FALSE){
-				//Add it into the queue
-				enqueue(&queue, direct_end_jump);
-			}
-
-			//Now we'll go through each of the successors in this node
-			for(u_int16_t idx = 0; idx < current->successors.current_index; idx++){
-				//Now as we go through here, if the direct end jump wasn't NULL, we'll have already added it in. We don't
-				//want to have that happen again, so we'll make sure that if it's not NULL we don't double add it
-
-				//Grab the successor
-				basic_block_t* successor = dynamic_array_get_at(&(current->successors), idx);
+	//Every old ordering for this function is now invalid
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+		block->direct_successor = NULL;
+	}
 
-				//If we had that jumping to block case happen, make sure we skip over it to avoid double adding
-				if(successor == direct_end_jump){
-					continue;
-				}
+	//Let the layout build the chain for us
+	lay_out_function_blocks(function_entry, BLOCK_LAYOUT_BEFORE_INSTRUCTION_SELECTION);
+}
 
-				//If the block is completely empty(function end block), we'll also skip
-				if(successor->leader_statement == NULL){
-					successor->visited = TRUE;
-					continue;
-				}
 
-				//Otherwise it's not, so we'll add it in
-				if(successor->visited == FALSE){
-					enqueue(&queue, successor);
-				}
-			}
-		}
-	}
+/**
+ * Order the blocks of the function at the given index. The visited status
+ * for the whole CFG must be wiped before any of these run
+ */
+static void order_blocks_job(void* shared_state, u_int32_t function_index){
+	//The shared state is just the CFG
+	cfg_t* cfg = shared_state;
 
-	//Destroy the queue when done
-	heap_queue_dealloc(&queue);
+	order_function_blocks(dynamic_array_get_at(&(cfg->function_entry_blocks), function_index));
 }
 
 
@@ -2016,6 +1929,12 @@ static inline void optimize_mod_by_power_of_2(instruction_window_t* window){
 		//Now we'll compute 2^n - 1 
 		u_int32_t and_mask = (1 << divisor_log2) - 1;
 
+		/**
+		 * The dividend is used by both the first shift and the addition, so it can't
+		 * be overwritten by the shift
+		 */
+		mod_instruction->operands.oir.operand1->was_value_named = TRUE;
+
 		/**
 		 * Step 1: Extract the sign bit, backfilling with either 1's or 0's as we go. Since we are
 		 * looking to backfill we *must* use an arithmetic right shift here
@@ -6208,105 +6127,66 @@ static u_int8_t simplifier_pass(basic_block_t* entry){
 
 
 /**
- * Get the value name for a given variable and *concatenate* it into
- * a given dynamic string. It is a assumed that the string has been
- * allocated by the caller
+ * Get the value name for a given variable and store it in the given
+ * operand of a key. A variable is identified by whatever it refers to
+ * along with its SSA generation, or by its temp number if it refers to nothing
  */
-static void concatenate_value_name_string(three_addr_var_t* variable, dynamic_string_t* output){
-	//Allocate a temporary buffer for this
-	char buffer[1000];
-	//Holder for the variable record
-	symtab_variable_record_t* variable_record = variable->linked_var;
+static void generate_value_name_operand(three_addr_var_t* variable, value_number_operand_t* operand){
+	operand->variable_type = variable->variable_type;
 
 	//Handle each variable type accordingly
 	switch(variable->variable_type){
 		/**
-		 * Temporary variables just output as t<number>
+		 * Temporary variables just use their temp number
 		 */
 		case VARIABLE_TYPE_TEMP:
-			sprintf(buffer, "t%d", variable->temp_var_number);
-			dynamic_string_concatenate(output, buffer);
-
+			operand->identity = NULL;
+			operand->number = variable->temp_var_number;
 			break;
 
 		/**
-		 * For non temporaries we will use:
-		 * 	<lexical_scope>_name_<ssa_generation>
-		 *
-		 * 	This will guarantee uniqueness even if we have
-		 * 	colliding
+		 * For non temporaries we will use the variable record and the
+		 * SSA generation. This will guarantee uniqueness even if we have
+		 * colliding names
 		 */
 		case VARIABLE_TYPE_NON_TEMP:
-			//Store the variable record
-			sprintf(buffer, "%d_%s_%d", variable_record->lexical_scope_id, variable_record->var_name.string, variable->ssa_generation);
-			dynamic_string_concatenate(output, buffer);
-
-			break;
-
-		/**
-		 * For a memory address, we will just print this
-		 * out as M<<lexical_scope>_<name>_<ssa_generation>>
-		 * if we have a variable name. If not then we'll just be printing
-		 * out the temp var number
-		 */
-		case VARIABLE_TYPE_MEMORY_ADDRESS:
-			if(variable_record != NULL){
-				sprintf(buffer, "M<%d_%s_%d>", variable_record->lexical_scope_id, variable_record->var_name.string, variable->ssa_generation);
-			} else {
-				sprintf(buffer, "M<t%d>", variable->temp_var_number);
-			}
-
-			dynamic_string_concatenate(output, buffer);
+			operand->identity = variable->linked_var;
+			operand->number = variable->ssa_generation;
 			break;
 
 		/**
-		 * For a stack memory address, we will just print this
-		 * out as SM<<scope>_<name>_<ssa_generation>> if we have a
-		 * variable name. If not then we will be using the temp 
+		 * Memory addresses, stack param memory addresses and return by copy addresses
+		 * use the variable record if they have one. If not then we'll be using the temp
 		 * variable number
 		 */
+		case VARIABLE_TYPE_MEMORY_ADDRESS:
 		case VARIABLE_TYPE_STACK_PARAM_MEMORY_ADDRESS:
-			if(variable_record != NULL){
-				sprintf(buffer, "SM<%d_%s_%d>", variable_record->lexical_scope_id, variable_record->var_name.string, variable->ssa_generation);
-			} else {
-				sprintf(buffer, "SM<t%d>", variable->temp_var_number);
-			}
-
-			dynamic_string_concatenate(output, buffer);
-			break;
-
-		/**
-		 * For a return by copy address, we'll just print out
-		 * RBC<<scope>_<name>_<ssa_generation> if we have an actual
-		 * variable name. Otherwise we just use the temp var
-		 * number
-		 */
 		case VARIABLE_TYPE_RETURN_BY_COPY_ADDRESS:
-			if(variable_record != NULL){
-				sprintf(buffer, "RBC<%d_%s_%d>", variable_record->lexical_scope_id, variable_record->var_name.string, variable->ssa_generation);
+			if(variable->linked_var != NULL){
+				operand->identity = variable->linked_var;
+				operand->number = variable->ssa_generation;
 			} else {
-				sprintf(buffer, "RBC<t%d>", variable->temp_var_number);
+				operand->identity = NULL;
+				operand->number = variable->temp_var_number;
 			}
 
-			dynamic_string_concatenate(output, buffer);
 			break;
 
 		/**
-		 * Local constants are already unique so we can just print them
-		 * out as is
+		 * Local constants are already unique so we can just use
+		 * them as is
 		 */
 		case VARIABLE_TYPE_LOCAL_CONSTANT:
-			sprintf(buffer, ".LC%d", variable->associated_memory_region.local_constant->local_constant_id);
-			dynamic_string_concatenate(output, buffer);
-
+			operand->identity = variable->associated_memory_region.local_constant;
+			operand->number = 0;
 			break;
 
 		/**
-		 * Function addresses just output the name of the underlying function
+		 * Function addresses just use the underlying function
 		 */
 		case VARIABLE_TYPE_FUNCTION_ADDRESS:
-			sprintf(buffer, "%s", variable->associated_memory_region.rip_relative_function->func_name.string);
-			dynamic_string_concatenate(output, buffer);
+			operand->identity = variable->associated_memory_region.rip_relative_function;
+			operand->number = 0;
 			break;
 
 		default:
@@ -6316,6 +6196,18 @@ static void concatenate_value_name_string(three_addr_var_t* variable, dynamic_st
 }
 
 
+/**
+ * Generate the key that holds the value name of a single variable
+ */
+static inline void generate_value_name_key_for_variable(three_addr_var_t* variable, value_number_key_t* key){
+	//Wipe out anything that was in here
+	memset(key, 0, sizeof(value_number_key_t));
+
+	key->key_type = VALUE_NUMBER_KEY_VARIABLE;
+	generate_value_name_operand(variable, &(key->operands[0]));
+}
+
+
 /**
  * Is the given phi function redundant? A phi function is redundant
  * if *all* of the variables inside of the phi function have ended
@@ -6358,16 +6250,17 @@ static inline u_int8_t convert_phi_function_if_redundant(value_numbering_table_t
 	 * We will now also create a value number for the phi assignee
 	 * to be replaced by whatever the simplfication came out to be
 	 */
-	dynamic_string_t value_name = dynamic_string_alloc();
+	value_number_key_t value_name;
 
-	//Get the value name string of the assignee
-	concatenate_value_name_string(phi_function->operands.oir.assignee, &value_name);
+	//Get the value name of the assignee
+	generate_value_name_key_for_variable(phi_function->operands.oir.assignee, &value_name);
 
 	/**
 	 * Store this in here so that every reference to the old assignee
 	 * can become the first parameter
 	 */
 	add_value_number_expression(table, first_parameter, &value_name);
+	first_parameter->was_value_named = TRUE;
 
 	//This was redundant
 	return TRUE;
@@ -6376,80 +6269,51 @@ static inline u_int8_t convert_phi_function_if_redundant(value_numbering_table_t
 
 /**
  * Generate the key for a given instruction. The key for a given
- * instruction consists of the instruction type converted to a char *and*
- * the variables that are inside of it. We are given an allocated
- * dynamic string as the key for this function and we will populate it
+ * instruction consists of the kind of instruction, the operator *and*
+ * the variables/constants that are inside of it. We are given a key
+ * to populate by the caller
  *
- * Remember that these value names are not meant to be anything fancy, they
- * just need to be unique. As such we will generate the value names with
- * some distinguishable starting keys and their given operand values
+ * Only instructions that are eligible for value numbering will ever
+ * have a key generated for them
  */
-static inline void generate_value_name_key_for_instruction(instruction_t* instruction, dynamic_string_t* textual_key){
-	//For holding constant strings
-	char constant_string[300];
+static inline void generate_value_name_key_for_instruction(instruction_t* instruction, value_number_key_t* key){
+	//Wipe out anything that was in here
+	memset(key, 0, sizeof(value_number_key_t));
+
+	//Every key has the operator and first operand
+	key->op = instruction->op;
+	generate_value_name_operand(instruction->operands.oir.operand1, &(key->operands[0]));
 
 	//Based on the instruction type we generate different keys
 	switch(instruction->statement_type){
-		case THREE_ADDR_CODE_PHI_FUNC:
-			dynamic_string_concatenate(textual_key, "PHI");
-
-			//Concatenate the variable name of each of the parameters onto the end
-			for(int32_t i = 0; i < instruction->parameters.current_index; i++){
-				//Extract the var
-				three_addr_var_t* variable = dynamic_array_get_at(&(instruction->parameters), i);
-
-				//Grab it's value name
-				concatenate_value_name_string(variable, textual_key);
-			}
-
-			break;
-
 		/**
 		 * For a bin op statement we'll have
-		 * value names like BINx_0+y_0
+		 * the second variable as well
 		 */
 		case THREE_ADDR_CODE_BIN_OP_STMT:
-			//Starting key
-			dynamic_string_concatenate(textual_key, "BIN");
-			
-			//First op
-			concatenate_value_name_string(instruction->operands.oir.operand1, textual_key);
-
-			//Actual opcode
-			dynamic_string_add_char_to_back(textual_key, instruction->op);
-
-			//Second op
-			concatenate_value_name_string(instruction->operands.oir.operand2, textual_key);
-
+			key->key_type = VALUE_NUMBER_KEY_BIN_OP;
+			generate_value_name_operand(instruction->operands.oir.operand2, &(key->operands[1]));
 			break;
 
 		/**
 		 * For bin op with const statements we'll
-		 * have value names like BINx_0-2
+		 * have the raw constant bits instead
 		 */
 		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
-			//Starting key
-			dynamic_string_concatenate(textual_key, "BIN");
-			
-			//First op
-			concatenate_value_name_string(instruction->operands.oir.operand1, textual_key);
-
-			//Actual opcode
-			dynamic_string_add_char_to_back(textual_key, instruction->op);
+			key->key_type = VALUE_NUMBER_KEY_BIN_OP_WITH_CONST;
 
 			//Extract this for convenience
 			three_addr_const_t* constant_value = instruction->operands.oir.constant_operand;
 
-			//Generate the constant string as well
-			sprintf(constant_string, "%d_%ld", constant_value->const_type, constant_value->constant_value.signed_long_constant);
-			
-			//Add this in
-			dynamic_string_concatenate(textual_key, constant_string);
+			key->constant_bits = constant_value->constant_value.unsigned_long_constant;
+			key->constant_adjustment = constant_value->constant_adjustment;
+			key->constant_type = constant_value->const_type;
 
 			break;
- 
+
 		default:
-			break;
+			fprintf(stderr, "Fatal internal compiler error: attempt to generate a value number key for an ineligible instruction\n");
+			exit(1);
 	}
 }
 
@@ -6465,13 +6329,12 @@ static three_addr_var_t* get_value_name(value_numbering_table_t* table, three_ad
 		return NULL;
 	}
 
-	//Clear out the search string
-	clear_dynamic_string(&value_name_searcher_string);
-	//Add the name to the string
-	concatenate_value_name_string(variable, &value_name_searcher_string);
+	//Generate the key for the variable
+	value_number_key_t value_name_key;
+	generate_value_name_key_for_variable(variable, &value_name_key);
 
 	//Try to find it
-	three_addr_var_t* value_name_substitution = lookup_value_number_expression(table, &value_name_searcher_string);
+	three_addr_var_t* value_name_substitution = lookup_value_number_expression(table, &value_name_key);
 
 	//Most common - it's null, just return ourselves
 	if(value_name_substitution == NULL){
@@ -6550,6 +6413,49 @@ static inline u_int8_t replace_all_parameter_list_variables(value_numbering_tabl
 }
 
 
+/**
+ * Replace the parameters of a phi function with their value names. Every version of a variable
+ * shares one live range, so a phi function only works if all of its parameters are versions
+ * of the variable that it assigns. The one exception is when every parameter has the same value
+ * name, because then the phi function is redundant and will be turned into a plain assignment
+ */
+static inline u_int8_t replace_phi_function_parameters(value_numbering_table_t* table, instruction_t* phi_function){
+	//Flag whether or not we've made one
+	u_int8_t performed_substitution = FALSE;
+
+	//Do all of the parameters have the same value name?
+	three_addr_var_t* first_value_name = get_value_name(table, dynamic_array_get_at(&(phi_function->parameters), 0));
+	u_int8_t all_same = TRUE;
+
+	for(int32_t i = 1; i < phi_function->parameters.current_index; i++){
+		if(variables_equal(first_value_name, get_value_name(table, dynamic_array_get_at(&(phi_function->parameters), i))) == FALSE){
+			all_same = FALSE;
+			break;
+		}
+	}
+
+	for(int32_t i = 0; i < phi_function->parameters.current_index; i++){
+		//Grab the old one out
+		three_addr_var_t* old_variable = dynamic_array_get_at(&(phi_function->parameters), i);
+
+		//Get the value name out
+		three_addr_var_t* value_name = get_value_name(table, old_variable);
+
+		//Otherwise only another version of the same variable is allowed
+		if(old_variable != value_name && (all_same == TRUE || variables_equal_no_ssa(old_variable, value_name) == TRUE)){
+			dynamic_array_set_at(&(phi_function->parameters), value_name, i);
+
+			old_variable->use_count--;
+			value_name->use_count++;
+
+			performed_substitution = TRUE;
+		}
+	}
+
+	return performed_substitution;
+}
+
+
 /**
  * For every RHS variable, we will perform value name substitutions. This is very
  * similar to the way that register allocation coalescence works except that this
@@ -6641,6 +6547,15 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 	//Were we able to perform any value numbering? If so flag this as true
 	u_int8_t simplification_occured = FALSE;
 
+	/**
+	 * Any expression that we compute in here is only available to the blocks that
+	 * this one dominates. We keep track of every expression that we add so that we
+	 * can take them back out once we're done with our dominator children. Value names
+	 * for variables are not tracked here, because the SSA form already guarantees that
+	 * the replacement dominates every use of the variable that it replaces
+	 */
+	u_int32_t scope_start = value_numbering_scope_begin(table);
+
 	/**
 	 * 	for each phi node in b:
 	 * 		if phi node is redundant then:
@@ -6668,18 +6583,12 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 		}
 		
 		/**
-		 * Otherwise we will need to save this value inside of the hash table. We
-		 * will generate the value name for it and save it inside. We need to do
-		 * this so that we have a trail of where it came from
+		 * Otherwise the phi function stays. Nothing else can compute the same value
+		 * that a phi function does, so there is no point in storing it in the table.
+		 * We still flag the assignee as value named so that it isn't clobbered
 		 */
-		dynamic_string_t textual_key = dynamic_string_alloc();
+		cursor->operands.oir.assignee->was_value_named = TRUE;
 
-		//Generate the value name like so
-		generate_value_name_key_for_instruction(cursor, &textual_key);
-		
-		//Now add this in with the key as our name, and the value as the assignee
-		add_value_number_expression(table, cursor->operands.oir.assignee, &textual_key);
-		
 		//Bump it up
 		cursor = cursor->next_statement;
 	}
@@ -6710,13 +6619,13 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 			 * for this instruction to see if it has already been computed 
 			 * before
 			 */
-			dynamic_string_t textual_string = dynamic_string_alloc();
+			value_number_key_t key;
 
 			//Generate the value name
-			generate_value_name_key_for_instruction(cursor, &textual_string);
+			generate_value_name_key_for_instruction(cursor, &key);
 
 			//Can we find the result in the table?
-			three_addr_var_t* found_result = lookup_value_number_expression(table, &textual_string);
+			three_addr_var_t* found_result = lookup_value_number_expression(table, &key);
 
 			/**
 			 * Option 1: we've found it, so this is a redundant computation. Instead of 
@@ -6745,15 +6654,15 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 				found_result->use_count++;
 
 				/**
-				 * Now we can use the textual string again to create a new 
-				 * record that makes sure any future instructions that use
-				 * the assignee here can instead use the result that we got
+				 * Now we can use the key again to create a new record that
+				 * makes sure any future instructions that use the assignee
+				 * here can instead use the result that we got
 				 */
-				clear_dynamic_string(&textual_string);
-				concatenate_value_name_string(cursor->operands.oir.assignee, &textual_string);
+				generate_value_name_key_for_variable(cursor->operands.oir.assignee, &key);
 
 				//Now we can add this to the table for future reference
-				add_value_number_expression(table, found_result, &textual_string);
+				add_value_number_expression(table, found_result, &key);
+				found_result->was_value_named = TRUE;
 
 				//Flag that we did do a simplification
 				simplification_occured = TRUE;
@@ -6764,7 +6673,8 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 			 * for future passes
 			 */
 			} else {
-				add_value_number_expression(table, cursor->operands.oir.assignee, &textual_string);
+				add_scoped_value_number_expression(table, cursor->operands.oir.assignee, &key);
+				cursor->operands.oir.assignee->was_value_named = TRUE;
 			}
 
 		/**
@@ -6797,7 +6707,7 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 		while(phi_cursor != NULL
 				&& phi_cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
 
-			if(perform_value_name_substitutions(table, phi_cursor) == TRUE){
+			if(replace_phi_function_parameters(table, phi_cursor) == TRUE){
 				//Flag that a simplification happened
 				simplification_occured = TRUE;
 			}
@@ -6811,9 +6721,9 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 	 * For each child c of the block in the *dominator* tree, we will
 	 * invoke this same algorithm recursively
 	 */
-	for(int32_t i = 0; i < block->dominator_children.current_index; i++){
+	for(int32_t i = 0; i < block->analysis->dominator_children.current_index; i++){
 		//Extract the dominator chid
-		basic_block_t* dominator_child = dynamic_array_get_at(&(block->dominator_children), i);
+		basic_block_t* dominator_child = dynamic_array_get_at(&(block->analysis->dominator_children), i);
 
 		/**
 		 * Recursively explore this one next. If we notice that this child
@@ -6824,6 +6734,9 @@ static u_int8_t global_value_number_block(value_numbering_table_t* table, basic_
 		}
 	}
 
+	//Now that we're leaving this block's dominance region, none of its expressions are available anymore
+	value_numbering_scope_end(table, scope_start);
+
 	//Return whether or not we did any simplifying
 	return simplification_occured;
 }
@@ -6852,13 +6765,13 @@ static inline u_int32_t estimate_value_numbering_keyspace_for_function(dynamic_a
 	 * number of instructions, we'll do nothing because
 	 * we expect to not be value numbering here. However
 	 * if we exceed the threshold, we will double the
-	 * keyspace to try and cut done on collisions
+	 * keyspace to keep the table at most half full
 	 */
 	if(keyspace <= INSTRUCTION_NUMBER_THRESHOLD){
 		return keyspace;
 	} else {
-		//There are 3 potential variables for each instruction
-		return keyspace * 3;
+		//Every instruction adds at most one entry to the table
+		return keyspace * 2;
 	}
 }
 
@@ -6867,7 +6780,7 @@ static inline u_int32_t estimate_value_numbering_keyspace_for_function(dynamic_a
  * Perform a global value numbering pass to determine if there are any redundant computations. This relies on
  * everything being in SSA form which OIR uses by default. We will also need the dominator tree and the ability
  * to traverse in reverse post order. We will be using the SSA names as the value numbers themselves inside of our
- * contextual strings
+ * keys
  *
  * Algorithm Dominator Value Numbering Traversal(block b):
  * 	for each phi node in b:
@@ -6919,23 +6832,6 @@ static u_int8_t global_value_numbering_pass(basic_block_t* function_entry_block,
 }
 
 
-/**
- * Run through an entire array of function blocks and reset the status for
- * every single one. We assume that the caller knows what they are doing, and
- * that the blocks inside of the array are really the correct blocks
- */
-static inline void reset_visit_status_for_function(dynamic_array_t* function_blocks){
-	//Run through all of the blocks
-	for(int32_t i = 0; i < function_blocks->current_index; i++){
-		//Extract the current block
-		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
-
-		//Flag it as false
-		current->visited = FALSE;
-	}
-}
-
-
 /**
  * Mark definitions(assignment) of a three address variable within a given
  * function. The current_function parameter is an optimization step designed to help
@@ -7007,7 +6903,7 @@ static void mark_and_add_definition(dynamic_array_t* current_function_blocks, th
 
 						dynamic_array_add(worklist, stmt);
 						stmt->mark = TRUE;
-						block->contains_mark = TRUE;
+						mark_block(block);
 						return;
 					}
 
@@ -7030,7 +6926,7 @@ static void mark_and_add_definition(dynamic_array_t* current_function_blocks, th
 					if(stmt->operands.oir.assignee->temp_var_number == variable->temp_var_number){
 						dynamic_array_add(worklist, stmt);
 						stmt->mark = TRUE;
-						block->contains_mark = TRUE;
+						mark_block(block);
 						return;
 					}
 
@@ -7182,41 +7078,31 @@ static simplification_type_t sweep(dynamic_array_t* function_blocks, basic_block
 }
 
 
-/**
- * Reset all of the marked instructions for a given block
- */
-static inline void reset_marks_for_block(basic_block_t* block){
-	//Start at the top
-	instruction_t* cursor = block->leader_statement;
-
-	//Crawl through the block
-	while(cursor != NULL){
-		//Unmark it
-		cursor->mark = FALSE;
-
-		//Go down the block by one
-		cursor = cursor->next_statement;
-	}
-
-	//Remove that this has a mark
-	block->contains_mark = FALSE;
-}
-
-
 /**
  * Run through and reset all of the marks on every instruction in a given
  * function. This is done in anticipation of us using the mark/sweep algorithm
- * again after branch optimizations
+ * again after branch optimizations. The block marks live in a side table, so
+ * those are all cleared at once by starting a new epoch
  */
-static inline void reset_all_marks(dynamic_array_t* function_blocks){
+static inline void reset_all_marks(symtab_function_record_t* function){
+	//Grab the blocks out
+	dynamic_array_t* function_blocks = &(function->function_blocks);
+
 	//Run through every block
 	for(int32_t i = 0; i < function_blocks->current_index; i++){
 		//Block to work on
 		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
 
-		//Let the helper do it
-		reset_marks_for_block(current);
+		//Crawl through the block and unmark every instruction
+		instruction_t* cursor = current->leader_statement;
+		while(cursor != NULL){
+			cursor->mark = FALSE;
+			cursor = cursor->next_statement;
+		}
 	}
+
+	//Now wipe every block mark in one go
+	reset_block_marks_for_function(function);
 }
 
 
@@ -7276,7 +7162,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_RET_STMT:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7286,7 +7172,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_RAISE_STMT:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7298,7 +7184,14 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_ASM_INLINE_STMT:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
+					break;
+
+				//Profile counters have to stay where they are, nothing reads them until the program exits
+				case THREE_ADDR_CODE_PROFILE_COUNTER_STMT:
+					current_stmt->mark = TRUE;
+					dynamic_array_add(&worklist, current_stmt);
+					mark_block(current);
 					break;
 
 				/**
@@ -7309,7 +7202,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_FUNC_CALL:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7321,7 +7214,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7334,7 +7227,7 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7344,7 +7237,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_STORE_STATEMENT:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7354,7 +7247,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -7366,7 +7259,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
 				case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
 					current_stmt->mark = TRUE;
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				//Let's see what other special cases we have
@@ -7482,10 +7375,10 @@ static void mark(dynamic_array_t* function_blocks){
 		 * 		add j to worklist
 		 */
 		//If this block even has an RDF(it may now)
-		if(block->reverse_dominance_frontier.internal_array != NULL){
-			for(int32_t i = 0; i < block->reverse_dominance_frontier.current_index; i++){
+		if(block->analysis->reverse_dominance_frontier.internal_array != NULL){
+			for(int32_t i = 0; i < block->analysis->reverse_dominance_frontier.current_index; i++){
 				//Grab the block out of the RDF
-				basic_block_t* rdf_block = dynamic_array_get_at(&(block->reverse_dominance_frontier), i);
+				basic_block_t* rdf_block = dynamic_array_get_at(&(block->analysis->reverse_dominance_frontier), i);
 
 				//Grab out the exit statement
 				instruction_t* exit_statement = rdf_block->exit_statement;
@@ -7499,7 +7392,7 @@ static void mark(dynamic_array_t* function_blocks){
 						if(exit_statement->mark == FALSE){
 							exit_statement->mark = TRUE;
 							dynamic_array_add(&worklist, exit_statement);
-							rdf_block->contains_mark = TRUE;
+							mark_block(rdf_block);
 						}
 
 						break;
@@ -7512,7 +7405,7 @@ static void mark(dynamic_array_t* function_blocks){
 						if(exit_statement->mark == FALSE){
 							exit_statement->mark = TRUE;
 							dynamic_array_add(&worklist, exit_statement);
-							rdf_block->contains_mark = TRUE;
+							mark_block(rdf_block);
 						}
 
 						break;
@@ -7540,12 +7433,12 @@ static inline simplification_type_t perform_mark_and_sweep_pass(basic_block_t* f
 	 * First thing we'll do is reset the visited status of the CFG. This just ensures
 	 * that we won't have any issues with the CFG in terms of traversal
 	 */
-	reset_visit_status_for_function(function_blocks);
+	reset_block_visits_for_function(function_entry->function_defined_in);
 
 	/**
 	 * Reset the marks for all of our blocks
 	 */
-	reset_all_marks(function_blocks);
+	reset_all_marks(function_entry->function_defined_in);
 
 	/**
 	 * Now we will let the mark algorithm go through and flag instructions as important
@@ -7566,70 +7459,73 @@ static inline simplification_type_t perform_mark_and_sweep_pass(basic_block_t* f
  * We'll make use of a while change algorithm here. We make passes
  * until we see the first pass where we experience no change at all.
  */
-static void simplify(cfg_t* cfg){
-	/**
-	 * We will do each function individually for efficiency reasons. This way, if
-	 * one function requires a lot of simplification, it will not drag the rest of the 
-	 * functions along with it in each pass
-	 */
-	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
-		//Extract it
-		basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+static void simplify_function(basic_block_t* function_entry){
+	//Extract the function record too
+	symtab_function_record_t* function = function_entry->function_defined_in;
 
-		//Extract the function record too
-		symtab_function_record_t* function = function_entry->function_defined_in;
+	//Let this keep going until we're done changing
+	while(simplifier_pass(function_entry) == TRUE);
 
-		//Let this keep going until we're done changing
-		while(simplifier_pass(function_entry) == TRUE);
+	/**
+	 * Once we're confident that we've done all of the simplifying that we can, we 
+	 * will now attempt to run a global value numbering pass for this function. If
+	 * this pass optimizes anything, we will then retrigger the simplifier
+	 * to see if there are any more opportuntities
+	 */
+	u_int8_t simplification_occured = global_value_numbering_pass(function_entry, &(function->function_blocks));
 
-		/**
-		 * Once we're confident that we've done all of the simplifying that we can, we 
-		 * will now attempt to run a global value numbering pass for this function. If
-		 * this pass optimizes anything, we will then retrigger the simplifier
-		 * to see if there are any more opportuntities
-		 */
-		u_int8_t simplification_occured = global_value_numbering_pass(function_entry, &(function->function_blocks));
+	/**
+	 * If we did do any global value numbering, then we'll need to come back
+	 * and resimplify to make sure we haven't missed anything post-simplify
+	 */
+	if(simplification_occured == TRUE){
+		//Run the mark and sweep
+		simplification_type_t result = perform_mark_and_sweep_pass(function_entry, &(function->function_blocks));
 
 		/**
-		 * If we did do any global value numbering, then we'll need to come back
-		 * and resimplify to make sure we haven't missed anything post-simplify
+		 * If we ended up doing control flow simplification, we are going to need
+		 * to reorder all of the blocks
 		 */
-		if(simplification_occured == TRUE){
-			//Run the mark and sweep
-			simplification_type_t result = perform_mark_and_sweep_pass(function_entry, &(function->function_blocks));
+		if(result == SIMPLIFICATION_INSTRUCTIONS_AND_CONTROL_FLOW){
+			order_function_blocks(function_entry);
+		}
 
-			/**
-			 * If we ended up doing control flow simplification, we are going to need
-			 * to reorder all of the blocks
-			 */
-			if(result == SIMPLIFICATION_INSTRUCTIONS_AND_CONTROL_FLOW){
-				order_blocks(cfg);
-			}
+		//Now run the simplifier
+		while(simplifier_pass(function_entry) == TRUE);
 
-			//Now run the simplifier
-			while(simplifier_pass(function_entry) == TRUE);
+	/**
+	 * Otherwise we were not able to value number anything, but we still may have redundant instructions
+	 * lying around. To fix this, we will now perform a mark and sweep pass but *no* additional simplifier
+	 * pass
+	 */
+	} else {
+		//Run the mark and sweep
+		simplification_type_t result = perform_mark_and_sweep_pass(function_entry, &(function->function_blocks));
 
 		/**
-		 * Otherwise we were not able to value number anything, but we still may have redundant instructions
-		 * lying around. To fix this, we will now perform a mark and sweep pass but *no* additional simplifier
-		 * pass
+		 * If we ended up doing control flow simplification, we are going to need
+		 * to reorder all of the blocks
 		 */
-		} else {
-			//Run the mark and sweep
-			simplification_type_t result = perform_mark_and_sweep_pass(function_entry, &(function->function_blocks));
-
-			/**
-			 * If we ended up doing control flow simplification, we are going to need
-			 * to reorder all of the blocks
-			 */
-			if(result == SIMPLIFICATION_INSTRUCTIONS_AND_CONTROL_FLOW){
-				order_blocks(cfg);
-			}
+		if(result == SIMPLIFICATION_INSTRUCTIONS_AND_CONTROL_FLOW){
+			order_function_blocks(function_entry);
 		}
 	}
 }
 
 
+/**
+ * Simplify the function at the given index. We will do each function individually for
+ * efficiency reasons. This way, if one function requires a lot of simplification, it will
+ * not drag the rest of the functions along with it in each pass
+ */
+static void simplify_job(void* shared_state, u_int32_t function_index){
+	//The shared state is just the CFG
+	cfg_t* cfg = shared_state;
+
+	simplify_function(dynamic_array_get_at(&(cfg->function_entry_blocks), function_index));
+}
+
+
 /**
  * Emit a PXOR instruction that's already been instruction selected. This is intended to
  * be used by the instruction selector when we need to insert pxor functions for clearing
@@ -13573,6 +13469,23 @@ static inline void handle_raise_instruction(instruction_t* instruction){
 }
 
 
+/**
+ * Handle a profile counter. There's no register involved, the counter is bumped
+ * right where it lives in memory. We emit this as a piece of inline assembly so
+ * that nothing downstream treats it as anything more than that
+ */
+static inline void handle_profile_counter_instruction(instruction_t* instruction){
+	char counter_increment[100];
+
+	//The offset is in the same union as the assembly, so grab it before anything is overwritten
+	sprintf(counter_increment, "\tincq %s+%lu(%%rip)", PROFILE_DATA_SYMBOL, instruction->optional_storage.profile_counter_offset);
+
+	instruction->instruction_type = ASM_INLINE;
+	instruction->optional_storage.inlined_assembly = dynamic_string_alloc();
+	dynamic_string_set(&(instruction->optional_storage.inlined_assembly), counter_increment);
+}
+
+
 /**
  * A branch statement always selects 2 instructions, the conditional
  * jump-to-if and the unconditional else jump
@@ -14164,6 +14077,52 @@ static inline void add_local_constant_to_cfg(cfg_t* cfg, local_constant_t* local
 }
 
 
+/**
+ * Get the sign mask that a floating point negation of the given size xors with, making
+ * it if it doesn't exist yet. The local constants are shared by every function, so this
+ * needs to hold the lock even when it's only looking
+ */
+static local_constant_t* get_or_create_negation_constant(variable_size_t size){
+	//A 1 at the end of the first 64 or 32 bits
+	u_int64_t mask = size == DOUBLE_PRECISION ? 0x8000000000000000 : 0x80000000;
+
+	pthread_mutex_lock(&local_constants_mutex);
+
+	//Let's see if we can find it
+	local_constant_t* local_constant = get_xmm128_local_constant(&(cfg_reference->local_xmm128_constants), 0, mask);
+
+	//If we can't we need to create it
+	if(local_constant == NULL){
+		local_constant = xmm128_local_constant_alloc(f64, 0, mask);
+
+		//Add this into the CFG
+		add_local_constant_to_cfg(cfg_reference, local_constant);
+	}
+
+	pthread_mutex_unlock(&local_constants_mutex);
+
+	return local_constant;
+}
+
+
+/**
+ * Make every sign mask that the floating point negations in this function will need. Functions
+ * are selected in parallel, so if we left this to the selector the masks would be numbered in
+ * whatever order the workers got to them. Doing it up front, one function at a time, keeps the
+ * output the same no matter how many threads we use
+ */
+static void create_negation_constants_in_function(basic_block_t* function_entry){
+	for(basic_block_t* current = function_entry; current != NULL; current = current->direct_successor){
+		for(instruction_t* cursor = current->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(cursor->statement_type == THREE_ADDR_CODE_NEG_STATEMENT
+				&& IS_FLOATING_POINT(cursor->operands.oir.assignee->type) == TRUE){
+				get_or_create_negation_constant(get_type_size(cursor->operands.oir.assignee->type));
+			}
+		}
+	}
+}
+
+
 /**
  * Handle a negation instruction. It should be noted that there
  * are 2 different kinds of negation selection processes, one for
@@ -14226,8 +14185,8 @@ static void handle_negation_instruction(instruction_window_t* window){
 		//This goes in before the move
 		insert_instruction_before_given(direct_move_instruction, negation_instruction);
 
-		//The local constant value. Will be allocated based on the size that we have
-		local_constant_t* local_constant;
+		//The sign mask that we'll xor with
+		local_constant_t* local_constant = get_or_create_negation_constant(size);
 
 		//The move instruction that we need to allocate as well
 		instruction_t* local_constant_load_instruction;
@@ -14238,18 +14197,6 @@ static void handle_negation_instruction(instruction_window_t* window){
 		//We'll need to emit the appropriate constant based on whether we have a float or not
 		switch(size){
 			case DOUBLE_PRECISION:
-				//Let's see if we can find it
-				local_constant = get_xmm128_local_constant(&(cfg_reference->local_xmm128_constants), 0, 0x8000000000000000);
-
-				//If we can't we need to create it
-				if(local_constant == NULL){
-					//Allocate a local constant with a 1 at the end of the first 64 bits
-					local_constant = xmm128_local_constant_alloc(f64, 0, 0x8000000000000000);
-
-					//Add this into the function
-					add_local_constant_to_cfg(cfg_reference, local_constant);
-				}
-
 				//Emit the load instruction with the aligned load set to true
 				local_constant_load_instruction = emit_local_constant_from_memory_load(f64, local_constant, TRUE);
 
@@ -14259,18 +14206,6 @@ static void handle_negation_instruction(instruction_window_t* window){
 				break;
 
 			case SINGLE_PRECISION:
-				//Let's see if we can find it
-				local_constant = get_xmm128_local_constant(&(cfg_reference->local_xmm128_constants), 0, 0x80000000);
-
-				//If we can't we need to create it
-				if(local_constant == NULL){
-					//Allocate a local constant with a 1 at the end of the first 32 bits
-					local_constant = xmm128_local_constant_alloc(f64, 0, 0x80000000);
-
-					//Add this into the function
-					add_local_constant_to_cfg(cfg_reference, local_constant);
-				}
-
 				//Emit the load instruction with the aligned load set to true
 				local_constant_load_instruction = emit_local_constant_from_memory_load(f32, local_constant, TRUE);
 
@@ -15120,6 +15055,9 @@ static void select_instruction_patterns(instruction_window_t* window, symtab_fun
 		case THREE_ADDR_CODE_ASM_INLINE_STMT:
 			instruction->instruction_type = ASM_INLINE;
 			break;
+		case THREE_ADDR_CODE_PROFILE_COUNTER_STMT:
+			handle_profile_counter_instruction(instruction);
+			break;
 		case THREE_ADDR_CODE_FUNC_CALL:
 			handle_function_call(instruction);
 			break;
@@ -15183,46 +15121,49 @@ static void select_instruction_patterns(instruction_window_t* window, symtab_fun
  * Run through every block and convert each instruction or sequence of instructions
  * from three address code to assembly statements
  */
-static void select_instructions(cfg_t* cfg){
-	//We will again do instruction selection on a per-function level basis
-	for(u_int16_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
-		//Extract the entry
-		basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
-
-		//Extract the function record too
-		symtab_function_record_t* function_record = function_entry->function_defined_in;
+static void select_function_instructions(basic_block_t* function_entry){
+	//Extract the function record too
+	symtab_function_record_t* function_record = function_entry->function_defined_in;
 
-		//Save the current block here
-		basic_block_t* current = function_entry;
+	//Save the current block here
+	basic_block_t* current = function_entry;
 
-		while(current != NULL){
-			//Initialize the sliding window(very basic, more to come)
-			instruction_window_t window = initialize_instruction_window(current);
+	while(current != NULL){
+		//Initialize the sliding window(very basic, more to come)
+		instruction_window_t window = initialize_instruction_window(current);
 
-			//Run through the window so long as we are not at the end
-			do{
-				//Select the instructions
-				select_instruction_patterns(&window, function_record);
+		//Run through the window so long as we are not at the end
+		do{
+			//Select the instructions
+			select_instruction_patterns(&window, function_record);
 
-				//Slide the window
-				slide_window(&window);
+			//Slide the window
+			slide_window(&window);
 
-			//Keep going if we aren't at the end
-			} while(window.instruction1 != NULL);
+		//Keep going if we aren't at the end
+		} while(window.instruction1 != NULL);
 
-			//Advance the current up
-			current = current->direct_successor;
-		}
+		//Advance the current up
+		current = current->direct_successor;
 	}
 }
 
 
 /**
- * A function that selects all instructions, via the peephole method. This kind of 
- * operation completely translates the CFG out of a CFG. When done, we have a straight line
- * of code that we print out
+ * Select the instructions for the function at the given index
  */
-void select_all_instructions(compiler_options_t* options, cfg_t* cfg){
+static void select_instructions_job(void* shared_state, u_int32_t function_index){
+	//The shared state is just the CFG
+	cfg_t* cfg = shared_state;
+
+	select_function_instructions(dynamic_array_get_at(&(cfg->function_entry_blocks), function_index));
+}
+
+
+/**
+ * Load up all of the shared state that the selector needs
+ */
+static void initialize_instruction_selector(cfg_t* cfg){
 	//Grab these general use types first
 	double_quad_word = lookup_type_name_only(cfg->type_symtab, "&double_quad_word", NOT_MUTABLE)->type;
 	f64 = lookup_type_name_only(cfg->type_symtab, "f64", NOT_MUTABLE)->type;
@@ -15235,27 +15176,65 @@ void select_all_instructions(compiler_options_t* options, cfg_t* cfg){
 	u16 = lookup_type_name_only(cfg->type_symtab, "u16", NOT_MUTABLE)->type;
 	u8 = lookup_type_name_only(cfg->type_symtab, "u8", NOT_MUTABLE)->type;
 
-	/**
-	 * Allocate any of these reusable memory regions that we'll
-	 * be using. We do this because it's cheaper to just use
-	 * 1 over and over instead of allocating fresh every single
-	 * time that we need something
-	 */
-	value_name_searcher_string = dynamic_string_alloc();
-
 	//Stash the stack pointer & instruction pointer
 	stack_pointer_variable = cfg->stack_pointer;
 	instruction_pointer_variable = cfg->instruction_pointer;
 
 	//Store a reference to the CFG as well
 	cfg_reference = cfg;
+}
+
+
+/**
+ * Order, simplify and select the instructions for only the function at the
+ * given index. This does the exact same thing as select_all_instructions, just
+ * for one function
+ */
+void select_instructions_in_function(cfg_t* cfg, u_int32_t function_index){
+	//Grab the function out
+	basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), function_index);
+
+	//Set up the shared state
+	initialize_instruction_selector(cfg);
+
+	//Put the blocks in a straight line
+	order_function_blocks(function_entry);
+
+	//Simplify the expanded OIR
+	simplify_function(function_entry);
+
+	//Make any sign masks before we select
+	create_negation_constants_in_function(function_entry);
+
+	//And finally select
+	select_function_instructions(function_entry);
+}
+
+
+/**
+ * A function that selects all instructions, via the peephole method. This kind of 
+ * operation completely translates the CFG out of a CFG. When done, we have a straight line
+ * of code that we print out
+ *
+ * Every step is done for each function on its own, using up to the given number of threads. The
+ * steps themselves still run one after the other so that the whole program can be printed in between
+ */
+void select_all_instructions(compiler_options_t* options, cfg_t* cfg){
+	//Set up the shared state
+	initialize_instruction_selector(cfg);
+
+	//How many functions we have to get through
+	u_int32_t function_count = cfg->function_entry_blocks.current_index;
+
+	//We'll first wipe the visited status on this CFG
+	reset_visited_status(cfg, TRUE);
 
 	/**
 	 * Our very first step in the instruction selector is to order all of the blocks in one 
 	 * straight line. This step is also able to recognize and exploit some early optimizations,
 	 * such as when a block ends in a jump to the block right below it 
 	 */
-	order_blocks(cfg);
+	thread_pool_run(options->thread_count, function_count, order_blocks_job, cfg);
 
 	//Do we need to print intermediate representations?
 	u_int8_t print_irs = options->print_irs;
@@ -15272,7 +15251,7 @@ void select_all_instructions(compiler_options_t* options, cfg_t* cfg){
 	 * format that is used in the optimization phase. Now, we need to take that expanded IR and
 	 * recognize any redundant operations, dead values, unnecessary loads, etc.
 	 */
-	simplify(cfg);
+	thread_pool_run(options->thread_count, function_count, simplify_job, cfg);
 
 	//If we need to print IRS, we can do so here
 	if(print_irs == TRUE){
@@ -15280,17 +15259,16 @@ void select_all_instructions(compiler_options_t* options, cfg_t* cfg){
 		printf("============================== AFTER INSTRUCTION SELECTION ========================================\n");
 	}
 
+	//The sign masks are shared, so they're made here in function order before any of the workers start
+	for(u_int32_t i = 0; i < function_count; i++){
+		create_negation_constants_in_function(dynamic_array_get_at(&(cfg->function_entry_blocks), i));
+	}
+
 	//Once we're done simplifying, we'll use the same sliding window technique to select instructions.
-	select_instructions(cfg);
+	thread_pool_run(options->thread_count, function_count, select_instructions_job, cfg);
 
 	//Final IR printing if requested by user
 	if(print_irs == TRUE){
 		print_ordered_blocks(cfg, PRINT_INSTRUCTION);
 	}
-
-	/**
-	 * Now we'll deallocate all of the shared memory
-	 * regions that we've been using
-	 */
-	dynamic_string_dealloc(&value_name_searcher_string);
 }
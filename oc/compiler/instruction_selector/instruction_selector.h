@@ -17,4 +17,10 @@
  */
 void select_all_instructions(compiler_options_t* options, cfg_t* cfg);
 
+/**
+ * Select all instructions for only the function at the given index. This is used
+ * when functions are streamed through the back end one at a time
+ */
+void select_instructions_in_function(cfg_t* cfg, u_int32_t function_index);
+
 #endif /* INTSTRUCTION_SELECTOR_H */
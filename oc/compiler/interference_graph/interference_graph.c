@@ -133,13 +133,33 @@ void remove_interference(interference_graph_t* graph, live_range_t* a, live_rang
  * caolescee at all
  */
 void coalesce_live_ranges(interference_graph_t* graph, live_range_t* target, live_range_t* coalescee){
+	/**
+	 * The %rsp and %rip live ranges are shared by every function in the program, and functions
+	 * may be allocated in parallel. Due to this, we never modify them here. All that we'll do
+	 * is point the coalescee's variables at them
+	 */
+	u_int8_t target_is_shared = FALSE;
+
+	if(target->live_range_class == LIVE_RANGE_CLASS_GEN_PURPOSE){
+		switch(target->reg.gen_purpose){
+			case RSP:
+			case RIP:
+				target_is_shared = TRUE;
+				break;
+			default:
+				break;
+		}
+	}
+
 	//All of these variables now belong to the target
 	for(u_int16_t i = 0; i < coalescee->variables.current_index; i++){
 		//Grab it out
 		three_addr_var_t* new_var = dynamic_array_get_at(&(coalescee->variables), i);
 
 		//Add it into the target's variables
-		dynamic_array_add(&(target->variables), new_var);
+		if(target_is_shared == FALSE){
+			dynamic_array_add(&(target->variables), new_var);
+		}
 
 		//Update the associated live range to be the target
 		new_var->associated_live_range = target;
@@ -163,6 +183,14 @@ void coalesce_live_ranges(interference_graph_t* graph, live_range_t* target, liv
 		add_interference_in_graph(graph, target, neighbor);
 	}
 
+	//We're done with the clone now
+	dynamic_array_dealloc(&clone);
+
+	//Nothing below here applies to a shared live range
+	if(target_is_shared == TRUE){
+		return;
+	}
+
 	/**
 	 * If the target has no register, we will be taking the coalescee's register
 	 *
@@ -203,10 +231,18 @@ void coalesce_live_ranges(interference_graph_t* graph, live_range_t* target, liv
  * Build the interference graph from the adjacency lists
  */
 interference_graph_t* construct_interference_graph_from_adjacency_lists(dynamic_array_t* live_ranges){
-	//Run through and give everything an index
+	/**
+	 * Run through and give everything an index. Some live ranges(the stack & instruction
+	 * pointer) are shared by every function and always land at the same index, so we only
+	 * write when something actually changes. This keeps those shared ranges untouched when
+	 * functions are being allocated in parallel
+	 */
 	for(u_int16_t i = 0; i < live_ranges->current_index; i++){
 		live_range_t* range = dynamic_array_get_at(live_ranges, i);
-		range->interference_graph_index = i;
+
+		if(range->interference_graph_index != i){
+			range->interference_graph_index = i;
+		}
 	}
 	
 	//Now we'll create the actual graph itself
@@ -7,6 +7,11 @@
 #include "optimizer.h"
 #include "../utils/constants.h"
 #include "../graph_analyzer/graph_analyzer.h"
+#include "../alias_analysis/alias_analysis.h"
+#include "../utils/value_numbering_table/value_numbering_table.h"
+#include "../utils/thread_pool/thread_pool.h"
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
@@ -19,6 +24,15 @@ static three_addr_var_t* instruction_pointer_variable;
 //A pointer to the cfg
 static cfg_t* cfg_reference;
 
+//How many copies of a loop body we may make when unrolling. This is never written once the workers start
+static u_int32_t loop_unroll_factor = DEFAULT_LOOP_UNROLL_FACTOR;
+
+//The list of created blocks is shared by every function, so any edits to it need this
+static pthread_mutex_t created_blocks_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//Same for the variable symtab, which we add to when we make new variables
+static pthread_mutex_t variable_symtab_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /**
  * We are going to need to maintain a mapping of temporary
  * variables to replacement variables. Remember that the SSA 
@@ -62,23 +76,6 @@ typedef enum{
 } conditional_status_t;
 
 
-/**
- * Run through an entire array of function blocks and reset the status for
- * every single one. We assume that the caller knows what they are doing, and
- * that the blocks inside of the array are really the correct blocks
- */
-static inline void reset_visit_status_for_function(dynamic_array_t* function_blocks){
-	//Run through all of the blocks
-	for(int32_t i = 0; i < function_blocks->current_index; i++){
-		//Extract the current block
-		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
-
-		//Flag it as false
-		current->visited = FALSE;
-	}
-}
-
-
 /**
  * A helper function that makes a new block id. This ensures we have an atomically
  * increasing block ID
@@ -154,7 +151,7 @@ static inline void reset_marks_for_block(basic_block_t* block){
 	}
 
 	//Remove that this has a mark
-	block->contains_mark = FALSE;
+	unmark_block(block);
 }
 
 
@@ -197,17 +194,28 @@ static inline u_int8_t does_statement_have_block_external_side_effects(instructi
 /**
  * Run through and reset all of the marks on every instruction in a given
  * function. This is done in anticipation of us using the mark/sweep algorithm
- * again after branch optimizations
+ * again after branch optimizations. The block marks live in a side table, so
+ * those are all cleared at once by starting a new epoch
  */
-static inline void reset_all_marks(dynamic_array_t* function_blocks){
+static inline void reset_all_marks(symtab_function_record_t* function){
+	//Grab the blocks out
+	dynamic_array_t* function_blocks = &(function->function_blocks);
+
 	//Run through every block
 	for(int32_t i = 0; i < function_blocks->current_index; i++){
 		//Block to work on
 		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
 
-		//Let the helper do it
-		reset_marks_for_block(current);
+		//Crawl through the block and unmark every instruction
+		instruction_t* cursor = current->leader_statement;
+		while(cursor != NULL){
+			cursor->mark = FALSE;
+			cursor = cursor->next_statement;
+		}
 	}
+
+	//Now wipe every block mark in one go
+	reset_block_marks_for_function(function);
 }
 
 
@@ -282,7 +290,9 @@ static void combine(cfg_t* cfg, basic_block_t* a, basic_block_t* b){
 	}
 	
 	//We'll remove this from the list of created blocks
-	dynamic_array_delete(&(cfg->created_blocks), b);
+	pthread_mutex_lock(&created_blocks_mutex);
+	remove_from_created_blocks(cfg, b);
+	pthread_mutex_unlock(&created_blocks_mutex);
 }
 
 
@@ -458,7 +468,7 @@ static void mark_and_add_definition(dynamic_array_t* current_function_blocks, th
 						//Mark it
 						stmt->mark = TRUE;
 						//Mark it
-						block->contains_mark = TRUE;
+						mark_block(block);
 						return;
 					}
 
@@ -474,6 +484,17 @@ static void mark_and_add_definition(dynamic_array_t* current_function_blocks, th
 					//Extract the assignee as we'll be needing it
 					three_addr_var_t* assignee = stmt->operands.oir.assignee;
 
+					//A call that isn't already important defines its error value as well
+					if(stmt->mark == FALSE && stmt->statement_type == THREE_ADDR_CODE_FUNC_CALL
+						&& stmt->optional_storage.error_assignee != NULL
+						&& stmt->optional_storage.error_assignee->variable_type == VARIABLE_TYPE_TEMP
+						&& stmt->optional_storage.error_assignee->temp_var_number == variable->temp_var_number){
+						dynamic_array_add(worklist, stmt);
+						stmt->mark = TRUE;
+						mark_block(block);
+						return;
+					}
+
 					//If this is the case, we'll just go onto the next one
 					if(stmt->mark == TRUE || assignee == NULL){
 						stmt = stmt->previous_statement;
@@ -487,7 +508,7 @@ static void mark_and_add_definition(dynamic_array_t* current_function_blocks, th
 						//Mark it
 						stmt->mark = TRUE;
 						//Mark the block
-						block->contains_mark = TRUE;
+						mark_block(block);
 						return;
 					}
 
@@ -567,7 +588,7 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -580,7 +601,7 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//This block does contain a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -594,20 +615,41 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
+					break;
+
+				/**
+				 * Profile counters are never read by the program
+				 * itself, but the runtime writes them all out
+				 * when the program exits
+				 */
+				case THREE_ADDR_CODE_PROFILE_COUNTER_STMT:
+					current_stmt->mark = TRUE;
+					//Add it to the list
+					dynamic_array_add(&worklist, current_stmt);
+					//The block now has a mark
+					mark_block(current);
 					break;
 
 				/**
 				 * Since we don't know whether or not a function
 				 * that is being called performs an important task,
-				 * we also always consider it to be important
+				 * we also consider it to be important. The exception is
+				 * a pure function that always returns - all it does is
+				 * give back a value, so it's only important if that value is
 				 */
 				case THREE_ADDR_CODE_FUNC_CALL:
+					if(current_stmt->called_function != NULL
+						&& current_stmt->called_function->is_pure == TRUE
+						&& current_stmt->called_function->always_returns == TRUE){
+						break;
+					}
+
 					current_stmt->mark = TRUE;
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -621,7 +663,7 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -634,7 +676,7 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -646,7 +688,7 @@ static void mark(dynamic_array_t* function_blocks){
 					//Add it to the list
 					dynamic_array_add(&worklist, current_stmt);
 					//The block now has a mark
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -656,7 +698,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
 					current_stmt->mark = TRUE;
 					dynamic_array_add(&worklist, current_stmt);
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				/**
@@ -668,7 +710,7 @@ static void mark(dynamic_array_t* function_blocks){
 				case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
 				case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
 					current_stmt->mark = TRUE;
-					current->contains_mark = TRUE;
+					mark_block(current);
 					break;
 
 				//Let's see what other special cases we have
@@ -785,10 +827,10 @@ static void mark(dynamic_array_t* function_blocks){
 		 * 		add j to worklist
 		 */
 		//If this block even has an RDF(it may now)
-		if(block->reverse_dominance_frontier.internal_array != NULL){
-			for(u_int16_t i = 0; i < block->reverse_dominance_frontier.current_index; i++){
+		if(block->analysis->reverse_dominance_frontier.internal_array != NULL){
+			for(u_int16_t i = 0; i < block->analysis->reverse_dominance_frontier.current_index; i++){
 				//Grab the block out of the RDF
-				basic_block_t* rdf_block = dynamic_array_get_at(&(block->reverse_dominance_frontier), i);
+				basic_block_t* rdf_block = dynamic_array_get_at(&(block->analysis->reverse_dominance_frontier), i);
 
 				//Grab out the exit statement
 				instruction_t* exit_statement = rdf_block->exit_statement;
@@ -807,7 +849,7 @@ static void mark(dynamic_array_t* function_blocks){
 							//Add it to the worklist
 							dynamic_array_add(&worklist, exit_statement);
 							//This now has a mark
-							rdf_block->contains_mark = TRUE;
+							mark_block(rdf_block);
 						}
 
 						break;
@@ -824,7 +866,7 @@ static void mark(dynamic_array_t* function_blocks){
 							//Add it to the worklist
 							dynamic_array_add(&worklist, exit_statement);
 							//This now has a mark
-							rdf_block->contains_mark = TRUE;
+							mark_block(rdf_block);
 						}
 
 						break;
@@ -843,82 +885,88 @@ static void mark(dynamic_array_t* function_blocks){
 
 
 /**
- * Replace all targets that jump to "empty block" with "replacement". This is a helper 
- * function for the "Empty Block Removal" step of clean()
+ * Make the given predecessor go to the replacement everywhere that it used to go to
+ * the old target. This covers the jump tables, jumps and branches that a block may end with
  */
-static void replace_all_branch_targets(basic_block_t* empty_block, basic_block_t* replacement){
-	//Use a clone since we are mutating
-	dynamic_array_t clone = clone_dynamic_array(&(empty_block->predecessors));
+static void redirect_block_exit(basic_block_t* predecessor, basic_block_t* old_target, basic_block_t* replacement){
+	//The old target is no longer a successor of this predecessor
+	delete_successor(predecessor, old_target);
+	
+	//Run through the jump table and replace all of those targets as well. Most of the time,
+	//we won't hit this because num_nodes will be 0. In the times that we do though, this is
+	//what will ensure that switch statements are not corrupted by the optimization process
+	if(predecessor->jump_table != NULL){
+		for(int32_t jump_table_index = 0; jump_table_index < predecessor->jump_table->num_nodes; jump_table_index++){
+			//If this equals the other node, we'll need to replace it
+			if(dynamic_array_get_at(&(predecessor->jump_table->nodes), jump_table_index) == old_target){
+				//This now points to the replacement
+				dynamic_array_set_at(&(predecessor->jump_table->nodes), replacement, jump_table_index);
+
+				//The replacement is now a successor of this predecessor
+				add_successor(predecessor, replacement);
+			}
+		}
+	}
 
-	//For everything in the predecessor set of the empty block
-	for(int32_t i = 0; i < clone.current_index; i++){
-		//Grab a given predecessor out
-		basic_block_t* predecessor = dynamic_array_get_at(&clone, i);
+	//We always will be starting at the exit statement. Branches/jumps
+	//can only happen at the end
+	instruction_t* exit_statement = predecessor->exit_statement;
 
-		//The empty block is no longer a successor of this predecessor
-		delete_successor(predecessor, empty_block);
-		
-		//Run through the jump table and replace all of those targets as well. Most of the time,
-		//we won't hit this because num_nodes will be 0. In the times that we do though, this is
-		//what will ensure that switch statements are not corrupted by the optimization process
-		if(predecessor->jump_table != NULL){
-			for(int32_t jump_table_index = 0; jump_table_index < predecessor->jump_table->num_nodes; jump_table_index++){
-				//If this equals the other node, we'll need to replace it
-				if(dynamic_array_get_at(&(predecessor->jump_table->nodes), jump_table_index) == empty_block){
-					//This now points to the replacement
-					dynamic_array_set_at(&(predecessor->jump_table->nodes), replacement, jump_table_index);
+	//This can happen - and if it's the case, we move along
+	if(exit_statement == NULL){
+		return;
+	}
 
-					//The replacement is now a successor of this predecessor
-					add_successor(predecessor, replacement);
-				}
+	//Go based on the type
+	switch(exit_statement->statement_type){
+		//One type of block exit
+		case THREE_ADDR_CODE_JUMP_STMT:
+			//If this is the right target, then replace it
+			if(exit_statement->if_block == old_target){
+				exit_statement->if_block = replacement;
+				//Counts as a successor
+				add_successor(predecessor, replacement);
 			}
-		}
 
-		//We always will be starting at the exit statement. Branches/jumps
-		//can only happen at the end
-		instruction_t* exit_statement = predecessor->exit_statement;
-
-		//This can happen - and if it's the case, we move along
-		if(exit_statement == NULL){
-			continue;
-		}
+			break;
 
-		//Go based on the type
-		switch(exit_statement->statement_type){
-			//One type of block exit
-			case THREE_ADDR_CODE_JUMP_STMT:
-				//If this is the right target, then replace it
-				if(exit_statement->if_block == empty_block){
-					exit_statement->if_block = replacement;
-					//Counts as a successor
-					add_successor(predecessor, replacement);
-				}
+		//Other type of block exit
+		case THREE_ADDR_CODE_BRANCH_STMT:
+			//If this is the right target, then replace it
+			if(exit_statement->if_block == old_target){
+				exit_statement->if_block = replacement;
+				//Counts as a successor
+				add_successor(predecessor, replacement);
+			}
 
-				break;
+			//Same for the else block
+			if(exit_statement->else_block == old_target){
+				exit_statement->else_block = replacement;
+				//Counts as a successor
+				add_successor(predecessor, replacement);
+			}
 
-			//Other type of block exit
-			case THREE_ADDR_CODE_BRANCH_STMT:
-				//If this is the right target, then replace it
-				if(exit_statement->if_block == empty_block){
-					exit_statement->if_block = replacement;
-					//Counts as a successor
-					add_successor(predecessor, replacement);
-				}
+			break;
 
-				//Same for the else block
-				if(exit_statement->else_block == empty_block){
-					exit_statement->else_block = replacement;
-					//Counts as a successor
-					add_successor(predecessor, replacement);
-				}
+		//By default do nothing
+		default:
+			break;
+	}
+}
 
-				break;
 
-			//By default do nothing
-			default:
-				break;
-		}
+/**
+ * Replace all targets that jump to "empty block" with "replacement". This is a helper 
+ * function for the "Empty Block Removal" step of clean()
+ */
+static void replace_all_branch_targets(basic_block_t* empty_block, basic_block_t* replacement){
+	//Use a clone since we are mutating
+	dynamic_array_t clone = clone_dynamic_array(&(empty_block->predecessors));
 
+	//For everything in the predecessor set of the empty block
+	for(int32_t i = 0; i < clone.current_index; i++){
+		//Grab a given predecessor out and send it to the replacement instead
+		redirect_block_exit(dynamic_array_get_at(&clone, i), empty_block, replacement);
 	}
 
 	//The empty block now no longer has the replacement as a successor
@@ -1036,7 +1084,7 @@ void sweep_local_constants(cfg_t* cfg){
  * 			  delete i
  *
  */
-static void sweep(dynamic_array_t* function_blocks, basic_block_t* function_entry_block){
+static void sweep(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, control_flow_update_log_t* control_flow_updates){
 	//For each and every operation in every basic block
 	for(int32_t _ = 0; _ < function_blocks->current_index; _++){
 		//Grab the block out
@@ -1094,6 +1142,11 @@ static void sweep(dynamic_array_t* function_blocks, basic_block_t* function_entr
 					 */
 					stmt = emit_jump(block, nearest_marked_postdom);
 
+					//This is a brand new edge in the CFG
+					if(nearest_marked_postdom != NULL){
+						record_control_flow_update(control_flow_updates, block, nearest_marked_postdom, CONTROL_FLOW_EDGE_INSERTED);
+					}
+
 					break;
 
 				/**
@@ -1450,15 +1503,28 @@ static inline u_int8_t are_blocks_eligible_for_branch_hoisting(basic_block_t* de
 	return TRUE;
 }
 
+/**
+ * Add a variable into a block's assigned set. Blocks that the optimizer makes don't
+ * have the set allocated yet, so we take care of that here
+ */
+static inline void add_assigned_variable_to_block(basic_block_t* block, three_addr_var_t* variable){
+	if(block->analysis->assigned_variables.internal_array == NULL){
+		block->analysis->assigned_variables = dynamic_array_alloc();
+	}
+
+	dynamic_array_add(&(block->analysis->assigned_variables), variable);
+}
+
+
 /**
  * Does a given block define a non-temporary variable? If so, we'll find out here by searching
  * through the block's "assigned" sets
  */
 static inline u_int8_t does_block_assign_variable(basic_block_t* block, three_addr_var_t* variable){
 	//Run through every assigned variable
-	for(int32_t i = 0; i < block->assigned_variables.current_index; i++){
+	for(int32_t i = 0; i < block->analysis->assigned_variables.current_index; i++){
 		//Extract it
-		three_addr_var_t* candidate = dynamic_array_get_at(&(block->assigned_variables), i);
+		three_addr_var_t* candidate = dynamic_array_get_at(&(block->analysis->assigned_variables), i);
 
 		//If they're equal then get out
 		if(variables_equal(variable, candidate) == TRUE){
@@ -2034,7 +2100,7 @@ static inline conditional_status_t determine_conditional_status(instruction_t* c
  * This will return true if we did find anything to optimize, and false if
  * we did not
  */
-static u_int8_t optimize_always_true_false_paths(dynamic_array_t* function_blocks){
+static u_int8_t optimize_always_true_false_paths(dynamic_array_t* function_blocks, control_flow_update_log_t* control_flow_updates){
 	//By default assume that we found nothing to optimize
 	u_int8_t found_branches_to_optimize = FALSE;
 
@@ -2115,6 +2181,7 @@ static u_int8_t optimize_always_true_false_paths(dynamic_array_t* function_block
 
 					//With that out of the way, we can remove the if block as a successor
 					delete_successor(current_block, if_block);
+					record_control_flow_update(control_flow_updates, current_block, if_block, CONTROL_FLOW_EDGE_DELETED);
 
 					//The branch instruction is now useless, delete it
 					delete_statement(branch_instruction);
@@ -2130,6 +2197,7 @@ static u_int8_t optimize_always_true_false_paths(dynamic_array_t* function_block
 
 					//With that out of the way, we can remove the else block as a successor
 					delete_successor(current_block, else_block);
+					record_control_flow_update(control_flow_updates, current_block, else_block, CONTROL_FLOW_EDGE_DELETED);
 
 					//The branch instruction is now useless, delete it
 					delete_statement(branch_instruction);
@@ -2156,6 +2224,7 @@ static u_int8_t optimize_always_true_false_paths(dynamic_array_t* function_block
 
 					//With that out of the way, we can remove the else block as a successor
 					delete_successor(current_block, else_block);
+					record_control_flow_update(control_flow_updates, current_block, else_block, CONTROL_FLOW_EDGE_DELETED);
 
 					//The branch instruction is now useless, delete it
 					delete_statement(branch_instruction);
@@ -2171,6 +2240,7 @@ static u_int8_t optimize_always_true_false_paths(dynamic_array_t* function_block
 
 					//With that out of the way, we can remove the if block as a successor
 					delete_successor(current_block, if_block);
+					record_control_flow_update(control_flow_updates, current_block, if_block, CONTROL_FLOW_EDGE_DELETED);
 
 					//The branch instruction is now useless, delete it
 					delete_statement(branch_instruction);
@@ -2354,7 +2424,7 @@ static inline conditional_movement_type_t convert_branch_type_to_conditional_mov
  * t5 <- x_0 > y_0
  * z_2 <- cmove_le y_0 else x_0
  */
-static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* current_function_blocks){
+static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* current_function_blocks, control_flow_update_log_t* control_flow_updates){
 	//Did we optimize a branching assignment? By default we did not
 	u_int8_t optimized_branching_assigment = FALSE;
 
@@ -2434,7 +2504,7 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
 		 * in order to get from the start block to our candidate block, we must flow through the
 		 * very first if, which is why this if "postdominates" our given candidate
 		 */
-		basic_block_t* top_level_if_block = candidate_block->dominator_info.immediate_dominator;
+		basic_block_t* top_level_if_block = candidate_block->analysis->dominator_info.immediate_dominator;
 		instruction_t* branch_statement = top_level_if_block->exit_statement;
 
 		/**
@@ -2452,6 +2522,17 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
 			continue;
 		}
 
+		/**
+		 * The two assignment blocks also need to be the direct targets of the branch. If
+		 * there's anything in between them(blocks that sweep emptied out but clean has not
+		 * yet gotten to), then we don't have the funnel shape that we're looking for
+		 */
+		if(branch_statement == NULL || branch_statement->statement_type != THREE_ADDR_CODE_BRANCH_STMT
+			|| dynamic_array_contains(&(candidate_block->predecessors), branch_statement->if_block) == NOT_FOUND
+			|| dynamic_array_contains(&(candidate_block->predecessors), branch_statement->else_block) == NOT_FOUND){
+			continue;
+		}
+
 		/**
 		 * We now know that this is eligible fully, so let's go ahead and perform the branching
 		 * assignment to converting move operation now. We are going to hoist everything up and
@@ -2507,6 +2588,8 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
 		delete_successor(top_level_if_block, if_destination);
 		delete_successor(top_level_if_block, else_destination);
 		delete_statement(branch_statement);
+		record_control_flow_update(control_flow_updates, top_level_if_block, if_destination, CONTROL_FLOW_EDGE_DELETED);
+		record_control_flow_update(control_flow_updates, top_level_if_block, else_destination, CONTROL_FLOW_EDGE_DELETED);
 
 		/**
 		 * Step 1: grab the if assignee out from the if block and
@@ -2541,6 +2624,7 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
 
 		//Unlink these two as successors - the block is now unreachable
 		delete_successor(if_destination, candidate_block);
+		record_control_flow_update(control_flow_updates, if_destination, candidate_block, CONTROL_FLOW_EDGE_DELETED);
 
 		/**
 		 * Step 2: grab the else assignee out from the if block and
@@ -2571,6 +2655,7 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
 
 		//Unlink these two as successors - the block is now unreachable
 		delete_successor(else_destination, candidate_block);
+		record_control_flow_update(control_flow_updates, else_destination, candidate_block, CONTROL_FLOW_EDGE_DELETED);
 
 		/**
 		 * Step 3: emit the conditional move now by using the final phi variable
@@ -2595,6 +2680,7 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
 		 * useful for us there
 		 */
 		emit_jump(top_level_if_block, candidate_block);
+		record_control_flow_update(control_flow_updates, top_level_if_block, candidate_block, CONTROL_FLOW_EDGE_INSERTED);
 		delete_statement(branching_assignment_phi);
 
 		//Flag that we did at least one of these
@@ -2632,7 +2718,7 @@ static u_int8_t optimize_branching_assignments_where_possible(dynamic_array_t* c
  * 		if j is empty and ends in a conditional branch then
  * 			overwrite i's jump with a copy of j's branch
  */
-static inline void clean(cfg_t* cfg, dynamic_array_t* current_function_blocks, basic_block_t* function_entry_block){
+static inline void clean(cfg_t* cfg, basic_block_t* function_entry_block){
 	//Have we seen a change?
 	u_int8_t changed;
 
@@ -2649,7 +2735,7 @@ static inline void clean(cfg_t* cfg, dynamic_array_t* current_function_blocks, b
 		 * Note that the result is going to be stored inside of the array that
 		 * we've already allocated
 		 */
-		get_post_order_traversal(current_function_blocks, function_entry_block, &postorder);
+		get_post_order_traversal(function_entry_block, &postorder);
 
 		//Call onepass() for the reduction
 		changed = branch_reduce(cfg, &postorder);
@@ -2689,12 +2775,12 @@ static inline void recompute_all_control_flow_relations_for_function(dynamic_arr
  */
 static void dfs_flag_block_reachability_rec(basic_block_t* block){
 	//We've already dealt with this one
-	if(block->visited == TRUE){
+	if(is_block_visited(block) == TRUE){
 		return;
 	}
 
 	//It is reachable
-	block->visited = TRUE;
+	mark_block_visited(block);
 
 	//For each of the successors recursively flag as reachable
 	for(int32_t i = 0; i < block->successors.current_index; i++){
@@ -2721,15 +2807,15 @@ static void dfs_flag_block_reachability_rec(basic_block_t* block){
  * 	for each block B in the function:
  * 		if B is not flagged as reachable then:
  * 			delete B
+ *
+ * If we're given a control flow update log, every deleted block is recorded in it
  */
-static inline void delete_all_unreachable_blocks(basic_block_t* function_entry, dynamic_array_t* function_blocks){
+static inline void delete_all_unreachable_blocks(basic_block_t* function_entry, dynamic_array_t* function_blocks, control_flow_update_log_t* control_flow_updates){
 	/**
-	 * For each block reset visited flag to false
+	 * Reset every visited flag to false. This is one epoch bump
+	 * on the function's side table
 	 */
-	for(int32_t i = 0; i < function_blocks->current_index; i++){
-		basic_block_t* block = function_blocks->internal_array[i];
-		block->visited = FALSE;
-	}
+	reset_block_visits_for_function(function_entry->function_defined_in);
 
 	/**
 	 * Now invoke the flagger to go through, starting at the function entry,
@@ -2751,7 +2837,7 @@ static inline void delete_all_unreachable_blocks(basic_block_t* function_entry,
 		/**
 		 * Throw it into the temp holding array
 		 */
-		if(block->visited == FALSE){
+		if(is_block_visited(block) == FALSE){
 			to_be_deleted[to_be_deleted_next_index] = block;
 			to_be_deleted_next_index++;
 		}
@@ -2789,176 +2875,8488 @@ static inline void delete_all_unreachable_blocks(basic_block_t* function_entry,
 
 		//Once we've fully decoupled we can then remove this block from the function
 		dynamic_array_delete(function_blocks, to_be_deleted[i]);
+
+		//Make a note of it for the dominance relations
+		record_control_flow_update(control_flow_updates, target, NULL, CONTROL_FLOW_BLOCK_REMOVED);
 	}
 }
 
 
 /**
- * The generic optimize function. We have the option to specific how many passes the optimizer
- * runs for in it's current iteration
-*/
-cfg_t* optimize(cfg_t* cfg){
-	cfg_reference = cfg;
+ * Where does a value sit in the SCCP lattice? Every value starts out at
+ * the top(not yet known) and is only ever able to move down. The order
+ * of this enum matters - lower on the lattice is a larger number
+ */
+typedef enum{
+	SCCP_LATTICE_TOP,
+	SCCP_LATTICE_CONSTANT,
+	SCCP_LATTICE_BOTTOM,
+} sccp_lattice_value_t;
 
-	//Prepopulate these global variables so that we don't need to pass them around
-	stack_pointer_variable = cfg->stack_pointer;
-	instruction_pointer_variable = cfg->instruction_pointer;
 
-	/**
-	 * We will optimize on a function by function basis. This is because functions are independent units 
-	 * that do not have interlocking dependencies. Us doing this allows for more efficient operation because
-	 * there may be instances where we need to use our "while changed" type processing, causing us to iterate
-	 * over entire sets of blocks repeatedly. 
-	 */
-	//Run through all of the functions
-	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
-		//Extract the entry and exit blocks
-		basic_block_t* function_entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
-		basic_block_t* function_exit_block = dynamic_array_get_at(&(cfg->function_exit_blocks), i);
+/**
+ * The lattice cell for one SSA value in the function. Cells live in an
+ * open addressing hash table that is keyed on the variable itself
+ */
+typedef struct sccp_cell_t{
+	//The variable that this cell is for. NULL means the slot is empty
+	three_addr_var_t* variable;
+	//The one instruction that defines it
+	instruction_t* definition;
+	//The constant value, if we're at SCCP_LATTICE_CONSTANT
+	int64_t constant_value;
+	//The head of this cell's use list(an index into the use records), -1 if empty
+	int32_t first_use;
+	//How many times is this value defined? Anything above 1 is not SSA and goes right to the bottom
+	u_int32_t definition_count;
+	//Where we are on the lattice
+	sccp_lattice_value_t lattice_value;
+} sccp_cell_t;
 
-		//What function are we in?
-		symtab_function_record_t* current_function = function_entry_block->function_defined_in;
 
-		//The current function blocks are stored in the symtab
-		dynamic_array_t* current_function_blocks = &(current_function->function_blocks);
+/**
+ * One use of an SSA value. The uses for a cell are chained together
+ * through the next index
+ */
+typedef struct sccp_use_t{
+	//The instruction that needs to be re-evaluated if the value drops
+	instruction_t* user;
+	//The next use for the same cell, -1 if there is none
+	int32_t next;
+} sccp_use_t;
 
-		/**
-		 * Once we get here, we have an array that is full of all of the blocks belonging
-		 * to the function that we wish to optimize. Now we will go through all of the 
-		 * optimization steps for this function
-		 */
 
-		/**
-		 * First thing we'll do is reset the visited status of the CFG. This just ensures
-		 * that we won't have any issues with the CFG in terms of traversal
-		 */
-		reset_visit_status_for_function(current_function_blocks);
+/**
+ * Everything that SCCP needs for one function. This is all local to the
+ * worker that is optimizing the function
+ */
+typedef struct sccp_context_t{
+	//The lattice cells
+	sccp_cell_t* cells;
+	//All of the use records
+	sccp_use_t* uses;
+	//Which blocks have been found executable, by function block index
+	u_int8_t* executable_blocks;
+	//Which edges have been found executable. A block's incoming edges start at its edge offset
+	u_int8_t* executable_edges;
+	u_int32_t* edge_offsets;
+	//CFG edge worklist - the source and target blocks are pushed in pairs
+	dynamic_array_t edge_worklist;
+	//SSA worklist - instructions that need to be re-evaluated
+	dynamic_array_t ssa_worklist;
+	//The size of the cell table(always a power of 2)
+	u_int32_t cell_table_size;
+	//Use record bookkeeping
+	u_int32_t uses_current_index;
+	u_int32_t uses_max_size;
+} sccp_context_t;
 
-		/**
-		 * PASS 1: Mark algorithm
-		 * The mark algorithm marks all useful operations. It will perform one full pass of the program
-		 */
-		mark(current_function_blocks);
 
-		/**
-		 * PASS 2: Sweep algorithm
-		 * Sweep follows directly after mark because it eliminates anything that is unmarked. If sweep
-		 * comes across branch ending statements that are unmarked, it will replace them with a jump to the
-		 * nearest marked postdominator
-		 */
-		sweep(current_function_blocks, function_entry_block);
+/**
+ * Is the given variable one that SCCP tracks? We only track the temporary and
+ * local variables that the SSA system gives one definition apiece
+ */
+static inline u_int8_t is_variable_sccp_trackable(three_addr_var_t* variable){
+	if(variable == NULL){
+		return FALSE;
+	}
 
-		/**
-		 * PASS 3: always true/false optimization
-		 * Now that we've swept everything, let's figure out if there are
-		 * any branches that are always true or always false. We'll need to 
-		 * elminate these before we go through and do anything with conditional
-		 * movement
-		 */
-		u_int8_t found_branches_to_optimize = optimize_always_true_false_paths(current_function_blocks);
+	switch(variable->variable_type){
+		case VARIABLE_TYPE_TEMP:
+			return TRUE;
+		case VARIABLE_TYPE_NON_TEMP:
+			return variable->linked_var != NULL ? TRUE : FALSE;
+		default:
+			return FALSE;
+	}
+}
 
-		/**
-		 * PASS 3.5: if we did find branches to optimize, we now potentially have a lot
-		 * of orphaned code that is no longer useful. This would not have been picked up by
-		 * the original mark and sweep, but it will be now. So, we will rerun mark/sweep
-		 * *if* we've found branches that were optimzied. Otherwise, this would just be a waste
-		 */
-		if(found_branches_to_optimize == TRUE){
-			//Reset all of the marks in the function
-			reset_all_marks(current_function_blocks);
 
-			/**
-			 * Optimizing branches and and then trying to run mark & sweep will not work because
-			 * we have fundamentally changed the structure & dominance in the CFG by doing
-			 * that. 
-			 *
-			 * We are going to need to delete all unreachable blocks *at this stage* and
-			 * then we are going to have to recompute all of the dominance relations. Mark
-			 * specifically relies on the "RDF"(reverse dominance frontier).
-			 */
-			delete_all_unreachable_blocks(function_entry_block, current_function_blocks);
+/**
+ * Hash a variable by the same things that variables_equal compares
+ */
+static inline u_int32_t hash_sccp_variable(three_addr_var_t* variable){
+	if(variable->variable_type == VARIABLE_TYPE_TEMP){
+		return variable->temp_var_number * 2654435761U;
+	}
+
+	return ((u_int32_t)((uintptr_t)(variable->linked_var) >> 4) * 2654435761U) ^ (variable->ssa_generation * 40503U);
+}
+
 
-			//Recalculate all dominance relations
-			recompute_all_control_flow_relations_for_function(current_function_blocks, function_entry_block, function_exit_block);
+/**
+ * Grab the cell for a variable. If create is TRUE and there is no cell, a new one
+ * at the top of the lattice is made. Otherwise NULL is given back when there's no cell
+ */
+static sccp_cell_t* get_sccp_cell(sccp_context_t* context, three_addr_var_t* variable, u_int8_t create){
+	//We don't track this at all
+	if(is_variable_sccp_trackable(variable) == FALSE){
+		return NULL;
+	}
 
-			//Invoke the marker
-			mark(current_function_blocks);
+	//The table size is a power of 2, so we can mask instead of mod
+	u_int32_t mask = context->cell_table_size - 1;
+	u_int32_t index = hash_sccp_variable(variable) & mask;
 
-			//Invoke the sweeper
-			sweep(current_function_blocks, function_entry_block);
+	//Linear probe until we hit the variable or an empty slot
+	while(context->cells[index].variable != NULL){
+		if(variables_equal(context->cells[index].variable, variable) == TRUE){
+			return &(context->cells[index]);
 		}
 
-		/**
-		 * PASS 4: certain common if-else assignments are good candidates for conditional moves in Ollie. We have
-		 * a dedicated pass that will crawl the function once and look for them. If it is able to find them, then
-		 * it will optimize them into a conditional move pattern. If this is to happen, it will require a full
-		 * redo of the mark, sweep, block deletion and control flow recalculation passes
-		 */
-		u_int8_t branching_assignments_optimized = optimize_branching_assignments_where_possible(current_function_blocks);
+		index = (index + 1) & mask;
+	}
 
-		/**
-		 * If these ended up being optimized, we will have unreachable blocks
-		 * that need to be cleaned up. We will also go through and
-		 * do a mark-and-sweep run to make sure that no straggler variables
-		 * are still around
-		 */
-		if(branching_assignments_optimized == TRUE){
-			//Reset all of the marks in the function
-			reset_all_marks(current_function_blocks);
+	//Not here and we're not making it
+	if(create == FALSE){
+		return NULL;
+	}
 
-			/**
-			 * Optimizing branches and and then trying to run mark & sweep will not work because
-			 * we have fundamentally changed the structure & dominance in the CFG by doing
-			 * that. 
-			 *
-			 * We are going to need to delete all unreachable blocks *at this stage* and
-			 * then we are going to have to recompute all of the dominance relations. Mark
-			 * specifically relies on the "RDF"(reverse dominance frontier).
-			 */
-			delete_all_unreachable_blocks(function_entry_block, current_function_blocks);
+	//Otherwise claim the slot
+	sccp_cell_t* cell = &(context->cells[index]);
+	cell->variable = variable;
+	cell->first_use = -1;
+	cell->lattice_value = SCCP_LATTICE_TOP;
 
-			//Recalculate all dominance relations
-			recompute_all_control_flow_relations_for_function(current_function_blocks, function_entry_block, function_exit_block);
+	return cell;
+}
 
-			//Invoke the marker
-			mark(current_function_blocks);
 
-			//Invoke the sweeper
-			sweep(current_function_blocks, function_entry_block);
-		}
+/**
+ * Record that the user instruction relies on the given variable
+ */
+static inline void add_sccp_use(sccp_context_t* context, three_addr_var_t* variable, instruction_t* user){
+	//If this isn't defined in the function, it's already at the bottom and we don't care who uses it
+	sccp_cell_t* cell = get_sccp_cell(context, variable, FALSE);
+	if(cell == NULL){
+		return;
+	}
 
-		/**
-		 * PASS 5: Clean algorithm
-		 * Clean follows after sweep because during the sweep process, we will likely delete the contents of
-		 * entire blocks. Clean uses 4 different steps in a specific order to eliminate control flow
-		 * that has been made useless by sweep()
-		 */
-		clean(cfg, current_function_blocks, function_entry_block);
+	//Resize if need be
+	if(context->uses_current_index == context->uses_max_size){
+		context->uses_max_size *= 2;
+		context->uses = realloc(context->uses, sizeof(sccp_use_t) * context->uses_max_size);
+	}
 
-		/**
-		 * PASS 6: Delete all unreachable blocks
-		 * There is a chance that we have some blocks who are now unreachable. We will
-		 * remove them now. This step is absolutely essential. If we do not do this,
-		 * then the dominance relation computation will not work
-		 */
-		delete_all_unreachable_blocks(function_entry_block, current_function_blocks);
+	//Chain it onto the front of the list
+	context->uses[context->uses_current_index].user = user;
+	context->uses[context->uses_current_index].next = cell->first_use;
+	cell->first_use = context->uses_current_index;
+	context->uses_current_index++;
+}
 
-		/**
-		 * PASS 6.5: Now that all of our marking and sweeping is done, it is possible that we'll
-		 * have some orphaned local constants. We will go through now and sweep them all up if 
-		 * any of them end up being completely unused
-		 */
-		sweep_local_constants(cfg);
 
-		/**
-		 * PASS 7: Recalculate everything
-		 * Now that we've marked, sweeped and cleaned, odds are that all of our control relations will be off due to deletions of blocks, statements,
-		 * etc. So, to remedy this, we will recalculate everything in the CFG. There is no advantage in splitting this section up by function, as 
-		 * all blocks are going to be traversed regardless. Due to this, we will be doing it over the entire CFG at the end
-		 */
-		recompute_all_control_flow_relations_for_function(current_function_blocks, function_entry_block, function_exit_block);
+/**
+ * Get the integer value of a constant. Values are sign or zero extended out to 64 bits
+ * based on the constant's type. If this is not an integer constant, we return FALSE
+ */
+static u_int8_t get_sccp_constant_value(three_addr_const_t* constant, int64_t* value){
+	switch(constant->const_type){
+		case BYTE_CONST:
+			*value = constant->constant_value.signed_byte_constant;
+			return TRUE;
+		case BYTE_CONST_FORCE_U:
+			*value = constant->constant_value.unsigned_byte_constant;
+			return TRUE;
+		case CHAR_CONST:
+			*value = constant->constant_value.char_constant;
+			return TRUE;
+		case SHORT_CONST:
+			*value = constant->constant_value.signed_short_constant;
+			return TRUE;
+		case SHORT_CONST_FORCE_U:
+			*value = constant->constant_value.unsigned_short_constant;
+			return TRUE;
+		case INT_CONST:
+			*value = constant->constant_value.signed_integer_constant;
+			return TRUE;
+		case INT_CONST_FORCE_U:
+			*value = constant->constant_value.unsigned_integer_constant;
+			return TRUE;
+		case LONG_CONST:
+		case LONG_CONST_FORCE_U:
+			*value = constant->constant_value.signed_long_constant;
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Is the given constant of an unsigned type?
+ */
+static inline u_int8_t is_sccp_constant_unsigned(three_addr_const_t* constant){
+	switch(constant->const_type){
+		case BYTE_CONST_FORCE_U:
+		case SHORT_CONST_FORCE_U:
+		case INT_CONST_FORCE_U:
+		case LONG_CONST_FORCE_U:
+		case CHAR_CONST:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Truncate a value to the size of the given type, and then sign or zero extend
+ * it back out to 64 bits based on the type's signedness. This is exactly what
+ * the value would look like if it was held in a register of that type
+ */
+static int64_t normalize_sccp_value(int64_t value, generic_type_t* type){
+	type = dealias_type(type);
+
+	switch(type->type_size){
+		case 1:
+			return is_type_signed(type) == TRUE ? (int64_t)(int8_t)value : (int64_t)(u_int8_t)value;
+		case 2:
+			return is_type_signed(type) == TRUE ? (int64_t)(int16_t)value : (int64_t)(u_int16_t)value;
+		case 4:
+			return is_type_signed(type) == TRUE ? (int64_t)(int32_t)value : (int64_t)(u_int32_t)value;
+		default:
+			return value;
+	}
+}
+
+
+/**
+ * Grab where a variable operand sits on the lattice. Anything that we don't track,
+ * or that isn't an integer, is always at the bottom
+ */
+static inline sccp_lattice_value_t get_sccp_operand(sccp_context_t* context, three_addr_var_t* operand, int64_t* value){
+	if(operand == NULL || is_integer_type(operand->type) == FALSE){
+		return SCCP_LATTICE_BOTTOM;
+	}
+
+	sccp_cell_t* cell = get_sccp_cell(context, operand, FALSE);
+
+	//Never defined in here(function parameters, etc.)
+	if(cell == NULL){
+		return SCCP_LATTICE_BOTTOM;
+	}
+
+	*value = cell->constant_value;
+	return cell->lattice_value;
+}
+
+
+/**
+ * Is the given operator one of the comparison operators?
+ */
+static inline u_int8_t is_sccp_comparison_operator(ollie_token_t op){
+	switch(op){
+		case G_THAN:
+		case L_THAN:
+		case G_THAN_OR_EQ:
+		case L_THAN_OR_EQ:
+		case DOUBLE_EQUALS:
+		case NOT_EQUALS:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Fold a binary operation over two known operands. The operand values are already
+ * extended out to 64 bits. Anything that we're not completely sure the machine would
+ * agree with(signed/unsigned ambiguity, division by zero, oversized shifts) goes to the bottom
+ */
+static sccp_lattice_value_t fold_sccp_binary_operation(instruction_t* instruction, int64_t a, int64_t b, u_int8_t b_unsigned, int64_t* result){
+	//The size of the assignee in bits, used for our shift checks
+	u_int32_t assignee_bits = dealias_type(instruction->operands.oir.assignee->type)->type_size * 8;
+
+	switch(instruction->op){
+		//For all of these, the low bits only depend on the low bits of the inputs, so two's complement wraparound is fine
+		case PLUS:
+			*result = (int64_t)((u_int64_t)a + (u_int64_t)b);
+			return SCCP_LATTICE_CONSTANT;
+		case MINUS:
+			*result = (int64_t)((u_int64_t)a - (u_int64_t)b);
+			return SCCP_LATTICE_CONSTANT;
+		case STAR:
+			*result = (int64_t)((u_int64_t)a * (u_int64_t)b);
+			return SCCP_LATTICE_CONSTANT;
+		case SINGLE_AND:
+			*result = a & b;
+			return SCCP_LATTICE_CONSTANT;
+		case SINGLE_OR:
+			*result = a | b;
+			return SCCP_LATTICE_CONSTANT;
+		case CARROT:
+			*result = a ^ b;
+			return SCCP_LATTICE_CONSTANT;
+
+		case L_SHIFT:
+			if(b < 0 || b >= assignee_bits){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			*result = (int64_t)((u_int64_t)a << b);
+			return SCCP_LATTICE_CONSTANT;
+
+		//Arithmetic and logical shifts agree on positive values, so we only do those
+		case R_SHIFT:
+			if(a < 0 || b < 0 || b >= assignee_bits){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			*result = a >> b;
+			return SCCP_LATTICE_CONSTANT;
+
+		//Same idea here - signed and unsigned division only agree on positive values
+		case F_SLASH:
+		case MOD:
+			if(a < 0 || b <= 0){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			*result = instruction->op == F_SLASH ? a / b : a % b;
+			return SCCP_LATTICE_CONSTANT;
+
+		case DOUBLE_AND:
+			*result = (a != 0 && b != 0) ? 1 : 0;
+			return SCCP_LATTICE_CONSTANT;
+		case DOUBLE_OR:
+			*result = (a != 0 || b != 0) ? 1 : 0;
+			return SCCP_LATTICE_CONSTANT;
+
+		default:
+			break;
+	}
+
+	//Anything left has to be a comparison
+	if(is_sccp_comparison_operator(instruction->op) == FALSE){
+		return SCCP_LATTICE_BOTTOM;
+	}
+
+	/**
+	 * The CFG picks a signed or unsigned comparison based on the result type(or op1's type if
+	 * there is none), so we go off of the exact same thing here
+	 */
+	generic_type_t* comparison_type = instruction->type_storage.result_type != NULL ? instruction->type_storage.result_type : instruction->operands.oir.operand1->type;
+
+	//The second value must survive being put into op1's type, otherwise the machine comparison would differ
+	if(normalize_sccp_value(b, instruction->operands.oir.operand1->type) != b){
+		return SCCP_LATTICE_BOTTOM;
 	}
 
+	//For unsigned comparisons, we can only be sure about values that look the same either way
+	if(is_type_signed(comparison_type) == FALSE || b_unsigned == TRUE){
+		if(a < 0 || b < 0){
+			return SCCP_LATTICE_BOTTOM;
+		}
+	}
+
+	switch(instruction->op){
+		case G_THAN:
+			*result = a > b;
+			break;
+		case L_THAN:
+			*result = a < b;
+			break;
+		case G_THAN_OR_EQ:
+			*result = a >= b;
+			break;
+		case L_THAN_OR_EQ:
+			*result = a <= b;
+			break;
+		case DOUBLE_EQUALS:
+			*result = a == b;
+			break;
+		default:
+			*result = a != b;
+			break;
+	}
+
+	return SCCP_LATTICE_CONSTANT;
+}
+
+
+/**
+ * Evaluate a non-phi instruction over the current lattice. The result value is
+ * stored in result if we come back with SCCP_LATTICE_CONSTANT
+ */
+static sccp_lattice_value_t evaluate_sccp_instruction(sccp_context_t* context, instruction_t* instruction, int64_t* result){
+	three_addr_var_t* assignee = instruction->operands.oir.assignee;
+
+	//We only ever fold down to integers
+	if(is_integer_type(assignee->type) == FALSE){
+		return SCCP_LATTICE_BOTTOM;
+	}
+
+	int64_t a = 0;
+	int64_t b = 0;
+	sccp_lattice_value_t a_status;
+	sccp_lattice_value_t b_status;
+	u_int8_t b_unsigned;
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_ASSN_CONST_STMT:
+			if(get_sccp_constant_value(instruction->operands.oir.constant_operand, &a) == FALSE){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			*result = normalize_sccp_value(a, assignee->type);
+			return SCCP_LATTICE_CONSTANT;
+
+		case THREE_ADDR_CODE_ASSN_STMT:
+		case THREE_ADDR_CODE_TRUNCATING_ASSN_STMT:
+			a_status = get_sccp_operand(context, instruction->operands.oir.operand1, &a);
+			if(a_status != SCCP_LATTICE_CONSTANT){
+				return a_status;
+			}
+
+			//Sign and zero extension only agree on positive values
+			if(a < 0 && dealias_type(instruction->operands.oir.operand1->type)->type_size < dealias_type(assignee->type)->type_size){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			*result = normalize_sccp_value(a, assignee->type);
+			return SCCP_LATTICE_CONSTANT;
+
+		case THREE_ADDR_CODE_INC_STMT:
+		case THREE_ADDR_CODE_DEC_STMT:
+		case THREE_ADDR_CODE_NEG_STATEMENT:
+		case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+		case THREE_ADDR_CODE_LOGICAL_NOT_STMT:
+			a_status = get_sccp_operand(context, instruction->operands.oir.operand1, &a);
+			if(a_status != SCCP_LATTICE_CONSTANT){
+				return a_status;
+			}
+
+			switch(instruction->statement_type){
+				case THREE_ADDR_CODE_INC_STMT:
+					*result = (int64_t)((u_int64_t)a + 1);
+					break;
+				case THREE_ADDR_CODE_DEC_STMT:
+					*result = (int64_t)((u_int64_t)a - 1);
+					break;
+				case THREE_ADDR_CODE_NEG_STATEMENT:
+					*result = (int64_t)(0 - (u_int64_t)a);
+					break;
+				case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+					*result = ~a;
+					break;
+				default:
+					*result = a == 0 ? 1 : 0;
+					break;
+			}
+
+			*result = normalize_sccp_value(*result, assignee->type);
+			return SCCP_LATTICE_CONSTANT;
+
+		case THREE_ADDR_CODE_TEST_IF_NOT_ZERO_STMT:
+			//This could be testing a constant directly
+			if(instruction->operands.oir.constant_operand != NULL){
+				if(get_sccp_constant_value(instruction->operands.oir.constant_operand, &a) == FALSE){
+					return SCCP_LATTICE_BOTTOM;
+				}
+			} else {
+				a_status = get_sccp_operand(context, instruction->operands.oir.operand1, &a);
+				if(a_status != SCCP_LATTICE_CONSTANT){
+					return a_status;
+				}
+			}
+
+			*result = a != 0 ? 1 : 0;
+			return SCCP_LATTICE_CONSTANT;
+
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			a_status = get_sccp_operand(context, instruction->operands.oir.operand1, &a);
+
+			if(instruction->statement_type == THREE_ADDR_CODE_BIN_OP_STMT){
+				b_status = get_sccp_operand(context, instruction->operands.oir.operand2, &b);
+				b_unsigned = instruction->operands.oir.operand2 != NULL && is_type_signed(instruction->operands.oir.operand2->type) == FALSE;
+			} else {
+				b_status = get_sccp_constant_value(instruction->operands.oir.constant_operand, &b) == TRUE ? SCCP_LATTICE_CONSTANT : SCCP_LATTICE_BOTTOM;
+				b_unsigned = is_sccp_constant_unsigned(instruction->operands.oir.constant_operand);
+			}
+
+			//The bottom wins over everything, and then the top wins over constants
+			if(a_status == SCCP_LATTICE_BOTTOM || b_status == SCCP_LATTICE_BOTTOM){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			if(a_status == SCCP_LATTICE_TOP || b_status == SCCP_LATTICE_TOP){
+				return SCCP_LATTICE_TOP;
+			}
+
+			if(fold_sccp_binary_operation(instruction, a, b, b_unsigned, result) == SCCP_LATTICE_BOTTOM){
+				return SCCP_LATTICE_BOTTOM;
+			}
+
+			*result = normalize_sccp_value(*result, assignee->type);
+			return SCCP_LATTICE_CONSTANT;
+
+		//Loads, calls, etc. We can never know anything about these
+		default:
+			return SCCP_LATTICE_BOTTOM;
+	}
+}
+
+
+/**
+ * Get the index of the edge from the source into the target, or -1 if
+ * there is no such edge
+ */
+static inline int32_t get_sccp_edge_index(sccp_context_t* context, basic_block_t* source, basic_block_t* target){
+	for(int32_t i = 0; i < target->predecessors.current_index; i++){
+		if(dynamic_array_get_at(&(target->predecessors), i) == source){
+			return context->edge_offsets[target->function_block_index] + i;
+		}
+	}
+
+	return -1;
+}
+
+
+/**
+ * Could a value that is defined in the definition block reach the phi block
+ * over an edge that we know is executable? Phi parameters are not kept in
+ * predecessor order, so we go off of dominance instead - whatever value comes in over
+ * an edge must dominate the block that the edge leaves from
+ */
+static u_int8_t does_value_reach_over_executable_edge(sccp_context_t* context, basic_block_t* phi_block, basic_block_t* definition_block){
+	u_int32_t edge_offset = context->edge_offsets[phi_block->function_block_index];
+
+	for(int32_t i = 0; i < phi_block->predecessors.current_index; i++){
+		if(context->executable_edges[edge_offset + i] == FALSE){
+			continue;
+		}
+
+		if(does_block_dominate(definition_block, dynamic_array_get_at(&(phi_block->predecessors), i)) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Evaluate a phi function over the current lattice. We take the meet of
+ * every parameter that could have come in over an executable edge
+ */
+static sccp_lattice_value_t evaluate_sccp_phi_function(sccp_context_t* context, instruction_t* phi_function, int64_t* result){
+	basic_block_t* phi_block = phi_function->block_contained_in;
+
+	//We only ever fold down to integers
+	if(is_integer_type(phi_function->operands.oir.assignee->type) == FALSE){
+		return SCCP_LATTICE_BOTTOM;
+	}
+
+	/**
+	 * If there are fewer parameters than incoming edges, some path brings in a value that
+	 * was never defined. We won't be making any assumptions about that
+	 */
+	if(phi_function->parameters.current_index < phi_block->predecessors.current_index){
+		return SCCP_LATTICE_BOTTOM;
+	}
+
+	sccp_lattice_value_t status = SCCP_LATTICE_TOP;
+
+	for(int32_t i = 0; i < phi_function->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(phi_function->parameters), i);
+
+		sccp_cell_t* cell = get_sccp_cell(context, parameter, FALSE);
+
+		//Something that isn't defined in here at all
+		if(cell == NULL){
+			return SCCP_LATTICE_BOTTOM;
+		}
+
+		//The top has no effect on the meet
+		if(cell->lattice_value == SCCP_LATTICE_TOP){
+			continue;
+		}
+
+		//If this can't have come in over an executable edge, it doesn't count
+		if(does_value_reach_over_executable_edge(context, phi_block, cell->definition->block_contained_in) == FALSE){
+			continue;
+		}
+
+		if(cell->lattice_value == SCCP_LATTICE_BOTTOM){
+			return SCCP_LATTICE_BOTTOM;
+		}
+
+		//Two different constants meet at the bottom
+		if(status == SCCP_LATTICE_CONSTANT && *result != cell->constant_value){
+			return SCCP_LATTICE_BOTTOM;
+		}
+
+		status = SCCP_LATTICE_CONSTANT;
+		*result = cell->constant_value;
+	}
+
+	return status;
+}
+
+
+/**
+ * Push an edge onto the CFG worklist if it's not already known to be executable
+ */
+static inline void push_sccp_edge(sccp_context_t* context, basic_block_t* source, basic_block_t* target){
+	int32_t edge_index = get_sccp_edge_index(context, source, target);
+
+	//Already seen or not a real edge
+	if(edge_index == -1 || context->executable_edges[edge_index] == TRUE){
+		return;
+	}
+
+	context->executable_edges[edge_index] = TRUE;
+
+	dynamic_array_add(&(context->edge_worklist), source);
+	dynamic_array_add(&(context->edge_worklist), target);
+}
+
+
+/**
+ * Move a cell down the lattice. If it did move, everything that uses
+ * it goes onto the SSA worklist
+ */
+static void lower_sccp_cell(sccp_context_t* context, sccp_cell_t* cell, sccp_lattice_value_t status, int64_t value){
+	//Values can only ever move down
+	if(status < cell->lattice_value){
+		return;
+	}
+
+	if(status == cell->lattice_value){
+		//Nothing changed
+		if(status != SCCP_LATTICE_CONSTANT || value == cell->constant_value){
+			return;
+		}
+
+		//We're seeing a different constant than before
+		status = SCCP_LATTICE_BOTTOM;
+	}
+
+	cell->lattice_value = status;
+	cell->constant_value = value;
+
+	for(int32_t use = cell->first_use; use != -1; use = context->uses[use].next){
+		dynamic_array_add(&(context->ssa_worklist), context->uses[use].user);
+	}
+}
+
+
+/**
+ * Which way will this branch go? We give back the block that it always goes to
+ * if we know, and NULL otherwise. The status tells us whether we don't know yet(top)
+ * or if we'll never know(bottom)
+ *
+ * The branch really goes off of the condition codes that the instruction defining
+ * its condition sets, and not the condition's value. Those are not always the same thing(switch
+ * statements test for equality and then jump if not equal), so we work out the condition codes
+ * from that instruction's operands and then apply the branch type to them directly
+ */
+static basic_block_t* get_sccp_branch_target(sccp_context_t* context, instruction_t* branch, sccp_lattice_value_t* status){
+	sccp_cell_t* cell = get_sccp_cell(context, branch->relies_on, FALSE);
+
+	if(cell == NULL){
+		*status = SCCP_LATTICE_BOTTOM;
+		return NULL;
+	}
+
+	*status = cell->lattice_value;
+	if(cell->lattice_value != SCCP_LATTICE_CONSTANT){
+		return NULL;
+	}
+
+	//Assume the worst until we've proven otherwise
+	*status = SCCP_LATTICE_BOTTOM;
+
+	instruction_t* definition = cell->definition;
+	int64_t a = 0;
+	int64_t b = 0;
+
+	switch(definition->statement_type){
+		//This is a test of the value against itself, so the flags are the same as comparing it to 0
+		case THREE_ADDR_CODE_TEST_IF_NOT_ZERO_STMT:
+			if(definition->operands.oir.constant_operand != NULL){
+				if(get_sccp_constant_value(definition->operands.oir.constant_operand, &a) == FALSE){
+					return NULL;
+				}
+			} else if(get_sccp_operand(context, definition->operands.oir.operand1, &a) != SCCP_LATTICE_CONSTANT){
+				return NULL;
+			}
+
+			//Only the zero flag is meaningful here
+			if(branch->branch_type != BRANCH_Z && branch->branch_type != BRANCH_NZ
+				&& branch->branch_type != BRANCH_E && branch->branch_type != BRANCH_NE){
+				return NULL;
+			}
+
+			break;
+
+		//Comparisons set the flags as if we compared op1 to op2
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			if(is_sccp_comparison_operator(definition->op) == FALSE
+				|| get_sccp_operand(context, definition->operands.oir.operand1, &a) != SCCP_LATTICE_CONSTANT){
+				return NULL;
+			}
+
+			if(definition->statement_type == THREE_ADDR_CODE_BIN_OP_STMT){
+				if(get_sccp_operand(context, definition->operands.oir.operand2, &b) != SCCP_LATTICE_CONSTANT){
+					return NULL;
+				}
+			} else if(get_sccp_constant_value(definition->operands.oir.constant_operand, &b) == FALSE){
+				return NULL;
+			}
+
+			//The second value must survive being put into op1's type, otherwise the machine comparison would differ
+			if(normalize_sccp_value(b, definition->operands.oir.operand1->type) != b){
+				return NULL;
+			}
+
+			break;
+
+		default:
+			return NULL;
+	}
+
+	//Does the jump get taken?
+	u_int8_t taken;
+
+	switch(branch->branch_type){
+		case BRANCH_E:
+		case BRANCH_Z:
+			taken = a == b;
+			break;
+		case BRANCH_NE:
+		case BRANCH_NZ:
+			taken = a != b;
+			break;
+
+		//Signed comparisons are only safe if op1 really is signed
+		case BRANCH_L:
+		case BRANCH_G:
+		case BRANCH_GE:
+		case BRANCH_LE:
+			if(is_type_signed(definition->operands.oir.operand1->type) == FALSE){
+				return NULL;
+			}
+
+			if(branch->branch_type == BRANCH_L){
+				taken = a < b;
+			} else if(branch->branch_type == BRANCH_G){
+				taken = a > b;
+			} else if(branch->branch_type == BRANCH_GE){
+				taken = a >= b;
+			} else {
+				taken = a <= b;
+			}
+
+			break;
+
+		//Unsigned comparisons are only safe on values that look the same either way
+		case BRANCH_A:
+		case BRANCH_AE:
+		case BRANCH_B:
+		case BRANCH_BE:
+			if(a < 0 || b < 0){
+				return NULL;
+			}
+
+			if(branch->branch_type == BRANCH_A){
+				taken = a > b;
+			} else if(branch->branch_type == BRANCH_AE){
+				taken = a >= b;
+			} else if(branch->branch_type == BRANCH_B){
+				taken = a < b;
+			} else {
+				taken = a <= b;
+			}
+
+			break;
+
+		default:
+			return NULL;
+	}
+
+	*status = SCCP_LATTICE_CONSTANT;
+
+	//The if block is where the jump goes, the else block is the fall through
+	return taken == TRUE ? branch->if_block : branch->else_block;
+}
+
+
+/**
+ * Where does this indirect jump go? Just like with branches, we give back the block if the index
+ * is known and NULL otherwise. An index that is outside of the table is left at the bottom
+ */
+static basic_block_t* get_sccp_indirect_jump_target(sccp_context_t* context, instruction_t* indirect_jump, sccp_lattice_value_t* status){
+	basic_block_t* block = indirect_jump->block_contained_in;
+	jump_table_t* jump_table = block->jump_table;
+	int64_t index = 0;
+
+	if(jump_table == NULL){
+		*status = SCCP_LATTICE_BOTTOM;
+		return NULL;
+	}
+
+	*status = get_sccp_operand(context, indirect_jump->operands.oir.address_operand2, &index);
+	if(*status != SCCP_LATTICE_CONSTANT){
+		return NULL;
+	}
+
+	if(index < 0 || index >= jump_table->num_nodes || dynamic_array_get_at(&(jump_table->nodes), index) == NULL){
+		*status = SCCP_LATTICE_BOTTOM;
+		return NULL;
+	}
+
+	return dynamic_array_get_at(&(jump_table->nodes), index);
+}
+
+
+/**
+ * Evaluate one instruction and push whatever changed
+ */
+static void visit_sccp_instruction(sccp_context_t* context, instruction_t* instruction){
+	basic_block_t* block = instruction->block_contained_in;
+	sccp_lattice_value_t status;
+	int64_t value = 0;
+
+	//Branches decide which of the successors are executable
+	if(instruction->statement_type == THREE_ADDR_CODE_BRANCH_STMT){
+		basic_block_t* target = get_sccp_branch_target(context, instruction, &status);
+
+		switch(status){
+			//Nothing to do yet
+			case SCCP_LATTICE_TOP:
+				break;
+
+			case SCCP_LATTICE_CONSTANT:
+				push_sccp_edge(context, block, target);
+				break;
+
+			case SCCP_LATTICE_BOTTOM:
+				for(int32_t i = 0; i < block->successors.current_index; i++){
+					push_sccp_edge(context, block, dynamic_array_get_at(&(block->successors), i));
+				}
+				break;
+		}
+
+		return;
+	}
+
+	//Indirect jumps only go to the one block in their table that a known index picks out
+	if(instruction->statement_type == THREE_ADDR_CODE_INDIRECT_JUMP_STMT){
+		basic_block_t* target = get_sccp_indirect_jump_target(context, instruction, &status);
+
+		switch(status){
+			case SCCP_LATTICE_TOP:
+				break;
+
+			case SCCP_LATTICE_CONSTANT:
+				push_sccp_edge(context, block, target);
+				break;
+
+			case SCCP_LATTICE_BOTTOM:
+				for(int32_t i = 0; i < block->successors.current_index; i++){
+					push_sccp_edge(context, block, dynamic_array_get_at(&(block->successors), i));
+				}
+				break;
+		}
+
+		return;
+	}
+
+	/**
+	 * Function calls can also hand back an error. If the callee can never raise one, the
+	 * error is always 0(no error)
+	 */
+	if((instruction->statement_type == THREE_ADDR_CODE_FUNC_CALL || instruction->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+		&& instruction->optional_storage.error_assignee != NULL){
+		sccp_cell_t* error_cell = get_sccp_cell(context, instruction->optional_storage.error_assignee, FALSE);
+
+		if(error_cell != NULL){
+			if(instruction->statement_type == THREE_ADDR_CODE_FUNC_CALL
+				&& instruction->called_function != NULL
+				&& instruction->called_function->never_raises == TRUE){
+				lower_sccp_cell(context, error_cell, SCCP_LATTICE_CONSTANT, 0);
+			} else {
+				lower_sccp_cell(context, error_cell, SCCP_LATTICE_BOTTOM, 0);
+			}
+		}
+	}
+
+	//Otherwise we only care about what's being assigned
+	sccp_cell_t* cell = get_sccp_cell(context, instruction->operands.oir.assignee, FALSE);
+	if(cell == NULL || cell->lattice_value == SCCP_LATTICE_BOTTOM){
+		return;
+	}
+
+	if(instruction->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+		status = evaluate_sccp_phi_function(context, instruction, &value);
+	} else {
+		status = evaluate_sccp_instruction(context, instruction, &value);
+	}
+
+	lower_sccp_cell(context, cell, status, value);
+}
+
+
+/**
+ * Visit a block that has just become executable. Every instruction is evaluated
+ * in order, and if the block doesn't end in a branch then all of its successors are
+ * executable too
+ */
+static void visit_sccp_block(sccp_context_t* context, basic_block_t* block){
+	context->executable_blocks[block->function_block_index] = TRUE;
+
+	for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+		visit_sccp_instruction(context, cursor);
+	}
+
+	if(block->exit_statement == NULL
+		|| (block->exit_statement->statement_type != THREE_ADDR_CODE_BRANCH_STMT
+			&& block->exit_statement->statement_type != THREE_ADDR_CODE_INDIRECT_JUMP_STMT)){
+		for(int32_t i = 0; i < block->successors.current_index; i++){
+			push_sccp_edge(context, block, dynamic_array_get_at(&(block->successors), i));
+		}
+	}
+}
+
+
+/**
+ * Run both worklists until neither has anything left
+ */
+static void run_sccp_worklists(sccp_context_t* context){
+	while(dynamic_array_is_empty(&(context->edge_worklist)) == FALSE || dynamic_array_is_empty(&(context->ssa_worklist)) == FALSE){
+		//Go through the CFG edges first
+		while(dynamic_array_is_empty(&(context->edge_worklist)) == FALSE){
+			basic_block_t* target = dynamic_array_delete_from_back(&(context->edge_worklist));
+			dynamic_array_delete_from_back(&(context->edge_worklist));
+
+			//First time we're here - do everything
+			if(context->executable_blocks[target->function_block_index] == FALSE){
+				visit_sccp_block(context, target);
+				continue;
+			}
+
+			//Otherwise only the phi functions can be affected by the new edge
+			for(instruction_t* cursor = target->leader_statement; cursor != NULL && cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC; cursor = cursor->next_statement){
+				visit_sccp_instruction(context, cursor);
+			}
+		}
+
+		//Now the SSA edges. We only look at instructions in blocks that are executable
+		while(dynamic_array_is_empty(&(context->ssa_worklist)) == FALSE){
+			instruction_t* instruction = dynamic_array_delete_from_back(&(context->ssa_worklist));
+			basic_block_t* block = instruction->block_contained_in;
+
+			if(context->executable_blocks[block->function_block_index] == TRUE){
+				visit_sccp_instruction(context, instruction);
+			}
+		}
+	}
+}
+
+
+/**
+ * Replace a phi function or an expression whose result we know with a plain
+ * constant assignment. Phi functions need to stay at the top of their block,
+ * so any replacement for one goes right after the last phi function
+ */
+static void replace_with_sccp_constant(instruction_t* instruction, int64_t value){
+	basic_block_t* block = instruction->block_contained_in;
+	three_addr_var_t* assignee = instruction->operands.oir.assignee;
+
+	//Make the new assignment
+	three_addr_const_t* constant = emit_direct_integer_or_char_constant(value, dealias_type(assignee->type));
+	instruction_t* assignment = emit_assignment_with_const_instruction(assignee, constant, instruction->line_number);
+
+	//We're losing all of these uses
+	if(instruction->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+		for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+			three_addr_var_t* parameter = dynamic_array_get_at(&(instruction->parameters), i);
+			parameter->use_count--;
+		}
+
+		delete_statement(instruction);
+
+		//Find the first thing that isn't a phi function
+		instruction_t* cursor = block->leader_statement;
+		while(cursor != NULL && cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+			cursor = cursor->next_statement;
+		}
+
+		if(cursor != NULL){
+			insert_instruction_before_given(assignment, cursor);
+		} else {
+			add_statement(block, assignment);
+		}
+
+		return;
+	}
+
+	if(instruction->operands.oir.operand1 != NULL){
+		instruction->operands.oir.operand1->use_count--;
+	}
+
+	if(instruction->operands.oir.operand2 != NULL){
+		instruction->operands.oir.operand2->use_count--;
+	}
+
+	insert_instruction_before_given(assignment, instruction);
+	delete_statement(instruction);
+}
+
+
+/**
+ * Is this an instruction that we're able to swap out for a constant assignment?
+ */
+static inline u_int8_t is_instruction_sccp_replaceable(instruction_t* instruction){
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_PHI_FUNC:
+		case THREE_ADDR_CODE_ASSN_STMT:
+		case THREE_ADDR_CODE_TRUNCATING_ASSN_STMT:
+		case THREE_ADDR_CODE_INC_STMT:
+		case THREE_ADDR_CODE_DEC_STMT:
+		case THREE_ADDR_CODE_NEG_STATEMENT:
+		case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+		case THREE_ADDR_CODE_LOGICAL_NOT_STMT:
+		case THREE_ADDR_CODE_TEST_IF_NOT_ZERO_STMT:
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			break;
+		default:
+			return FALSE;
+	}
+
+	three_addr_var_t* assignee = instruction->operands.oir.assignee;
+
+	/**
+	 * Anything that sets condition codes for a branch or conditional move has to stay. If
+	 * the branch was folded away, mark & sweep will clean these up on its own
+	 */
+	if(assignee->sets_cc == TRUE){
+		return FALSE;
+	}
+
+	//Booleans can't be emitted as direct constants
+	generic_type_t* type = dealias_type(assignee->type);
+	if(type->type_class != TYPE_CLASS_BASIC || type->basic_type_token == BOOL){
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Once SCCP is done, can every executable block still reach the function exit if we
+ * only ever follow the edges that were found to be executable? We crawl backwards from the
+ * exit to find out
+ */
+static u_int8_t can_every_executable_block_reach_exit(sccp_context_t* context, basic_block_t* function_exit_block, dynamic_array_t* function_blocks){
+	//If the exit itself never runs, there's nothing to reach
+	if(context->executable_blocks[function_exit_block->function_block_index] == FALSE){
+		return FALSE;
+	}
+
+	//How many executable blocks are there in total?
+	u_int32_t executable_count = 0;
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		if(context->executable_blocks[block->function_block_index] == TRUE){
+			executable_count++;
+		}
+	}
+
+	//Reuse the visited flags for this crawl
+	reset_block_visits_for_function(function_exit_block->function_defined_in);
+
+	dynamic_array_t stack = dynamic_array_alloc();
+	dynamic_array_add(&stack, function_exit_block);
+	mark_block_visited(function_exit_block);
+	u_int32_t reached_count = 1;
+
+	while(dynamic_array_is_empty(&stack) == FALSE){
+		basic_block_t* block = dynamic_array_delete_from_back(&stack);
+		u_int32_t edge_offset = context->edge_offsets[block->function_block_index];
+
+		for(int32_t i = 0; i < block->predecessors.current_index; i++){
+			basic_block_t* predecessor = dynamic_array_get_at(&(block->predecessors), i);
+
+			if(context->executable_edges[edge_offset + i] == FALSE || is_block_visited(predecessor) == TRUE){
+				continue;
+			}
+
+			mark_block_visited(predecessor);
+			dynamic_array_add(&stack, predecessor);
+			reached_count++;
+		}
+	}
+
+	dynamic_array_dealloc(&stack);
+
+	return reached_count == executable_count ? TRUE : FALSE;
+}
+
+
+/**
+ * Sparse conditional constant propagation(Wegman & Zadeck). We run over the SSA form of the function
+ * with two worklists - one for CFG edges and one for SSA def-use edges. Every value starts out
+ * at the top of the lattice and only ever moves down, and blocks are only looked at once an edge into
+ * them is found to be executable. This lets constants flow through phi functions while ignoring the
+ * paths that can never be taken.
+ *
+ * Once we're done:
+ * 	1.) Every branch that always goes one way is replaced with a jump, and the dead edge is removed
+ * 	2.) Every expression or phi function that always gives back the same value is replaced with
+ * 		a constant assignment
+ *
+ * The now-unreachable blocks and now-useless instructions are left for the unreachable block
+ * deletion and mark & sweep to clean up. If we've changed any control flow, we give back TRUE
+ */
+static u_int8_t sparse_conditional_constant_propagation(basic_block_t* function_entry_block, basic_block_t* function_exit_block, dynamic_array_t* function_blocks, control_flow_update_log_t* control_flow_updates){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+	u_int8_t changed_control_flow = FALSE;
+
+	/**
+	 * Inline assembly could be doing anything to our variables, so
+	 * we won't touch those functions at all. While we're here, count up
+	 * how many instructions and edges that we have
+	 */
+	u_int32_t instruction_count = 0;
+	u_int32_t edge_count = 0;
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(cursor->statement_type == THREE_ADDR_CODE_ASM_INLINE_STMT){
+				return FALSE;
+			}
+
+			instruction_count++;
+		}
+
+		edge_count += block->predecessors.current_index;
+	}
+
+	sccp_context_t context;
+
+	//Size the table so that it's never more than half full
+	context.cell_table_size = 16;
+	while(context.cell_table_size < instruction_count * 2){
+		context.cell_table_size *= 2;
+	}
+
+	context.cells = calloc(context.cell_table_size, sizeof(sccp_cell_t));
+	context.uses_max_size = instruction_count + 16;
+	context.uses = calloc(context.uses_max_size, sizeof(sccp_use_t));
+	context.uses_current_index = 0;
+	context.executable_blocks = calloc(function->number_of_block_indices, sizeof(u_int8_t));
+	context.edge_offsets = calloc(function->number_of_block_indices, sizeof(u_int32_t));
+	context.executable_edges = calloc(edge_count + 1, sizeof(u_int8_t));
+	context.edge_worklist = dynamic_array_alloc();
+	context.ssa_worklist = dynamic_array_alloc();
+
+	/**
+	 * First pass - make a cell for every definition, and lay out where each
+	 * block's incoming edges live
+	 */
+	edge_count = 0;
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		context.edge_offsets[block->function_block_index] = edge_count;
+		edge_count += block->predecessors.current_index;
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			sccp_cell_t* cell = get_sccp_cell(&context, cursor->operands.oir.assignee, TRUE);
+
+			if(cell != NULL){
+				cell->definition = cursor;
+				cell->definition_count++;
+			}
+
+			//Calls can define an error value as well
+			if((cursor->statement_type == THREE_ADDR_CODE_FUNC_CALL || cursor->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+				&& cursor->optional_storage.error_assignee != NULL){
+				cell = get_sccp_cell(&context, cursor->optional_storage.error_assignee, TRUE);
+
+				if(cell != NULL){
+					cell->definition = cursor;
+					cell->definition_count++;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Second pass - record the uses that we care about. Anything that's defined more
+	 * than once is not in SSA form, so we send it right to the bottom
+	 */
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			sccp_cell_t* cell = get_sccp_cell(&context, cursor->operands.oir.assignee, FALSE);
+			if(cell != NULL && cell->definition_count > 1){
+				cell->lattice_value = SCCP_LATTICE_BOTTOM;
+			}
+
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_PHI_FUNC:
+					for(int32_t j = 0; j < cursor->parameters.current_index; j++){
+						add_sccp_use(&context, dynamic_array_get_at(&(cursor->parameters), j), cursor);
+					}
+					break;
+
+				case THREE_ADDR_CODE_BRANCH_STMT:
+					add_sccp_use(&context, cursor->relies_on, cursor);
+					break;
+
+				case THREE_ADDR_CODE_INDIRECT_JUMP_STMT:
+					add_sccp_use(&context, cursor->operands.oir.address_operand2, cursor);
+					break;
+
+				default:
+					add_sccp_use(&context, cursor->operands.oir.operand1, cursor);
+					add_sccp_use(&context, cursor->operands.oir.operand2, cursor);
+					break;
+			}
+		}
+	}
+
+	//The entry block is always executable
+	visit_sccp_block(&context, function_entry_block);
+
+	/**
+	 * Run until we're stable. Strange code that relies on values that are never defined
+	 * can leave a branch in an executable block sitting at the top. The blocks after that
+	 * branch are certainly still reachable, so we drop its condition to the bottom and go again
+	 */
+	u_int8_t stable = FALSE;
+	while(stable == FALSE){
+		run_sccp_worklists(&context);
+
+		stable = TRUE;
+		for(int32_t i = 0; i < function_blocks->current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+			sccp_lattice_value_t status;
+
+			if(context.executable_blocks[block->function_block_index] == FALSE || block->exit_statement == NULL){
+				continue;
+			}
+
+			switch(block->exit_statement->statement_type){
+				case THREE_ADDR_CODE_BRANCH_STMT:
+					get_sccp_branch_target(&context, block->exit_statement, &status);
+
+					if(status == SCCP_LATTICE_TOP){
+						lower_sccp_cell(&context, get_sccp_cell(&context, block->exit_statement->relies_on, FALSE), SCCP_LATTICE_BOTTOM, 0);
+						dynamic_array_add(&(context.ssa_worklist), block->exit_statement);
+						stable = FALSE;
+					}
+
+					break;
+
+				case THREE_ADDR_CODE_INDIRECT_JUMP_STMT:
+					get_sccp_indirect_jump_target(&context, block->exit_statement, &status);
+
+					if(status == SCCP_LATTICE_TOP){
+						lower_sccp_cell(&context, get_sccp_cell(&context, block->exit_statement->operands.oir.address_operand2, FALSE), SCCP_LATTICE_BOTTOM, 0);
+						dynamic_array_add(&(context.ssa_worklist), block->exit_statement);
+						stable = FALSE;
+					}
+
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+
+	/**
+	 * Now we can rewrite. First every branch that always goes one way becomes a jump. We
+	 * only do this in executable blocks - the rest are about to be deleted anyway
+	 *
+	 * If some executable block is no longer able to reach the exit over executable edges, then
+	 * folding the branches would leave behind a loop that never ends with no way out of it. The
+	 * dominance relations can't handle that, so we leave the control flow alone. The values that
+	 * we found are still good, because the paths that we ruled out really can't run
+	 */
+	u_int8_t can_fold_branches = can_every_executable_block_reach_exit(&context, function_exit_block, function_blocks);
+
+	for(int32_t i = 0; can_fold_branches == TRUE && i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		if(context.executable_blocks[block->function_block_index] == FALSE){
+			continue;
+		}
+
+		instruction_t* branch = block->exit_statement;
+		sccp_lattice_value_t status;
+
+		/**
+		 * An indirect jump that always goes to the same place becomes a jump there. Every other block
+		 * in its table is no longer a successor, and the table itself is no longer needed
+		 */
+		if(branch != NULL && branch->statement_type == THREE_ADDR_CODE_INDIRECT_JUMP_STMT){
+			basic_block_t* target = get_sccp_indirect_jump_target(&context, branch, &status);
+
+			if(status != SCCP_LATTICE_CONSTANT){
+				continue;
+			}
+
+			add_statement(block, emit_jmp_instruction(target));
+
+			for(int32_t j = block->successors.current_index - 1; j >= 0; j--){
+				basic_block_t* successor = dynamic_array_get_at(&(block->successors), j);
+
+				if(successor != target){
+					delete_successor(block, successor);
+					record_control_flow_update(control_flow_updates, block, successor, CONTROL_FLOW_EDGE_DELETED);
+				}
+			}
+
+			delete_statement(branch);
+			jump_table_dealloc(block->jump_table);
+			block->jump_table = NULL;
+
+			changed_control_flow = TRUE;
+			continue;
+		}
+
+		if(branch == NULL || branch->statement_type != THREE_ADDR_CODE_BRANCH_STMT || branch->if_block == branch->else_block){
+			continue;
+		}
+
+		basic_block_t* target = get_sccp_branch_target(&context, branch, &status);
+
+		if(status != SCCP_LATTICE_CONSTANT){
+			continue;
+		}
+
+		//Whichever one we're not going to
+		basic_block_t* dead_target = target == branch->if_block ? branch->else_block : branch->if_block;
+
+		add_statement(block, emit_jmp_instruction(target));
+
+		delete_successor(block, dead_target);
+		record_control_flow_update(control_flow_updates, block, dead_target, CONTROL_FLOW_EDGE_DELETED);
+
+		delete_statement(branch);
+
+		changed_control_flow = TRUE;
+	}
+
+	/**
+	 * Then every instruction whose value we know is swapped for a constant assignment
+	 */
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		if(context.executable_blocks[block->function_block_index] == FALSE){
+			continue;
+		}
+
+		instruction_t* cursor = block->leader_statement;
+		while(cursor != NULL){
+			//Hang onto this, the cursor may be deleted
+			instruction_t* next = cursor->next_statement;
+
+			sccp_cell_t* cell = get_sccp_cell(&context, cursor->operands.oir.assignee, FALSE);
+
+			if(cell != NULL && cell->lattice_value == SCCP_LATTICE_CONSTANT
+				&& is_instruction_sccp_replaceable(cursor) == TRUE){
+				replace_with_sccp_constant(cursor, cell->constant_value);
+			}
+
+			cursor = next;
+		}
+	}
+
+	//Clean up everything that we used
+	free(context.cells);
+	free(context.uses);
+	free(context.executable_blocks);
+	free(context.edge_offsets);
+	free(context.executable_edges);
+	dynamic_array_dealloc(&(context.edge_worklist));
+	dynamic_array_dealloc(&(context.ssa_worklist));
+
+	return changed_control_flow;
+}
+
+
+/**
+ * One field of an aggregate that is being split up. Every field
+ * becomes its own SSA compatible variable
+ */
+typedef struct scalar_replacement_field_t{
+	//The record that now holds the field's value
+	symtab_variable_record_t* record;
+	//The version that reaches the point that the renamer is at
+	three_addr_var_t* current_version;
+	//What type is the field read and written as?
+	generic_type_t* type;
+	//Every block that writes to the field
+	dynamic_array_t defining_blocks;
+	//Where does the field start in the aggregate?
+	int64_t offset;
+} scalar_replacement_field_t;
+
+
+/**
+ * A stack allocated aggregate that we may be able to split up. Anything that
+ * touches its memory other than a load or store at a constant offset rejects it
+ */
+typedef struct scalar_replacement_aggregate_t{
+	//The variable that owns the stack region
+	symtab_variable_record_t* record;
+	//The aggregate's memory address, as the function first uses it
+	three_addr_var_t* address;
+	//All of the fields that we've seen accessed
+	dynamic_array_t fields;
+	//Calls to non capturing callees that the aggregate's address is passed to
+	dynamic_array_t calls;
+	//How large is the aggregate in bytes?
+	int64_t size;
+	//How often do we expect the aggregate's loads and stores to run?
+	u_int64_t access_frequency;
+	//Did something disqualify this aggregate?
+	u_int8_t rejected;
+} scalar_replacement_aggregate_t;
+
+
+/**
+ * A variable that holds an address inside of an aggregate, like a pointer
+ * that was made with &x or a copy of it with a constant added on
+ */
+typedef struct scalar_replacement_address_t{
+	//The variable holding the address
+	three_addr_var_t* variable;
+	//The aggregate that it points into
+	scalar_replacement_aggregate_t* aggregate;
+	//How far into the aggregate does it point?
+	int64_t offset;
+} scalar_replacement_address_t;
+
+
+/**
+ * Everything that scalar replacement needs for one function. This is all local to
+ * the worker that is optimizing the function
+ */
+typedef struct scalar_replacement_context_t{
+	//Every aggregate that we've seen in the function
+	dynamic_array_t aggregates;
+	//Every variable that holds an address inside of an aggregate
+	dynamic_array_t addresses;
+	//The function's local stack. Only regions in here are candidates
+	stack_data_area_t* local_stack;
+	//Every field of every aggregate that we're going to split up
+	dynamic_array_t fields;
+	//Inline assembly could do anything at all with the stack
+	u_int8_t contains_inline_assembly;
+} scalar_replacement_context_t;
+
+
+/**
+ * The places in an instruction that an address is allowed to show up. Anything
+ * outside of the allowed slots lets the address escape
+ */
+typedef enum{
+	ADDRESS_USE_SLOT_NONE = 0,
+	ADDRESS_USE_SLOT_BASE_ADDRESS = 1 << 0,
+	ADDRESS_USE_SLOT_ASSIGNEE = 1 << 1,
+	ADDRESS_USE_SLOT_OPERAND1 = 1 << 2,
+	ADDRESS_USE_SLOT_PARAMETERS = 1 << 3,
+} address_use_slot_t;
+
+
+/**
+ * Grab the aggregate for a given variable. Only memory addresses of regions that the function's
+ * own local stack holds can be split, so for anything else we give back NULL. If create is TRUE and
+ * we've not seen this aggregate before, it is made here
+ */
+static scalar_replacement_aggregate_t* get_scalar_replacement_aggregate(scalar_replacement_context_t* context, three_addr_var_t* variable, u_int8_t create){
+	if(variable == NULL || variable->variable_type != VARIABLE_TYPE_MEMORY_ADDRESS || variable->linked_var == NULL){
+		return NULL;
+	}
+
+	for(int32_t i = 0; i < context->aggregates.current_index; i++){
+		scalar_replacement_aggregate_t* aggregate = dynamic_array_get_at(&(context->aggregates), i);
+
+		if(aggregate->record == variable->linked_var){
+			return aggregate;
+		}
+	}
+
+	if(create == FALSE){
+		return NULL;
+	}
+
+	/**
+	 * The region has to be owned by this variable in the local stack. Stack passed
+	 * parameters and return by copy regions live elsewhere and can't be touched
+	 */
+	if(does_stack_contain_pointer_to_variable(context->local_stack, variable->linked_var) == NULL){
+		return NULL;
+	}
+
+	scalar_replacement_aggregate_t* aggregate = calloc(1, sizeof(scalar_replacement_aggregate_t));
+	aggregate->record = variable->linked_var;
+	aggregate->address = variable;
+	aggregate->fields = dynamic_array_alloc();
+	aggregate->calls = dynamic_array_alloc();
+	aggregate->size = dealias_type(variable->type)->type_size;
+
+	dynamic_array_add(&(context->aggregates), aggregate);
+
+	return aggregate;
+}
+
+
+/**
+ * Grab the aggregate that a variable points into, along with how far into it the variable points. This
+ * is either the aggregate's own memory address or a variable that we've already seen being derived
+ * from one. For anything else we give back NULL
+ */
+static scalar_replacement_aggregate_t* get_scalar_replacement_address(scalar_replacement_context_t* context, three_addr_var_t* variable, u_int8_t create, int64_t* offset){
+	if(variable == NULL){
+		return NULL;
+	}
+
+	if(variable->variable_type == VARIABLE_TYPE_MEMORY_ADDRESS){
+		*offset = 0;
+		return get_scalar_replacement_aggregate(context, variable, create);
+	}
+
+	for(int32_t i = 0; i < context->addresses.current_index; i++){
+		scalar_replacement_address_t* address = dynamic_array_get_at(&(context->addresses), i);
+
+		if(variables_equal(address->variable, variable) == TRUE){
+			*offset = address->offset;
+			return address->aggregate;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Record that a variable now holds an address inside of an aggregate
+ */
+static inline void add_scalar_replacement_address(scalar_replacement_context_t* context, three_addr_var_t* variable, scalar_replacement_aggregate_t* aggregate, int64_t offset){
+	scalar_replacement_address_t* address = calloc(1, sizeof(scalar_replacement_address_t));
+	address->variable = variable;
+	address->aggregate = aggregate;
+	address->offset = offset;
+
+	dynamic_array_add(&(context->addresses), address);
+}
+
+
+/**
+ * If the given variable holds an address inside of a local aggregate, then that aggregate
+ * is now off the table
+ */
+static inline void reject_scalar_replacement_aggregate(scalar_replacement_context_t* context, three_addr_var_t* variable){
+	int64_t offset;
+	scalar_replacement_aggregate_t* aggregate = get_scalar_replacement_address(context, variable, TRUE, &offset);
+
+	if(aggregate != NULL){
+		aggregate->rejected = TRUE;
+	}
+}
+
+
+/**
+ * Reject every aggregate whose address shows up anywhere in the instruction outside
+ * of the slots that the caller has allowed
+ */
+static void reject_scalar_replacement_escapes(scalar_replacement_context_t* context, instruction_t* instruction, u_int32_t allowed_slots){
+	if((allowed_slots & ADDRESS_USE_SLOT_BASE_ADDRESS) == 0){
+		reject_scalar_replacement_aggregate(context, instruction->operands.oir.address_operand1);
+	}
+
+	if((allowed_slots & ADDRESS_USE_SLOT_ASSIGNEE) == 0){
+		reject_scalar_replacement_aggregate(context, instruction->operands.oir.assignee);
+	}
+
+	if((allowed_slots & ADDRESS_USE_SLOT_OPERAND1) == 0){
+		reject_scalar_replacement_aggregate(context, instruction->operands.oir.operand1);
+	}
+
+	reject_scalar_replacement_aggregate(context, instruction->operands.oir.operand2);
+	reject_scalar_replacement_aggregate(context, instruction->operands.oir.address_operand2);
+	reject_scalar_replacement_aggregate(context, instruction->operands.oir.rip_offset_var);
+	reject_scalar_replacement_aggregate(context, instruction->relies_on);
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_FUNC_CALL:
+		case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+			reject_scalar_replacement_aggregate(context, instruction->optional_storage.error_assignee);
+			//Fall through to the parameters
+		case THREE_ADDR_CODE_PHI_FUNC:
+			if((allowed_slots & ADDRESS_USE_SLOT_PARAMETERS) != 0){
+				break;
+			}
+
+			for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+				reject_scalar_replacement_aggregate(context, dynamic_array_get_at(&(instruction->parameters), i));
+			}
+
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+/**
+ * Get the value of a temp that is used by the given instruction, so long as it was assigned
+ * a constant earlier in the same block. Otherwise we give back FALSE
+ */
+static u_int8_t get_scalar_replacement_temp_constant(instruction_t* user, three_addr_var_t* temp, int64_t* value){
+	if(temp->variable_type != VARIABLE_TYPE_TEMP){
+		return FALSE;
+	}
+
+	//Temps are only ever assigned once, so the first assignment we find is the one
+	for(instruction_t* cursor = user->previous_statement; cursor != NULL; cursor = cursor->previous_statement){
+		three_addr_var_t* assignee = cursor->operands.oir.assignee;
+
+		if(assignee != NULL && assignee->variable_type == VARIABLE_TYPE_TEMP && assignee->temp_var_number == temp->temp_var_number){
+			if(cursor->statement_type != THREE_ADDR_CODE_ASSN_CONST_STMT){
+				return FALSE;
+			}
+
+			return get_sccp_constant_value(cursor->operands.oir.constant_operand, value);
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Get the constant byte offset that a load or store uses relative to its base address. A
+ * variable index is only allowed if it's a temp that was assigned a constant earlier in
+ * the same block. If the offset is not known at compile time, we give back FALSE
+ */
+static u_int8_t get_scalar_replacement_offset(instruction_t* access, int64_t* offset){
+	switch(access->addressing_mode){
+		case ADDRESSING_MODE_BASE_ADDRESS_ONLY:
+			*offset = 0;
+			return TRUE;
+
+		case ADDRESSING_MODE_OFFSET_ONLY:
+			return get_sccp_constant_value(access->operands.oir.address_offset, offset);
+
+		case ADDRESSING_MODE_REGISTERS_ONLY:
+			return get_scalar_replacement_temp_constant(access, access->operands.oir.address_operand2, offset);
+
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Can a value of this type live in a register on its own? We need to be able to
+ * zero it out, so this is limited to the integer, floating point and pointer types
+ */
+static inline u_int8_t is_type_scalar_replaceable(generic_type_t* type){
+	switch(type->type_class){
+		case TYPE_CLASS_BASIC:
+			if(type->basic_type_token == VOID || type->basic_type_token == F128){
+				return FALSE;
+			}
+
+			break;
+
+		case TYPE_CLASS_POINTER:
+		case TYPE_CLASS_ENUMERATED:
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	switch(type->type_size){
+		case 1:
+		case 2:
+		case 4:
+		case 8:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Find the field that starts at the given offset, if there is one
+ */
+static inline scalar_replacement_field_t* get_scalar_replacement_field(scalar_replacement_aggregate_t* aggregate, int64_t offset){
+	for(int32_t i = 0; i < aggregate->fields.current_index; i++){
+		scalar_replacement_field_t* field = dynamic_array_get_at(&(aggregate->fields), i);
+
+		if(field->offset == offset){
+			return field;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Record a load or store to an aggregate through an address that points base_offset bytes into it. The
+ * access needs to be at a known offset, inside of the aggregate and move a value of the same size and
+ * class that the memory holds. Every access to the same field has to agree on that, and no two fields
+ * may overlap. If any of this fails the whole aggregate is rejected
+ */
+static void add_scalar_replacement_access(scalar_replacement_aggregate_t* aggregate, instruction_t* access, int64_t base_offset){
+	int64_t offset;
+	if(get_scalar_replacement_offset(access, &offset) == FALSE){
+		aggregate->rejected = TRUE;
+		return;
+	}
+
+	offset += base_offset;
+
+	generic_type_t* memory_type = dealias_type(access->type_storage.memory_read_write_type);
+	if(is_type_scalar_replaceable(memory_type) == FALSE){
+		aggregate->rejected = TRUE;
+		return;
+	}
+
+	int64_t size = memory_type->type_size;
+	u_int8_t is_floating_point = IS_FLOATING_POINT(memory_type);
+
+	if(offset < 0 || offset + size > aggregate->size){
+		aggregate->rejected = TRUE;
+		return;
+	}
+
+	//What is actually moving in or out of memory?
+	generic_type_t* value_type;
+	if(access->statement_type == THREE_ADDR_CODE_LOAD_STATEMENT){
+		value_type = dealias_type(access->operands.oir.assignee->type);
+
+	//Storing the address of some other variable. What we're storing is a pointer, not a value of the variable's type
+	} else if(access->operands.oir.operand1 != NULL
+		&& (access->operands.oir.operand1->variable_type == VARIABLE_TYPE_MEMORY_ADDRESS || access->operands.oir.operand1->variable_type == VARIABLE_TYPE_STACK_PARAM_MEMORY_ADDRESS)){
+		if(memory_type->type_class != TYPE_CLASS_POINTER){
+			aggregate->rejected = TRUE;
+			return;
+		}
+
+		value_type = memory_type;
+
+	} else if(access->operands.oir.operand1 != NULL){
+		value_type = dealias_type(access->operands.oir.operand1->type);
+
+	//Constant stores are only done for integers
+	} else {
+		int64_t value;
+		if(is_floating_point == TRUE || get_sccp_constant_value(access->operands.oir.constant_operand, &value) == FALSE){
+			aggregate->rejected = TRUE;
+			return;
+		}
+
+		value_type = memory_type;
+	}
+
+	/**
+	 * A load is allowed to widen an integer, because an assignment from the field extends it the
+	 * same way. Anything else has to go through memory untouched
+	 */
+	if(IS_FLOATING_POINT(value_type) != is_floating_point
+		|| value_type->type_size < size
+		|| (value_type->type_size > size && (access->statement_type == THREE_ADDR_CODE_STORE_STATEMENT || is_floating_point == TRUE))){
+		aggregate->rejected = TRUE;
+		return;
+	}
+
+	scalar_replacement_field_t* field = get_scalar_replacement_field(aggregate, offset);
+
+	if(field == NULL){
+		//Fields can't overlap with one another
+		for(int32_t i = 0; i < aggregate->fields.current_index; i++){
+			scalar_replacement_field_t* other = dynamic_array_get_at(&(aggregate->fields), i);
+
+			if(offset < other->offset + other->type->type_size && other->offset < offset + size){
+				aggregate->rejected = TRUE;
+				return;
+			}
+		}
+
+		if(aggregate->fields.current_index == SCALAR_REPLACEMENT_MAX_FIELDS){
+			aggregate->rejected = TRUE;
+			return;
+		}
+
+		field = calloc(1, sizeof(scalar_replacement_field_t));
+		field->type = memory_type;
+		field->offset = offset;
+		field->defining_blocks = dynamic_array_alloc();
+
+		dynamic_array_add(&(aggregate->fields), field);
+
+	} else if(field->type->type_size != size || IS_FLOATING_POINT(field->type) != is_floating_point){
+		aggregate->rejected = TRUE;
+		return;
+	}
+
+	if(access->statement_type == THREE_ADDR_CODE_STORE_STATEMENT && dynamic_array_contains(&(field->defining_blocks), access->block_contained_in) == NOT_FOUND){
+		dynamic_array_add(&(field->defining_blocks), access->block_contained_in);
+	}
+}
+
+
+/**
+ * Does the callee store through any of the parameters that point into the given aggregate?
+ */
+static u_int8_t does_call_write_to_aggregate(scalar_replacement_context_t* context, instruction_t* call, scalar_replacement_aggregate_t* aggregate){
+	for(int32_t i = 0; i < call->parameters.current_index; i++){
+		int64_t offset;
+
+		if(get_scalar_replacement_address(context, dynamic_array_get_at(&(call->parameters), i), FALSE, &offset) == aggregate
+			&& (call->called_function->written_through_parameters & (1U << i)) != 0){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Look at one instruction for the aggregate scan. Loads and stores are recorded as accesses, copies
+ * and constant offsets of an aggregate's address are followed, and calls may be handed an address if the
+ * callee never holds onto it. Anything else that sees an aggregate's address rejects it
+ */
+static void scan_scalar_replacement_instruction(scalar_replacement_context_t* context, instruction_t* instruction){
+	scalar_replacement_aggregate_t* aggregate;
+	int64_t offset;
+	int64_t constant;
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_ASM_INLINE_STMT:
+			context->contains_inline_assembly = TRUE;
+			break;
+
+		case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+			get_scalar_replacement_aggregate(context, instruction->operands.oir.assignee, TRUE);
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_ASSIGNEE);
+			break;
+
+		case THREE_ADDR_CODE_LOAD_STATEMENT:
+		case THREE_ADDR_CODE_STORE_STATEMENT:
+			aggregate = get_scalar_replacement_address(context, instruction->operands.oir.address_operand1, TRUE, &offset);
+
+			if(aggregate != NULL && aggregate->rejected == FALSE){
+				add_scalar_replacement_access(aggregate, instruction, offset);
+				aggregate->access_frequency += ((basic_block_t*)(instruction->block_contained_in))->estimated_execution_frequency;
+			}
+
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_BASE_ADDRESS);
+			break;
+
+		//Copying an address around is fine so long as every copy is watched too
+		case THREE_ADDR_CODE_ASSN_STMT:
+			aggregate = get_scalar_replacement_address(context, instruction->operands.oir.operand1, TRUE, &offset);
+
+			if(aggregate == NULL || instruction->operands.oir.assignee->variable_size != QUAD_WORD){
+				reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_NONE);
+				break;
+			}
+
+			add_scalar_replacement_address(context, instruction->operands.oir.assignee, aggregate, offset);
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_OPERAND1 | ADDRESS_USE_SLOT_ASSIGNEE);
+			break;
+
+		//Pointer arithmetic is already scaled, so a constant here moves the address by that many bytes
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			aggregate = get_scalar_replacement_address(context, instruction->operands.oir.operand1, TRUE, &offset);
+
+			if(aggregate == NULL
+				|| (instruction->op != PLUS && instruction->op != MINUS)
+				|| instruction->operands.oir.assignee->variable_size != QUAD_WORD
+				|| get_sccp_constant_value(instruction->operands.oir.constant_operand, &constant) == FALSE){
+				reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_NONE);
+				break;
+			}
+
+			add_scalar_replacement_address(context, instruction->operands.oir.assignee, aggregate, instruction->op == PLUS ? offset + constant : offset - constant);
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_OPERAND1 | ADDRESS_USE_SLOT_ASSIGNEE);
+			break;
+
+		//The same goes for a temp that holds a constant
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+			aggregate = get_scalar_replacement_address(context, instruction->operands.oir.operand1, TRUE, &offset);
+
+			if(aggregate == NULL
+				|| (instruction->op != PLUS && instruction->op != MINUS)
+				|| instruction->operands.oir.assignee->variable_size != QUAD_WORD
+				|| get_scalar_replacement_temp_constant(instruction, instruction->operands.oir.operand2, &constant) == FALSE){
+				reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_NONE);
+				break;
+			}
+
+			add_scalar_replacement_address(context, instruction->operands.oir.assignee, aggregate, instruction->op == PLUS ? offset + constant : offset - constant);
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_OPERAND1 | ADDRESS_USE_SLOT_ASSIGNEE);
+			break;
+
+		/**
+		 * A callee that never holds onto a parameter can be given an aggregate's address. The
+		 * memory is brought up to date right before the call, and read back afterwards if the
+		 * callee writes to it
+		 */
+		case THREE_ADDR_CODE_FUNC_CALL:
+			for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+				aggregate = get_scalar_replacement_address(context, dynamic_array_get_at(&(instruction->parameters), i), TRUE, &offset);
+
+				if(aggregate == NULL){
+					continue;
+				}
+
+				if(instruction->called_function == NULL
+					|| i >= 32
+					|| (instruction->called_function->non_capturing_parameters & (1U << i)) == 0){
+					aggregate->rejected = TRUE;
+					continue;
+				}
+
+				if(dynamic_array_contains(&(aggregate->calls), instruction) == NOT_FOUND){
+					dynamic_array_add(&(aggregate->calls), instruction);
+				}
+			}
+
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_PARAMETERS);
+			break;
+
+		default:
+			reject_scalar_replacement_escapes(context, instruction, ADDRESS_USE_SLOT_NONE);
+			break;
+	}
+}
+
+
+/**
+ * Scan every block that the renamer will get to. We go in dominator tree order so that
+ * an address is always seen being made before it is used anywhere other than a phi function
+ */
+static void scan_scalar_replacement_block(scalar_replacement_context_t* context, basic_block_t* block){
+	mark_block_visited(block);
+
+	for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+		scan_scalar_replacement_instruction(context, cursor);
+	}
+
+	for(int32_t i = 0; i < block->analysis->dominator_children.current_index; i++){
+		scan_scalar_replacement_block(context, dynamic_array_get_at(&(block->analysis->dominator_children), i));
+	}
+}
+
+
+/**
+ * Find every local aggregate in the function and work out which ones can be split up. Blocks
+ * that the renamer won't reach are not allowed to touch an aggregate at all. Gives back FALSE
+ * if nothing in the function can be split
+ */
+static u_int8_t find_scalar_replacement_candidates(scalar_replacement_context_t* context, basic_block_t* function_entry_block, dynamic_array_t* function_blocks){
+	reset_block_visits_for_function(function_entry_block->function_defined_in);
+	scan_scalar_replacement_block(context, function_entry_block);
+
+	if(context->contains_inline_assembly == TRUE){
+		return FALSE;
+	}
+
+	/**
+	 * A phi function's parameters can come from blocks that the walk had not gotten to yet, so
+	 * they're only checked now that every address is known
+	 */
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+		u_int8_t reachable = is_block_visited(block);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(reachable == FALSE || cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+				reject_scalar_replacement_escapes(context, cursor, ADDRESS_USE_SLOT_NONE);
+			}
+		}
+	}
+
+	reset_block_visits_for_function(function_entry_block->function_defined_in);
+
+	for(int32_t i = 0; i < context->aggregates.current_index; i++){
+		scalar_replacement_aggregate_t* aggregate = dynamic_array_get_at(&(context->aggregates), i);
+
+		if(aggregate->rejected == TRUE || dynamic_array_is_empty(&(aggregate->calls)) == TRUE){
+			continue;
+		}
+
+		/**
+		 * Every call costs a store for each field, and a load for each field too if the callee
+		 * writes. Unless that is less than the loads and stores that we would get rid of, leave it in memory
+		 */
+		u_int64_t synchronization_frequency = 0;
+
+		for(int32_t j = 0; j < aggregate->calls.current_index; j++){
+			instruction_t* call = dynamic_array_get_at(&(aggregate->calls), j);
+			basic_block_t* block = call->block_contained_in;
+
+			if(does_call_write_to_aggregate(context, call, aggregate) == FALSE){
+				synchronization_frequency += block->estimated_execution_frequency;
+				continue;
+			}
+
+			synchronization_frequency += 2 * (u_int64_t)block->estimated_execution_frequency;
+
+			//Reading the fields back in defines them again
+			for(int32_t k = 0; k < aggregate->fields.current_index; k++){
+				scalar_replacement_field_t* field = dynamic_array_get_at(&(aggregate->fields), k);
+
+				if(dynamic_array_contains(&(field->defining_blocks), block) == NOT_FOUND){
+					dynamic_array_add(&(field->defining_blocks), block);
+				}
+			}
+		}
+
+		if(synchronization_frequency * aggregate->fields.current_index >= aggregate->access_frequency){
+			aggregate->rejected = TRUE;
+		}
+	}
+
+	//Pull every field that we're going to split out into one list
+	for(int32_t i = 0; i < context->aggregates.current_index; i++){
+		scalar_replacement_aggregate_t* aggregate = dynamic_array_get_at(&(context->aggregates), i);
+
+		if(aggregate->rejected == TRUE){
+			continue;
+		}
+
+		for(int32_t j = 0; j < aggregate->fields.current_index; j++){
+			dynamic_array_add(&(context->fields), dynamic_array_get_at(&(aggregate->fields), j));
+		}
+	}
+
+	for(int32_t i = 0; i < context->aggregates.current_index; i++){
+		scalar_replacement_aggregate_t* aggregate = dynamic_array_get_at(&(context->aggregates), i);
+
+		if(aggregate->rejected == FALSE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Make the next version of a field
+ */
+static inline three_addr_var_t* emit_next_scalar_replacement_version(scalar_replacement_field_t* field){
+	(field->record->ssa_counter)++;
+
+	three_addr_var_t* version = emit_var(field->record);
+	version->ssa_generation = field->record->ssa_counter;
+
+	return version;
+}
+
+
+/**
+ * Give back the aggregate that a variable points into if it is one that
+ * we are splitting up
+ */
+static inline scalar_replacement_aggregate_t* get_split_aggregate(scalar_replacement_context_t* context, three_addr_var_t* variable, int64_t* offset){
+	scalar_replacement_aggregate_t* aggregate = get_scalar_replacement_address(context, variable, FALSE, offset);
+
+	if(aggregate == NULL || aggregate->rejected == TRUE){
+		return NULL;
+	}
+
+	return aggregate;
+}
+
+
+/**
+ * Find the field that a phi function was made for, if it was made for one
+ */
+static inline scalar_replacement_field_t* get_scalar_replacement_phi_field(scalar_replacement_context_t* context, instruction_t* phi_function){
+	symtab_variable_record_t* record = phi_function->operands.oir.assignee->linked_var;
+
+	for(int32_t i = 0; i < context->fields.current_index; i++){
+		scalar_replacement_field_t* field = dynamic_array_get_at(&(context->fields), i);
+
+		if(field->record == record){
+			return field;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Make the variable for each field and give it a starting value of 0 at the very top of the function. Memory
+ * that was never written is undefined anyways, and this way every use has a definition that dominates it
+ */
+static void create_scalar_replacement_fields(scalar_replacement_context_t* context, basic_block_t* function_entry_block){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+	instruction_t* first_instruction = function_entry_block->leader_statement;
+
+	for(int32_t i = 0; i < context->fields.current_index; i++){
+		scalar_replacement_field_t* field = dynamic_array_get_at(&(context->fields), i);
+
+		//The variable symtab is shared by every function
+		pthread_mutex_lock(&variable_symtab_mutex);
+		field->record = create_ssa_compatible_temp_var(function, field->type, cfg_reference->variable_symtab, increment_and_get_temp_id());
+		pthread_mutex_unlock(&variable_symtab_mutex);
+
+		field->current_version = emit_next_scalar_replacement_version(field);
+
+		instruction_t* initialization;
+		if(IS_FLOATING_POINT(field->type) == TRUE){
+			initialization = emit_floating_point_clear_instruction(field->current_version, function->line_number);
+
+		} else {
+			//Bools, pointers and enums are zeroed with an unsigned constant of the same size
+			generic_type_t* constant_type = field->type;
+
+			if(field->type->type_class != TYPE_CLASS_BASIC || field->type->basic_type_token == BOOL){
+				switch(field->type->type_size){
+					case 1:
+						constant_type = lookup_type_name_only(cfg_reference->type_symtab, "u8", NOT_MUTABLE)->type;
+						break;
+					case 2:
+						constant_type = lookup_type_name_only(cfg_reference->type_symtab, "u16", NOT_MUTABLE)->type;
+						break;
+					case 4:
+						constant_type = lookup_type_name_only(cfg_reference->type_symtab, "u32", NOT_MUTABLE)->type;
+						break;
+					default:
+						constant_type = lookup_type_name_only(cfg_reference->type_symtab, "u64", NOT_MUTABLE)->type;
+						break;
+				}
+			}
+
+			initialization = emit_assignment_with_const_instruction(field->current_version, emit_direct_integer_or_char_constant(0, constant_type), function->line_number);
+		}
+
+		if(first_instruction != NULL){
+			insert_instruction_before_given(initialization, first_instruction);
+		} else {
+			add_statement(function_entry_block, initialization);
+		}
+
+		add_assigned_variable_to_block(function_entry_block, field->current_version);
+		dynamic_array_add(&(field->defining_blocks), function_entry_block);
+	}
+}
+
+
+/**
+ * Put phi functions for a field at the iterated dominance frontier of every block that
+ * writes to it. Block marks flag which blocks already have one
+ */
+static void insert_scalar_replacement_phi_functions(symtab_function_record_t* function, scalar_replacement_field_t* field, dynamic_array_t* worklist){
+	reset_block_marks_for_function(function);
+
+	for(int32_t i = 0; i < field->defining_blocks.current_index; i++){
+		dynamic_array_add(worklist, dynamic_array_get_at(&(field->defining_blocks), i));
+	}
+
+	while(dynamic_array_is_empty(worklist) == FALSE){
+		basic_block_t* block = dynamic_array_delete_from_back(worklist);
+
+		for(int32_t i = 0; i < block->analysis->dominance_frontier.current_index; i++){
+			basic_block_t* frontier_block = dynamic_array_get_at(&(block->analysis->dominance_frontier), i);
+
+			//Nothing can be read in the exit block
+			if(does_block_contain_mark(frontier_block) == TRUE || frontier_block->block_type == BLOCK_TYPE_FUNC_EXIT){
+				continue;
+			}
+
+			instruction_t* phi_function = calloc(1, sizeof(instruction_t));
+			phi_function->statement_type = THREE_ADDR_CODE_PHI_FUNC;
+			phi_function->operands.oir.assignee = emit_next_scalar_replacement_version(field);
+			phi_function->parameters = dynamic_array_alloc();
+
+			if(frontier_block->leader_statement != NULL){
+				phi_function->line_number = frontier_block->leader_statement->line_number;
+				insert_instruction_before_given(phi_function, frontier_block->leader_statement);
+			} else {
+				add_statement(frontier_block, phi_function);
+			}
+
+			add_assigned_variable_to_block(frontier_block, phi_function->operands.oir.assignee);
+			mark_block(frontier_block);
+
+			//A phi function is a definition too
+			dynamic_array_add(worklist, frontier_block);
+		}
+	}
+}
+
+
+/**
+ * Turn a load from or store to a split aggregate into a plain assignment using
+ * the field's current version
+ */
+static void replace_scalar_replacement_access(scalar_replacement_aggregate_t* aggregate, instruction_t* access, int64_t base_offset){
+	int64_t offset;
+	get_scalar_replacement_offset(access, &offset);
+
+	scalar_replacement_field_t* field = get_scalar_replacement_field(aggregate, base_offset + offset);
+
+	instruction_t* replacement;
+	if(access->statement_type == THREE_ADDR_CODE_LOAD_STATEMENT){
+		three_addr_var_t* current_version = emit_var_copy(field->current_version);
+		current_version->use_count = 1;
+
+		replacement = emit_assignment_instruction(access->operands.oir.assignee, current_version, access->line_number);
+
+	} else {
+		field->current_version = emit_next_scalar_replacement_version(field);
+
+		if(access->operands.oir.operand1 != NULL){
+			replacement = emit_assignment_instruction(field->current_version, access->operands.oir.operand1, access->line_number);
+
+			//This now belongs to the replacement, so the delete can't take a use away from it
+			access->operands.oir.operand1 = NULL;
+
+		} else {
+			replacement = emit_assignment_with_const_instruction(field->current_version, access->operands.oir.constant_operand, access->line_number);
+		}
+
+		add_assigned_variable_to_block(access->block_contained_in, field->current_version);
+	}
+
+	insert_instruction_before_given(replacement, access);
+	delete_statement(access);
+}
+
+
+/**
+ * Bring a split aggregate's memory up to date before a call that is handed its address. If
+ * the callee writes to it, every field is read back in afterwards
+ */
+static void synchronize_scalar_replacement_call(scalar_replacement_context_t* context, scalar_replacement_aggregate_t* aggregate, instruction_t* call){
+	generic_type_t* offset_type = lookup_type_name_only(cfg_reference->type_symtab, "u64", NOT_MUTABLE)->type;
+
+	for(int32_t i = 0; i < aggregate->fields.current_index; i++){
+		scalar_replacement_field_t* field = dynamic_array_get_at(&(aggregate->fields), i);
+
+		three_addr_var_t* base_address = emit_var_copy(aggregate->address);
+		base_address->use_count = 1;
+
+		three_addr_var_t* current_version = emit_var_copy(field->current_version);
+		current_version->use_count = 1;
+
+		insert_instruction_before_given(emit_store_base_address_and_constant_offset(base_address, emit_direct_integer_or_char_constant(field->offset, offset_type), current_version, field->type, call->line_number), call);
+	}
+
+	if(does_call_write_to_aggregate(context, call, aggregate) == FALSE){
+		return;
+	}
+
+	//Go in reverse so that the loads come out in field order
+	for(int32_t i = aggregate->fields.current_index - 1; i >= 0; i--){
+		scalar_replacement_field_t* field = dynamic_array_get_at(&(aggregate->fields), i);
+
+		three_addr_var_t* base_address = emit_var_copy(aggregate->address);
+		base_address->use_count = 1;
+
+		field->current_version = emit_next_scalar_replacement_version(field);
+
+		insert_instruction_after_given(emit_load_base_address_and_constant_offset(field->current_version, base_address, emit_direct_integer_or_char_constant(field->offset, offset_type), field->type, call->line_number), call);
+		add_assigned_variable_to_block(call->block_contained_in, field->current_version);
+	}
+}
+
+
+/**
+ * Rename every access to a split aggregate with a walk down the dominator tree. This is the
+ * same renaming that SSA construction does, except that a field's "stack" is just the version
+ * that was current when we came into the block
+ */
+static void rename_scalar_replacement_block(scalar_replacement_context_t* context, basic_block_t* block){
+	//Save what we came in with so that it can be put back for our siblings
+	three_addr_var_t** saved_versions = malloc(sizeof(three_addr_var_t*) * context->fields.current_index);
+	for(int32_t i = 0; i < context->fields.current_index; i++){
+		saved_versions[i] = ((scalar_replacement_field_t*)dynamic_array_get_at(&(context->fields), i))->current_version;
+	}
+
+	instruction_t* cursor = block->leader_statement;
+	while(cursor != NULL){
+		//The cursor may get deleted
+		instruction_t* next = cursor->next_statement;
+		scalar_replacement_aggregate_t* aggregate;
+		int64_t offset;
+
+		switch(cursor->statement_type){
+			case THREE_ADDR_CODE_PHI_FUNC:
+				{
+					scalar_replacement_field_t* field = get_scalar_replacement_phi_field(context, cursor);
+
+					if(field != NULL){
+						field->current_version = cursor->operands.oir.assignee;
+					}
+				}
+
+				break;
+
+			case THREE_ADDR_CODE_LOAD_STATEMENT:
+			case THREE_ADDR_CODE_STORE_STATEMENT:
+				aggregate = get_split_aggregate(context, cursor->operands.oir.address_operand1, &offset);
+
+				if(aggregate != NULL){
+					replace_scalar_replacement_access(aggregate, cursor, offset);
+				}
+
+				break;
+
+			//The next statement was saved above, so the loads that come after the call are skipped over
+			case THREE_ADDR_CODE_FUNC_CALL:
+				for(int32_t i = 0; i < cursor->parameters.current_index; i++){
+					aggregate = get_split_aggregate(context, dynamic_array_get_at(&(cursor->parameters), i), &offset);
+
+					if(aggregate == NULL){
+						continue;
+					}
+
+					//The same aggregate may be passed more than once, but it only needs to be synchronized once
+					int32_t j = 0;
+					while(j < i && get_split_aggregate(context, dynamic_array_get_at(&(cursor->parameters), j), &offset) != aggregate){
+						j++;
+					}
+
+					if(j == i){
+						synchronize_scalar_replacement_call(context, aggregate, cursor);
+					}
+				}
+
+				break;
+
+			//These have served their purpose, unless a callee still needs the memory
+			case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+				aggregate = get_split_aggregate(context, cursor->operands.oir.assignee, &offset);
+
+				if(aggregate != NULL && dynamic_array_is_empty(&(aggregate->calls)) == TRUE){
+					delete_statement(cursor);
+				}
+
+				break;
+
+			default:
+				break;
+		}
+
+		cursor = next;
+	}
+
+	//Fill in our side of the successor's phi functions
+	for(int32_t i = 0; i < block->successors.current_index; i++){
+		basic_block_t* successor = dynamic_array_get_at(&(block->successors), i);
+
+		for(cursor = successor->leader_statement; cursor != NULL && cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC; cursor = cursor->next_statement){
+			scalar_replacement_field_t* field = get_scalar_replacement_phi_field(context, cursor);
+
+			if(field == NULL){
+				continue;
+			}
+
+			three_addr_var_t* parameter = emit_var_copy(field->current_version);
+			parameter->use_count = 1;
+
+			dynamic_array_add(&(cursor->parameters), parameter);
+		}
+	}
+
+	for(int32_t i = 0; i < block->analysis->dominator_children.current_index; i++){
+		rename_scalar_replacement_block(context, dynamic_array_get_at(&(block->analysis->dominator_children), i));
+	}
+
+	for(int32_t i = 0; i < context->fields.current_index; i++){
+		((scalar_replacement_field_t*)dynamic_array_get_at(&(context->fields), i))->current_version = saved_versions[i];
+	}
+
+	free(saved_versions);
+}
+
+
+/**
+ * Scalar replacement of aggregates. Local structs, arrays and address-taken variables all live in a stack
+ * region, so every access to them is a trip through memory. If an aggregate's address never escapes, then
+ * none of its fields can be reached any other way than the loads and stores that we can see. Each field can
+ * be pulled out into its own variable, and the loads and stores become plain assignments
+ *
+ * An address escapes when it is used by anything other than a load/store at a known offset, a copy or
+ * a constant offset of itself, or a call to a function that never holds onto that parameter. Which of a
+ * callee's parameters are safe is worked out for the whole program before any function is optimized
+ *
+ * Algorithm:
+ * 	for each local aggregate A:
+ * 		follow A's address through every copy and constant offset
+ * 		if any of them escapes:
+ * 			reject A
+ * 		if two accesses to A overlap without lining up:
+ * 			reject A
+ * 		if keeping A's memory up to date around calls costs more than the accesses that we'd remove:
+ * 			reject A
+ *
+ * 	for each field F of every aggregate that's left:
+ * 		F_0 <- 0 at the top of the function
+ * 		insert phi functions for F at the iterated dominance frontier of the blocks that store to F
+ *
+ * 	rename(function entry), where every load of F becomes x <- current(F) and every store
+ * 	becomes F_n <- y. Every field is stored before a call that is given A's address, and read
+ * 	back in after it if the callee writes to A
+ *
+ * The regions that we emptied out have no references left, so mark and sweep will throw
+ * them out of the stack for us. The SSA versions that we make here are left for SCCP and
+ * value numbering to clean up
+ */
+static void scalar_replace_aggregates(basic_block_t* function_entry_block, dynamic_array_t* function_blocks){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+
+	//Nothing to split up
+	if(function->local_stack.stack_regions.current_index == 0){
+		return;
+	}
+
+	scalar_replacement_context_t context;
+	context.aggregates = dynamic_array_alloc();
+	context.addresses = dynamic_array_alloc();
+	context.fields = dynamic_array_alloc();
+	context.local_stack = &(function->local_stack);
+	context.contains_inline_assembly = FALSE;
+
+	if(find_scalar_replacement_candidates(&context, function_entry_block, function_blocks) == TRUE){
+		create_scalar_replacement_fields(&context, function_entry_block);
+
+		dynamic_array_t worklist = dynamic_array_alloc();
+
+		for(int32_t i = 0; i < context.fields.current_index; i++){
+			insert_scalar_replacement_phi_functions(function, dynamic_array_get_at(&(context.fields), i), &worklist);
+		}
+
+		dynamic_array_dealloc(&worklist);
+		reset_block_marks_for_function(function);
+
+		rename_scalar_replacement_block(&context, function_entry_block);
+	}
+
+	//Clean up everything that we used
+	for(int32_t i = 0; i < context.aggregates.current_index; i++){
+		scalar_replacement_aggregate_t* aggregate = dynamic_array_get_at(&(context.aggregates), i);
+
+		for(int32_t j = 0; j < aggregate->fields.current_index; j++){
+			scalar_replacement_field_t* field = dynamic_array_get_at(&(aggregate->fields), j);
+			dynamic_array_dealloc(&(field->defining_blocks));
+			free(field);
+		}
+
+		dynamic_array_dealloc(&(aggregate->fields));
+		dynamic_array_dealloc(&(aggregate->calls));
+		free(aggregate);
+	}
+
+	for(int32_t i = 0; i < context.addresses.current_index; i++){
+		free(dynamic_array_get_at(&(context.addresses), i));
+	}
+
+	dynamic_array_dealloc(&(context.aggregates));
+	dynamic_array_dealloc(&(context.addresses));
+	dynamic_array_dealloc(&(context.fields));
+}
+
+
+/**
+ * One entry in the LICM variable table. Non-temp variables are keyed without their
+ * SSA generation, because the register allocator gives every version of a variable the same
+ * live range. If any version is assigned in a loop, then every version of it is varying there
+ */
+typedef struct licm_variable_t{
+	//The variable that this entry is for. NULL means the slot is empty
+	three_addr_var_t* variable;
+	//The last instruction seen defining it. This is only meaningful for temps that are defined once
+	instruction_t* definition;
+	//How many times is this defined in the whole function?
+	u_int32_t definition_count;
+	//How many times is this defined in the loop that we're currently looking at?
+	u_int32_t loop_definition_count;
+} licm_variable_t;
+
+
+/**
+ * Everything that LICM needs for one function. This is all local to the
+ * worker that is optimizing the function
+ */
+typedef struct licm_context_t{
+	//The variable table
+	licm_variable_t* variables;
+	//Every block that leaves the current loop
+	dynamic_array_t exiting_blocks;
+	//Every instruction in the current loop that could write to memory
+	dynamic_array_t memory_writers;
+	//The size of the variable table(always a power of 2)
+	u_int32_t variable_table_size;
+} licm_context_t;
+
+
+/**
+ * Hash a variable by the same things that variables_equal_no_ssa compares
+ */
+static inline u_int32_t hash_licm_variable(three_addr_var_t* variable){
+	if(variable->variable_type == VARIABLE_TYPE_TEMP){
+		return variable->temp_var_number * 2654435761U;
+	}
+
+	return ((u_int32_t)((uintptr_t)(variable->linked_var) >> 4) * 2654435761U) ^ variable->variable_type;
+}
+
+
+/**
+ * Grab the entry for a variable. If create is TRUE and there is no entry, a new
+ * one is made. Otherwise NULL is given back when there's no entry
+ */
+static licm_variable_t* get_licm_variable(licm_context_t* context, three_addr_var_t* variable, u_int8_t create){
+	if(variable == NULL){
+		return NULL;
+	}
+
+	//The table size is a power of 2, so we can mask instead of mod
+	u_int32_t mask = context->variable_table_size - 1;
+	u_int32_t index = hash_licm_variable(variable) & mask;
+
+	//Linear probe until we hit the variable or an empty slot
+	while(context->variables[index].variable != NULL){
+		if(variables_equal_no_ssa(context->variables[index].variable, variable) == TRUE){
+			return &(context->variables[index]);
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	//Not here and we're not making it
+	if(create == FALSE){
+		return NULL;
+	}
+
+	context->variables[index].variable = variable;
+
+	return &(context->variables[index]);
+}
+
+
+/**
+ * Add the given amount onto the loop definition counts of everything that the
+ * instruction assigns
+ */
+static inline void adjust_licm_loop_definition_counts(licm_context_t* context, instruction_t* instruction, int32_t amount){
+	licm_variable_t* entry = get_licm_variable(context, instruction->operands.oir.assignee, FALSE);
+	if(entry != NULL){
+		entry->loop_definition_count += amount;
+	}
+
+	//Calls can define an error value as well
+	if((instruction->statement_type == THREE_ADDR_CODE_FUNC_CALL || instruction->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+		&& instruction->optional_storage.error_assignee != NULL){
+		entry = get_licm_variable(context, instruction->optional_storage.error_assignee, FALSE);
+		if(entry != NULL){
+			entry->loop_definition_count += amount;
+		}
+	}
+}
+
+
+/**
+ * Is the given operand the same on every trip through the current loop? If the only thing
+ * stopping it is a constant assignment that nothing else uses, then that constant assignment
+ * is handed back through carried_constant so that it can move along with its user
+ */
+static u_int8_t is_licm_operand_invariant(licm_context_t* context, three_addr_var_t* operand, instruction_t** carried_constant){
+	licm_variable_t* entry = get_licm_variable(context, operand, FALSE);
+
+	//Nothing in the loop defines it
+	if(entry == NULL || entry->loop_definition_count == 0){
+		return TRUE;
+	}
+
+	/**
+	 * Constants are usually left where they are so that the instruction selector can fold
+	 * them into immediates. When the constant only exists to feed this one instruction though,
+	 * it can come with it
+	 */
+	if(operand->variable_type == VARIABLE_TYPE_TEMP
+		&& entry->definition_count == 1
+		&& entry->definition->statement_type == THREE_ADDR_CODE_ASSN_CONST_STMT
+		&& operand->use_count <= 1
+		&& *carried_constant == NULL){
+		*carried_constant = entry->definition;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Get the constant byte offset that a load reads from relative to its base address. If
+ * the offset is not known at compile time, we give back FALSE
+ */
+static u_int8_t get_licm_load_offset(licm_context_t* context, instruction_t* load, int64_t* offset){
+	switch(load->addressing_mode){
+		case ADDRESSING_MODE_BASE_ADDRESS_ONLY:
+			*offset = 0;
+			return TRUE;
+
+		case ADDRESSING_MODE_OFFSET_ONLY:
+			return get_sccp_constant_value(load->operands.oir.address_offset, offset);
+
+		//Only allowed if the index is a constant assignment
+		case ADDRESSING_MODE_REGISTERS_ONLY:
+			{
+				three_addr_var_t* index = load->operands.oir.address_operand2;
+				if(index->variable_type != VARIABLE_TYPE_TEMP){
+					return FALSE;
+				}
+
+				licm_variable_t* entry = get_licm_variable(context, index, FALSE);
+				if(entry == NULL || entry->definition_count != 1 || entry->definition->statement_type != THREE_ADDR_CODE_ASSN_CONST_STMT){
+					return FALSE;
+				}
+
+				return get_sccp_constant_value(entry->definition->operands.oir.constant_operand, offset);
+			}
+
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Could we read the memory for this load before the loop even if the loop would never
+ * have run it? This is true when:
+ * 	1.) It's a rip-relative read of a global, which is always mapped
+ * 	2.) It reads a known offset inside of a stack or global variable's own memory
+ * 	3.) The load runs on every trip through the loop anyways, because its block dominates every
+ * 		block that leaves the loop
+ */
+static u_int8_t is_licm_load_safe_to_speculate(licm_context_t* context, instruction_t* load){
+	if(load->addressing_mode == ADDRESSING_MODE_RIP_RELATIVE){
+		return TRUE;
+	}
+
+	three_addr_var_t* base = load->operands.oir.address_operand1;
+	int64_t offset;
+
+	if(base != NULL
+		&& (base->variable_type == VARIABLE_TYPE_MEMORY_ADDRESS || base->variable_type == VARIABLE_TYPE_STACK_PARAM_MEMORY_ADDRESS)
+		&& get_licm_load_offset(context, load, &offset) == TRUE){
+		int64_t region_size = dealias_type(base->type)->type_size;
+		int64_t read_size = dealias_type(load->type_storage.memory_read_write_type)->type_size;
+
+		if(offset >= 0 && offset + read_size <= region_size){
+			return TRUE;
+		}
+	}
+
+	basic_block_t* load_block = load->block_contained_in;
+
+	for(int32_t i = 0; i < context->exiting_blocks.current_index; i++){
+		if(does_block_dominate(load_block, dynamic_array_get_at(&(context->exiting_blocks), i)) == FALSE){
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Could anything in the current loop write to the memory that a load reads? We ask alias
+ * analysis about every writer in the loop, so stores to other stack objects or globals
+ * no longer keep a load in place
+ */
+static u_int8_t is_licm_load_clobbered_in_loop(licm_context_t* context, instruction_t* load){
+	memory_location_t location;
+
+	//If we can't say where it reads from, any write could change it
+	if(get_memory_location_for_instruction(load, &location) == FALSE){
+		return context->memory_writers.current_index > 0;
+	}
+
+	for(int32_t i = 0; i < context->memory_writers.current_index; i++){
+		if(may_instruction_write_memory_location(dynamic_array_get_at(&(context->memory_writers), i), &location) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Can a call be moved into the preheader of the current loop? The callee needs to be pure and
+ * always return, and every argument needs to be invariant. Unless the callee is const, nothing in
+ * the loop can write to any memory that it could read. Since the callee could still fault on
+ * something that the loop would never have given it, the call also needs to run on every trip
+ */
+static u_int8_t is_licm_call_hoistable(licm_context_t* context, instruction_t* call, instruction_t** carried_constants){
+	symtab_function_record_t* callee = call->called_function;
+
+	if(callee == NULL || callee->is_pure == FALSE || callee->always_returns == FALSE
+		|| call->optional_storage.error_assignee != NULL){
+		return FALSE;
+	}
+
+	//Constant arguments can come along with the call so long as there's room for them
+	for(int32_t i = 0; i < call->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(call->parameters), i);
+
+		if(is_licm_operand_invariant(context, parameter, &(carried_constants[0])) == FALSE
+			&& is_licm_operand_invariant(context, parameter, &(carried_constants[1])) == FALSE){
+			return FALSE;
+		}
+	}
+
+	if(callee->is_const == FALSE){
+		for(int32_t i = 0; i < context->memory_writers.current_index; i++){
+			if(may_instruction_write_call_visible_memory(dynamic_array_get_at(&(context->memory_writers), i)) == TRUE){
+				return FALSE;
+			}
+		}
+	}
+
+	for(int32_t i = 0; i < context->exiting_blocks.current_index; i++){
+		if(does_block_dominate(call->block_contained_in, dynamic_array_get_at(&(context->exiting_blocks), i)) == FALSE){
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Can the given instruction be moved into the preheader of the current loop? It needs
+ * to have no side effects, give back the same value on every trip and be safe to run even
+ * when the loop body would not have run it
+ */
+static u_int8_t is_instruction_licm_hoistable(licm_context_t* context, instruction_t* instruction, instruction_t** carried_constants){
+	int64_t divisor;
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_ASSN_STMT:
+		case THREE_ADDR_CODE_TRUNCATING_ASSN_STMT:
+		case THREE_ADDR_CODE_LEA_STMT:
+		case THREE_ADDR_CODE_NEG_STATEMENT:
+		case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+		case THREE_ADDR_CODE_LOGICAL_NOT_STMT:
+			break;
+
+		//Division by a variable could fault on a trip that never would have happened
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+			if(instruction->op == F_SLASH || instruction->op == MOD){
+				return FALSE;
+			}
+
+			break;
+
+		//Division by a constant is fine so long as it can't fault. -1 is ruled out too because of overflow
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			if(instruction->op == F_SLASH || instruction->op == MOD){
+				if(get_sccp_constant_value(instruction->operands.oir.constant_operand, &divisor) == FALSE || divisor <= 0){
+					return FALSE;
+				}
+			}
+
+			break;
+
+		//Loads can only go if nothing in the loop could change what they read
+		case THREE_ADDR_CODE_LOAD_STATEMENT:
+			if(is_licm_load_clobbered_in_loop(context, instruction) == TRUE){
+				return FALSE;
+			}
+
+			break;
+
+		//Calls have their own rules, which we get to once we know the assignee is good
+		case THREE_ADDR_CODE_FUNC_CALL:
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	three_addr_var_t* assignee = instruction->operands.oir.assignee;
+
+	//Only temps that are defined exactly once can move, and never anything that a branch relies on
+	if(assignee == NULL || assignee->variable_type != VARIABLE_TYPE_TEMP || assignee->sets_cc == TRUE){
+		return FALSE;
+	}
+
+	licm_variable_t* entry = get_licm_variable(context, assignee, FALSE);
+	if(entry == NULL || entry->definition_count != 1){
+		return FALSE;
+	}
+
+	//Every operand needs to be invariant
+	carried_constants[0] = NULL;
+	carried_constants[1] = NULL;
+
+	if(is_licm_operand_invariant(context, instruction->operands.oir.operand1, &(carried_constants[0])) == FALSE
+		|| is_licm_operand_invariant(context, instruction->operands.oir.operand2, &(carried_constants[1])) == FALSE
+		|| is_licm_operand_invariant(context, instruction->operands.oir.address_operand1, &(carried_constants[0])) == FALSE
+		|| is_licm_operand_invariant(context, instruction->operands.oir.address_operand2, &(carried_constants[1])) == FALSE){
+		return FALSE;
+	}
+
+	if(instruction->statement_type == THREE_ADDR_CODE_LOAD_STATEMENT){
+		return is_licm_load_safe_to_speculate(context, instruction);
+	}
+
+	if(instruction->statement_type == THREE_ADDR_CODE_FUNC_CALL){
+		return is_licm_call_hoistable(context, instruction, carried_constants);
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Move an instruction to the end of the preheader, just before the preheader's jump
+ */
+static inline void hoist_instruction_into_preheader(licm_context_t* context, instruction_t* instruction, basic_block_t* preheader){
+	instruction_t* preheader_jump = preheader->exit_statement;
+
+	//Move it to the very end and then put the jump back after it
+	move_statement(instruction, preheader);
+	move_statement(preheader_jump, preheader);
+
+	//It's no longer defined in the loop
+	adjust_licm_loop_definition_counts(context, instruction, -1);
+
+	/**
+	 * The value is now read on every trip through the loop, so the instruction selector
+	 * can never overwrite it in place
+	 */
+	if(instruction->operands.oir.assignee != NULL
+		&& instruction->operands.oir.assignee->variable_type == VARIABLE_TYPE_TEMP){
+		instruction->operands.oir.assignee->was_value_named = TRUE;
+	}
+}
+
+
+/**
+ * Get the preheader for a loop - the one block outside of the loop that leads into the header,
+ * which only goes to the header. If there's no such block we give back NULL
+ */
+static basic_block_t* get_loop_preheader(loop_nest_forest_t* forest, natural_loop_t* loop){
+	basic_block_t* preheader = NULL;
+
+	for(int32_t i = 0; i < loop->header->predecessors.current_index; i++){
+		basic_block_t* predecessor = dynamic_array_get_at(&(loop->header->predecessors), i);
+
+		if(is_block_in_loop(forest, loop, predecessor) == TRUE){
+			continue;
+		}
+
+		//More than one way in
+		if(preheader != NULL){
+			return NULL;
+		}
+
+		preheader = predecessor;
+	}
+
+	if(preheader == NULL || preheader->successors.current_index != 1 || preheader->exit_statement == NULL
+		|| preheader->exit_statement->statement_type != THREE_ADDR_CODE_JUMP_STMT){
+		return NULL;
+	}
+
+	return preheader;
+}
+
+
+/**
+ * Give every loop that doesn't already have one a preheader. The outside predecessors
+ * of the header are all pointed at the new block, which jumps straight into the header. We
+ * don't need to touch any phi functions - the register allocator gives every version of a
+ * variable the same live range, so a value coming in through the preheader is already
+ * where the header expects it to be
+ *
+ * Every block that we make is added to the created_preheaders array
+ */
+static void insert_loop_preheaders(loop_nest_forest_t* forest, symtab_function_record_t* function, dynamic_array_t* created_preheaders){
+	dynamic_array_t outside_predecessors = dynamic_array_alloc();
+
+	for(int32_t i = 0; i < forest->loops.current_index; i++){
+		natural_loop_t* loop = dynamic_array_get_at(&(forest->loops), i);
+
+		//Already has one
+		if(get_loop_preheader(forest, loop) != NULL){
+			continue;
+		}
+
+		clear_dynamic_array(&outside_predecessors);
+		u_int32_t preheader_frequency = 0;
+		u_int8_t can_redirect = TRUE;
+
+		for(int32_t j = 0; j < loop->header->predecessors.current_index; j++){
+			basic_block_t* predecessor = dynamic_array_get_at(&(loop->header->predecessors), j);
+
+			if(is_block_in_loop(forest, loop, predecessor) == TRUE){
+				continue;
+			}
+
+			//We only know how to redirect jumps and branches
+			if(predecessor->exit_statement == NULL || predecessor->jump_table != NULL
+				|| (predecessor->exit_statement->statement_type != THREE_ADDR_CODE_JUMP_STMT
+					&& predecessor->exit_statement->statement_type != THREE_ADDR_CODE_BRANCH_STMT)){
+				can_redirect = FALSE;
+				break;
+			}
+
+			if(predecessor->estimated_execution_frequency > preheader_frequency){
+				preheader_frequency = predecessor->estimated_execution_frequency;
+			}
+
+			dynamic_array_add(&outside_predecessors, predecessor);
+		}
+
+		//The header is the function entry or we can't get in the way
+		if(can_redirect == FALSE || outside_predecessors.current_index == 0){
+			continue;
+		}
+
+		//The created block list is shared by every function
+		pthread_mutex_lock(&created_blocks_mutex);
+		basic_block_t* preheader = basic_block_alloc_in_function(cfg_reference, function, preheader_frequency);
+		pthread_mutex_unlock(&created_blocks_mutex);
+
+		add_statement(preheader, emit_jmp_instruction(loop->header));
+		add_successor(preheader, loop->header);
+
+		for(int32_t j = 0; j < outside_predecessors.current_index; j++){
+			redirect_block_exit(dynamic_array_get_at(&outside_predecessors, j), loop->header, preheader);
+		}
+
+		dynamic_array_add(created_preheaders, preheader);
+	}
+
+	dynamic_array_dealloc(&outside_predecessors);
+}
+
+
+/**
+ * Hoist everything that we can out of one loop and into its preheader. We keep going
+ * over the loop until nothing else moves, because hoisting one instruction can make the
+ * instructions that use it invariant too. An instruction is only ever hoisted once everything
+ * that it relies on is out of the loop, so the preheader always stays in a valid order
+ */
+static void hoist_loop_invariant_instructions(licm_context_t* context, loop_nest_forest_t* forest, natural_loop_t* loop){
+	basic_block_t* preheader = get_loop_preheader(forest, loop);
+	if(preheader == NULL){
+		return;
+	}
+
+	/**
+	 * Count up the definitions inside of the loop and look for anything that could
+	 * write to memory. Stack allocations move the stack pointer under us, so we don't
+	 * touch those loops at all
+	 */
+	clear_dynamic_array(&(context->memory_writers));
+	clear_dynamic_array(&(context->exiting_blocks));
+
+	for(int32_t i = 0; i < loop->blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
+				case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
+					return;
+
+				case THREE_ADDR_CODE_STORE_STATEMENT:
+				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+				case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+				case THREE_ADDR_CODE_FUNC_CALL:
+				case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+					dynamic_array_add(&(context->memory_writers), cursor);
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		for(int32_t j = 0; j < block->successors.current_index; j++){
+			if(is_block_in_loop(forest, loop, dynamic_array_get_at(&(block->successors), j)) == FALSE){
+				dynamic_array_add(&(context->exiting_blocks), block);
+				break;
+			}
+		}
+	}
+
+	for(int32_t i = 0; i < loop->blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			adjust_licm_loop_definition_counts(context, cursor, 1);
+		}
+	}
+
+	u_int8_t changed;
+	instruction_t* carried_constants[2];
+
+	do {
+		changed = FALSE;
+
+		for(int32_t i = 0; i < loop->blocks.current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+
+			instruction_t* cursor = block->leader_statement;
+			while(cursor != NULL){
+				//Save this, the cursor may be about to move
+				instruction_t* next = cursor->next_statement;
+
+				if(is_instruction_licm_hoistable(context, cursor, carried_constants) == TRUE){
+					//Anything that it carries has to go first
+					for(u_int32_t j = 0; j < 2; j++){
+						if(carried_constants[j] == NULL){
+							continue;
+						}
+
+						//Don't leave the next pointer on something that is leaving
+						if(carried_constants[j] == next){
+							next = next->next_statement;
+						}
+
+						hoist_instruction_into_preheader(context, carried_constants[j], preheader);
+					}
+
+					hoist_instruction_into_preheader(context, cursor, preheader);
+					changed = TRUE;
+				}
+
+				cursor = next;
+			}
+		}
+	} while(changed == TRUE);
+
+	//Take back out everything that stayed, so the counts are all at 0 for the next loop
+	for(int32_t i = 0; i < loop->blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			adjust_licm_loop_definition_counts(context, cursor, -1);
+		}
+	}
+}
+
+
+/**
+ * A basic induction variable - a variable with a phi function at the top of the loop header that
+ * is stepped by a constant amount by exactly one instruction inside of the loop
+ */
+typedef struct induction_variable_t{
+	//The phi function at the top of the header
+	instruction_t* phi_function;
+	//The one instruction in the loop that steps it
+	instruction_t* step_instruction;
+	//The version that comes in from outside of the loop
+	three_addr_var_t* initial_version;
+	//The comparison in the header that decides when we leave the loop, if we found one
+	instruction_t* exit_test;
+	//The value that it starts at. Only meaningful if initial_value_known is TRUE
+	int64_t initial_value;
+	//How much it changes by on each step
+	int64_t step;
+	//The constant that the exit test compares against. Only meaningful if bound_known is TRUE
+	int64_t bound;
+	u_int8_t initial_value_known;
+	u_int8_t bound_known;
+	//Is the variable always between 0 and its bound, so that it can never wrap?
+	u_int8_t never_wraps;
+} induction_variable_t;
+
+
+/**
+ * A multiple of a basic induction variable that we're keeping in its own variable. It's stepped
+ * right along with the induction variable, so it always holds induction variable * multiplier
+ */
+typedef struct reduced_induction_variable_t{
+	//The variable's record
+	symtab_variable_record_t* record;
+	//The version that the header's phi function defines
+	three_addr_var_t* phi_version;
+	//The version defined right after the induction variable is stepped
+	three_addr_var_t* stepped_version;
+	//The type that it's held in
+	generic_type_t* type;
+	int64_t multiplier;
+} reduced_induction_variable_t;
+
+
+/**
+ * How many times is the given variable defined inside of the loop? Every SSA version counts. The
+ * last definition that is not a phi function is handed back through definition
+ */
+static u_int32_t count_loop_definitions(natural_loop_t* loop, three_addr_var_t* variable, instruction_t** definition){
+	u_int32_t count = 0;
+	*definition = NULL;
+
+	for(int32_t i = 0; i < loop->blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			u_int8_t defines = variables_equal_no_ssa(cursor->operands.oir.assignee, variable);
+
+			//Calls can define an error value as well
+			if((cursor->statement_type == THREE_ADDR_CODE_FUNC_CALL || cursor->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+				&& variables_equal_no_ssa(cursor->optional_storage.error_assignee, variable) == TRUE){
+				defines = TRUE;
+			}
+
+			if(defines == FALSE){
+				continue;
+			}
+
+			count++;
+
+			if(cursor->statement_type != THREE_ADDR_CODE_PHI_FUNC){
+				*definition = cursor;
+			}
+		}
+	}
+
+	return count;
+}
+
+
+/**
+ * Find the instruction that defines this exact version of a variable, if there is one
+ */
+static instruction_t* find_variable_definition(dynamic_array_t* function_blocks, three_addr_var_t* variable){
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(variables_equal(cursor->operands.oir.assignee, variable) == TRUE){
+				return cursor;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Figure out whether the loop header's branch leaves the loop once the induction variable reaches
+ * some invariant bound, so that it's always true that 0 <= variable < bound + step(or it's still at its
+ * start). For that to be true, the variable must start at a known non-negative value and go up. Every step
+ * in the body happens after the header has checked that the variable is still under its bound. The
+ * step can't happen more than once per check, because the step would need another phi function
+ * inside of the loop to do that
+ */
+static void analyze_induction_variable_exit(natural_loop_t* loop, loop_nest_forest_t* forest, induction_variable_t* variable){
+	basic_block_t* header = loop->header;
+	instruction_t* branch = header->exit_statement;
+	three_addr_var_t* phi_version = variable->phi_function->operands.oir.assignee;
+	instruction_t* unused;
+
+	if(branch == NULL || branch->statement_type != THREE_ADDR_CODE_BRANCH_STMT || branch->relies_on == NULL){
+		return;
+	}
+
+	//The comparison has to happen in the header too
+	instruction_t* comparison = NULL;
+	for(instruction_t* cursor = header->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+		if(variables_equal(cursor->operands.oir.assignee, branch->relies_on) == TRUE){
+			comparison = cursor;
+		}
+	}
+
+	if(comparison == NULL || is_sccp_comparison_operator(comparison->op) == FALSE
+		|| variables_equal(comparison->operands.oir.operand1, phi_version) == FALSE){
+		return;
+	}
+
+	//The bound is either a constant that fits in the variable's type or something that the loop never changes
+	if(comparison->statement_type == THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT){
+		if(get_sccp_constant_value(comparison->operands.oir.constant_operand, &(variable->bound)) == FALSE
+			|| normalize_sccp_value(variable->bound, phi_version->type) != variable->bound){
+			return;
+		}
+
+		variable->bound_known = TRUE;
+
+	} else if(comparison->statement_type == THREE_ADDR_CODE_BIN_OP_STMT){
+		three_addr_var_t* bound = comparison->operands.oir.operand2;
+
+		if(dealias_type(bound->type)->type_size != dealias_type(phi_version->type)->type_size
+			|| count_loop_definitions(loop, bound, &unused) != 0){
+			return;
+		}
+
+	} else {
+		return;
+	}
+
+	variable->exit_test = comparison;
+
+	if(variable->initial_value_known == FALSE || variable->initial_value < 0 || variable->step <= 0){
+		return;
+	}
+
+	/**
+	 * With a step bigger than 1 the variable can go past its bound by up to step - 1 before
+	 * we see it, so the bound needs to be known to make sure that this still fits
+	 */
+	if(variable->step != 1){
+		if(variable->bound_known == FALSE || variable->bound > INT64_MAX - variable->step
+			|| normalize_sccp_value(variable->bound + variable->step - 1, phi_version->type) != variable->bound + variable->step - 1){
+			return;
+		}
+	}
+
+	/**
+	 * We need to leave exactly when variable >= bound. The jump goes to the if block when the
+	 * flags match the branch type, otherwise we fall through to the else block
+	 */
+	u_int8_t if_block_leaves = is_block_in_loop(forest, loop, branch->if_block) == FALSE;
+	u_int8_t else_block_leaves = is_block_in_loop(forest, loop, branch->else_block) == FALSE;
+	u_int8_t is_signed = is_type_signed(phi_version->type);
+
+	if(if_block_leaves == TRUE && else_block_leaves == FALSE){
+		variable->never_wraps = branch->branch_type == (is_signed == TRUE ? BRANCH_GE : BRANCH_AE);
+	} else if(if_block_leaves == FALSE && else_block_leaves == TRUE){
+		variable->never_wraps = branch->branch_type == (is_signed == TRUE ? BRANCH_L : BRANCH_B);
+	}
+}
+
+
+/**
+ * The largest value that an induction variable which never wraps can have. This is only
+ * meaningful when the bound is known
+ */
+static inline int64_t get_induction_variable_largest_value(induction_variable_t* variable){
+	int64_t largest = variable->bound + variable->step - 1;
+
+	return largest > variable->initial_value ? largest : variable->initial_value;
+}
+
+
+/**
+ * Is the given phi function in the loop header for a basic induction variable? If so, everything
+ * that we know about it is filled in
+ */
+static u_int8_t get_basic_induction_variable(loop_nest_forest_t* forest, natural_loop_t* loop, dynamic_array_t* function_blocks, instruction_t* phi_function, induction_variable_t* variable){
+	three_addr_var_t* phi_version = phi_function->operands.oir.assignee;
+	generic_type_t* type = dealias_type(phi_version->type);
+
+	if(phi_version->variable_type != VARIABLE_TYPE_NON_TEMP || is_integer_type(type) == FALSE || type->basic_type_token == BOOL){
+		return FALSE;
+	}
+
+	//The phi function and the step are the only things in the loop that may define it
+	instruction_t* step_instruction;
+	if(count_loop_definitions(loop, phi_version, &step_instruction) != 2 || step_instruction == NULL
+		|| step_instruction->block_contained_in == loop->header){
+		return FALSE;
+	}
+
+	int64_t amount;
+
+	switch(step_instruction->statement_type){
+		case THREE_ADDR_CODE_INC_STMT:
+			variable->step = 1;
+			break;
+
+		case THREE_ADDR_CODE_DEC_STMT:
+			variable->step = -1;
+			break;
+
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			if((step_instruction->op != PLUS && step_instruction->op != MINUS)
+				|| variables_equal_no_ssa(step_instruction->operands.oir.operand1, phi_version) == FALSE
+				|| get_sccp_constant_value(step_instruction->operands.oir.constant_operand, &amount) == FALSE
+				|| amount == 0 || amount > INT32_MAX || amount < -INT32_MAX){
+				return FALSE;
+			}
+
+			variable->step = step_instruction->op == PLUS ? amount : -amount;
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	//Anything that sets flags for a branch has to stay right where it is
+	if(step_instruction->operands.oir.assignee->sets_cc == TRUE){
+		return FALSE;
+	}
+
+	/**
+	 * Everything coming in over a back edge has to be the stepped version, and everything else has
+	 * to be the same version from outside of the loop
+	 */
+	three_addr_var_t* stepped_version = step_instruction->operands.oir.assignee;
+	variable->initial_version = NULL;
+	u_int8_t has_back_edge = FALSE;
+
+	for(int32_t i = 0; i < phi_function->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(phi_function->parameters), i);
+
+		if(variables_equal(parameter, stepped_version) == TRUE){
+			has_back_edge = TRUE;
+		} else if(variables_equal(parameter, phi_version) == TRUE){
+			return FALSE;
+		} else if(variable->initial_version == NULL){
+			variable->initial_version = parameter;
+		} else if(variables_equal(parameter, variable->initial_version) == FALSE){
+			return FALSE;
+		}
+	}
+
+	if(has_back_edge == FALSE || variable->initial_version == NULL){
+		return FALSE;
+	}
+
+	variable->phi_function = phi_function;
+	variable->step_instruction = step_instruction;
+	variable->exit_test = NULL;
+	variable->initial_value_known = FALSE;
+	variable->bound_known = FALSE;
+	variable->never_wraps = FALSE;
+
+	//A constant start is needed to prove that the variable never wraps
+	instruction_t* initial_definition = find_variable_definition(function_blocks, variable->initial_version);
+	if(initial_definition != NULL && initial_definition->statement_type == THREE_ADDR_CODE_ASSN_CONST_STMT
+		&& get_sccp_constant_value(initial_definition->operands.oir.constant_operand, &(variable->initial_value)) == TRUE
+		&& normalize_sccp_value(variable->initial_value, phi_version->type) == variable->initial_value){
+		variable->initial_value_known = TRUE;
+	}
+
+	analyze_induction_variable_exit(loop, forest, variable);
+
+	return TRUE;
+}
+
+
+/**
+ * Can the given multiplication of an induction variable be replaced by a reduced variable? The
+ * multiplier needs to be a constant. Powers of 2 are left alone, because the instruction selector
+ * already folds those into the addressing mode or a shift for free. If the result is wider than the
+ * induction variable, the induction variable has to be known to never wrap, otherwise the product
+ * would not be the same as the running sum
+ */
+static u_int8_t is_induction_variable_multiple_reducible(induction_variable_t* variable, instruction_t* multiplication, int64_t* multiplier){
+	if(multiplication->statement_type != THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT || multiplication->op != STAR){
+		return FALSE;
+	}
+
+	three_addr_var_t* operand = multiplication->operands.oir.operand1;
+	three_addr_var_t* phi_version = variable->phi_function->operands.oir.assignee;
+	three_addr_var_t* stepped_version = variable->step_instruction->operands.oir.assignee;
+
+	if(variables_equal(operand, phi_version) == FALSE && variables_equal(operand, stepped_version) == FALSE){
+		return FALSE;
+	}
+
+	if(get_sccp_constant_value(multiplication->operands.oir.constant_operand, multiplier) == FALSE
+		|| *multiplier <= 1 || (*multiplier & (*multiplier - 1)) == 0
+		|| *multiplier > INT32_MAX / llabs(variable->step)){
+		return FALSE;
+	}
+
+	three_addr_var_t* assignee = multiplication->operands.oir.assignee;
+	generic_type_t* assignee_type = dealias_type(assignee->type);
+
+	if(assignee->variable_type != VARIABLE_TYPE_TEMP || assignee->sets_cc == TRUE
+		|| is_integer_type(assignee_type) == FALSE || assignee_type->basic_type_token == BOOL){
+		return FALSE;
+	}
+
+	u_int32_t variable_size = dealias_type(phi_version->type)->type_size;
+
+	if(assignee_type->type_size < variable_size
+		|| (assignee_type->type_size > variable_size && variable->never_wraps == FALSE)){
+		return FALSE;
+	}
+
+	/**
+	 * The phi version is dead once the step happens, so a use of it after the step would see the
+	 * reduced variable's stepped value instead. The SSA renaming never makes this, but we check anyways
+	 */
+	if(variables_equal(operand, phi_version) == TRUE){
+		basic_block_t* step_block = variable->step_instruction->block_contained_in;
+		basic_block_t* block = multiplication->block_contained_in;
+
+		if(block == step_block){
+			for(instruction_t* cursor = variable->step_instruction; cursor != NULL; cursor = cursor->next_statement){
+				if(cursor == multiplication){
+					return FALSE;
+				}
+			}
+
+		} else if(does_block_dominate(step_block, block) == TRUE){
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Make a new variable that holds induction variable * multiplier. It starts out with the product in the
+ * preheader, gets its own phi function in the header and is bumped by multiplier * step right after
+ * the induction variable is stepped
+ */
+static reduced_induction_variable_t* create_reduced_induction_variable(induction_variable_t* variable, basic_block_t* preheader, generic_type_t* type, three_addr_const_t* multiplier_constant, int64_t multiplier){
+	instruction_t* phi_function = variable->phi_function;
+	instruction_t* step_instruction = variable->step_instruction;
+	symtab_function_record_t* function = ((basic_block_t*)(phi_function->block_contained_in))->function_defined_in;
+
+	reduced_induction_variable_t* reduced = calloc(1, sizeof(reduced_induction_variable_t));
+	reduced->type = type;
+	reduced->multiplier = multiplier;
+
+	//The variable symtab is shared by every function
+	pthread_mutex_lock(&variable_symtab_mutex);
+	reduced->record = create_ssa_compatible_temp_var(function, type, cfg_reference->variable_symtab, increment_and_get_temp_id());
+	pthread_mutex_unlock(&variable_symtab_mutex);
+
+	reduced->record->ssa_counter = 3;
+
+	three_addr_var_t* initial_version = emit_var(reduced->record);
+	initial_version->ssa_generation = 1;
+
+	reduced->phi_version = emit_var(reduced->record);
+	reduced->phi_version->ssa_generation = 2;
+
+	reduced->stepped_version = emit_var(reduced->record);
+	reduced->stepped_version->ssa_generation = 3;
+
+	//Get the starting product in the preheader. If the start is known we can just do it here
+	instruction_t* initialization;
+	if(variable->initial_value_known == TRUE && variable->initial_value * multiplier <= INT32_MAX && variable->initial_value * multiplier >= -INT32_MAX){
+		three_addr_const_t* product = emit_direct_integer_or_char_constant(variable->initial_value * multiplier, type);
+		initialization = emit_assignment_with_const_instruction(initial_version, product, phi_function->line_number);
+
+	} else {
+		three_addr_var_t* initial_operand = emit_var_copy(variable->initial_version);
+		initial_operand->use_count = 1;
+
+		three_addr_const_t* product_constant = emit_direct_integer_or_char_constant(multiplier, dealias_type(multiplier_constant->type));
+		initialization = emit_binary_operation_with_const_instruction(initial_version, initial_operand, STAR, product_constant, phi_function->line_number);
+	}
+
+	insert_instruction_before_given(initialization, preheader->exit_statement);
+	add_assigned_variable_to_block(preheader, initial_version);
+
+	//The phi function takes the same shape as the induction variable's
+	instruction_t* reduced_phi_function = calloc(1, sizeof(instruction_t));
+	reduced_phi_function->statement_type = THREE_ADDR_CODE_PHI_FUNC;
+	reduced_phi_function->operands.oir.assignee = reduced->phi_version;
+	reduced_phi_function->parameters = dynamic_array_alloc();
+	reduced_phi_function->line_number = phi_function->line_number;
+
+	for(int32_t i = 0; i < phi_function->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(phi_function->parameters), i);
+
+		three_addr_var_t* reduced_parameter = emit_var_copy(variables_equal(parameter, variable->initial_version) == TRUE ? initial_version : reduced->stepped_version);
+		reduced_parameter->use_count = 1;
+
+		dynamic_array_add(&(reduced_phi_function->parameters), reduced_parameter);
+	}
+
+	insert_instruction_after_given(reduced_phi_function, phi_function);
+	add_assigned_variable_to_block(phi_function->block_contained_in, reduced->phi_version);
+
+	//Now step it right after the induction variable is stepped
+	int64_t increment = multiplier * variable->step;
+	three_addr_var_t* stepped_operand = emit_var_copy(reduced->phi_version);
+	stepped_operand->use_count = 1;
+
+	instruction_t* step;
+	if(increment > 0){
+		step = emit_binary_operation_with_const_instruction(reduced->stepped_version, stepped_operand, PLUS, emit_direct_integer_or_char_constant(increment, type), step_instruction->line_number);
+	} else {
+		step = emit_binary_operation_with_const_instruction(reduced->stepped_version, stepped_operand, MINUS, emit_direct_integer_or_char_constant(-increment, type), step_instruction->line_number);
+	}
+
+	insert_instruction_after_given(step, step_instruction);
+	add_assigned_variable_to_block(step_instruction->block_contained_in, reduced->stepped_version);
+
+	return reduced;
+}
+
+
+/**
+ * Point the loop's exit test at a reduced variable instead of the induction variable. This is only
+ * done when the bound is a constant and the induction variable never wraps, so that
+ * variable < bound is exactly the same as variable * multiplier < bound * multiplier. Once
+ * this is done, the induction variable is often only used to step itself, and mark & sweep
+ * can take it out entirely
+ */
+static u_int8_t replace_induction_variable_exit_test(induction_variable_t* variable, reduced_induction_variable_t* reduced){
+	if(variable->never_wraps == FALSE || variable->bound_known == FALSE){
+		return FALSE;
+	}
+
+	int64_t largest = get_induction_variable_largest_value(variable);
+
+	//The new bound needs to fit in an immediate, and the product can't wrap
+	if(largest > INT32_MAX / reduced->multiplier){
+		return FALSE;
+	}
+
+	instruction_t* exit_test = variable->exit_test;
+
+	exit_test->operands.oir.operand1->use_count--;
+
+	three_addr_var_t* operand = emit_var_copy(reduced->phi_version);
+	operand->use_count = 1;
+	exit_test->operands.oir.operand1 = operand;
+	exit_test->operands.oir.constant_operand = emit_direct_integer_or_char_constant(variable->bound * reduced->multiplier, reduced->type);
+
+	//The comparison is now done at the reduced variable's width
+	exit_test->type_storage.result_type = reduced->type;
+
+	return TRUE;
+}
+
+
+/**
+ * Strength reduce the induction variables in one loop. Every constant multiple of a basic induction
+ * variable(i * 12, for example) is given its own variable that is bumped by 12 every time that i is
+ * stepped, and the multiplication itself becomes a copy. When the loop's exit test compares the
+ * induction variable against a constant, the test is rewritten to use a reduced variable
+ * instead(linear function test replacement)
+ *
+ * Gives back TRUE if any exit test was replaced
+ */
+static u_int8_t reduce_loop_induction_variables(loop_nest_forest_t* forest, natural_loop_t* loop, dynamic_array_t* function_blocks){
+	basic_block_t* preheader = get_loop_preheader(forest, loop);
+	if(preheader == NULL){
+		return FALSE;
+	}
+
+	u_int8_t replaced_exit_test = FALSE;
+	dynamic_array_t reduced_variables = dynamic_array_alloc();
+	induction_variable_t variable;
+
+	instruction_t* phi_function = loop->header->leader_statement;
+	while(phi_function != NULL && phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+		//Anything that we add goes right after this one, so we need to hang onto this now
+		instruction_t* next = phi_function->next_statement;
+
+		if(get_basic_induction_variable(forest, loop, function_blocks, phi_function, &variable) == FALSE){
+			phi_function = next;
+			continue;
+		}
+
+		for(int32_t i = 0; i < loop->blocks.current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+
+			instruction_t* cursor = block->leader_statement;
+			while(cursor != NULL){
+				//The cursor may be about to be replaced
+				instruction_t* next_statement = cursor->next_statement;
+				int64_t multiplier;
+
+				if(is_induction_variable_multiple_reducible(&variable, cursor, &multiplier) == FALSE){
+					cursor = next_statement;
+					continue;
+				}
+
+				three_addr_var_t* assignee = cursor->operands.oir.assignee;
+				generic_type_t* type = dealias_type(assignee->type);
+
+				//If we already have one that is the same, it gets reused
+				reduced_induction_variable_t* reduced = NULL;
+				for(int32_t j = 0; j < reduced_variables.current_index; j++){
+					reduced_induction_variable_t* candidate = dynamic_array_get_at(&reduced_variables, j);
+
+					if(candidate->multiplier == multiplier && candidate->type == type){
+						reduced = candidate;
+						break;
+					}
+				}
+
+				if(reduced == NULL){
+					reduced = create_reduced_induction_variable(&variable, preheader, type, cursor->operands.oir.constant_operand, multiplier);
+					dynamic_array_add(&reduced_variables, reduced);
+				}
+
+				//Use whichever version lines up with the version of the induction variable that was used
+				three_addr_var_t* replacement = emit_var_copy(variables_equal(cursor->operands.oir.operand1, variable.phi_function->operands.oir.assignee) == TRUE
+																? reduced->phi_version : reduced->stepped_version);
+				replacement->use_count = 1;
+
+				instruction_t* copy = emit_assignment_instruction(assignee, replacement, cursor->line_number);
+				insert_instruction_before_given(copy, cursor);
+				delete_statement(cursor);
+				instruction_dealloc(cursor);
+
+				cursor = next_statement;
+			}
+		}
+
+		//The first reduced variable that we made can take over the exit test
+		if(reduced_variables.current_index > 0
+			&& replace_induction_variable_exit_test(&variable, dynamic_array_get_at(&reduced_variables, 0)) == TRUE){
+			replaced_exit_test = TRUE;
+		}
+
+		for(int32_t i = 0; i < reduced_variables.current_index; i++){
+			free(dynamic_array_get_at(&reduced_variables, i));
+		}
+
+		clear_dynamic_array(&reduced_variables);
+
+		phi_function = next;
+	}
+
+	dynamic_array_dealloc(&reduced_variables);
+
+	return replaced_exit_test;
+}
+
+
+/**
+ * Everything that we need to hang onto while we make copies of a loop body. Every copy gets
+ * its own temps. Non-temp variables that the loop assigns get a new SSA generation for every
+ * assignment in every copy, and we keep track of which version is current as we go
+ */
+typedef struct loop_unrolling_context_t{
+	//Variable object -> replacement object, for the copy that we're making right now
+	dynamic_array_t source_variables;
+	dynamic_array_t replacement_variables;
+	//The temp var numbers that we've already renumbered for this copy
+	temporary_variable_mapping_t* temp_mapping;
+	u_int32_t temp_mapping_current_index;
+	u_int32_t temp_mapping_max_size;
+	//Every instruction in the body, in order, without the jumps
+	dynamic_array_t body;
+	//Every non-temp variable record that the body assigns, and the version of it that is current
+	dynamic_array_t assigned_records;
+	three_addr_var_t** current_versions;
+	u_int32_t current_versions_size;
+} loop_unrolling_context_t;
+
+
+/**
+ * Is the given variable(or version of a variable) assigned anywhere in the loop body?
+ */
+static u_int8_t is_version_assigned_in_loop_body(loop_unrolling_context_t* context, three_addr_var_t* variable){
+	for(int32_t i = 0; i < context->body.current_index; i++){
+		instruction_t* instruction = dynamic_array_get_at(&(context->body), i);
+
+		if(variables_equal(instruction->operands.oir.assignee, variable) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Get the index of a record in the assigned records, or -1 if the body doesn't assign it
+ */
+static int32_t get_unrolled_record_index(loop_unrolling_context_t* context, symtab_variable_record_t* record){
+	for(int32_t i = 0; i < context->assigned_records.current_index; i++){
+		if(dynamic_array_get_at(&(context->assigned_records), i) == record){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+/**
+ * Get the new temp var number that a temp has in the copy that we're making
+ */
+static u_int32_t get_unrolled_temp_var_number(loop_unrolling_context_t* context, three_addr_var_t* variable){
+	for(u_int32_t i = 0; i < context->temp_mapping_current_index; i++){
+		if(context->temp_mapping[i].source_temp_var_id == variable->temp_var_number){
+			return context->temp_mapping[i].replacement_var->temp_var_number;
+		}
+	}
+
+	//Dynamically reup this if we need to
+	if(context->temp_mapping_current_index == context->temp_mapping_max_size){
+		context->temp_mapping_max_size *= 2;
+		context->temp_mapping = realloc(context->temp_mapping, sizeof(temporary_variable_mapping_t) * context->temp_mapping_max_size);
+	}
+
+	three_addr_var_t* replacement_var = emit_var_copy(variable);
+	replacement_var->temp_var_number = increment_and_get_temp_id();
+
+	context->temp_mapping[context->temp_mapping_current_index].source_temp_var_id = variable->temp_var_number;
+	context->temp_mapping[context->temp_mapping_current_index].replacement_var = replacement_var;
+	context->temp_mapping_current_index++;
+
+	return replacement_var->temp_var_number;
+}
+
+
+/**
+ * Give a variable a brand new SSA generation and make it the current version
+ */
+static three_addr_var_t* emit_next_unrolled_version(loop_unrolling_context_t* context, three_addr_var_t* variable, int32_t record_index){
+	three_addr_var_t* version = emit_var_copy(variable);
+
+	(version->linked_var->ssa_counter)++;
+	version->ssa_generation = version->linked_var->ssa_counter;
+
+	context->current_versions[record_index] = version;
+
+	return version;
+}
+
+
+/**
+ * Clone a variable that one of the copies uses. Anything that the body doesn't assign is the same in
+ * every copy, so temps like that are shared with the original and just get another use
+ */
+static three_addr_var_t* clone_used_variable_for_unrolling(loop_unrolling_context_t* context, three_addr_var_t* variable){
+	//Nothing to clone
+	if(variable == NULL){
+		return NULL;
+	}
+
+	//These are unique objects that everything compares against by pointer, so they are never copied
+	if(variable == stack_pointer_variable || variable == instruction_pointer_variable){
+		return variable;
+	}
+
+	//If we've already cloned this exact object for this copy, then we'll give back the same copy
+	for(int32_t i = 0; i < context->source_variables.current_index; i++){
+		if(context->source_variables.internal_array[i] == variable){
+			return context->replacement_variables.internal_array[i];
+		}
+	}
+
+	three_addr_var_t* copy;
+	int32_t record_index;
+
+	switch(variable->variable_type){
+		case VARIABLE_TYPE_TEMP:
+			/**
+			 * This now has more than one use, so just like with value numbering the
+			 * instruction selector can't go overwriting it in place
+			 */
+			if(is_version_assigned_in_loop_body(context, variable) == FALSE){
+				variable->use_count++;
+				variable->was_value_named = TRUE;
+				return variable;
+			}
+
+			copy = emit_var_copy(variable);
+			copy->temp_var_number = get_unrolled_temp_var_number(context, variable);
+			break;
+
+		//Anything that the body assigns picks up whatever version is current
+		case VARIABLE_TYPE_NON_TEMP:
+			copy = emit_var_copy(variable);
+			record_index = get_unrolled_record_index(context, variable->linked_var);
+
+			if(record_index != -1 && context->current_versions[record_index] != NULL){
+				copy->ssa_generation = context->current_versions[record_index]->ssa_generation;
+			}
+
+			break;
+
+		default:
+			copy = emit_var_copy(variable);
+			break;
+	}
+
+	dynamic_array_add(&(context->source_variables), variable);
+	dynamic_array_add(&(context->replacement_variables), copy);
+
+	return copy;
+}
+
+
+/**
+ * Clone a variable that one of the copies assigns
+ */
+static three_addr_var_t* clone_assigned_variable_for_unrolling(loop_unrolling_context_t* context, three_addr_var_t* variable){
+	if(variable == NULL){
+		return NULL;
+	}
+
+	//Non-temps get a new generation on every assignment
+	if(variable->variable_type == VARIABLE_TYPE_NON_TEMP){
+		return emit_next_unrolled_version(context, variable, get_unrolled_record_index(context, variable->linked_var));
+	}
+
+	return clone_used_variable_for_unrolling(context, variable);
+}
+
+
+/**
+ * Make one copy of the whole loop body at the end of the given block
+ */
+static void append_unrolled_loop_body(loop_unrolling_context_t* context, basic_block_t* block){
+	//Every copy gets its own temps
+	clear_dynamic_array(&(context->source_variables));
+	clear_dynamic_array(&(context->replacement_variables));
+	context->temp_mapping_current_index = 0;
+
+	for(int32_t i = 0; i < context->body.current_index; i++){
+		instruction_t* cloned = dynamic_array_get_at(&(context->body), i);
+
+		instruction_t* copy = calloc(1, sizeof(instruction_t));
+		memcpy(copy, cloned, sizeof(instruction_t));
+
+		//The uses go first so that they see the versions from before this instruction
+		copy->operands.oir.operand1 = clone_used_variable_for_unrolling(context, cloned->operands.oir.operand1);
+		copy->operands.oir.operand2 = clone_used_variable_for_unrolling(context, cloned->operands.oir.operand2);
+		copy->operands.oir.address_operand1 = clone_used_variable_for_unrolling(context, cloned->operands.oir.address_operand1);
+		copy->operands.oir.address_operand2 = clone_used_variable_for_unrolling(context, cloned->operands.oir.address_operand2);
+		copy->operands.oir.rip_offset_var = clone_used_variable_for_unrolling(context, cloned->operands.oir.rip_offset_var);
+		copy->operands.oir.constant_operand = clone_constant(cloned->operands.oir.constant_operand);
+		copy->operands.oir.address_offset = clone_constant(cloned->operands.oir.address_offset);
+
+		//Function call parameters
+		if(cloned->parameters.internal_array != NULL){
+			copy->parameters = dynamic_array_alloc();
+
+			for(int32_t j = 0; j < cloned->parameters.current_index; j++){
+				dynamic_array_add(&(copy->parameters), clone_used_variable_for_unrolling(context, dynamic_array_get_at(&(cloned->parameters), j)));
+			}
+		}
+
+		copy->operands.oir.assignee = clone_assigned_variable_for_unrolling(context, cloned->operands.oir.assignee);
+
+		//Calls can define an error value as well
+		if((cloned->statement_type == THREE_ADDR_CODE_FUNC_CALL || cloned->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+			&& cloned->optional_storage.error_assignee != NULL){
+			copy->optional_storage.error_assignee = clone_assigned_variable_for_unrolling(context, cloned->optional_storage.error_assignee);
+		}
+
+		//One more reference to any local constant. Constants are shared between functions, so this must be atomic
+		three_addr_var_t* local_constant_var = copy->operands.oir.rip_offset_var;
+		if(local_constant_var != NULL && local_constant_var->variable_type == VARIABLE_TYPE_LOCAL_CONSTANT){
+			__atomic_add_fetch(&(local_constant_var->associated_memory_region.local_constant->reference_count), 1, __ATOMIC_RELAXED);
+		}
+
+		//IMPORTANT: null out the next/previous for the instruction
+		copy->next_statement = NULL;
+		copy->previous_statement = NULL;
+		copy->block_contained_in = NULL;
+		copy->mark = FALSE;
+
+		add_statement(block, copy);
+
+		if(copy->operands.oir.assignee != NULL && copy->operands.oir.assignee->variable_type == VARIABLE_TYPE_NON_TEMP){
+			add_assigned_variable_to_block(block, copy->operands.oir.assignee);
+		}
+	}
+}
+
+
+/**
+ * Swap every use of one version of a variable in an instruction for another version
+ */
+static void replace_variable_version_uses(instruction_t* instruction, three_addr_var_t* old_version, three_addr_var_t* new_version){
+	three_addr_var_t** slots[] = {&(instruction->operands.oir.operand1), &(instruction->operands.oir.operand2),
+								  &(instruction->operands.oir.address_operand1), &(instruction->operands.oir.address_operand2)};
+
+	for(u_int32_t i = 0; i < sizeof(slots) / sizeof(slots[0]); i++){
+		if(variables_equal(*(slots[i]), old_version) == TRUE){
+			three_addr_var_t* replacement = emit_var_copy(new_version);
+			replacement->use_count = (*(slots[i]))->use_count;
+			*(slots[i]) = replacement;
+		}
+	}
+
+	for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(instruction->parameters), i);
+
+		if(variables_equal(parameter, old_version) == TRUE){
+			three_addr_var_t* replacement = emit_var_copy(new_version);
+			replacement->use_count = parameter->use_count;
+			dynamic_array_set_at(&(instruction->parameters), replacement, i);
+		}
+	}
+}
+
+
+/**
+ * Does the given instruction use a value that only exists inside of the loop body? The only
+ * values from the loop that anything outside of it may see are the header's phi functions
+ */
+static u_int8_t does_instruction_use_loop_body_value(loop_unrolling_context_t* context, instruction_t* instruction){
+	three_addr_var_t* used[] = {instruction->operands.oir.operand1, instruction->operands.oir.operand2,
+								instruction->operands.oir.address_operand1, instruction->operands.oir.address_operand2,
+								instruction->relies_on};
+
+	for(u_int32_t i = 0; i < sizeof(used) / sizeof(used[0]); i++){
+		if(used[i] != NULL && is_version_assigned_in_loop_body(context, used[i]) == TRUE){
+			return TRUE;
+		}
+	}
+
+	for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+		if(is_version_assigned_in_loop_body(context, dynamic_array_get_at(&(instruction->parameters), i)) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Can this loop be unrolled? We only take on the simplest shape, which is what counted loops
+ * almost always look like once everything else has run:
+ * 	1.) The header has nothing but phi functions and the exit test. Its branch either leaves or goes into the body
+ * 	2.) The body is a straight chain of blocks that ends by jumping back to the header
+ * 	3.) Nothing outside of the loop sees a value from the body other than through the header's phi functions
+ * If it can be, the body's instructions and the variables that it assigns are loaded into the context
+ */
+static u_int8_t can_loop_be_unrolled(loop_unrolling_context_t* context, loop_nest_forest_t* forest, natural_loop_t* loop, dynamic_array_t* function_blocks){
+	basic_block_t* header = loop->header;
+	instruction_t* branch = header->exit_statement;
+
+	//Only the innermost loops are unrolled
+	for(int32_t i = 0; i < forest->loops.current_index; i++){
+		if(((natural_loop_t*)dynamic_array_get_at(&(forest->loops), i))->parent == loop){
+			return FALSE;
+		}
+	}
+
+	if(branch == NULL || branch->statement_type != THREE_ADDR_CODE_BRANCH_STMT || header->jump_table != NULL){
+		return FALSE;
+	}
+
+	//Phi functions, then the comparison, then the branch
+	instruction_t* cursor = header->leader_statement;
+	while(cursor != NULL && cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+		cursor = cursor->next_statement;
+	}
+
+	if(cursor == NULL || cursor->next_statement != branch || variables_equal(cursor->operands.oir.assignee, branch->relies_on) == FALSE){
+		return FALSE;
+	}
+
+	//Walk the body
+	basic_block_t* body_block = is_block_in_loop(forest, loop, branch->if_block) == TRUE ? branch->if_block : branch->else_block;
+	if(body_block == header || is_block_in_loop(forest, loop, branch->if_block) == is_block_in_loop(forest, loop, branch->else_block)){
+		return FALSE;
+	}
+
+	int32_t chain_length = 0;
+	clear_dynamic_array(&(context->body));
+	clear_dynamic_array(&(context->assigned_records));
+
+	while(body_block != header){
+		if(is_block_in_loop(forest, loop, body_block) == FALSE || body_block->predecessors.current_index != 1
+			|| body_block->successors.current_index != 1 || body_block->jump_table != NULL
+			|| body_block->exit_statement == NULL || body_block->exit_statement->statement_type != THREE_ADDR_CODE_JUMP_STMT){
+			return FALSE;
+		}
+
+		for(cursor = body_block->leader_statement; cursor != body_block->exit_statement; cursor = cursor->next_statement){
+			three_addr_var_t* assignee = cursor->operands.oir.assignee;
+
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_PHI_FUNC:
+				case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
+				case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
+				case THREE_ADDR_CODE_INDIRECT_JUMP_STMT:
+				case THREE_ADDR_CODE_ASM_INLINE_STMT:
+					return FALSE;
+				default:
+					break;
+			}
+
+			//Errorable calls are left alone
+			if((cursor->statement_type == THREE_ADDR_CODE_FUNC_CALL || cursor->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+				&& cursor->optional_storage.error_assignee != NULL){
+				return FALSE;
+			}
+
+			if(assignee != NULL && assignee->variable_type != VARIABLE_TYPE_TEMP){
+				//Only plain local variables can be given new generations
+				if(assignee->variable_type != VARIABLE_TYPE_NON_TEMP || assignee->linked_var == NULL
+					|| assignee->linked_var->membership == GLOBAL_VARIABLE || assignee->linked_var->membership == STATIC_VARIABLE){
+					return FALSE;
+				}
+
+				if(get_unrolled_record_index(context, assignee->linked_var) == -1){
+					dynamic_array_add(&(context->assigned_records), assignee->linked_var);
+				}
+			}
+
+			dynamic_array_add(&(context->body), cursor);
+		}
+
+		chain_length++;
+		body_block = dynamic_array_get_at(&(body_block->successors), 0);
+	}
+
+	//Anything else in the loop is control flow that we don't handle
+	if(chain_length + 1 != loop->blocks.current_index){
+		return FALSE;
+	}
+
+	/**
+	 * Every phi function in the header needs to be for something that the body assigns, with
+	 * one version coming in from the preheader and one coming around from the body
+	 */
+	for(cursor = header->leader_statement; cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC; cursor = cursor->next_statement){
+		three_addr_var_t* assignee = cursor->operands.oir.assignee;
+
+		if(assignee->variable_type != VARIABLE_TYPE_NON_TEMP || get_unrolled_record_index(context, assignee->linked_var) == -1
+			|| cursor->parameters.current_index != 2){
+			return FALSE;
+		}
+
+		u_int8_t first_from_body = is_version_assigned_in_loop_body(context, dynamic_array_get_at(&(cursor->parameters), 0));
+		u_int8_t second_from_body = is_version_assigned_in_loop_body(context, dynamic_array_get_at(&(cursor->parameters), 1));
+
+		if(first_from_body == second_from_body){
+			return FALSE;
+		}
+	}
+
+	//The header itself can't be letting a body temp out either
+	if(does_instruction_use_loop_body_value(context, header->exit_statement->previous_statement) == TRUE){
+		return FALSE;
+	}
+
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		if(is_block_in_loop(forest, loop, block) == TRUE){
+			continue;
+		}
+
+		for(cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(does_instruction_use_loop_body_value(context, cursor) == TRUE){
+				return FALSE;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Point the current versions at what comes into the loop from the preheader. If a header phi version
+ * is given for each record instead, those are used
+ */
+static void seed_unrolled_versions(loop_unrolling_context_t* context, basic_block_t* header, dynamic_array_t* phi_versions){
+	//Dynamically reup this if we need to
+	if((int32_t)context->current_versions_size < context->assigned_records.current_index){
+		context->current_versions_size = context->assigned_records.current_index;
+		context->current_versions = realloc(context->current_versions, sizeof(three_addr_var_t*) * context->current_versions_size);
+	}
+
+	memset(context->current_versions, 0, sizeof(three_addr_var_t*) * context->current_versions_size);
+
+	int32_t phi_index = 0;
+
+	for(instruction_t* phi_function = header->leader_statement; phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC; phi_function = phi_function->next_statement){
+		int32_t record_index = get_unrolled_record_index(context, phi_function->operands.oir.assignee->linked_var);
+
+		if(phi_versions != NULL){
+			context->current_versions[record_index] = dynamic_array_get_at(phi_versions, phi_index);
+			phi_index++;
+			continue;
+		}
+
+		//Whatever isn't assigned in the body came in from outside
+		for(int32_t i = 0; i < phi_function->parameters.current_index; i++){
+			three_addr_var_t* parameter = dynamic_array_get_at(&(phi_function->parameters), i);
+
+			if(is_version_assigned_in_loop_body(context, parameter) == FALSE){
+				context->current_versions[record_index] = parameter;
+				break;
+			}
+		}
+	}
+}
+
+
+/**
+ * Unroll a loop with a tiny constant trip count all the way. The preheader jumps to one block with
+ * every copy of the body in it, which then goes straight to wherever the loop used to exit to. Anything
+ * after the loop that used a header phi function now uses the last version from the copies instead
+ */
+static void fully_unroll_loop(loop_unrolling_context_t* context, loop_nest_forest_t* forest, natural_loop_t* loop, basic_block_t* preheader, dynamic_array_t* function_blocks, u_int32_t trip_count){
+	basic_block_t* header = loop->header;
+	instruction_t* branch = header->exit_statement;
+	basic_block_t* exit_block = is_block_in_loop(forest, loop, branch->if_block) == TRUE ? branch->else_block : branch->if_block;
+	symtab_function_record_t* function = header->function_defined_in;
+
+	//This only ever runs once for every time that the preheader does
+	pthread_mutex_lock(&created_blocks_mutex);
+	basic_block_t* unrolled = basic_block_alloc_in_function(cfg_reference, function, preheader->estimated_execution_frequency);
+	pthread_mutex_unlock(&created_blocks_mutex);
+
+	seed_unrolled_versions(context, header, NULL);
+
+	for(u_int32_t i = 0; i < trip_count; i++){
+		append_unrolled_loop_body(context, unrolled);
+	}
+
+	emit_jump(unrolled, exit_block);
+	redirect_block_exit(preheader, header, unrolled);
+
+	//Everything after the loop now sees the last versions
+	for(instruction_t* phi_function = header->leader_statement; phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC; phi_function = phi_function->next_statement){
+		three_addr_var_t* phi_version = phi_function->operands.oir.assignee;
+		three_addr_var_t* last_version = context->current_versions[get_unrolled_record_index(context, phi_version->linked_var)];
+
+		for(int32_t i = 0; i < function_blocks->current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+			if(block == unrolled || is_block_in_loop(forest, loop, block) == TRUE){
+				continue;
+			}
+
+			for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+				replace_variable_version_uses(cursor, phi_version, last_version);
+			}
+		}
+	}
+}
+
+
+/**
+ * Unroll a loop by the given factor. An unrolled copy of the loop goes in front of the original, which
+ * stays around to run whatever is left over:
+ *
+ * 	preheader -> unrolled header: are there at least factor trips left? If not go to the original header
+ * 				 unrolled body: factor copies of the body, then jump back to the unrolled header
+ * 	original header -> original body: runs the remaining trips, and is the only way out of the loop
+ *
+ * The original header's phi functions take the unrolled header's versions instead of the preheader's, and
+ * the unrolled header gets its own phi functions. Since the original loop is still the only way out, nothing
+ * after the loop needs to change
+ */
+static void partially_unroll_loop(loop_unrolling_context_t* context, natural_loop_t* loop, basic_block_t* preheader, induction_variable_t* variable, u_int32_t factor){
+	basic_block_t* header = loop->header;
+	symtab_function_record_t* function = header->function_defined_in;
+	instruction_t* exit_test = variable->exit_test;
+	three_addr_var_t* induction_variable = variable->phi_function->operands.oir.assignee;
+	generic_type_t* type = dealias_type(induction_variable->type);
+	u_int8_t is_signed = is_type_signed(type);
+
+	//The unrolled loop goes around 1/factor as often. The original now only runs the leftover trips
+	u_int32_t loop_frequency = header->estimated_execution_frequency / factor;
+	if(loop_frequency < preheader->estimated_execution_frequency){
+		loop_frequency = preheader->estimated_execution_frequency;
+	}
+
+	//The created block list is shared by every function
+	pthread_mutex_lock(&created_blocks_mutex);
+	basic_block_t* unrolled_header = basic_block_alloc_in_function(cfg_reference, function, loop_frequency);
+	basic_block_t* unrolled_body = basic_block_alloc_in_function(cfg_reference, function, loop_frequency);
+	basic_block_t* trip_check = NULL;
+	if(variable->bound_known == FALSE){
+		trip_check = basic_block_alloc_in_function(cfg_reference, function, loop_frequency);
+	}
+	pthread_mutex_unlock(&created_blocks_mutex);
+
+	for(int32_t i = 0; i < loop->blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(loop->blocks), i);
+		block->estimated_execution_frequency = loop_frequency;
+	}
+
+	seed_unrolled_versions(context, header, NULL);
+
+	/**
+	 * Every header phi function gets a partner in the unrolled header. The versions coming in from
+	 * the preheader go there now, and the original header gets the unrolled header's version instead
+	 */
+	dynamic_array_t unrolled_phi_functions = dynamic_array_alloc();
+	dynamic_array_t unrolled_phi_versions = dynamic_array_alloc();
+
+	for(instruction_t* phi_function = header->leader_statement; phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC; phi_function = phi_function->next_statement){
+		three_addr_var_t* phi_version = phi_function->operands.oir.assignee;
+		int32_t record_index = get_unrolled_record_index(context, phi_version->linked_var);
+		three_addr_var_t* initial_version = context->current_versions[record_index];
+
+		three_addr_var_t* unrolled_version = emit_next_unrolled_version(context, phi_version, record_index);
+
+		instruction_t* unrolled_phi_function = calloc(1, sizeof(instruction_t));
+		unrolled_phi_function->statement_type = THREE_ADDR_CODE_PHI_FUNC;
+		unrolled_phi_function->operands.oir.assignee = unrolled_version;
+		unrolled_phi_function->parameters = dynamic_array_alloc();
+		unrolled_phi_function->line_number = phi_function->line_number;
+
+		three_addr_var_t* initial_parameter = emit_var_copy(initial_version);
+		initial_parameter->use_count = 1;
+		dynamic_array_add(&(unrolled_phi_function->parameters), initial_parameter);
+
+		add_statement(unrolled_header, unrolled_phi_function);
+		add_assigned_variable_to_block(unrolled_header, unrolled_version);
+
+		dynamic_array_add(&unrolled_phi_functions, unrolled_phi_function);
+		dynamic_array_add(&unrolled_phi_versions, unrolled_version);
+
+		replace_variable_version_uses(phi_function, initial_version, unrolled_version);
+	}
+
+	//The induction variable as the unrolled header sees it
+	three_addr_var_t* unrolled_induction_variable = context->current_versions[get_unrolled_record_index(context, induction_variable->linked_var)];
+
+	three_addr_var_t* tested = emit_var_copy(unrolled_induction_variable);
+	tested->use_count = 1;
+
+	three_addr_var_t* decider = emit_temp_var(exit_test->operands.oir.assignee->type);
+	decider->sets_cc = TRUE;
+	instruction_t* comparison;
+
+	/**
+	 * With a known bound, there are at least factor trips left exactly when
+	 * variable < bound - step * (factor - 1)
+	 */
+	if(variable->bound_known == TRUE){
+		int64_t limit = variable->bound - variable->step * (factor - 1);
+		comparison = emit_binary_operation_with_const_instruction(decider, tested, L_THAN, emit_direct_integer_or_char_constant(limit, type), exit_test->line_number);
+		comparison->type_storage.result_type = type;
+		add_statement(unrolled_header, comparison);
+
+		add_statement(unrolled_header, emit_branch_statement(header, unrolled_body, decider, is_signed == TRUE ? BRANCH_GE : BRANCH_AE, exit_test->line_number));
+		add_successor(unrolled_header, header);
+		add_successor(unrolled_header, unrolled_body);
+
+	/**
+	 * Otherwise, we first check that we're under the bound at all. Once we know that, bound - variable
+	 * can't overflow(the variable is never negative), so we can see if there's enough room left
+	 */
+	} else {
+		three_addr_var_t* bound = clone_used_variable_for_unrolling(context, exit_test->operands.oir.operand2);
+
+		comparison = emit_binary_operation_instruction(decider, tested, L_THAN, bound, exit_test->line_number);
+		comparison->type_storage.result_type = type;
+		add_statement(unrolled_header, comparison);
+
+		add_statement(unrolled_header, emit_branch_statement(header, trip_check, decider, is_signed == TRUE ? BRANCH_GE : BRANCH_AE, exit_test->line_number));
+		add_successor(unrolled_header, header);
+		add_successor(unrolled_header, trip_check);
+
+		three_addr_var_t* remaining = emit_temp_var(induction_variable->type);
+		three_addr_var_t* subtracted = emit_var_copy(unrolled_induction_variable);
+		subtracted->use_count = 1;
+		add_statement(trip_check, emit_binary_operation_instruction(remaining, clone_used_variable_for_unrolling(context, exit_test->operands.oir.operand2), MINUS, subtracted, exit_test->line_number));
+		remaining->use_count = 1;
+
+		three_addr_var_t* remaining_decider = emit_temp_var(exit_test->operands.oir.assignee->type);
+		remaining_decider->sets_cc = TRUE;
+		instruction_t* remaining_comparison = emit_binary_operation_with_const_instruction(remaining_decider, remaining, L_THAN, emit_direct_integer_or_char_constant(factor, type), exit_test->line_number);
+		remaining_comparison->type_storage.result_type = type;
+		add_statement(trip_check, remaining_comparison);
+
+		add_statement(trip_check, emit_branch_statement(header, unrolled_body, remaining_decider, is_signed == TRUE ? BRANCH_L : BRANCH_B, exit_test->line_number));
+		add_successor(trip_check, header);
+		add_successor(trip_check, unrolled_body);
+	}
+
+	//Now make all of the copies
+	seed_unrolled_versions(context, header, &unrolled_phi_versions);
+
+	for(u_int32_t i = 0; i < factor; i++){
+		append_unrolled_loop_body(context, unrolled_body);
+	}
+
+	emit_jump(unrolled_body, unrolled_header);
+
+	//The unrolled header's phi functions get whatever the copies ended up with
+	for(int32_t i = 0; i < unrolled_phi_functions.current_index; i++){
+		instruction_t* unrolled_phi_function = dynamic_array_get_at(&unrolled_phi_functions, i);
+		int32_t record_index = get_unrolled_record_index(context, unrolled_phi_function->operands.oir.assignee->linked_var);
+
+		three_addr_var_t* last_parameter = emit_var_copy(context->current_versions[record_index]);
+		last_parameter->use_count = 1;
+		dynamic_array_add(&(unrolled_phi_function->parameters), last_parameter);
+	}
+
+	redirect_block_exit(preheader, header, unrolled_header);
+
+	dynamic_array_dealloc(&unrolled_phi_functions);
+	dynamic_array_dealloc(&unrolled_phi_versions);
+}
+
+
+/**
+ * Unroll one loop if it has a trip count that we can work out, either at compile time or when
+ * the loop is entered. Loops with a tiny constant trip count are unrolled all the way, everything
+ * else is unrolled by up to loop_unroll_factor with the original loop left to handle any
+ * remainder. Gives back TRUE if the loop was unrolled
+ */
+static u_int8_t unroll_loop(loop_unrolling_context_t* context, loop_nest_forest_t* forest, natural_loop_t* loop, dynamic_array_t* function_blocks){
+	//The profile(--profile-use) says that this loop never ran, so unrolling it would only grow the code
+	if(loop->header->estimated_execution_frequency == 0){
+		return FALSE;
+	}
+
+	basic_block_t* preheader = get_loop_preheader(forest, loop);
+	if(preheader == NULL || can_loop_be_unrolled(context, forest, loop, function_blocks) == FALSE){
+		return FALSE;
+	}
+
+	//We need an induction variable that decides how many trips there are
+	induction_variable_t variable;
+	u_int8_t found = FALSE;
+
+	for(instruction_t* phi_function = loop->header->leader_statement; phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC; phi_function = phi_function->next_statement){
+		if(get_basic_induction_variable(forest, loop, function_blocks, phi_function, &variable) == TRUE
+			&& variable.never_wraps == TRUE
+			&& variable.exit_test == loop->header->exit_statement->previous_statement){
+			found = TRUE;
+			break;
+		}
+	}
+
+	if(found == FALSE){
+		return FALSE;
+	}
+
+	u_int32_t body_size = context->body.current_index;
+	if(body_size == 0){
+		return FALSE;
+	}
+
+	//Small enough to do all the way?
+	if(variable.bound_known == TRUE){
+		int64_t trip_count = 0;
+		if(variable.initial_value < variable.bound){
+			trip_count = (variable.bound - variable.initial_value + variable.step - 1) / variable.step;
+		}
+
+		if(trip_count > 0 && trip_count <= LOOP_FULL_UNROLL_MAX_TRIP_COUNT && trip_count * body_size <= LOOP_UNROLL_MAX_INSTRUCTIONS){
+			fully_unroll_loop(context, forest, loop, preheader, function_blocks, trip_count);
+			return TRUE;
+		}
+	}
+
+	//Otherwise go as far as the size limit lets us
+	u_int32_t factor = loop_unroll_factor;
+	if(factor * body_size > LOOP_UNROLL_MAX_INSTRUCTIONS){
+		factor = LOOP_UNROLL_MAX_INSTRUCTIONS / body_size;
+	}
+
+	if(factor < 2){
+		return FALSE;
+	}
+
+	//If the unrolled loop would never even run once, there's no point
+	if(variable.bound_known == TRUE && variable.bound - variable.step * (factor - 1) <= variable.initial_value){
+		return FALSE;
+	}
+
+	partially_unroll_loop(context, loop, preheader, &variable, factor);
+
+	return TRUE;
+}
+
+
+/**
+ * Unroll every innermost loop that we can. Gives back TRUE if anything was unrolled, in which case the
+ * caller needs to clean up unreachable blocks and recompute the control flow relations
+ */
+static u_int8_t unroll_loops(loop_nest_forest_t* forest, dynamic_array_t* function_blocks){
+	//Unrolling is turned off
+	if(loop_unroll_factor < 2){
+		return FALSE;
+	}
+
+	loop_unrolling_context_t context;
+	context.source_variables = dynamic_array_alloc();
+	context.replacement_variables = dynamic_array_alloc();
+	context.body = dynamic_array_alloc();
+	context.assigned_records = dynamic_array_alloc();
+	context.current_versions = NULL;
+	context.current_versions_size = 0;
+	context.temp_mapping_max_size = 32;
+	context.temp_mapping_current_index = 0;
+	context.temp_mapping = calloc(context.temp_mapping_max_size, sizeof(temporary_variable_mapping_t));
+
+	u_int8_t unrolled = FALSE;
+
+	for(int32_t i = forest->loops.current_index - 1; i >= 0; i--){
+		if(unroll_loop(&context, forest, dynamic_array_get_at(&(forest->loops), i), function_blocks) == TRUE){
+			unrolled = TRUE;
+		}
+	}
+
+	dynamic_array_dealloc(&(context.source_variables));
+	dynamic_array_dealloc(&(context.replacement_variables));
+	dynamic_array_dealloc(&(context.body));
+	dynamic_array_dealloc(&(context.assigned_records));
+	free(context.current_versions);
+	free(context.temp_mapping);
+
+	return unrolled;
+}
+
+
+/**
+ * Loop optimizations. We find every natural loop in the function and give each one a preheader. Then:
+ * 	1.) Loop invariant code motion moves everything that computes the same value on every trip out into the
+ * 		preheader. Inner loops go first, so something that is invariant across a whole loop nest works its
+ * 		way out one level at a time. Only temps that are defined once are moved, and only when the instruction
+ * 		has no side effects. Loads are allowed when alias analysis says that nothing in the loop could write
+ * 		the memory that they read, and the read is known to be safe to do early(see is_licm_load_safe_to_speculate)
+ * 	2.) Induction variable strength reduction turns constant multiples of induction variables into running
+ * 		sums, and points exit tests at them where it can(see reduce_loop_induction_variables)
+ * 	3.) Loop unrolling makes several copies of the body of innermost counted loops, with the original loop
+ * 		left to run whatever trips are left over(see unroll_loop)
+ *
+ * If we made any preheaders that ended up empty, they are taken back out. If the CFG changed at all,
+ * the control flow relations are recomputed before we give back. We give back TRUE if any exit test was
+ * replaced or any loop was unrolled, because either one can leave behind code that nothing needs anymore
+ */
+static u_int8_t optimize_loops(basic_block_t* function_entry_block, basic_block_t* function_exit_block, dynamic_array_t* function_blocks){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+
+	loop_nest_forest_t forest = build_loop_nest_forest(function_blocks, function->number_of_block_indices);
+
+	//Nothing to do
+	if(forest.loops.current_index == 0){
+		loop_nest_forest_dealloc(&forest);
+		return FALSE;
+	}
+
+	/**
+	 * Inline assembly could be doing anything to our variables, so we won't touch
+	 * those functions at all. While we're here, count how many instructions there are
+	 */
+	u_int32_t instruction_count = 0;
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(cursor->statement_type == THREE_ADDR_CODE_ASM_INLINE_STMT){
+				loop_nest_forest_dealloc(&forest);
+				return FALSE;
+			}
+
+			instruction_count++;
+		}
+	}
+
+	/**
+	 * Give everything a preheader first. If we made any new blocks, the dominators and the
+	 * loops themselves need to be found again so that the new blocks are in them
+	 */
+	dynamic_array_t created_preheaders = dynamic_array_alloc();
+	insert_loop_preheaders(&forest, function, &created_preheaders);
+
+	if(created_preheaders.current_index > 0){
+		loop_nest_forest_dealloc(&forest);
+		recompute_all_control_flow_relations_for_function(function_blocks, function_entry_block, function_exit_block);
+		forest = build_loop_nest_forest(function_blocks, function->number_of_block_indices);
+	}
+
+	licm_context_t context;
+
+	//Size the table so that it's never more than half full
+	context.variable_table_size = 16;
+	while(context.variable_table_size < instruction_count * 2){
+		context.variable_table_size *= 2;
+	}
+
+	context.variables = calloc(context.variable_table_size, sizeof(licm_variable_t));
+	context.exiting_blocks = dynamic_array_alloc();
+	context.memory_writers = dynamic_array_alloc();
+
+	//Which stack objects could a pointer reach? The load hoisting in LICM relies on this
+	compute_address_exposure(function);
+
+	//Count up every definition in the function
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			licm_variable_t* entry = get_licm_variable(&context, cursor->operands.oir.assignee, TRUE);
+
+			if(entry != NULL){
+				entry->definition = cursor;
+				entry->definition_count++;
+			}
+
+			//Calls can define an error value as well
+			if((cursor->statement_type == THREE_ADDR_CODE_FUNC_CALL || cursor->statement_type == THREE_ADDR_CODE_INDIRECT_FUNC_CALL)
+				&& cursor->optional_storage.error_assignee != NULL){
+				entry = get_licm_variable(&context, cursor->optional_storage.error_assignee, TRUE);
+
+				if(entry != NULL){
+					entry->definition = cursor;
+					entry->definition_count++;
+				}
+			}
+		}
+	}
+
+	//Walk backwards so that inner loops always go before the loops around them
+	for(int32_t i = forest.loops.current_index - 1; i >= 0; i--){
+		hoist_loop_invariant_instructions(&context, &forest, dynamic_array_get_at(&(forest.loops), i));
+	}
+
+	/**
+	 * Now that everything invariant is out of the way, we can strength reduce the induction variables. Inner
+	 * loops go first here as well
+	 */
+	u_int8_t replaced_exit_tests = FALSE;
+	for(int32_t i = forest.loops.current_index - 1; i >= 0; i--){
+		if(reduce_loop_induction_variables(&forest, dynamic_array_get_at(&(forest.loops), i), function_blocks) == TRUE){
+			replaced_exit_tests = TRUE;
+		}
+	}
+
+	//Unrolling goes last, so that every copy gets the benefit of everything above
+	u_int8_t unrolled = unroll_loops(&forest, function_blocks);
+
+	free(context.variables);
+	dynamic_array_dealloc(&(context.exiting_blocks));
+	dynamic_array_dealloc(&(context.memory_writers));
+	loop_nest_forest_dealloc(&forest);
+
+	//No new blocks means no CFG changes, so the control flow relations are still good
+	if(created_preheaders.current_index == 0 && unrolled == FALSE){
+		dynamic_array_dealloc(&created_preheaders);
+		return replaced_exit_tests;
+	}
+
+	/**
+	 * Any preheader that we made that has nothing but its jump is just overhead, so we send its
+	 * predecessors straight to the header again. The unreachable block deletion takes it out from there
+	 */
+	for(int32_t i = 0; i < created_preheaders.current_index; i++){
+		basic_block_t* preheader = dynamic_array_get_at(&created_preheaders, i);
+
+		if(preheader->leader_statement == preheader->exit_statement){
+			replace_all_branch_targets(preheader, preheader->exit_statement->if_block);
+		}
+	}
+
+	delete_all_unreachable_blocks(function_entry_block, function_blocks, NULL);
+	recompute_all_control_flow_relations_for_function(function_blocks, function_entry_block, function_exit_block);
+
+	dynamic_array_dealloc(&created_preheaders);
+
+	return replaced_exit_tests == TRUE || unrolled == TRUE;
+}
+
+
+/**
+ * A value that is known to be sitting in memory, because a load read it or a store wrote it
+ */
+typedef struct available_memory_value_t{
+	//Where it is
+	memory_location_t location;
+	//The load or store that put it there
+	instruction_t* source;
+	//Has anything written over it since?
+	u_int8_t killed;
+} available_memory_value_t;
+
+
+/**
+ * Everything that global value numbering needs for one function. This is all local
+ * to the worker that is optimizing the function
+ */
+typedef struct value_numbering_context_t{
+	/**
+	 * Leader instructions are added to this for as long as their scope lasts. Every redundant temp
+	 * is added for good with its leader's result, since that result dominates all of the temp's uses
+	 */
+	value_numbering_table_t table;
+	//Every memory value found on the way down the dominator tree, oldest first
+	available_memory_value_t* memory_values;
+	u_int32_t memory_value_count;
+	//Only memory values from this one on are available in the current block
+	u_int32_t first_available_memory_value;
+	//Every memory value that has been killed, so that the kill can be taken back once its scope is done
+	u_int32_t* killed_memory_values;
+	u_int32_t killed_memory_value_count;
+} value_numbering_context_t;
+
+
+/**
+ * Can this instruction's result be found again somewhere else? It needs to be a pure computation
+ * that goes into a temp. Anything that goes into a non-temp variable is left alone, because every
+ * version of a variable shares one live range. Comparisons that only feed a branch are left alone
+ * as well, since the branch needs them to set the flags right in front of it. Address calculations
+ * are also left alone. The instruction selector folds those into the memory accesses that use them
+ * for free, which it can only do when they have one use
+ */
+static u_int8_t is_instruction_value_numberable(instruction_t* instruction){
+	three_addr_var_t* assignee = instruction->operands.oir.assignee;
+
+	if(assignee == NULL || assignee->variable_type != VARIABLE_TYPE_TEMP || assignee->sets_cc == TRUE){
+		return FALSE;
+	}
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+		case THREE_ADDR_CODE_NEG_STATEMENT:
+		case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+		case THREE_ADDR_CODE_LOGICAL_NOT_STMT:
+			return TRUE;
+
+		//A const function gives back the same thing for the same arguments every time
+		case THREE_ADDR_CODE_FUNC_CALL:
+			return instruction->called_function != NULL
+				&& instruction->called_function->is_const == TRUE
+				&& instruction->optional_storage.error_assignee == NULL ? TRUE : FALSE;
+
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Does the order of the operands of this instruction not matter?
+ */
+static inline u_int8_t is_value_numbered_instruction_commutative(instruction_t* instruction){
+	if(instruction->statement_type != THREE_ADDR_CODE_BIN_OP_STMT
+		|| dealias_type(instruction->operands.oir.operand1->type) != dealias_type(instruction->operands.oir.operand2->type)){
+		return FALSE;
+	}
+
+	switch(instruction->op){
+		case PLUS:
+		case STAR:
+		case SINGLE_AND:
+		case SINGLE_OR:
+		case CARROT:
+		case DOUBLE_EQUALS:
+		case NOT_EQUALS:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * The value number of a variable. Temps are numbered by their temp var number, and
+ * everything else by what it refers to
+ */
+static inline u_int32_t hash_value_numbered_variable(three_addr_var_t* variable){
+	if(variable == NULL){
+		return 0;
+	}
+
+	switch(variable->variable_type){
+		case VARIABLE_TYPE_TEMP:
+			return variable->temp_var_number * 2654435761U;
+		case VARIABLE_TYPE_LOCAL_CONSTANT:
+			return (u_int32_t)((uintptr_t)(variable->associated_memory_region.local_constant) >> 4) * 2654435761U;
+		case VARIABLE_TYPE_FUNCTION_ADDRESS:
+			return (u_int32_t)((uintptr_t)(variable->associated_memory_region.rip_relative_function) >> 4) * 2654435761U;
+		default:
+			if(variable->linked_var == NULL){
+				return ((u_int32_t)((uintptr_t)variable >> 4) * 2654435761U);
+			}
+
+			return (((u_int32_t)((uintptr_t)(variable->linked_var) >> 4) + variable->ssa_generation) * 2654435761U) ^ variable->variable_type;
+	}
+}
+
+
+/**
+ * Do two variables hold the same value? variables_equal can't tell local constants and function
+ * addresses apart, so we compare those by what they refer to
+ */
+static u_int8_t value_numbered_variables_equal(three_addr_var_t* a, three_addr_var_t* b){
+	if(a == b){
+		return TRUE;
+	}
+
+	if(a == NULL || b == NULL || a->variable_type != b->variable_type){
+		return FALSE;
+	}
+
+	switch(a->variable_type){
+		case VARIABLE_TYPE_TEMP:
+			return a->temp_var_number == b->temp_var_number;
+		case VARIABLE_TYPE_LOCAL_CONSTANT:
+			return a->associated_memory_region.local_constant == b->associated_memory_region.local_constant;
+		case VARIABLE_TYPE_FUNCTION_ADDRESS:
+			return a->associated_memory_region.rip_relative_function == b->associated_memory_region.rip_relative_function;
+		default:
+			//Anything without a record is only ever equal to itself
+			if(a->linked_var == NULL){
+				return FALSE;
+			}
+
+			return a->linked_var == b->linked_var && a->ssa_generation == b->ssa_generation;
+	}
+}
+
+
+/**
+ * Are two types the same once any aliases are taken off? Either one may be missing
+ */
+static inline u_int8_t value_numbered_types_equal(generic_type_t* a, generic_type_t* b){
+	if(a == NULL || b == NULL){
+		return a == b;
+	}
+
+	return dealias_type(a) == dealias_type(b);
+}
+
+
+/**
+ * The value number of a constant. This only ever reads the union member that the constant's type
+ * says is in use
+ */
+static inline u_int32_t hash_value_numbered_constant(three_addr_const_t* constant){
+	int64_t value;
+	if(get_sccp_constant_value(constant, &value) == FALSE){
+		return constant->const_type;
+	}
+
+	return (u_int32_t)(value ^ (value >> 32)) * 2654435761U;
+}
+
+
+/**
+ * Are two constants the same value of the same type? The union is compared by whichever member the
+ * constant's type says is in use. Anything that we don't know how to compare is never equal
+ */
+static u_int8_t value_numbered_constants_equal(three_addr_const_t* a, three_addr_const_t* b){
+	if(a == NULL || b == NULL){
+		return a == b;
+	}
+
+	if(a->const_type != b->const_type || value_numbered_types_equal(a->type, b->type) == FALSE
+		|| a->constant_adjustment != b->constant_adjustment){
+		return FALSE;
+	}
+
+	//All of the integer types
+	int64_t a_value;
+	int64_t b_value;
+	if(get_sccp_constant_value(a, &a_value) == TRUE && get_sccp_constant_value(b, &b_value) == TRUE){
+		return a_value == b_value;
+	}
+
+	switch(a->const_type){
+		//These go by their bits, so that 0.0 and -0.0 are never mixed up
+		case FLOAT_CONST:
+			return memcmp(&(a->constant_value.float_constant), &(b->constant_value.float_constant), sizeof(float)) == 0;
+		case DOUBLE_CONST:
+			return memcmp(&(a->constant_value.double_constant), &(b->constant_value.double_constant), sizeof(double)) == 0;
+		case REL_ADDRESS_CONST:
+			return a->constant_value.local_constant_address == b->constant_value.local_constant_address;
+		case STACK_PASSED_PARAM_OFFSET:
+			return a->constant_value.parameter_passed_stack_region == b->constant_value.parameter_passed_stack_region;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Every call argument is copied into a temp of its own right before the call, so two calls with
+ * the same arguments never pass the same temps. We go by whatever was copied instead, which means
+ * finding the copy. Gives back NULL if the argument isn't a copy of a variable or a constant
+ */
+static instruction_t* get_value_numbered_call_argument_copy(instruction_t* call, int32_t index){
+	three_addr_var_t* argument = dynamic_array_get_at(&(call->parameters), index);
+
+	if(argument->variable_type != VARIABLE_TYPE_TEMP){
+		return NULL;
+	}
+
+	for(instruction_t* cursor = call->previous_statement; cursor != NULL; cursor = cursor->previous_statement){
+		three_addr_var_t* assignee = cursor->operands.oir.assignee;
+
+		if(assignee == NULL || assignee->variable_type != VARIABLE_TYPE_TEMP || assignee->temp_var_number != argument->temp_var_number){
+			continue;
+		}
+
+		if(cursor->statement_type == THREE_ADDR_CODE_ASSN_STMT || cursor->statement_type == THREE_ADDR_CODE_ASSN_CONST_STMT){
+			return cursor;
+		}
+
+		return NULL;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * The value number of a call argument
+ */
+static inline u_int32_t hash_value_numbered_call_argument(instruction_t* call, int32_t index){
+	instruction_t* copy = get_value_numbered_call_argument_copy(call, index);
+
+	if(copy == NULL){
+		return hash_value_numbered_variable(dynamic_array_get_at(&(call->parameters), index));
+	}
+
+	if(copy->statement_type == THREE_ADDR_CODE_ASSN_CONST_STMT){
+		return hash_value_numbered_constant(copy->operands.oir.constant_operand);
+	}
+
+	return hash_value_numbered_variable(copy->operands.oir.operand1);
+}
+
+
+/**
+ * Do two calls pass the same value for the given argument?
+ */
+static u_int8_t value_numbered_call_arguments_equal(instruction_t* a, instruction_t* b, int32_t index){
+	three_addr_var_t* a_argument = dynamic_array_get_at(&(a->parameters), index);
+	three_addr_var_t* b_argument = dynamic_array_get_at(&(b->parameters), index);
+
+	if(value_numbered_types_equal(a_argument->type, b_argument->type) == FALSE){
+		return FALSE;
+	}
+
+	instruction_t* a_copy = get_value_numbered_call_argument_copy(a, index);
+	instruction_t* b_copy = get_value_numbered_call_argument_copy(b, index);
+
+	if(a_copy == NULL || b_copy == NULL){
+		return a_copy == b_copy && value_numbered_variables_equal(a_argument, b_argument) == TRUE;
+	}
+
+	if(a_copy->statement_type != b_copy->statement_type){
+		return FALSE;
+	}
+
+	if(a_copy->statement_type == THREE_ADDR_CODE_ASSN_CONST_STMT){
+		return value_numbered_constants_equal(a_copy->operands.oir.constant_operand, b_copy->operands.oir.constant_operand);
+	}
+
+	return value_numbered_variables_equal(a_copy->operands.oir.operand1, b_copy->operands.oir.operand1);
+}
+
+
+/**
+ * Hash an instruction by its structure: the opcode, the value numbers of its operands and its
+ * constants. Commutative operations hash the same either way around
+ */
+static u_int32_t hash_value_numbered_instruction(instruction_t* instruction){
+	u_int32_t operand1_hash = hash_value_numbered_variable(instruction->operands.oir.operand1);
+	u_int32_t operand2_hash = hash_value_numbered_variable(instruction->operands.oir.operand2);
+
+	u_int32_t hash = (instruction->statement_type * 31 + instruction->op) * 2654435761U;
+
+	if(is_value_numbered_instruction_commutative(instruction) == TRUE){
+		hash ^= operand1_hash + operand2_hash;
+	} else {
+		hash ^= operand1_hash + (operand2_hash * 31);
+	}
+
+	hash = hash * 31 + hash_value_numbered_variable(instruction->operands.oir.address_operand1);
+	hash = hash * 31 + hash_value_numbered_variable(instruction->operands.oir.address_operand2);
+	hash = hash * 31 + (u_int32_t)instruction->operands.oir.address_multiplier;
+
+	if(instruction->operands.oir.constant_operand != NULL){
+		hash = hash * 31 + hash_value_numbered_constant(instruction->operands.oir.constant_operand);
+	}
+
+	if(instruction->operands.oir.address_offset != NULL){
+		hash = hash * 31 + hash_value_numbered_constant(instruction->operands.oir.address_offset);
+	}
+
+	//Calls go by who they call and what they pass
+	if(instruction->statement_type == THREE_ADDR_CODE_FUNC_CALL){
+		hash = hash * 31 + (u_int32_t)((uintptr_t)(instruction->called_function) >> 4);
+
+		for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+			hash = hash * 31 + hash_value_numbered_call_argument(instruction, i);
+		}
+	}
+
+	return hash;
+}
+
+
+/**
+ * Do two instructions compute exactly the same value?
+ */
+static u_int8_t value_numbered_instructions_equal(instruction_t* a, instruction_t* b){
+	if(a->statement_type != b->statement_type || a->op != b->op || a->addressing_mode != b->addressing_mode
+		|| a->cannot_be_combined != b->cannot_be_combined
+		|| a->operands.oir.address_multiplier != b->operands.oir.address_multiplier
+		|| value_numbered_types_equal(a->operands.oir.assignee->type, b->operands.oir.assignee->type) == FALSE
+		|| value_numbered_types_equal(a->type_storage.result_type, b->type_storage.result_type) == FALSE){
+		return FALSE;
+	}
+
+	//Shifts can be forced to be signed or unsigned
+	if((a->op == L_SHIFT || a->op == R_SHIFT) && a->optional_storage.forced_signedness != b->optional_storage.forced_signedness){
+		return FALSE;
+	}
+
+	if(value_numbered_variables_equal(a->operands.oir.address_operand1, b->operands.oir.address_operand1) == FALSE
+		|| value_numbered_variables_equal(a->operands.oir.address_operand2, b->operands.oir.address_operand2) == FALSE
+		|| value_numbered_variables_equal(a->operands.oir.rip_offset_var, b->operands.oir.rip_offset_var) == FALSE
+		|| value_numbered_constants_equal(a->operands.oir.constant_operand, b->operands.oir.constant_operand) == FALSE
+		|| value_numbered_constants_equal(a->operands.oir.address_offset, b->operands.oir.address_offset) == FALSE){
+		return FALSE;
+	}
+
+	//Calls need to be to the same function with the same arguments
+	if(a->statement_type == THREE_ADDR_CODE_FUNC_CALL){
+		if(a->called_function != b->called_function || a->parameters.current_index != b->parameters.current_index){
+			return FALSE;
+		}
+
+		for(int32_t i = 0; i < a->parameters.current_index; i++){
+			if(value_numbered_call_arguments_equal(a, b, i) == FALSE){
+				return FALSE;
+			}
+		}
+	}
+
+	//Straight across
+	if(value_numbered_variables_equal(a->operands.oir.operand1, b->operands.oir.operand1) == TRUE
+		&& value_numbered_variables_equal(a->operands.oir.operand2, b->operands.oir.operand2) == TRUE){
+		return TRUE;
+	}
+
+	//Or swapped, if that's allowed
+	return is_value_numbered_instruction_commutative(a) == TRUE && is_value_numbered_instruction_commutative(b) == TRUE
+		&& value_numbered_variables_equal(a->operands.oir.operand1, b->operands.oir.operand2) == TRUE
+		&& value_numbered_variables_equal(a->operands.oir.operand2, b->operands.oir.operand1) == TRUE;
+}
+
+
+/**
+ * Build the key that a redundant temp is stored under in the value numbering table
+ */
+static inline void generate_value_numbered_temp_key(three_addr_var_t* temp, value_number_key_t* key){
+	memset(key, 0, sizeof(value_number_key_t));
+
+	key->key_type = VALUE_NUMBER_KEY_VARIABLE;
+	key->operands[0].number = temp->temp_var_number;
+	key->operands[0].variable_type = VARIABLE_TYPE_TEMP;
+}
+
+
+/**
+ * Swap a used variable for its leader if it was found to be redundant
+ */
+static inline void replace_value_numbered_use(value_numbering_context_t* context, three_addr_var_t** use){
+	if(*use == NULL || (*use)->variable_type != VARIABLE_TYPE_TEMP){
+		return;
+	}
+
+	value_number_key_t key;
+	generate_value_numbered_temp_key(*use, &key);
+
+	three_addr_var_t* leader = lookup_value_number_expression(&(context->table), &key);
+
+	if(leader != NULL){
+		*use = leader;
+		leader->use_count++;
+	}
+}
+
+
+/**
+ * Swap every used variable in an instruction for its leader
+ */
+static void replace_value_numbered_uses(value_numbering_context_t* context, instruction_t* instruction){
+	replace_value_numbered_use(context, &(instruction->operands.oir.operand1));
+	replace_value_numbered_use(context, &(instruction->operands.oir.operand2));
+	replace_value_numbered_use(context, &(instruction->operands.oir.address_operand1));
+	replace_value_numbered_use(context, &(instruction->operands.oir.address_operand2));
+	replace_value_numbered_use(context, &(instruction->relies_on));
+
+	for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(instruction->parameters), i);
+
+		replace_value_numbered_use(context, &parameter);
+		dynamic_array_set_at(&(instruction->parameters), parameter, i);
+	}
+}
+
+
+/**
+ * Can a memory value of one type stand in for a load of the other? Mutable and immutable versions
+ * of a type are separate types, so this goes by what the value actually looks like. Basic types need
+ * to be the same type, and pointers only need to be the same size
+ */
+static u_int8_t are_memory_value_types_compatible(generic_type_t* a, generic_type_t* b){
+	if(a == NULL || b == NULL){
+		return FALSE;
+	}
+
+	a = dealias_type(a);
+	b = dealias_type(b);
+
+	if(a == b){
+		return TRUE;
+	}
+
+	if(a->type_class != b->type_class || a->type_size != b->type_size){
+		return FALSE;
+	}
+
+	switch(a->type_class){
+		case TYPE_CLASS_BASIC:
+			return a->basic_type_token == b->basic_type_token;
+		case TYPE_CLASS_POINTER:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Note down that a redundant temp is now the same as its leader from here on out
+ */
+static inline void add_value_numbered_replacement(value_numbering_context_t* context, three_addr_var_t* redundant, three_addr_var_t* leader){
+	//The leader now has more than one use, so it can't be overwritten in place
+	leader->was_value_named = TRUE;
+
+	value_number_key_t key;
+	generate_value_numbered_temp_key(redundant, &key);
+
+	add_value_number_expression(&(context->table), leader, &key);
+}
+
+
+/**
+ * Mark a memory value as no longer available. The kill is logged so that it can be
+ * taken back once we leave the block that did it
+ */
+static inline void kill_available_memory_value(value_numbering_context_t* context, u_int32_t index){
+	context->memory_values[index].killed = TRUE;
+	context->killed_memory_values[context->killed_memory_value_count] = index;
+	context->killed_memory_value_count++;
+}
+
+
+/**
+ * The variable that holds a memory value. Stores of a constant have none
+ */
+static inline three_addr_var_t* get_available_memory_value_variable(instruction_t* source){
+	if(source->statement_type == THREE_ADDR_CODE_LOAD_STATEMENT){
+		return source->operands.oir.assignee;
+	}
+
+	return source->operands.oir.operand1;
+}
+
+
+/**
+ * Every version of a non-temp variable shares one live range, so once a variable is
+ * assigned again any value that was held in an older version of it is gone
+ */
+static void kill_available_memory_values_held_in(value_numbering_context_t* context, three_addr_var_t* variable){
+	if(variable == NULL || variable->variable_type == VARIABLE_TYPE_TEMP || variable->linked_var == NULL){
+		return;
+	}
+
+	for(u_int32_t i = context->first_available_memory_value; i < context->memory_value_count; i++){
+		if(context->memory_values[i].killed == TRUE){
+			continue;
+		}
+
+		three_addr_var_t* value = get_available_memory_value_variable(context->memory_values[i].source);
+
+		if(value != NULL && value->variable_type != VARIABLE_TYPE_TEMP && value->linked_var == variable->linked_var){
+			kill_available_memory_value(context, i);
+		}
+	}
+}
+
+
+/**
+ * Kill every available memory value that the given instruction could write over. Alias analysis
+ * decides what a store, copy or call could reach
+ */
+static void kill_available_memory_values_written_by(value_numbering_context_t* context, instruction_t* instruction){
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_STORE_STATEMENT:
+		case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+		case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+		case THREE_ADDR_CODE_FUNC_CALL:
+		case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+		case THREE_ADDR_CODE_ASM_INLINE_STMT:
+			break;
+
+		//These move the stack pointer under anything that was based off of it, so nothing is trusted
+		case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
+		case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
+			for(u_int32_t i = context->first_available_memory_value; i < context->memory_value_count; i++){
+				if(context->memory_values[i].killed == FALSE){
+					kill_available_memory_value(context, i);
+				}
+			}
+
+			return;
+
+		default:
+			return;
+	}
+
+	for(u_int32_t i = context->first_available_memory_value; i < context->memory_value_count; i++){
+		if(context->memory_values[i].killed == FALSE
+			&& may_instruction_write_memory_location(instruction, &(context->memory_values[i].location)) == TRUE){
+			kill_available_memory_value(context, i);
+		}
+	}
+}
+
+
+/**
+ * Make what a load or store leaves in memory available to everything after it
+ */
+static inline void add_available_memory_value(value_numbering_context_t* context, instruction_t* source){
+	available_memory_value_t* value = &(context->memory_values[context->memory_value_count]);
+
+	//If we can't say anything about where it is, nothing could ever use it
+	if(get_memory_location_for_instruction(source, &(value->location)) == FALSE || value->location.base_type == MEMORY_BASE_UNKNOWN){
+		return;
+	}
+
+	//Local constants are left alone, since the selector folds reads of them into whatever uses them for free
+	if(value->location.base_type == MEMORY_BASE_READ_ONLY_CONSTANT){
+		return;
+	}
+
+	value->source = source;
+	value->killed = FALSE;
+	context->memory_value_count++;
+}
+
+
+/**
+ * Try to give a load the value that is already known to be in the memory that it reads. That value
+ * is either from an earlier load of the same memory or from the store that wrote to it. Either way
+ * the load itself is deleted. Gives back TRUE if it was
+ *
+ * The value has to be exactly what the load would have given back, so the memory types need to match
+ * and nothing can be widened or truncated along the way
+ */
+static u_int8_t forward_available_memory_value(value_numbering_context_t* context, instruction_t* load){
+	three_addr_var_t* assignee = load->operands.oir.assignee;
+
+	if(assignee == NULL || assignee->sets_cc == TRUE){
+		return FALSE;
+	}
+
+	memory_location_t location;
+	if(get_memory_location_for_instruction(load, &location) == FALSE || location.base_type == MEMORY_BASE_UNKNOWN){
+		return FALSE;
+	}
+
+	//Newest first. The newest value for any location is always the right one
+	available_memory_value_t* available = NULL;
+	for(int32_t i = context->memory_value_count - 1; i >= (int32_t)context->first_available_memory_value; i--){
+		if(context->memory_values[i].killed == FALSE
+			&& memory_locations_alias(&(context->memory_values[i].location), &location) == MUST_ALIAS){
+			available = &(context->memory_values[i]);
+			break;
+		}
+	}
+
+	if(available == NULL
+		|| are_memory_value_types_compatible(available->source->type_storage.memory_read_write_type, load->type_storage.memory_read_write_type) == FALSE){
+		return FALSE;
+	}
+
+	generic_type_t* memory_type = dealias_type(load->type_storage.memory_read_write_type);
+	three_addr_var_t* value = get_available_memory_value_variable(available->source);
+	instruction_t* replacement;
+
+	//A constant store. These can only be handed over if the load doesn't widen them
+	if(value == NULL){
+		int64_t constant;
+		if(IS_FLOATING_POINT(memory_type) == TRUE
+			|| are_memory_value_types_compatible(assignee->type, memory_type) == FALSE
+			|| get_sccp_constant_value(available->source->operands.oir.constant_operand, &constant) == FALSE){
+			return FALSE;
+		}
+
+		replacement = emit_assignment_with_const_instruction(assignee, emit_direct_integer_or_char_constant(constant, memory_type), load->line_number);
+		insert_instruction_before_given(replacement, load);
+		delete_statement(load);
+
+		return TRUE;
+	}
+
+	/**
+	 * The value needs to be the same type that the load gives back. A stored value also needs to have
+	 * gone into memory whole, otherwise the store truncated it
+	 */
+	if(are_memory_value_types_compatible(value->type, assignee->type) == FALSE
+		|| (available->source->statement_type == THREE_ADDR_CODE_STORE_STATEMENT && dealias_type(value->type)->type_size != memory_type->type_size)){
+		return FALSE;
+	}
+
+	//Temp to temp is the same as any other redundancy, every use is just pointed at the value
+	if(assignee->variable_type == VARIABLE_TYPE_TEMP && value->variable_type == VARIABLE_TYPE_TEMP){
+		add_value_numbered_replacement(context, assignee, value);
+		delete_statement(load);
+
+		return TRUE;
+	}
+
+	//Otherwise the load turns into a copy of the value
+	three_addr_var_t* copy = emit_var_copy(value);
+	copy->use_count = 1;
+
+	if(value->variable_type == VARIABLE_TYPE_TEMP){
+		value->was_value_named = TRUE;
+	}
+
+	replacement = emit_assignment_instruction(assignee, copy, load->line_number);
+	insert_instruction_before_given(replacement, load);
+	delete_statement(load);
+
+	return TRUE;
+}
+
+
+/**
+ * Handle the memory side of value numbering for one instruction. Loads are given any value that is
+ * already known to be in the memory that they read, and anything that writes to memory or to a
+ * variable holding a memory value kills what it could have changed. Gives back TRUE if the instruction
+ * was deleted
+ */
+static u_int8_t value_number_memory_access(value_numbering_context_t* context, instruction_t* instruction){
+	//The assignee of a load is killed after the load itself is looked at, since the load may be reading into it
+	if(instruction->statement_type == THREE_ADDR_CODE_LOAD_STATEMENT){
+		if(forward_available_memory_value(context, instruction) == TRUE){
+			return TRUE;
+		}
+
+		kill_available_memory_values_held_in(context, instruction->operands.oir.assignee);
+		add_available_memory_value(context, instruction);
+
+		return FALSE;
+	}
+
+	kill_available_memory_values_written_by(context, instruction);
+	kill_available_memory_values_held_in(context, instruction->operands.oir.assignee);
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_STORE_STATEMENT:
+			add_available_memory_value(context, instruction);
+			break;
+
+		case THREE_ADDR_CODE_FUNC_CALL:
+		case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+			kill_available_memory_values_held_in(context, instruction->optional_storage.error_assignee);
+			break;
+
+		default:
+			break;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Value number one block, and then everything that it dominates. Anything that this block adds
+ * to the table comes back out once its dominator subtree is done, so a leader is only ever
+ * used where its definition dominates
+ *
+ * Memory values work the same way, with one difference. A block that can be reached from more
+ * than one place could have had its memory written on the way in from any of them, so none of
+ * the memory values from above it are available there
+ *
+ * NOTE: this function is recursive
+ */
+static u_int8_t value_number_block(value_numbering_context_t* context, basic_block_t* block){
+	u_int8_t changed = FALSE;
+	u_int32_t scope_start = value_numbering_scope_begin(&(context->table));
+	u_int32_t memory_scope_start = context->memory_value_count;
+	u_int32_t kill_scope_start = context->killed_memory_value_count;
+
+	instruction_t* cursor = block->leader_statement;
+	while(cursor != NULL){
+		//This may get deleted out from under us
+		instruction_t* next = cursor->next_statement;
+
+		//Phi functions only take non-temps, and those are never replaced
+		if(cursor->statement_type != THREE_ADDR_CODE_PHI_FUNC){
+			replace_value_numbered_uses(context, cursor);
+		}
+
+		if(value_number_memory_access(context, cursor) == TRUE){
+			changed = TRUE;
+			cursor = next;
+			continue;
+		}
+
+		if(is_instruction_value_numberable(cursor) == FALSE){
+			cursor = next;
+			continue;
+		}
+
+		value_number_key_t key;
+		memset(&key, 0, sizeof(value_number_key_t));
+		key.key_type = VALUE_NUMBER_KEY_INSTRUCTION;
+		key.instruction = cursor;
+		key.instruction_hash = hash_value_numbered_instruction(cursor);
+
+		three_addr_var_t* leader = lookup_value_number_expression(&(context->table), &key);
+
+		//Brand new, so this is now the leader for its value
+		if(leader == NULL){
+			add_scoped_value_number_expression(&(context->table), cursor->operands.oir.assignee, &key);
+
+			cursor = next;
+			continue;
+		}
+
+		/**
+		 * Otherwise this was already computed somewhere that dominates us. Everything after this that uses
+		 * our result will use the leader's instead, so this instruction is done. The leader now has more
+		 * than one use, so just like with the instruction selector's value numbering it can't be
+		 * overwritten in place
+		 */
+		add_value_numbered_replacement(context, cursor->operands.oir.assignee, leader);
+
+		delete_statement(cursor);
+		changed = TRUE;
+
+		cursor = next;
+	}
+
+	//Now go through everything that this block dominates
+	for(int32_t i = 0; i < block->analysis->dominator_children.current_index; i++){
+		basic_block_t* child = dynamic_array_get_at(&(block->analysis->dominator_children), i);
+		u_int32_t first_available_memory_value = context->first_available_memory_value;
+
+		//If we aren't the only way in, the child starts over with no memory values
+		if(child->predecessors.current_index != 1){
+			context->first_available_memory_value = context->memory_value_count;
+		}
+
+		if(value_number_block(context, child) == TRUE){
+			changed = TRUE;
+		}
+
+		context->first_available_memory_value = first_available_memory_value;
+	}
+
+	//Take our scope back out
+	value_numbering_scope_end(&(context->table), scope_start);
+
+	//Any memory values that we killed are back, and any that we added are gone
+	while(context->killed_memory_value_count > kill_scope_start){
+		context->killed_memory_value_count--;
+		context->memory_values[context->killed_memory_values[context->killed_memory_value_count]].killed = FALSE;
+	}
+
+	context->memory_value_count = memory_scope_start;
+
+	return changed;
+}
+
+
+/**
+ * Global value numbering over the function's SSA. Every pure computation that goes into a temp is
+ * hashed by its opcode, the value numbers of its operands and its constants. If that computation
+ * was already done by something that dominates it, the later one is deleted and every use of its
+ * result is pointed at the earlier result instead:
+ *
+ * 	t7 <- x_2 * y_1			t7 <- x_2 * y_1
+ * 	...				  ==>	...
+ * 	t12 <- y_1 * x_2		(gone)
+ * 	t13 <- t12 + 4			t13 <- t7 + 4
+ *
+ * Since t7 and t12 are the same value, t13 is now the same computation anywhere that t7 + 4 has already
+ * been done too, so this will catch whole chains of redundant computations in one go. The table is scoped
+ * by the dominator tree, so a leader is never used anywhere that its definition doesn't dominate.
+ *
+ * Loads are handled here as well. Once a load or store has happened, the value that is in memory is known
+ * until something that alias analysis says could write there comes along. A later load of the same memory
+ * is given that value instead of going back out to memory for it:
+ *
+ * 	store (p_1, 4) <- t4		store (p_1, 4) <- t4
+ * 	load t5 <- (p_1, 4)	  ==>	(gone, t5 is now t4)
+ * 	load t6 <- (p_1, 4)			(gone, t6 is now t4)
+ *
+ * Gives back TRUE if anything was removed
+ */
+static u_int8_t global_value_numbering(basic_block_t* function_entry_block, dynamic_array_t* function_blocks){
+	u_int32_t instruction_count = 0;
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			instruction_count++;
+		}
+	}
+
+	value_numbering_context_t context;
+
+	//Every instruction could end up in here once as a leader or as a redundant temp
+	context.table = value_numbering_table_alloc(instruction_count * 2);
+	context.table.instructions_equal = value_numbered_instructions_equal;
+	context.memory_values = calloc(instruction_count + 1, sizeof(available_memory_value_t));
+	context.memory_value_count = 0;
+	context.first_available_memory_value = 0;
+	context.killed_memory_values = calloc(instruction_count + 1, sizeof(u_int32_t));
+	context.killed_memory_value_count = 0;
+
+	//Alias analysis needs to know which stack objects pointers can reach
+	compute_address_exposure(function_entry_block->function_defined_in);
+
+	u_int8_t changed = value_number_block(&context, function_entry_block);
+
+	value_numbering_table_dealloc(&(context.table));
+	free(context.memory_values);
+	free(context.killed_memory_values);
+
+	return changed;
+}
+
+
+/**
+ * Find which of the tracked stack objects a memory address variable is the base of. Gives
+ * back -1 if it isn't the base of any of them
+ */
+static int32_t get_dead_store_object_index(dynamic_array_t* objects, three_addr_var_t* base_address){
+	if(base_address == NULL || base_address->variable_type != VARIABLE_TYPE_MEMORY_ADDRESS || base_address->linked_var == NULL){
+		return -1;
+	}
+
+	for(int32_t i = 0; i < objects->current_index; i++){
+		if(dynamic_array_get_at(objects, i) == base_address->linked_var){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+/**
+ * Start tracking the stack object that a memory address variable is the base of. Only this function's own
+ * objects whose address never gets out are tracked, because nothing but a load or copy right here can ever
+ * read what is stored in them
+ */
+static void add_dead_store_object(dynamic_array_t* objects, symtab_function_record_t* function, three_addr_var_t* base_address){
+	if(base_address == NULL || base_address->variable_type != VARIABLE_TYPE_MEMORY_ADDRESS || base_address->linked_var == NULL){
+		return;
+	}
+
+	symtab_variable_record_t* object = base_address->linked_var;
+
+	if(object->function_declared_in != function || object->address_exposure != ADDRESS_NOT_EXPOSED){
+		return;
+	}
+
+	if(get_dead_store_object_index(objects, base_address) == -1){
+		dynamic_array_add(objects, object);
+	}
+}
+
+
+/**
+ * Mark the object that an instruction reads from as live. Inline assembly could be
+ * reading any of them
+ */
+static void add_dead_store_object_reads(dynamic_array_t* objects, instruction_t* instruction, u_int8_t* live){
+	int32_t index;
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_LOAD_STATEMENT:
+			index = get_dead_store_object_index(objects, instruction->operands.oir.address_operand1);
+			break;
+
+		case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+			index = get_dead_store_object_index(objects, instruction->operands.oir.address_operand2);
+			break;
+
+		case THREE_ADDR_CODE_ASM_INLINE_STMT:
+			memset(live, TRUE, objects->current_index);
+			return;
+
+		default:
+			return;
+	}
+
+	if(index != -1){
+		live[index] = TRUE;
+	}
+}
+
+
+/**
+ * Drop every pending overwrite that the given instruction could read, or that it changes the base address of
+ */
+static void remove_dead_store_overwrites(dynamic_array_t* overwrites, instruction_t* instruction){
+	three_addr_var_t* assignee = instruction->operands.oir.assignee;
+
+	for(int32_t i = overwrites->current_index - 1; i >= 0; i--){
+		memory_location_t* overwrite = dynamic_array_get_at(overwrites, i);
+
+		if(may_instruction_read_memory_location(instruction, overwrite) == TRUE
+			|| (overwrite->base_type == MEMORY_BASE_POINTER && assignee != NULL && variables_equal_no_ssa(assignee, overwrite->base) == TRUE)){
+			free(dynamic_array_delete_at(overwrites, i));
+		}
+	}
+}
+
+
+/**
+ * Is every byte that the location covers written again later on, before anything could read it?
+ */
+static u_int8_t is_location_overwritten(dynamic_array_t* overwrites, memory_location_t* location){
+	for(int32_t i = 0; i < overwrites->current_index; i++){
+		if(does_memory_location_contain(dynamic_array_get_at(overwrites, i), location) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Remember that the location is written before anything after here gets to read it
+ */
+static void add_dead_store_overwrite(dynamic_array_t* overwrites, memory_location_t* location){
+	//We need to know exactly which bytes are written for this to ever cover anything
+	if(location->base_type == MEMORY_BASE_UNKNOWN || location->base_type == MEMORY_BASE_STACK_POINTER
+		|| location->offset_known == FALSE || location->size == 0){
+		return;
+	}
+
+	memory_location_t* overwrite = malloc(sizeof(memory_location_t));
+	*overwrite = *location;
+
+	dynamic_array_add(overwrites, overwrite);
+}
+
+
+/**
+ * Empty out the pending overwrites
+ */
+static void clear_dead_store_overwrites(dynamic_array_t* overwrites){
+	while(dynamic_array_is_empty(overwrites) == FALSE){
+		free(dynamic_array_delete_from_back(overwrites));
+	}
+}
+
+
+/**
+ * Dead store elimination. mark() has to treat every store as useful, because on its own it can't tell
+ * whether anything will read the memory. There are two ways that we can tell that a store is dead:
+ *
+ * 	1.) It writes to a stack object whose address never gets out of the function, and no load or copy
+ * 		of that object can be reached from it. We work this out with a liveness pass over the function
+ * 		where every object is live or dead as a whole. Nothing is ever killed, so writing one part of an
+ * 		object does not make what was there before it dead
+ * 	2.) Every byte that it writes is written again further down in the block, and alias analysis says
+ * 		that nothing in between could read any of it. This works for globals and pointers as well:
+ *
+ * 	store (g, 0) <- t4		(gone)
+ * 	t5 <- t4 + 1		  ==>	t5 <- t4 + 1
+ * 	store (g, 0) <- t5		store (g, 0) <- t5
+ *
+ * Once the stores are gone, whatever computed the values that they stored is left for mark & sweep, along
+ * with any stack region that nothing touches anymore. Gives back TRUE if any store was removed
+ */
+static u_int8_t eliminate_dead_stores(basic_block_t* function_entry_block, dynamic_array_t* function_blocks){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+
+	//Alias analysis needs to know which stack objects pointers can reach
+	compute_address_exposure(function);
+
+	//Find every object that we can track
+	dynamic_array_t objects = dynamic_array_alloc();
+
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_LOAD_STATEMENT:
+				case THREE_ADDR_CODE_STORE_STATEMENT:
+					add_dead_store_object(&objects, function, cursor->operands.oir.address_operand1);
+					break;
+
+				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+					add_dead_store_object(&objects, function, cursor->operands.oir.address_operand1);
+					add_dead_store_object(&objects, function, cursor->operands.oir.address_operand2);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+
+	u_int32_t object_count = objects.current_index;
+
+	/**
+	 * Which objects are live going into each block. A block's objects are live coming in if
+	 * the block reads them, or if they're live coming into any of its successors. We keep
+	 * going over the blocks backwards until nothing changes
+	 */
+	u_int8_t* live_in = calloc((function->number_of_block_indices * object_count) + 1, sizeof(u_int8_t));
+	u_int8_t* live = calloc(object_count + 1, sizeof(u_int8_t));
+
+	u_int8_t liveness_changed = object_count > 0;
+	while(liveness_changed == TRUE){
+		liveness_changed = FALSE;
+
+		for(int32_t i = function_blocks->current_index - 1; i >= 0; i--){
+			basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+			u_int8_t* block_live_in = live_in + (block->function_block_index * object_count);
+
+			memset(live, FALSE, object_count);
+
+			for(int32_t j = 0; j < block->successors.current_index; j++){
+				basic_block_t* successor = dynamic_array_get_at(&(block->successors), j);
+				u_int8_t* successor_live_in = live_in + (successor->function_block_index * object_count);
+
+				for(u_int32_t k = 0; k < object_count; k++){
+					live[k] |= successor_live_in[k];
+				}
+			}
+
+			for(instruction_t* cursor = block->exit_statement; cursor != NULL; cursor = cursor->previous_statement){
+				add_dead_store_object_reads(&objects, cursor, live);
+			}
+
+			//Nothing is ever killed, so all that can happen is that more becomes live
+			for(u_int32_t k = 0; k < object_count; k++){
+				if(live[k] == TRUE && block_live_in[k] == FALSE){
+					block_live_in[k] = TRUE;
+					liveness_changed = TRUE;
+				}
+			}
+		}
+	}
+
+	//The overwrites that we've seen so far on the way back up through a block
+	dynamic_array_t overwrites = dynamic_array_alloc();
+
+	u_int8_t changed = FALSE;
+	memory_location_t destination;
+	memory_location_t source;
+	int32_t index;
+
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		//Start off with whatever is live going out
+		memset(live, FALSE, object_count);
+
+		for(int32_t j = 0; j < block->successors.current_index; j++){
+			basic_block_t* successor = dynamic_array_get_at(&(block->successors), j);
+			u_int8_t* successor_live_in = live_in + (successor->function_block_index * object_count);
+
+			for(u_int32_t k = 0; k < object_count; k++){
+				live[k] |= successor_live_in[k];
+			}
+		}
+
+		instruction_t* cursor = block->exit_statement;
+		while(cursor != NULL){
+			//Grab this now in case the cursor is deleted
+			instruction_t* previous = cursor->previous_statement;
+
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_STORE_STATEMENT:
+					get_memory_location_for_instruction(cursor, &destination);
+					index = get_dead_store_object_index(&objects, cursor->operands.oir.address_operand1);
+
+					if((index != -1 && live[index] == FALSE) || is_location_overwritten(&overwrites, &destination) == TRUE){
+						delete_statement(cursor);
+						changed = TRUE;
+						break;
+					}
+
+					add_dead_store_overwrite(&overwrites, &destination);
+					break;
+
+				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+					get_memory_locations_for_memory_copy(cursor, &destination, &source);
+					index = get_dead_store_object_index(&objects, cursor->operands.oir.address_operand1);
+
+					if((index != -1 && live[index] == FALSE) || is_location_overwritten(&overwrites, &destination) == TRUE){
+						delete_statement(cursor);
+						changed = TRUE;
+						break;
+					}
+
+					//The copy reads the source before it writes the destination
+					remove_dead_store_overwrites(&overwrites, cursor);
+					add_dead_store_overwrite(&overwrites, &destination);
+					add_dead_store_object_reads(&objects, cursor, live);
+					break;
+
+				//These move the stack pointer, so nothing that was based off of it is the same memory
+				case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
+				case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
+					clear_dead_store_overwrites(&overwrites);
+					break;
+
+				default:
+					remove_dead_store_overwrites(&overwrites, cursor);
+					add_dead_store_object_reads(&objects, cursor, live);
+					break;
+			}
+
+			cursor = previous;
+		}
+
+		//Nothing carries over between blocks
+		clear_dead_store_overwrites(&overwrites);
+	}
+
+	dynamic_array_dealloc(&overwrites);
+	dynamic_array_dealloc(&objects);
+	free(live_in);
+	free(live);
+
+	return changed;
+}
+
+
+/**
+ * Get the instruction in a block that works out what its branch relies on. If that
+ * isn't in the block, we give back NULL
+ */
+static instruction_t* get_branch_conditional(basic_block_t* block){
+	instruction_t* branch = block->exit_statement;
+
+	if(branch->relies_on == NULL){
+		return NULL;
+	}
+
+	for(instruction_t* cursor = branch->previous_statement; cursor != NULL; cursor = cursor->previous_statement){
+		if(variables_equal(cursor->operands.oir.assignee, branch->relies_on) == TRUE){
+			return cursor;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * What must the branch's conditional have been if we went to the given successor? A true conditional
+ * sends a regular branch to its if block, and an inverse branch to its else block
+ */
+static inline conditional_status_t get_conditional_status_for_successor(instruction_t* branch, basic_block_t* successor){
+	u_int8_t went_to_if_block = successor == branch->if_block ? TRUE : FALSE;
+
+	return went_to_if_block != branch->inverse_branch ? CONDITIONAL_ALWAYS_TRUE : CONDITIONAL_ALWAYS_FALSE;
+}
+
+
+/**
+ * Is the variable used anywhere outside of the given block? Phi functions in
+ * other blocks count as uses
+ */
+static u_int8_t is_variable_used_outside_of_block(dynamic_array_t* function_blocks, basic_block_t* block, three_addr_var_t* variable){
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
+
+		if(current == block){
+			continue;
+		}
+
+		for(instruction_t* cursor = current->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(variables_equal(cursor->operands.oir.operand1, variable) == TRUE
+				|| variables_equal(cursor->operands.oir.operand2, variable) == TRUE
+				|| variables_equal(cursor->operands.oir.address_operand1, variable) == TRUE
+				|| variables_equal(cursor->operands.oir.address_operand2, variable) == TRUE
+				|| variables_equal(cursor->relies_on, variable) == TRUE){
+				return TRUE;
+			}
+
+			//Stores use their assignee as well
+			if(cursor->statement_type == THREE_ADDR_CODE_STORE_STATEMENT && variables_equal(cursor->operands.oir.assignee, variable) == TRUE){
+				return TRUE;
+			}
+
+			for(int32_t j = 0; j < cursor->parameters.current_index; j++){
+				if(variables_equal(dynamic_array_get_at(&(cursor->parameters), j), variable) == TRUE){
+					return TRUE;
+				}
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Can the given block be copied into its predecessors? It needs to be small, and nothing that it defines can be
+ * used anywhere else. That way no path that skips the block, or goes through a copy of it, can ever see a value
+ * that it doesn't define. Anything with side effects that has to come along into the copies is flagged
+ */
+static u_int8_t can_block_be_jump_threaded(dynamic_array_t* function_blocks, basic_block_t* block, u_int8_t* needs_copy){
+	u_int32_t instruction_count = 0;
+
+	*needs_copy = FALSE;
+
+	for(instruction_t* cursor = block->leader_statement; cursor != block->exit_statement; cursor = cursor->next_statement){
+		switch(cursor->statement_type){
+			case THREE_ADDR_CODE_PHI_FUNC:
+				break;
+
+			//These have to be done along every path, so the copies need them
+			case THREE_ADDR_CODE_STORE_STATEMENT:
+			case THREE_ADDR_CODE_FUNC_CALL:
+			case THREE_ADDR_CODE_PROFILE_COUNTER_STMT:
+				*needs_copy = TRUE;
+				instruction_count++;
+				break;
+
+			case THREE_ADDR_CODE_BIN_OP_STMT:
+			case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			case THREE_ADDR_CODE_SETNE_STMT:
+			case THREE_ADDR_CODE_INC_STMT:
+			case THREE_ADDR_CODE_DEC_STMT:
+			case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+			case THREE_ADDR_CODE_LOGICAL_NOT_STMT:
+			case THREE_ADDR_CODE_ASSN_STMT:
+			case THREE_ADDR_CODE_TRUNCATING_ASSN_STMT:
+			case THREE_ADDR_CODE_ASSN_CONST_STMT:
+			case THREE_ADDR_CODE_NEG_STATEMENT:
+			case THREE_ADDR_CODE_TEST_IF_NOT_ZERO_STMT:
+			case THREE_ADDR_CODE_LEA_STMT:
+			case THREE_ADDR_CODE_LOAD_STATEMENT:
+				instruction_count++;
+				break;
+
+			//Anything else stays where it is
+			default:
+				return FALSE;
+		}
+
+		if(instruction_count > JUMP_THREADING_MAX_INSTRUCTIONS){
+			return FALSE;
+		}
+	}
+
+	for(instruction_t* cursor = block->leader_statement; cursor != block->exit_statement; cursor = cursor->next_statement){
+		three_addr_var_t* assignee = cursor->operands.oir.assignee;
+
+		if(cursor->statement_type == THREE_ADDR_CODE_STORE_STATEMENT || assignee == NULL){
+			continue;
+		}
+
+		//A copy would define a second instance of this exact version
+		if(cursor->statement_type != THREE_ADDR_CODE_PHI_FUNC && assignee->variable_type != VARIABLE_TYPE_TEMP){
+			return FALSE;
+		}
+
+		if(is_variable_used_outside_of_block(function_blocks, block, assignee) == TRUE){
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Find the phi function parameter that comes into the block from the given predecessor. Parameters aren't
+ * kept in predecessor order, so we go by dominance - whatever comes in over an edge must be defined somewhere
+ * that dominates the block the edge leaves from. If more than one does, the one defined closest to the
+ * predecessor wins. Parameters that are never defined come straight from the function entry
+ */
+static three_addr_var_t* get_phi_parameter_from_predecessor(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, instruction_t* phi_function, basic_block_t* predecessor){
+	//Some path brings in a value that was never defined
+	if(phi_function->parameters.current_index < ((basic_block_t*)(phi_function->block_contained_in))->predecessors.current_index){
+		return NULL;
+	}
+
+	three_addr_var_t* found = NULL;
+	basic_block_t* found_block = NULL;
+
+	for(int32_t i = 0; i < phi_function->parameters.current_index; i++){
+		three_addr_var_t* parameter = dynamic_array_get_at(&(phi_function->parameters), i);
+		instruction_t* definition = find_variable_definition(function_blocks, parameter);
+		basic_block_t* definition_block = definition != NULL ? definition->block_contained_in : function_entry_block;
+
+		if(does_block_dominate(definition_block, predecessor) == FALSE){
+			continue;
+		}
+
+		//Two that are defined in the same place can't be told apart
+		if(found_block == definition_block){
+			return NULL;
+		}
+
+		//Everything defined above the predecessor is on one dominator chain, so the deepest is easy to find
+		if(found == NULL || does_block_dominate(found_block, definition_block) == TRUE){
+			found = parameter;
+			found_block = definition_block;
+		}
+	}
+
+	return found;
+}
+
+
+/**
+ * Get the value that an operand of the block's conditional has when we come in from the predecessor. This
+ * works for constants that come in through the block's phi functions or are assigned in the block itself
+ */
+static u_int8_t get_jump_threading_operand_value(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, basic_block_t* block,
+												 basic_block_t* predecessor, three_addr_var_t* operand, int64_t* value){
+	if(operand == NULL || is_integer_type(operand->type) == FALSE){
+		return FALSE;
+	}
+
+	for(instruction_t* cursor = block->leader_statement; cursor != block->exit_statement; cursor = cursor->next_statement){
+		if(variables_equal(cursor->operands.oir.assignee, operand) == FALSE){
+			continue;
+		}
+
+		//Swap the phi function's result for whatever comes in from the predecessor
+		if(cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+			three_addr_var_t* parameter = get_phi_parameter_from_predecessor(function_blocks, function_entry_block, cursor, predecessor);
+
+			if(parameter == NULL){
+				return FALSE;
+			}
+
+			cursor = find_variable_definition(function_blocks, parameter);
+
+			if(cursor == NULL){
+				return FALSE;
+			}
+		}
+
+		if(cursor->statement_type != THREE_ADDR_CODE_ASSN_CONST_STMT
+			|| get_sccp_constant_value(cursor->operands.oir.constant_operand, value) == FALSE){
+			return FALSE;
+		}
+
+		*value = normalize_sccp_value(*value, cursor->operands.oir.assignee->type);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Work out the block's conditional using the constants that come in from the predecessor
+ */
+static conditional_status_t get_phi_input_conditional_status(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, basic_block_t* block,
+															 basic_block_t* predecessor, instruction_t* conditional){
+	int64_t a;
+	int64_t b;
+	int64_t result;
+	u_int8_t b_unsigned;
+
+	switch(conditional->statement_type){
+		case THREE_ADDR_CODE_TEST_IF_NOT_ZERO_STMT:
+			if(conditional->operands.oir.operand1 == NULL
+				|| get_jump_threading_operand_value(function_blocks, function_entry_block, block, predecessor, conditional->operands.oir.operand1, &a) == FALSE){
+				return CONDITIONAL_UNKNOWN;
+			}
+
+			return a != 0 ? CONDITIONAL_ALWAYS_TRUE : CONDITIONAL_ALWAYS_FALSE;
+
+		case THREE_ADDR_CODE_BIN_OP_STMT:
+		case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+			if(get_jump_threading_operand_value(function_blocks, function_entry_block, block, predecessor, conditional->operands.oir.operand1, &a) == FALSE){
+				return CONDITIONAL_UNKNOWN;
+			}
+
+			if(conditional->statement_type == THREE_ADDR_CODE_BIN_OP_STMT){
+				if(get_jump_threading_operand_value(function_blocks, function_entry_block, block, predecessor, conditional->operands.oir.operand2, &b) == FALSE){
+					return CONDITIONAL_UNKNOWN;
+				}
+
+				b_unsigned = is_type_signed(conditional->operands.oir.operand2->type) == FALSE;
+
+			} else {
+				if(get_sccp_constant_value(conditional->operands.oir.constant_operand, &b) == FALSE){
+					return CONDITIONAL_UNKNOWN;
+				}
+
+				b_unsigned = is_sccp_constant_unsigned(conditional->operands.oir.constant_operand);
+			}
+
+			if(is_integer_type(conditional->operands.oir.assignee->type) == FALSE
+				|| fold_sccp_binary_operation(conditional, a, b, b_unsigned, &result) != SCCP_LATTICE_CONSTANT){
+				return CONDITIONAL_UNKNOWN;
+			}
+
+			return normalize_sccp_value(result, conditional->operands.oir.assignee->type) != 0 ? CONDITIONAL_ALWAYS_TRUE : CONDITIONAL_ALWAYS_FALSE;
+
+		default:
+			return CONDITIONAL_UNKNOWN;
+	}
+}
+
+
+/**
+ * Look for a branch above the predecessor that already tested the exact same conditional. We walk up the
+ * dominator tree from the edge into the block. An edge into a child decides the conditional for everything
+ * under the child so long as it is the only way into it. The edge into the block itself is the one that
+ * we're threading, so that one always counts
+ */
+static conditional_status_t get_dominating_conditional_status(basic_block_t* block, basic_block_t* predecessor, instruction_t* conditional){
+	basic_block_t* child = block;
+	basic_block_t* parent = predecessor;
+
+	while(parent != NULL && parent != child){
+		instruction_t* branch = parent->exit_statement;
+
+		if((child == block || child->predecessors.current_index == 1)
+			&& branch != NULL && branch->statement_type == THREE_ADDR_CODE_BRANCH_STMT
+			&& branch->if_block != branch->else_block){
+			instruction_t* earlier_conditional = get_branch_conditional(parent);
+
+			if(earlier_conditional != NULL && value_numbered_instructions_equal(earlier_conditional, conditional) == TRUE){
+				return get_conditional_status_for_successor(branch, child);
+			}
+		}
+
+		child = parent;
+		parent = parent->analysis->dominator_info.immediate_dominator;
+	}
+
+	return CONDITIONAL_UNKNOWN;
+}
+
+
+/**
+ * Send the predecessor straight to the target instead of through the block. If the block does anything that
+ * has to happen on every path, the predecessor goes through its own copy of the block instead. Uses of the
+ * block's phi functions in that copy are given whatever comes in from the predecessor
+ */
+static void thread_jump(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, basic_block_t* block, basic_block_t* predecessor,
+						basic_block_t* target, u_int8_t needs_copy){
+	basic_block_t* replacement = target;
+
+	if(needs_copy == TRUE){
+		//The created block list is shared by every function
+		pthread_mutex_lock(&created_blocks_mutex);
+		replacement = basic_block_alloc_in_function(cfg_reference, block->function_defined_in, predecessor->estimated_execution_frequency);
+		pthread_mutex_unlock(&created_blocks_mutex);
+
+		//Every variable slot could be a new temp, so this never needs to grow
+		u_int32_t mapping_max_size = 1;
+		for(instruction_t* cursor = block->leader_statement; cursor != block->exit_statement; cursor = cursor->next_statement){
+			mapping_max_size += 5 + cursor->parameters.current_index;
+		}
+
+		temporary_variable_mapping_t* mapping = calloc(mapping_max_size, sizeof(temporary_variable_mapping_t));
+		u_int32_t mapping_current_index = 0;
+
+		for(instruction_t* cursor = block->leader_statement; cursor != block->exit_statement; cursor = cursor->next_statement){
+			if(cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+				continue;
+			}
+
+			instruction_t* copy = clone_instruction(cursor, mapping, &mapping_current_index, &mapping_max_size);
+
+			//Anything that came from a phi function now comes straight from the predecessor
+			three_addr_var_t** slots[] = {&(copy->operands.oir.operand1), &(copy->operands.oir.operand2),
+										  &(copy->operands.oir.address_operand1), &(copy->operands.oir.address_operand2)};
+
+			for(instruction_t* phi_function = block->leader_statement; phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC; phi_function = phi_function->next_statement){
+				three_addr_var_t* parameter = NULL;
+
+				for(u_int32_t i = 0; i < sizeof(slots) / sizeof(slots[0]); i++){
+					if(variables_equal(*(slots[i]), phi_function->operands.oir.assignee) == TRUE){
+						if(parameter == NULL){
+							parameter = get_phi_parameter_from_predecessor(function_blocks, function_entry_block, phi_function, predecessor);
+						}
+
+						*(slots[i]) = emit_var_copy(parameter);
+					}
+				}
+
+				for(int32_t i = 0; i < copy->parameters.current_index; i++){
+					if(variables_equal(dynamic_array_get_at(&(copy->parameters), i), phi_function->operands.oir.assignee) == TRUE){
+						if(parameter == NULL){
+							parameter = get_phi_parameter_from_predecessor(function_blocks, function_entry_block, phi_function, predecessor);
+						}
+
+						dynamic_array_set_at(&(copy->parameters), emit_var_copy(parameter), i);
+					}
+				}
+			}
+
+			add_statement(replacement, copy);
+		}
+
+		free(mapping);
+
+		emit_jump(replacement, target);
+	}
+
+	redirect_block_exit(predecessor, block, replacement);
+
+	//A branch whose sides now go to the same place is just a jump
+	instruction_t* exit_statement = predecessor->exit_statement;
+	if(exit_statement->statement_type == THREE_ADDR_CODE_BRANCH_STMT && exit_statement->if_block == exit_statement->else_block){
+		delete_statement(exit_statement);
+		emit_jump(predecessor, replacement);
+	}
+
+	/**
+	 * Anything that the predecessor defined for the block's phi functions can't come in anymore, unless it
+	 * still gets there through some other predecessor that the predecessor dominates
+	 */
+	for(int32_t i = 0; i < block->predecessors.current_index; i++){
+		if(does_block_dominate(predecessor, dynamic_array_get_at(&(block->predecessors), i)) == TRUE){
+			return;
+		}
+	}
+
+	remediate_phi_functions(block, predecessor);
+}
+
+
+/**
+ * Find one predecessor of the block that we already know the way out of, and thread it. Gives back
+ * TRUE if we did
+ */
+static u_int8_t jump_thread_block(dynamic_array_t* function_blocks, basic_block_t* function_entry_block, basic_block_t* block){
+	instruction_t* branch = block->exit_statement;
+
+	if(branch == NULL || branch->statement_type != THREE_ADDR_CODE_BRANCH_STMT || branch->if_block == branch->else_block
+		|| block->block_type == BLOCK_TYPE_FUNC_ENTRY){
+		return FALSE;
+	}
+
+	instruction_t* conditional = get_branch_conditional(block);
+
+	if(conditional == NULL){
+		return FALSE;
+	}
+
+	//Loop headers are left alone so that we never mess with the shape of a loop
+	for(int32_t i = 0; i < block->predecessors.current_index; i++){
+		if(does_block_dominate(block, dynamic_array_get_at(&(block->predecessors), i)) == TRUE){
+			return FALSE;
+		}
+	}
+
+	//Only worked out once we have a predecessor that we could thread
+	u_int8_t checked = FALSE;
+	u_int8_t needs_copy = FALSE;
+
+	for(int32_t i = 0; i < block->predecessors.current_index; i++){
+		basic_block_t* predecessor = dynamic_array_get_at(&(block->predecessors), i);
+		instruction_t* exit_statement = predecessor->exit_statement;
+
+		//We only know how to redirect jumps and branches
+		if(exit_statement == NULL || predecessor->jump_table != NULL
+			|| (exit_statement->statement_type != THREE_ADDR_CODE_JUMP_STMT && exit_statement->statement_type != THREE_ADDR_CODE_BRANCH_STMT)
+			|| (exit_statement->statement_type == THREE_ADDR_CODE_BRANCH_STMT && exit_statement->if_block == exit_statement->else_block)){
+			continue;
+		}
+
+		conditional_status_t status = get_phi_input_conditional_status(function_blocks, function_entry_block, block, predecessor, conditional);
+
+		if(status == CONDITIONAL_UNKNOWN){
+			status = get_dominating_conditional_status(block, predecessor, conditional);
+		}
+
+		if(status == CONDITIONAL_UNKNOWN){
+			continue;
+		}
+
+		if(checked == FALSE){
+			if(can_block_be_jump_threaded(function_blocks, block, &needs_copy) == FALSE){
+				return FALSE;
+			}
+
+			checked = TRUE;
+		}
+
+		//A copy can only be made if we know what every phi function used in it has coming in
+		if(needs_copy == TRUE){
+			u_int8_t parameters_known = TRUE;
+
+			for(instruction_t* phi_function = block->leader_statement; phi_function->statement_type == THREE_ADDR_CODE_PHI_FUNC; phi_function = phi_function->next_statement){
+				if(get_phi_parameter_from_predecessor(function_blocks, function_entry_block, phi_function, predecessor) == NULL){
+					parameters_known = FALSE;
+					break;
+				}
+			}
+
+			if(parameters_known == FALSE){
+				continue;
+			}
+		}
+
+		//Where does this predecessor always end up?
+		basic_block_t* target;
+		if(status == CONDITIONAL_ALWAYS_TRUE){
+			target = branch->inverse_branch == FALSE ? branch->if_block : branch->else_block;
+		} else {
+			target = branch->inverse_branch == FALSE ? branch->else_block : branch->if_block;
+		}
+
+		thread_jump(function_blocks, function_entry_block, block, predecessor, target, needs_copy);
+
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Jump threading. optimize_always_true_false_paths can only fold a branch whose conditional is known in its
+ * own block. Quite often though, the way out of a block is only known for some of the ways in:
+ *
+ * 	if(x > 5){			//.L1
+ * 		@log(x);
+ * 	}
+ *
+ * 	if(x > 5){			//.L3 - coming from the call we know this is true, otherwise it's false
+ * 		...
+ * 	}
+ *
+ * The same goes for a flag that is set to a constant in a predecessor and then tested. For every predecessor that
+ * we know the way out for, we send it straight to where it'll end up. If the block does something that has to
+ * happen on the way, the predecessor gets its own copy of the block to go through. This only works on small blocks
+ * whose values are never used anywhere else, so nothing past the block can tell which way we came. Loop headers
+ * are never threaded
+ *
+ * Every time that a jump is threaded the control flow relations are brought back up to date, since the next one
+ * relies on the dominator tree. Gives back TRUE if anything was threaded
+ */
+static u_int8_t thread_jumps(basic_block_t* function_entry_block, basic_block_t* function_exit_block, dynamic_array_t* function_blocks){
+	u_int8_t changed = FALSE;
+
+	for(u_int32_t threaded = 0; threaded < JUMP_THREADING_MAX_THREADS; threaded++){
+		u_int8_t found = FALSE;
+
+		for(int32_t i = 0; i < function_blocks->current_index; i++){
+			if(jump_thread_block(function_blocks, function_entry_block, dynamic_array_get_at(function_blocks, i)) == TRUE){
+				found = TRUE;
+				break;
+			}
+		}
+
+		if(found == FALSE){
+			break;
+		}
+
+		changed = TRUE;
+
+		//The block may not have anything left coming into it
+		delete_all_unreachable_blocks(function_entry_block, function_blocks, NULL);
+		recompute_all_control_flow_relations_for_function(function_blocks, function_entry_block, function_exit_block);
+	}
+
+	return changed;
+}
+
+
+/**
+ * Everything that we need to hang onto while we copy a callee's body into a caller. Every
+ * variable object in the callee gets exactly one replacement object, so any variable that was
+ * shared between instructions(and with it, its use count) is still shared in the copy. On top of
+ * that, temporary variables are renumbered and local variables get brand new symtab records,
+ * because every inlined copy needs its own live ranges
+ */
+typedef struct inlining_context_t{
+	//The function that we're inlining into
+	symtab_function_record_t* caller;
+	//Are we making a specialized copy of a function? If so, its parameters stay as parameters
+	u_int8_t keeps_parameters;
+	//Variable object -> replacement object
+	dynamic_array_t source_variables;
+	dynamic_array_t replacement_variables;
+	//Local variable record -> replacement record
+	dynamic_array_t source_records;
+	dynamic_array_t replacement_records;
+	//The temp var numbers that we've already renumbered. We store the replacements
+	//alongside of them
+	temporary_variable_mapping_t* temp_mapping;
+	u_int32_t temp_mapping_current_index;
+	u_int32_t temp_mapping_max_size;
+} inlining_context_t;
+
+
+/**
+ * Find the replacement record for a local variable of the callee, creating one
+ * if we haven't seen this variable yet
+ */
+static symtab_variable_record_t* get_inlined_variable_record(inlining_context_t* context, symtab_variable_record_t* record){
+	//Have we already made one?
+	for(int32_t i = 0; i < context->source_records.current_index; i++){
+		if(context->source_records.internal_array[i] == record){
+			return context->replacement_records.internal_array[i];
+		}
+	}
+
+	//Otherwise this is our first time seeing it, so we'll make a brand new record in the caller
+	symtab_variable_record_t* replacement = create_ssa_compatible_temp_var(context->caller, record->type_defined_as, cfg_reference->variable_symtab, increment_and_get_temp_id());
+
+	//The generations are copied over verbatim, so the counter needs to match
+	replacement->ssa_counter = record->ssa_counter;
+
+	dynamic_array_add(&(context->source_records), record);
+	dynamic_array_add(&(context->replacement_records), replacement);
+
+	return replacement;
+}
+
+
+/**
+ * Get the new temp var number for a callee temp var number, handing out
+ * a fresh one if this is the first time that we've seen it
+ */
+static u_int32_t get_inlined_temp_var_number(inlining_context_t* context, three_addr_var_t* variable){
+	//Have we already renumbered it?
+	for(u_int32_t i = 0; i < context->temp_mapping_current_index; i++){
+		if(context->temp_mapping[i].source_temp_var_id == variable->temp_var_number){
+			return context->temp_mapping[i].replacement_var->temp_var_number;
+		}
+	}
+
+	//Dynamically reup this if we need to
+	if(context->temp_mapping_current_index == context->temp_mapping_max_size){
+		context->temp_mapping_max_size *= 2;
+		context->temp_mapping = realloc(context->temp_mapping, sizeof(temporary_variable_mapping_t) * context->temp_mapping_max_size);
+	}
+
+	//We only need the number, but we'll still keep a var around to hold it
+	three_addr_var_t* replacement_var = emit_var_copy(variable);
+	replacement_var->temp_var_number = increment_and_get_temp_id();
+
+	context->temp_mapping[context->temp_mapping_current_index].source_temp_var_id = variable->temp_var_number;
+	context->temp_mapping[context->temp_mapping_current_index].replacement_var = replacement_var;
+	context->temp_mapping_current_index++;
+
+	return replacement_var->temp_var_number;
+}
+
+
+/**
+ * Clone a variable out of the callee for use in the caller
+ */
+static three_addr_var_t* clone_variable_for_inlining(inlining_context_t* context, three_addr_var_t* variable){
+	//Nothing to clone
+	if(variable == NULL){
+		return NULL;
+	}
+
+	//These are unique objects that everything compares against by pointer, so they are never copied
+	if(variable == stack_pointer_variable || variable == instruction_pointer_variable){
+		return variable;
+	}
+
+	//If we've already cloned this exact object, then we'll give back the same copy
+	for(int32_t i = 0; i < context->source_variables.current_index; i++){
+		if(context->source_variables.internal_array[i] == variable){
+			return context->replacement_variables.internal_array[i];
+		}
+	}
+
+	//Start with a straight copy
+	three_addr_var_t* copy = emit_var_copy(variable);
+
+	switch(variable->variable_type){
+		//Temps just need a new number
+		case VARIABLE_TYPE_TEMP:
+			copy->temp_var_number = get_inlined_temp_var_number(context, variable);
+			break;
+
+		/**
+		 * Local variables(and the parameters) get moved over to their new
+		 * records. Globals and statics are shared by everyone, so they stay as they are
+		 */
+		case VARIABLE_TYPE_NON_TEMP:
+			if(variable->linked_var == NULL
+				|| variable->linked_var->membership == GLOBAL_VARIABLE
+				|| variable->linked_var->membership == STATIC_VARIABLE){
+				break;
+			}
+
+			copy->linked_var = get_inlined_variable_record(context, variable->linked_var);
+
+			//A specialized copy still takes its parameters in the same places
+			if(context->keeps_parameters == TRUE){
+				break;
+			}
+
+			//This is now just a regular local variable in the caller
+			copy->membership = NO_MEMBERSHIP;
+			copy->class_relative_parameter_order = 0;
+			break;
+
+		//Local constants, function addresses, etc. are the same everywhere
+		default:
+			break;
+	}
+
+	dynamic_array_add(&(context->source_variables), variable);
+	dynamic_array_add(&(context->replacement_variables), copy);
+
+	return copy;
+}
+
+
+/**
+ * Clone an instruction out of the callee for use in the caller. Any jump targets
+ * are left pointing at the callee's blocks, the caller is responsible for remapping them
+ */
+static instruction_t* clone_instruction_for_inlining(inlining_context_t* context, instruction_t* cloned){
+	//First we allocate
+	instruction_t* copy = calloc(1, sizeof(instruction_t));
+
+	//Perform a complete memory copy
+	memcpy(copy, cloned, sizeof(instruction_t));
+
+	//Duplicate the variables
+	copy->operands.oir.assignee = clone_variable_for_inlining(context, cloned->operands.oir.assignee);
+	copy->operands.oir.operand1 = clone_variable_for_inlining(context, cloned->operands.oir.operand1);
+	copy->operands.oir.operand2 = clone_variable_for_inlining(context, cloned->operands.oir.operand2);
+	copy->operands.oir.address_operand1 = clone_variable_for_inlining(context, cloned->operands.oir.address_operand1);
+	copy->operands.oir.address_operand2 = clone_variable_for_inlining(context, cloned->operands.oir.address_operand2);
+	copy->operands.oir.rip_offset_var = clone_variable_for_inlining(context, cloned->operands.oir.rip_offset_var);
+	copy->relies_on = clone_variable_for_inlining(context, cloned->relies_on);
+	copy->operands.oir.constant_operand = clone_constant(cloned->operands.oir.constant_operand);
+	copy->operands.oir.address_offset = clone_constant(cloned->operands.oir.address_offset);
+
+	//Function call parameters and phi function parameters
+	if(cloned->parameters.internal_array != NULL){
+		copy->parameters = dynamic_array_alloc();
+
+		for(int32_t i = 0; i < cloned->parameters.current_index; i++){
+			dynamic_array_add(&(copy->parameters), clone_variable_for_inlining(context, dynamic_array_get_at(&(cloned->parameters), i)));
+		}
+	}
+
+	//One more reference to any local constant. Constants are shared between functions, so this must be atomic
+	three_addr_var_t* local_constant_var = copy->operands.oir.rip_offset_var;
+	if(local_constant_var != NULL && local_constant_var->variable_type == VARIABLE_TYPE_LOCAL_CONSTANT){
+		__atomic_add_fetch(&(local_constant_var->associated_memory_region.local_constant->reference_count), 1, __ATOMIC_RELAXED);
+	}
+
+	//IMPORTANT: null out the next/previous for the instruction
+	copy->next_statement = NULL;
+	copy->previous_statement = NULL;
+	copy->block_contained_in = NULL;
+	copy->mark = FALSE;
+
+	return copy;
+}
+
+
+/**
+ * Is there anything in this variable that stops its function from being
+ * inlined? Anything that lives on the stack is tied to the callee's frame
+ */
+static inline u_int8_t is_variable_inlining_compatible(three_addr_var_t* variable){
+	if(variable == NULL){
+		return TRUE;
+	}
+
+	switch(variable->variable_type){
+		case VARIABLE_TYPE_MEMORY_ADDRESS:
+		case VARIABLE_TYPE_STACK_PARAM_MEMORY_ADDRESS:
+		case VARIABLE_TYPE_RETURN_BY_COPY_ADDRESS:
+			return FALSE;
+		default:
+			return TRUE;
+	}
+}
+
+
+/**
+ * Determine whether or not a call may be inlined. We need the callee's body
+ * to be something that we are able to copy verbatim, and it needs to fit
+ * inside of our size budget:
+ *
+ * 	1.) Functions marked as inline are a strong hint, and get INLINE_FUNCTION_MAX_INSTRUCTIONS
+ * 	2.) Unmarked functions must be leaf functions(they call nothing), and get LEAF_FUNCTION_MAX_INSTRUCTIONS.
+ * 		We also won't grow a caller past INLINING_MAX_CALLER_INSTRUCTIONS with these, or inline them
+ * 		at calls that a profile says never happened
+ *
+ * Recursion can't happen here. The parser rejects recursive inline functions and leaf
+ * functions call nothing at all
+ */
+static u_int8_t is_call_inlining_candidate(instruction_t* call, symtab_function_record_t* caller, u_int32_t caller_instruction_count){
+	symtab_function_record_t* callee = call->called_function;
+
+	//Can't copy something that has no body
+	if(callee == NULL || callee == caller || callee->function_entry_block == NULL){
+		return FALSE;
+	}
+
+	//Anything that needs the callee's own frame is out
+	function_type_t* signature = callee->signature->internal_types.function_type;
+	if(signature->raises_errors == TRUE
+		|| signature->returns_by_copy == TRUE
+		|| signature->contains_stack_params == TRUE
+		|| signature->contains_elaborative_stack_param == TRUE
+		|| callee->local_stack.stack_regions.current_index != 0
+		|| callee->stack_passed_parameters.stack_regions.current_index != 0){
+		return FALSE;
+	}
+
+	//Every argument needs a parameter to go into
+	if(call->parameters.current_index != callee->function_parameters.current_index){
+		return FALSE;
+	}
+
+	//Select our budget
+	u_int32_t budget;
+	if(signature->is_inlined == TRUE){
+		budget = INLINE_FUNCTION_MAX_INSTRUCTIONS;
+	} else {
+		if(caller_instruction_count > INLINING_MAX_CALLER_INSTRUCTIONS){
+			return FALSE;
+		}
+
+		//The profile(--profile-use) says that this call never happened, so there's nothing to gain
+		if(((basic_block_t*)(call->block_contained_in))->estimated_execution_frequency == 0){
+			return FALSE;
+		}
+
+		budget = LEAF_FUNCTION_MAX_INSTRUCTIONS;
+	}
+
+	u_int32_t instruction_count = 0;
+	u_int32_t return_count = 0;
+
+	//Run through the entire body
+	for(int32_t i = 0; i < callee->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(callee->function_blocks), i);
+
+		//The exit block needs to be empty, and only reached by returns
+		if(block->block_type == BLOCK_TYPE_FUNC_EXIT){
+			if(block->leader_statement != NULL){
+				return FALSE;
+			}
+
+			for(int32_t j = 0; j < block->predecessors.current_index; j++){
+				basic_block_t* predecessor = dynamic_array_get_at(&(block->predecessors), j);
+
+				if(predecessor->exit_statement == NULL || predecessor->exit_statement->statement_type != THREE_ADDR_CODE_RET_STMT){
+					return FALSE;
+				}
+			}
+
+			continue;
+		}
+
+		//Add these all up
+		instruction_count += block->number_of_instructions;
+
+		//Too big
+		if(instruction_count > budget){
+			return FALSE;
+		}
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			switch(cursor->statement_type){
+				//None of these can be moved into another function's frame
+				case THREE_ADDR_CODE_RAISE_STMT:
+				case THREE_ADDR_CODE_INDIRECT_JUMP_STMT:
+				case THREE_ADDR_CODE_ASM_INLINE_STMT:
+				case THREE_ADDR_CODE_STACK_ALLOCATION_STMT:
+				case THREE_ADDR_CODE_STACK_DEALLOCATION_STMT:
+				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+				case THREE_ADDR_CODE_ELABORATIVE_PARAM_OFFSET:
+				case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+					return FALSE;
+
+				//Leaf functions can't call anything, and nobody can call something that raises errors
+				case THREE_ADDR_CODE_FUNC_CALL:
+				case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+					if(signature->is_inlined == FALSE || cursor->optional_storage.error_assignee != NULL){
+						return FALSE;
+					}
+
+					break;
+
+				case THREE_ADDR_CODE_RET_STMT:
+					return_count++;
+					break;
+
+				default:
+					break;
+			}
+
+			if(is_variable_inlining_compatible(cursor->operands.oir.assignee) == FALSE
+				|| is_variable_inlining_compatible(cursor->operands.oir.operand1) == FALSE
+				|| is_variable_inlining_compatible(cursor->operands.oir.operand2) == FALSE
+				|| is_variable_inlining_compatible(cursor->operands.oir.address_operand1) == FALSE
+				|| is_variable_inlining_compatible(cursor->operands.oir.address_operand2) == FALSE){
+				return FALSE;
+			}
+
+			for(int32_t j = 0; j < cursor->parameters.current_index; j++){
+				if(is_variable_inlining_compatible(dynamic_array_get_at(&(cursor->parameters), j)) == FALSE){
+					return FALSE;
+				}
+			}
+		}
+	}
+
+	//If we never return, there's nothing to merge into
+	if(return_count == 0){
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Inline the given call. The block that holds the call is split in two:
+ *
+ * 	pre:	everything before the call
+ * 		param_1 <- arg_1
+ * 		...
+ * 		jmp <copy of callee entry>
+ *
+ * 	<copy of the callee's body, where every "ret x" becomes "result_n <- x; jmp post">
+ *
+ * 	post:	result <- PHI(result_1, ..., result_n)
+ * 		assignee <- result
+ * 		everything after the call
+ *
+ * Returns the number of instructions that the caller grew by
+ */
+static u_int32_t inline_call(instruction_t* call){
+	//Extract everything we need
+	basic_block_t* block = call->block_contained_in;
+	symtab_function_record_t* caller = block->function_defined_in;
+	symtab_function_record_t* callee = call->called_function;
+	three_addr_var_t* assignee = call->operands.oir.assignee;
+	u_int32_t line_number = call->line_number;
+	u_int32_t growth = 0;
+
+	//The context for all of our cloning
+	inlining_context_t context;
+	context.caller = caller;
+	context.keeps_parameters = FALSE;
+	context.source_variables = dynamic_array_alloc();
+	context.replacement_variables = dynamic_array_alloc();
+	context.source_records = dynamic_array_alloc();
+	context.replacement_records = dynamic_array_alloc();
+	context.temp_mapping_max_size = 20;
+	context.temp_mapping = calloc(context.temp_mapping_max_size, sizeof(temporary_variable_mapping_t));
+	context.temp_mapping_current_index = 0;
+
+	/**
+	 * The post block takes over everything after the call, including all of
+	 * the block's successors. It's reached on every path that the pre block was,
+	 * so it inherits the assigned set too. That way any phi functions in the successors
+	 * still see their variables coming in from this edge
+	 */
+	basic_block_t* post = basic_block_alloc_in_function(cfg_reference, caller, block->estimated_execution_frequency);
+	post->analysis->assigned_variables = clone_dynamic_array(&(block->analysis->assigned_variables));
+	post->successors = block->successors;
+	block->successors = dynamic_array_alloc();
+
+	//The successors now come from post instead
+	for(int32_t i = 0; i < post->successors.current_index; i++){
+		basic_block_t* successor = dynamic_array_get_at(&(post->successors), i);
+
+		for(int32_t j = 0; j < successor->predecessors.current_index; j++){
+			if(successor->predecessors.internal_array[j] == block){
+				successor->predecessors.internal_array[j] = post;
+			}
+		}
+	}
+
+	//Any jump table goes along with the jump that uses it
+	if(block->jump_table != NULL){
+		post->jump_table = block->jump_table;
+		post->block_type = block->block_type;
+		block->jump_table = NULL;
+		block->block_type = (block->block_type == BLOCK_TYPE_FUNC_ENTRY) ? BLOCK_TYPE_FUNC_ENTRY : BLOCK_TYPE_NORMAL;
+	}
+
+	/**
+	 * Each parameter gets its own variable in the caller, and the arguments are
+	 * moved into them right where the call used to be. The parameter records are seeded into
+	 * the context so that every use of them in the body picks up the new ones
+	 */
+	for(int32_t i = 0; i < callee->function_parameters.current_index; i++){
+		symtab_variable_record_t* parameter = dynamic_array_get_at(&(callee->function_parameters), i);
+		three_addr_var_t* argument = dynamic_array_get_at(&(call->parameters), i);
+
+		symtab_variable_record_t* replacement = create_ssa_compatible_temp_var(caller, parameter->type_defined_as, cfg_reference->variable_symtab, increment_and_get_temp_id());
+		replacement->ssa_counter = 1;
+
+		dynamic_array_add(&(context.source_records), parameter);
+		dynamic_array_add(&(context.replacement_records), replacement);
+
+		three_addr_var_t* parameter_var = emit_var(replacement);
+		parameter_var->ssa_generation = 1;
+
+		instruction_t* parameter_assignment = emit_assignment_instruction(parameter_var, argument, line_number);
+		insert_instruction_before_given(parameter_assignment, call);
+		dynamic_array_add(&(block->analysis->assigned_variables), parameter_var);
+		growth++;
+	}
+
+	//Everything after the call now belongs to post
+	if(call->next_statement != NULL){
+		bisect_block(post, call->next_statement);
+	}
+
+	//The call itself is gone
+	delete_statement(call);
+
+	/**
+	 * Copy every block in the callee except for the exit block. We index the copies
+	 * by the callee's dense block indices
+	 */
+	basic_block_t* callee_entry = callee->function_entry_block;
+	basic_block_t** copies = calloc(callee->number_of_block_indices, sizeof(basic_block_t*));
+
+	for(int32_t i = 0; i < callee->function_blocks.current_index; i++){
+		basic_block_t* callee_block = dynamic_array_get_at(&(callee->function_blocks), i);
+
+		if(callee_block->block_type == BLOCK_TYPE_FUNC_EXIT){
+			continue;
+		}
+
+		//Scale the frequency by how often the call site itself runs
+		u_int64_t frequency = (u_int64_t)callee_block->estimated_execution_frequency * block->estimated_execution_frequency;
+		if(callee_entry->estimated_execution_frequency > 1){
+			frequency /= callee_entry->estimated_execution_frequency;
+		}
+
+		if(frequency > UINT32_MAX){
+			frequency = UINT32_MAX;
+		}
+
+		basic_block_t* copy = basic_block_alloc_in_function(cfg_reference, caller, frequency);
+		copies[callee_block->function_block_index] = copy;
+
+		//The function entry has nothing special about it once it's inside of the caller
+		if(callee_block->block_type != BLOCK_TYPE_FUNC_ENTRY){
+			copy->block_type = callee_block->block_type;
+		}
+
+		//Copy over all of the instructions
+		for(instruction_t* cursor = callee_block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			add_statement(copy, clone_instruction_for_inlining(&context, cursor));
+			growth++;
+		}
+
+		//And the assigned variables, for phi function maintenance
+		copy->analysis->assigned_variables = dynamic_array_alloc();
+		for(int32_t j = 0; j < callee_block->analysis->assigned_variables.current_index; j++){
+			three_addr_var_t* assigned = dynamic_array_get_at(&(callee_block->analysis->assigned_variables), j);
+			dynamic_array_add(&(copy->analysis->assigned_variables), clone_variable_for_inlining(&context, assigned));
+		}
+	}
+
+	//The pre block now runs straight into the callee's body
+	emit_jump(block, copies[callee_entry->function_block_index]);
+
+	//The return values get merged into this variable, if there are any
+	symtab_variable_record_t* result_record = NULL;
+	dynamic_array_t results = dynamic_array_alloc();
+	if(assignee != NULL){
+		result_record = create_ssa_compatible_temp_var(caller, assignee->type, cfg_reference->variable_symtab, increment_and_get_temp_id());
+	}
+
+	/**
+	 * Now that every copy exists, we can wire up the edges and jump targets. Any return
+	 * is rewritten into an assignment of the result followed by a jump to post
+	 */
+	for(int32_t i = 0; i < callee->function_blocks.current_index; i++){
+		basic_block_t* callee_block = dynamic_array_get_at(&(callee->function_blocks), i);
+
+		if(callee_block->block_type == BLOCK_TYPE_FUNC_EXIT){
+			continue;
+		}
+
+		basic_block_t* copy = copies[callee_block->function_block_index];
+
+		//Everything that's not the exit block maps over directly
+		for(int32_t j = 0; j < callee_block->successors.current_index; j++){
+			basic_block_t* successor = dynamic_array_get_at(&(callee_block->successors), j);
+
+			if(successor->block_type != BLOCK_TYPE_FUNC_EXIT){
+				add_successor(copy, copies[successor->function_block_index]);
+			}
+		}
+
+		//Redirect any jumps
+		instruction_t* exit = copy->exit_statement;
+		three_addr_var_t* returned;
+		if(exit == NULL){
+			continue;
+		}
+
+		switch(exit->statement_type){
+			case THREE_ADDR_CODE_JUMP_STMT:
+			case THREE_ADDR_CODE_BRANCH_STMT:
+				if(exit->if_block != NULL && copies[((basic_block_t*)(exit->if_block))->function_block_index] != NULL){
+					exit->if_block = copies[((basic_block_t*)(exit->if_block))->function_block_index];
+				}
+
+				if(exit->else_block != NULL && copies[((basic_block_t*)(exit->else_block))->function_block_index] != NULL){
+					exit->else_block = copies[((basic_block_t*)(exit->else_block))->function_block_index];
+				}
+
+				break;
+
+			case THREE_ADDR_CODE_RET_STMT:
+				returned = exit->operands.oir.operand1;
+				delete_statement(exit);
+				instruction_dealloc(exit);
+				growth--;
+
+				//Every return gets its own generation of the result
+				if(result_record != NULL && returned != NULL){
+					three_addr_var_t* result = emit_var(result_record);
+					result->ssa_generation = results.current_index + 1;
+					add_statement(copy, emit_assignment_instruction(result, returned, line_number));
+					dynamic_array_add(&(copy->analysis->assigned_variables), result);
+					dynamic_array_add(&results, result);
+					growth++;
+				}
+
+				emit_jump(copy, post);
+				growth++;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	//Now merge the results at the top of post
+	if(results.current_index > 0){
+		three_addr_var_t* merged;
+
+		//With one result there's nothing to merge
+		if(results.current_index == 1){
+			merged = dynamic_array_get_at(&results, 0);
+			result_record->ssa_counter = 1;
+
+		} else {
+			merged = emit_var(result_record);
+			merged->ssa_generation = results.current_index + 1;
+			result_record->ssa_counter = results.current_index + 1;
+
+			instruction_t* phi_function = calloc(1, sizeof(instruction_t));
+			phi_function->statement_type = THREE_ADDR_CODE_PHI_FUNC;
+			phi_function->operands.oir.assignee = merged;
+			phi_function->parameters = clone_dynamic_array(&results);
+			phi_function->line_number = line_number;
+
+			//This needs to be at the very top
+			if(post->leader_statement != NULL){
+				insert_instruction_before_given(phi_function, post->leader_statement);
+			} else {
+				add_statement(post, phi_function);
+			}
+
+			dynamic_array_add(&(post->analysis->assigned_variables), merged);
+			growth++;
+
+			//Use a fresh object for the assignment below
+			merged = emit_var(result_record);
+			merged->ssa_generation = results.current_index + 1;
+		}
+
+		//This is the one and only use of the merged result
+		merged->use_count = 1;
+
+		//The original assignee is set right after the phi function, if there is one
+		instruction_t* result_assignment = emit_assignment_instruction(assignee, merged, line_number);
+		instruction_t* after_phi = post->leader_statement;
+		while(after_phi != NULL && after_phi->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+			after_phi = after_phi->next_statement;
+		}
+
+		if(after_phi != NULL){
+			insert_instruction_before_given(result_assignment, after_phi);
+		} else {
+			add_statement(post, result_assignment);
+		}
+
+		growth++;
+	}
+
+	/**
+	 * Whatever the callee needed, the caller now needs as well. That's the
+	 * functions that it calls and its alignment requirements
+	 */
+	if(callee->requires_initial_alignment == TRUE){
+		caller->requires_initial_alignment = TRUE;
+	}
+
+	for(int32_t i = 0; i < callee->called_functions.current_index; i++){
+		dynamic_set_add(&(caller->called_functions), dynamic_set_get_at(&(callee->called_functions), i));
+	}
+
+	//Release everything
+	instruction_dealloc(call);
+	free(copies);
+	free(context.temp_mapping);
+	dynamic_array_dealloc(&results);
+	dynamic_array_dealloc(&(context.source_variables));
+	dynamic_array_dealloc(&(context.replacement_variables));
+	dynamic_array_dealloc(&(context.source_records));
+	dynamic_array_dealloc(&(context.replacement_records));
+
+	return growth;
+}
+
+
+/**
+ * Inline every call inside of the given function that we are able to. The blocks that inlining creates
+ * are added onto the end of the function's block array, so simply walking the array to the end will
+ * also process any calls that came in with the callee's body. Once we're done, all of the control relations
+ * are recomputed because the optimizer relies on them
+ */
+static void inline_calls_in_function(basic_block_t* function_entry_block, basic_block_t* function_exit_block){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+	dynamic_array_t* function_blocks = &(function->function_blocks);
+
+	//How large is the function right now?
+	u_int32_t instruction_count = 0;
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+		instruction_count += block->number_of_instructions;
+	}
+
+	u_int8_t changed = FALSE;
+
+	//Note that the array grows as we go
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(cursor->statement_type != THREE_ADDR_CODE_FUNC_CALL
+				|| is_call_inlining_candidate(cursor, function, instruction_count) == FALSE){
+				continue;
+			}
+
+			instruction_count += inline_call(cursor);
+			changed = TRUE;
+
+			//Everything after the call has been moved into a new block that we'll see later on
+			break;
+		}
+	}
+
+	if(changed == TRUE){
+		recompute_all_control_flow_relations_for_function(function_blocks, function_entry_block, function_exit_block);
+	}
+}
+
+
+/**
+ * Is this variable the given parameter, or something that we've already seen being derived
+ * from it? Every version of the parameter itself counts
+ */
+static u_int8_t is_parameter_derived_variable(symtab_variable_record_t* parameter, dynamic_array_t* derived, three_addr_var_t* variable){
+	if(variable == NULL){
+		return FALSE;
+	}
+
+	if(variable->variable_type == VARIABLE_TYPE_NON_TEMP && variable->linked_var == parameter){
+		return TRUE;
+	}
+
+	for(int32_t i = 0; i < derived->current_index; i++){
+		if(variables_equal(dynamic_array_get_at(derived, i), variable) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Does anything outside of the allowed slots in the instruction use the parameter
+ * or something derived from it?
+ */
+static u_int8_t does_instruction_capture_parameter(symtab_variable_record_t* parameter, dynamic_array_t* derived, instruction_t* instruction, u_int32_t allowed_slots){
+	if((allowed_slots & ADDRESS_USE_SLOT_BASE_ADDRESS) == 0 && is_parameter_derived_variable(parameter, derived, instruction->operands.oir.address_operand1) == TRUE){
+		return TRUE;
+	}
+
+	if((allowed_slots & ADDRESS_USE_SLOT_OPERAND1) == 0 && is_parameter_derived_variable(parameter, derived, instruction->operands.oir.operand1) == TRUE){
+		return TRUE;
+	}
+
+	if(is_parameter_derived_variable(parameter, derived, instruction->operands.oir.operand2) == TRUE
+		|| is_parameter_derived_variable(parameter, derived, instruction->operands.oir.address_operand2) == TRUE
+		|| is_parameter_derived_variable(parameter, derived, instruction->operands.oir.rip_offset_var) == TRUE
+		|| is_parameter_derived_variable(parameter, derived, instruction->relies_on) == TRUE){
+		return TRUE;
+	}
+
+	switch(instruction->statement_type){
+		case THREE_ADDR_CODE_FUNC_CALL:
+		case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+		case THREE_ADDR_CODE_PHI_FUNC:
+			if((allowed_slots & ADDRESS_USE_SLOT_PARAMETERS) != 0){
+				return FALSE;
+			}
+
+			for(int32_t i = 0; i < instruction->parameters.current_index; i++){
+				if(is_parameter_derived_variable(parameter, derived, dynamic_array_get_at(&(instruction->parameters), i)) == TRUE){
+					return TRUE;
+				}
+			}
+
+			return FALSE;
+
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Work out whether a function ever holds onto one of its parameters past the end of the call. Everything
+ * that is derived from the parameter by copies, pointer arithmetic and phi functions is found first. After
+ * that, the only things allowed to use any of them are loads, stores and calls to parameters that we already
+ * know don't capture. Anything else(returning it, storing it to memory, comparing it, etc.) captures it
+ *
+ * If the parameter is not captured, we also tell the caller whether it is ever written through
+ */
+static u_int8_t does_function_capture_parameter(symtab_function_record_t* function, symtab_variable_record_t* parameter, u_int8_t* written){
+	dynamic_array_t derived = dynamic_array_alloc();
+	u_int8_t captured = FALSE;
+	u_int8_t changed;
+
+	*written = FALSE;
+
+	//Find everything derived from the parameter. Loops can feed phi functions, so go until nothing changes
+	do {
+		changed = FALSE;
+
+		for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+			for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+				three_addr_var_t* assignee = cursor->operands.oir.assignee;
+				u_int8_t is_derived = FALSE;
+
+				if(assignee == NULL || is_parameter_derived_variable(parameter, &derived, assignee) == TRUE){
+					continue;
+				}
+
+				switch(cursor->statement_type){
+					case THREE_ADDR_CODE_ASSN_STMT:
+						is_derived = is_parameter_derived_variable(parameter, &derived, cursor->operands.oir.operand1);
+						break;
+
+					case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+					case THREE_ADDR_CODE_BIN_OP_STMT:
+						if(cursor->op == PLUS || cursor->op == MINUS){
+							is_derived = is_parameter_derived_variable(parameter, &derived, cursor->operands.oir.operand1);
+						}
+
+						break;
+
+					case THREE_ADDR_CODE_LEA_STMT:
+						is_derived = is_parameter_derived_variable(parameter, &derived, cursor->operands.oir.address_operand1);
+						break;
+
+					case THREE_ADDR_CODE_PHI_FUNC:
+						for(int32_t j = 0; j < cursor->parameters.current_index && is_derived == FALSE; j++){
+							is_derived = is_parameter_derived_variable(parameter, &derived, dynamic_array_get_at(&(cursor->parameters), j));
+						}
+
+						break;
+
+					default:
+						break;
+				}
+
+				if(is_derived == TRUE){
+					dynamic_array_add(&derived, assignee);
+					changed = TRUE;
+				}
+			}
+		}
+	} while(changed == TRUE);
+
+	//Now make sure that every use of them is one that we allow
+	for(int32_t i = 0; i < function->function_blocks.current_index && captured == FALSE; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL && captured == FALSE; cursor = cursor->next_statement){
+			u_int32_t allowed_slots = ADDRESS_USE_SLOT_NONE;
+
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_LOAD_STATEMENT:
+				case THREE_ADDR_CODE_LEA_STMT:
+					allowed_slots = ADDRESS_USE_SLOT_BASE_ADDRESS;
+					break;
+
+				case THREE_ADDR_CODE_STORE_STATEMENT:
+					if(is_parameter_derived_variable(parameter, &derived, cursor->operands.oir.address_operand1) == TRUE){
+						*written = TRUE;
+					}
+
+					allowed_slots = ADDRESS_USE_SLOT_BASE_ADDRESS;
+					break;
+
+				case THREE_ADDR_CODE_ASSN_STMT:
+					allowed_slots = ADDRESS_USE_SLOT_OPERAND1;
+					break;
+
+				case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+				case THREE_ADDR_CODE_BIN_OP_STMT:
+					if(cursor->op == PLUS || cursor->op == MINUS){
+						allowed_slots = ADDRESS_USE_SLOT_OPERAND1;
+					}
+
+					break;
+
+				case THREE_ADDR_CODE_PHI_FUNC:
+					allowed_slots = ADDRESS_USE_SLOT_PARAMETERS;
+					break;
+
+				//Passing it along is fine if the next callee doesn't capture it either
+				case THREE_ADDR_CODE_FUNC_CALL:
+					allowed_slots = ADDRESS_USE_SLOT_PARAMETERS;
+
+					for(int32_t j = 0; j < cursor->parameters.current_index; j++){
+						if(is_parameter_derived_variable(parameter, &derived, dynamic_array_get_at(&(cursor->parameters), j)) == FALSE){
+							continue;
+						}
+
+						if(cursor->called_function == NULL || j >= 32 || (cursor->called_function->non_capturing_parameters & (1U << j)) == 0){
+							captured = TRUE;
+						} else if((cursor->called_function->written_through_parameters & (1U << j)) != 0){
+							*written = TRUE;
+						}
+					}
+
+					break;
+
+				default:
+					break;
+			}
+
+			if(does_instruction_capture_parameter(parameter, &derived, cursor, allowed_slots) == TRUE){
+				captured = TRUE;
+			}
+		}
+	}
+
+	dynamic_array_dealloc(&derived);
+
+	return captured;
+}
+
+
+/**
+ * Work out which parameters of every function are never captured. A function can pass a parameter
+ * along to another one without capturing it, so we start off assuming that everything is captured and
+ * keep going until nothing new can be proven. Recursive cycles will stay captured, which is safe
+ *
+ * This reads every function's body, so it must be run before any of them are optimized
+ */
+static void summarize_parameter_captures(cfg_t* cfg){
+	u_int8_t changed;
+
+	do {
+		changed = FALSE;
+
+		for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+			basic_block_t* entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+			symtab_function_record_t* function = entry_block->function_defined_in;
+
+			//Parameters that come in on the stack are read out of memory, so we can't follow them
+			if(function->signature->internal_types.function_type->contains_stack_params == TRUE
+				|| function->signature->internal_types.function_type->contains_elaborative_stack_param == TRUE){
+				continue;
+			}
+
+			u_int32_t non_capturing_parameters = 0;
+			u_int32_t written_through_parameters = 0;
+
+			for(int32_t j = 0; j < function->function_parameters.current_index && j < 32; j++){
+				u_int8_t written;
+
+				if(does_function_capture_parameter(function, dynamic_array_get_at(&(function->function_parameters), j), &written) == TRUE){
+					continue;
+				}
+
+				non_capturing_parameters |= 1U << j;
+
+				if(written == TRUE){
+					written_through_parameters |= 1U << j;
+				}
+			}
+
+			if(non_capturing_parameters != function->non_capturing_parameters
+				|| written_through_parameters != function->written_through_parameters){
+				function->non_capturing_parameters = non_capturing_parameters;
+				function->written_through_parameters = written_through_parameters;
+				changed = TRUE;
+			}
+		}
+	} while(changed == TRUE);
+}
+
+
+/**
+ * Is this variable the given parameter itself(not its presaved copy)?
+ */
+static inline u_int8_t is_variable_parameter(three_addr_var_t* variable, symtab_variable_record_t* parameter){
+	return variable != NULL && variable->variable_type == VARIABLE_TYPE_NON_TEMP && variable->linked_var == parameter ? TRUE : FALSE;
+}
+
+
+/**
+ * Can a constant be swapped in for this parameter? Every parameter that lives in a register is copied into
+ * its presaved variable once at the top of the function, and that copy is the only thing that we're able
+ * to rewrite. If the parameter is used in any other way, we leave it alone
+ */
+static u_int8_t can_parameter_take_constant(symtab_function_record_t* function, symtab_variable_record_t* parameter){
+	if(parameter->stack_variable == TRUE || is_integer_type(parameter->type_defined_as) == FALSE){
+		return FALSE;
+	}
+
+	u_int32_t copies = 0;
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(is_variable_parameter(cursor->operands.oir.assignee, parameter) == TRUE
+				|| is_variable_parameter(cursor->operands.oir.operand2, parameter) == TRUE
+				|| is_variable_parameter(cursor->operands.oir.address_operand1, parameter) == TRUE
+				|| is_variable_parameter(cursor->operands.oir.address_operand2, parameter) == TRUE
+				|| is_variable_parameter(cursor->relies_on, parameter) == TRUE){
+				return FALSE;
+			}
+
+			for(int32_t j = 0; j < cursor->parameters.current_index; j++){
+				if(is_variable_parameter(dynamic_array_get_at(&(cursor->parameters), j), parameter) == TRUE){
+					return FALSE;
+				}
+			}
+
+			if(is_variable_parameter(cursor->operands.oir.operand1, parameter) == TRUE){
+				if(cursor->statement_type != THREE_ADDR_CODE_ASSN_STMT){
+					return FALSE;
+				}
+
+				copies++;
+			}
+		}
+	}
+
+	return copies > 0 ? TRUE : FALSE;
+}
+
+
+/**
+ * Swap the given constant in for every copy of the parameter. The copies become constant assignments
+ * that SCCP will take through the rest of the body
+ */
+static void propagate_constant_into_parameter(symtab_function_record_t* function, symtab_variable_record_t* parameter, int64_t value){
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+		instruction_t* cursor = block->leader_statement;
+
+		while(cursor != NULL){
+			//The cursor may be deleted
+			instruction_t* next = cursor->next_statement;
+
+			if(cursor->statement_type == THREE_ADDR_CODE_ASSN_STMT && is_variable_parameter(cursor->operands.oir.operand1, parameter) == TRUE){
+				replace_with_sccp_constant(cursor, normalize_sccp_value(value, cursor->operands.oir.assignee->type));
+			}
+
+			cursor = next;
+		}
+	}
+}
+
+
+/**
+ * Follow a call's argument back to the integer constant that it holds. Constants are usually
+ * moved into a temp right before the call, but they may go through a few copies first
+ */
+static u_int8_t get_constant_argument_value(symtab_function_record_t* caller, three_addr_var_t* argument, int64_t* value){
+	//A copy chain this long is not worth following
+	for(u_int32_t i = 0; i < 8; i++){
+		if(is_variable_sccp_trackable(argument) == FALSE){
+			return FALSE;
+		}
+
+		instruction_t* definition = find_variable_definition(&(caller->function_blocks), argument);
+
+		if(definition == NULL){
+			return FALSE;
+		}
+
+		switch(definition->statement_type){
+			case THREE_ADDR_CODE_ASSN_CONST_STMT:
+				if(is_integer_type(definition->operands.oir.assignee->type) == FALSE
+					|| get_sccp_constant_value(definition->operands.oir.constant_operand, value) == FALSE){
+					return FALSE;
+				}
+
+				*value = normalize_sccp_value(*value, definition->operands.oir.assignee->type);
+				return TRUE;
+
+			case THREE_ADDR_CODE_ASSN_STMT:
+				argument = definition->operands.oir.operand1;
+				break;
+
+			default:
+				return FALSE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Note down the function behind a function address variable. Any function whose address is taken
+ * can be called from places that we can't see
+ */
+static inline void add_address_taken_function(dynamic_array_t* address_taken, three_addr_var_t* variable){
+	if(variable == NULL || variable->variable_type != VARIABLE_TYPE_FUNCTION_ADDRESS){
+		return;
+	}
+
+	symtab_function_record_t* function = variable->associated_memory_region.rip_relative_function;
+
+	if(dynamic_array_contains(address_taken, function) == NOT_FOUND){
+		dynamic_array_add(address_taken, function);
+	}
+}
+
+
+/**
+ * Gather up every direct call in the program, along with every function whose address is taken
+ */
+static void collect_interprocedural_call_sites(cfg_t* cfg, dynamic_array_t* calls, dynamic_array_t* address_taken){
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		basic_block_t* entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+		symtab_function_record_t* function = entry_block->function_defined_in;
+
+		for(int32_t j = 0; j < function->function_blocks.current_index; j++){
+			basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), j);
+
+			for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+				if(cursor->statement_type == THREE_ADDR_CODE_FUNC_CALL && cursor->called_function != NULL){
+					dynamic_array_add(calls, cursor);
+				}
+
+				add_address_taken_function(address_taken, cursor->operands.oir.assignee);
+				add_address_taken_function(address_taken, cursor->operands.oir.operand1);
+				add_address_taken_function(address_taken, cursor->operands.oir.operand2);
+				add_address_taken_function(address_taken, cursor->operands.oir.address_operand1);
+				add_address_taken_function(address_taken, cursor->operands.oir.address_operand2);
+				add_address_taken_function(address_taken, cursor->operands.oir.rip_offset_var);
+
+				for(int32_t k = 0; k < cursor->parameters.current_index; k++){
+					add_address_taken_function(address_taken, dynamic_array_get_at(&(cursor->parameters), k));
+				}
+			}
+		}
+	}
+}
+
+
+/**
+ * Propagate any constant argument that every caller of a function agrees on into the function itself. This
+ * only works if we can see every caller, so public functions(which other modules may call) and functions whose
+ * address is taken are skipped
+ */
+static void propagate_agreed_constant_arguments(cfg_t* cfg, dynamic_array_t* calls, dynamic_array_t* address_taken){
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		basic_block_t* entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+		symtab_function_record_t* function = entry_block->function_defined_in;
+		function_type_t* signature = function->signature->internal_types.function_type;
+
+		if(function->visibility == VISIBILITY_TYPE_PUBLIC
+			|| dynamic_array_contains(address_taken, function) != NOT_FOUND
+			|| signature->contains_stack_params == TRUE
+			|| signature->contains_elaborative_stack_param == TRUE){
+			continue;
+		}
+
+		for(int32_t j = 0; j < function->function_parameters.current_index; j++){
+			symtab_variable_record_t* parameter = dynamic_array_get_at(&(function->function_parameters), j);
+
+			if(can_parameter_take_constant(function, parameter) == FALSE){
+				continue;
+			}
+
+			u_int32_t call_count = 0;
+			u_int8_t agreed = TRUE;
+			int64_t agreed_value = 0;
+
+			for(int32_t k = 0; k < calls->current_index && agreed == TRUE; k++){
+				instruction_t* call = dynamic_array_get_at(calls, k);
+				int64_t value;
+
+				if(call->called_function != function){
+					continue;
+				}
+
+				call_count++;
+
+				if(call->parameters.current_index != function->function_parameters.current_index
+					|| get_constant_argument_value(((basic_block_t*)(call->block_contained_in))->function_defined_in, dynamic_array_get_at(&(call->parameters), j), &value) == FALSE){
+					agreed = FALSE;
+					break;
+				}
+
+				value = normalize_sccp_value(value, parameter->type_defined_as);
+
+				if(call_count == 1){
+					agreed_value = value;
+				} else if(value != agreed_value){
+					agreed = FALSE;
+				}
+			}
+
+			if(agreed == TRUE && call_count > 0){
+				propagate_constant_into_parameter(function, parameter, agreed_value);
+			}
+		}
+	}
+}
+
+
+/**
+ * Is the given function something that we're able to make a specialized copy of? The copy is made the
+ * same way that the inliner copies a callee, so anything that ties the body to its own frame is out
+ */
+static u_int8_t is_function_specialization_candidate(symtab_function_record_t* function){
+	if(function->function_entry_block == NULL){
+		return FALSE;
+	}
+
+	function_type_t* signature = function->signature->internal_types.function_type;
+	if(signature->raises_errors == TRUE
+		|| signature->returns_by_copy == TRUE
+		|| signature->contains_stack_params == TRUE
+		|| signature->contains_elaborative_stack_param == TRUE
+		|| function->local_stack.stack_regions.current_index != 0
+		|| function->stack_passed_parameters.stack_regions.current_index != 0){
+		return FALSE;
+	}
+
+	u_int32_t instruction_count = 0;
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		//Jump tables would need copies of their own
+		if(block->jump_table != NULL){
+			return FALSE;
+		}
+
+		instruction_count += block->number_of_instructions;
+
+		if(instruction_count > SPECIALIZATION_MAX_INSTRUCTIONS){
+			return FALSE;
+		}
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_INDIRECT_JUMP_STMT:
+				case THREE_ADDR_CODE_ASM_INLINE_STMT:
+					return FALSE;
+				default:
+					break;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Has this variable been worked out to be a constant by the specialization estimate?
+ */
+static inline u_int8_t is_specialization_operand_known(dynamic_array_t* known, three_addr_var_t* variable){
+	if(variable == NULL){
+		return TRUE;
+	}
+
+	for(int32_t i = 0; i < known->current_index; i++){
+		if(variables_equal(dynamic_array_get_at(known, i), variable) == TRUE){
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Roughly how much of the function would fold away if the given parameters were constants? Every
+ * expression that only relies on constants counts once, and every branch that would be decided counts
+ * for SPECIALIZATION_BRANCH_BENEFIT, since one side of it goes away entirely. Phi functions are never
+ * assumed to be known
+ */
+static u_int32_t estimate_specialization_benefit(symtab_function_record_t* function, u_int32_t constant_parameters){
+	dynamic_array_t known = dynamic_array_alloc();
+	u_int32_t benefit = 0;
+
+	//Start with the copies of the constant parameters, and anything that was a constant anyways
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(cursor->statement_type == THREE_ADDR_CODE_ASSN_CONST_STMT){
+				dynamic_array_add(&known, cursor->operands.oir.assignee);
+				continue;
+			}
+
+			if(cursor->statement_type != THREE_ADDR_CODE_ASSN_STMT){
+				continue;
+			}
+
+			for(int32_t j = 0; j < function->function_parameters.current_index && j < 32; j++){
+				if((constant_parameters & (1U << j)) != 0
+					&& is_variable_parameter(cursor->operands.oir.operand1, dynamic_array_get_at(&(function->function_parameters), j)) == TRUE){
+					dynamic_array_add(&known, cursor->operands.oir.assignee);
+				}
+			}
+		}
+	}
+
+	//Keep going until nothing new folds
+	u_int8_t changed;
+	do {
+		changed = FALSE;
+
+		for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+			basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+			for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+				switch(cursor->statement_type){
+					case THREE_ADDR_CODE_BIN_OP_STMT:
+					case THREE_ADDR_CODE_BIN_OP_WITH_CONST_STMT:
+					case THREE_ADDR_CODE_SETNE_STMT:
+					case THREE_ADDR_CODE_INC_STMT:
+					case THREE_ADDR_CODE_DEC_STMT:
+					case THREE_ADDR_CODE_BITWISE_NOT_STMT:
+					case THREE_ADDR_CODE_LOGICAL_NOT_STMT:
+					case THREE_ADDR_CODE_ASSN_STMT:
+					case THREE_ADDR_CODE_NEG_STATEMENT:
+					case THREE_ADDR_CODE_TEST_IF_NOT_ZERO_STMT:
+						break;
+					default:
+						continue;
+				}
+
+				if((cursor->operands.oir.operand1 == NULL && cursor->operands.oir.operand2 == NULL)
+					|| is_specialization_operand_known(&known, cursor->operands.oir.assignee) == TRUE
+					|| is_specialization_operand_known(&known, cursor->operands.oir.operand1) == FALSE
+					|| is_specialization_operand_known(&known, cursor->operands.oir.operand2) == FALSE){
+					continue;
+				}
+
+				dynamic_array_add(&known, cursor->operands.oir.assignee);
+				benefit++;
+				changed = TRUE;
+			}
+		}
+	} while(changed == TRUE);
+
+	//Now count up the branches that get decided
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+		instruction_t* exit_statement = block->exit_statement;
+
+		if(exit_statement != NULL && exit_statement->statement_type == THREE_ADDR_CODE_BRANCH_STMT
+			&& exit_statement->relies_on != NULL
+			&& is_specialization_operand_known(&known, exit_statement->relies_on) == TRUE){
+			benefit += SPECIALIZATION_BRANCH_BENEFIT;
+		}
+	}
+
+	dynamic_array_dealloc(&known);
+
+	return benefit;
+}
+
+
+/**
+ * Make a private copy of the function with the given parameters fixed to constants. The body is copied
+ * block for block(exit block included) with the inliner's cloning, except that the parameters keep their
+ * places in the calling convention. Callers don't change what they pass, so the copy takes the exact same
+ * arguments as the original
+ */
+static symtab_function_record_t* specialize_function(cfg_t* cfg, symtab_function_record_t* function, u_int32_t constant_parameters, int64_t* values, u_int32_t specialization_id){
+	//The '.' keeps this from ever colliding with a name in the source
+	char* name_buffer = calloc(strlen(function->func_name.string) + 32, sizeof(char));
+	sprintf(name_buffer, "%s.specialized.%u", function->func_name.string, specialization_id);
+
+	dynamic_string_t name = dynamic_string_alloc();
+	dynamic_string_set(&name, name_buffer);
+	free(name_buffer);
+
+	symtab_function_record_t* specialized = create_function_record(&name, function->dependency_graph_node, VISIBILITY_TYPE_PRIVATE, FALSE, FALSE, function->line_number, function->token_index_of_definition);
+
+	//The copy has the exact same signature, except that nobody outside of this module can see it
+	*(specialized->signature->internal_types.function_type) = *(function->signature->internal_types.function_type);
+	specialized->signature->internal_types.function_type->visibility = VISIBILITY_TYPE_PRIVATE;
+	specialized->defined = TRUE;
+	specialized->called = TRUE;
+	specialized->requires_initial_alignment = function->requires_initial_alignment;
+
+	for(int32_t i = 0; i < function->called_functions.current_index; i++){
+		dynamic_set_add(&(specialized->called_functions), dynamic_set_get_at(&(function->called_functions), i));
+	}
+
+	//The context for all of our cloning
+	inlining_context_t context;
+	context.caller = specialized;
+	context.keeps_parameters = TRUE;
+	context.source_variables = dynamic_array_alloc();
+	context.replacement_variables = dynamic_array_alloc();
+	context.source_records = dynamic_array_alloc();
+	context.replacement_records = dynamic_array_alloc();
+	context.temp_mapping_max_size = 20;
+	context.temp_mapping = calloc(context.temp_mapping_max_size, sizeof(temporary_variable_mapping_t));
+	context.temp_mapping_current_index = 0;
+
+	//The parameters get their own records, but they still come in the same registers
+	for(int32_t i = 0; i < function->function_parameters.current_index; i++){
+		symtab_variable_record_t* parameter = dynamic_array_get_at(&(function->function_parameters), i);
+		symtab_variable_record_t* replacement = get_inlined_variable_record(&context, parameter);
+
+		replacement->membership = parameter->membership;
+		replacement->class_relative_function_parameter_order = parameter->class_relative_function_parameter_order;
+
+		dynamic_array_add(&(specialized->function_parameters), replacement);
+	}
+
+	//Copy every block, indexed by the original's dense block indices
+	basic_block_t** copies = calloc(function->number_of_block_indices, sizeof(basic_block_t*));
+	basic_block_t* exit_copy = NULL;
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+		basic_block_t* copy = basic_block_alloc_in_function(cfg, specialized, block->estimated_execution_frequency);
+		copies[block->function_block_index] = copy;
+
+		copy->block_type = block->block_type;
+		copy->case_stmt_val = block->case_stmt_val;
+
+		if(block->block_type == BLOCK_TYPE_FUNC_EXIT){
+			exit_copy = copy;
+		}
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			add_statement(copy, clone_instruction_for_inlining(&context, cursor));
+		}
+
+		//And the assigned variables, for phi function maintenance
+		copy->analysis->assigned_variables = dynamic_array_alloc();
+		for(int32_t j = 0; j < block->analysis->assigned_variables.current_index; j++){
+			dynamic_array_add(&(copy->analysis->assigned_variables), clone_variable_for_inlining(&context, dynamic_array_get_at(&(block->analysis->assigned_variables), j)));
+		}
+	}
+
+	//Now that every copy exists, the edges and jump targets can be wired up
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+		basic_block_t* copy = copies[block->function_block_index];
+
+		for(int32_t j = 0; j < block->successors.current_index; j++){
+			add_successor(copy, copies[((basic_block_t*)dynamic_array_get_at(&(block->successors), j))->function_block_index]);
+		}
+
+		if(block->direct_successor != NULL){
+			copy->direct_successor = copies[block->direct_successor->function_block_index];
+		}
+
+		instruction_t* exit_statement = copy->exit_statement;
+		if(exit_statement == NULL
+			|| (exit_statement->statement_type != THREE_ADDR_CODE_JUMP_STMT && exit_statement->statement_type != THREE_ADDR_CODE_BRANCH_STMT)){
+			continue;
+		}
+
+		if(exit_statement->if_block != NULL){
+			exit_statement->if_block = copies[((basic_block_t*)(exit_statement->if_block))->function_block_index];
+		}
+
+		if(exit_statement->else_block != NULL){
+			exit_statement->else_block = copies[((basic_block_t*)(exit_statement->else_block))->function_block_index];
+		}
+	}
+
+	basic_block_t* entry_copy = copies[((basic_block_t*)(function->function_entry_block))->function_block_index];
+	specialized->function_entry_block = entry_copy;
+
+	//This is now a function like any other, so the rest of the compiler will pick it up
+	dynamic_array_add(&(cfg->function_entry_blocks), entry_copy);
+	dynamic_array_add(&(cfg->function_exit_blocks), exit_copy);
+
+	//Finally the constants go in
+	for(int32_t i = 0; i < specialized->function_parameters.current_index && i < 32; i++){
+		if((constant_parameters & (1U << i)) != 0){
+			propagate_constant_into_parameter(specialized, dynamic_array_get_at(&(specialized->function_parameters), i), values[i]);
+		}
+	}
+
+	recompute_all_control_flow_relations_for_function(&(specialized->function_blocks), entry_copy, exit_copy);
+
+	//Release everything
+	free(copies);
+	free(context.temp_mapping);
+	dynamic_array_dealloc(&(context.source_variables));
+	dynamic_array_dealloc(&(context.replacement_variables));
+	dynamic_array_dealloc(&(context.source_records));
+	dynamic_array_dealloc(&(context.replacement_records));
+
+	return specialized;
+}
+
+
+/**
+ * A specialized copy of a function that we've already made
+ */
+typedef struct specialization_t{
+	//What we copied
+	symtab_function_record_t* original;
+	//The copy
+	symtab_function_record_t* specialized;
+	//The constants that went into it
+	int64_t* values;
+	//Which parameters are constants
+	u_int32_t constant_parameters;
+} specialization_t;
+
+
+/**
+ * Point hot calls that pass constants at specialized copies of their callees. A copy is only made if the
+ * constants would fold away enough of it to be worth the extra code. Calls that pass the same constants to
+ * the same function share a copy. Any calls that were already handled by propagating agreed arguments won't
+ * have anything left to specialize on
+ */
+static void specialize_hot_calls(cfg_t* cfg, dynamic_array_t* calls){
+	dynamic_array_t specializations = dynamic_array_alloc();
+
+	for(int32_t i = 0; i < calls->current_index; i++){
+		instruction_t* call = dynamic_array_get_at(calls, i);
+		basic_block_t* block = call->block_contained_in;
+		symtab_function_record_t* caller = block->function_defined_in;
+		symtab_function_record_t* callee = call->called_function;
+
+		//Recursive calls are left alone
+		if(callee == caller
+			|| block->estimated_execution_frequency < SPECIALIZATION_MIN_CALL_FREQUENCY
+			|| call->parameters.current_index != callee->function_parameters.current_index
+			|| is_function_specialization_candidate(callee) == FALSE){
+			continue;
+		}
+
+		//Which arguments are constants?
+		int64_t* values = calloc(callee->function_parameters.current_index, sizeof(int64_t));
+		u_int32_t constant_parameters = 0;
+
+		for(int32_t j = 0; j < callee->function_parameters.current_index && j < 32; j++){
+			symtab_variable_record_t* parameter = dynamic_array_get_at(&(callee->function_parameters), j);
+
+			if(can_parameter_take_constant(callee, parameter) == TRUE
+				&& get_constant_argument_value(caller, dynamic_array_get_at(&(call->parameters), j), &(values[j])) == TRUE){
+				values[j] = normalize_sccp_value(values[j], parameter->type_defined_as);
+				constant_parameters |= 1U << j;
+			} else {
+				values[j] = 0;
+			}
+		}
+
+		if(constant_parameters == 0){
+			free(values);
+			continue;
+		}
+
+		//Can we reuse one that we already have?
+		specialization_t* match = NULL;
+		for(int32_t j = 0; j < specializations.current_index && match == NULL; j++){
+			specialization_t* candidate = dynamic_array_get_at(&specializations, j);
+
+			if(candidate->original == callee && candidate->constant_parameters == constant_parameters
+				&& memcmp(candidate->values, values, callee->function_parameters.current_index * sizeof(int64_t)) == 0){
+				match = candidate;
+			}
+		}
+
+		if(match == NULL){
+			if(specializations.current_index >= SPECIALIZATION_MAX_CLONES
+				|| estimate_specialization_benefit(callee, constant_parameters) < SPECIALIZATION_MIN_BENEFIT){
+				free(values);
+				continue;
+			}
+
+			match = calloc(1, sizeof(specialization_t));
+			match->original = callee;
+			match->values = values;
+			match->constant_parameters = constant_parameters;
+			match->specialized = specialize_function(cfg, callee, constant_parameters, values, specializations.current_index);
+			dynamic_array_add(&specializations, match);
+
+		} else {
+			free(values);
+		}
+
+		//The call now goes to the copy
+		call->called_function = match->specialized;
+		match->specialized->called_by_count++;
+		dynamic_set_add(&(caller->called_functions), match->specialized);
+	}
+
+	for(int32_t i = 0; i < specializations.current_index; i++){
+		specialization_t* specialization = dynamic_array_get_at(&specializations, i);
+		free(specialization->values);
+		free(specialization);
+	}
+
+	dynamic_array_dealloc(&specializations);
+}
+
+
+/**
+ * Interprocedural constant propagation. This goes in two steps:
+ *
+ * 	1.) If every caller of a function passes the same constant for a parameter, that constant is put right
+ * 		into the function. SCCP and branch folding will take it from there when the function is optimized
+ * 	2.) Hot calls that pass constants which would fold away a good chunk of their callee are sent to a
+ * 		specialized copy of the callee that has those constants built in
+ *
+ * This reads and changes the bodies of other functions, so it must run before any of them are optimized
+ */
+static void propagate_interprocedural_constants(cfg_t* cfg){
+	dynamic_array_t calls = dynamic_array_alloc();
+	dynamic_array_t address_taken = dynamic_array_alloc();
+
+	collect_interprocedural_call_sites(cfg, &calls, &address_taken);
+
+	propagate_agreed_constant_arguments(cfg, &calls, &address_taken);
+
+	specialize_hot_calls(cfg, &calls);
+
+	dynamic_array_dealloc(&calls);
+	dynamic_array_dealloc(&address_taken);
+}
+
+
+/**
+ * What a function's own body does, apart from whatever the functions that it calls do
+ */
+typedef struct function_attribute_summary_t{
+	//The function itself
+	symtab_function_record_t* function;
+	//Every function that it calls directly
+	dynamic_array_t callees;
+	//Does the body write to any memory that its caller could see?
+	u_int8_t writes_visible_memory;
+	//Does the body read any memory that its caller could see?
+	u_int8_t reads_visible_memory;
+	//Indirect calls and inline assembly could be doing anything at all
+	u_int8_t has_unknown_effects;
+	//Is there a cycle anywhere in the control flow?
+	u_int8_t has_cycle;
+	//Is there a raise statement?
+	u_int8_t raises;
+} function_attribute_summary_t;
+
+
+/**
+ * Is this memory location a part of the function's own stack frame? Nothing outside of the
+ * function can see these once it has returned. Stack passed parameters are left out, since
+ * those are written by the caller
+ */
+static inline u_int8_t is_memory_location_in_own_frame(symtab_function_record_t* function, memory_location_t* location){
+	return location->base_type == MEMORY_BASE_STACK_OBJECT
+		&& location->variable != NULL
+		&& location->variable->function_declared_in == function
+		&& location->variable->membership != FUNCTION_PARAMETER ? TRUE : FALSE;
+}
+
+
+/**
+ * Note down what one memory access means for the function. Read-only constants never change, so
+ * reading them is the same as not reading memory at all
+ */
+static inline void summarize_memory_access(function_attribute_summary_t* summary, memory_location_t* location, u_int8_t is_write){
+	if(is_memory_location_in_own_frame(summary->function, location) == TRUE){
+		return;
+	}
+
+	if(is_write == TRUE){
+		summary->writes_visible_memory = TRUE;
+	} else if(location->base_type != MEMORY_BASE_READ_ONLY_CONSTANT){
+		summary->reads_visible_memory = TRUE;
+	}
+}
+
+
+/**
+ * Does the function's control flow have a cycle in it? We knock out every block that has no
+ * predecessors left(Kahn's algorithm). If anything can't be knocked out, it's on a cycle or
+ * only reachable from one
+ */
+static u_int8_t does_function_have_cycle(symtab_function_record_t* function){
+	u_int32_t* remaining_predecessors = calloc(function->number_of_block_indices, sizeof(u_int32_t));
+	dynamic_array_t worklist = dynamic_array_alloc();
+	int32_t removed_count = 0;
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		remaining_predecessors[block->function_block_index] = block->predecessors.current_index;
+
+		if(block->predecessors.current_index == 0){
+			dynamic_array_add(&worklist, block);
+		}
+	}
+
+	while(dynamic_array_is_empty(&worklist) == FALSE){
+		basic_block_t* block = dynamic_array_delete_from_back(&worklist);
+		removed_count++;
+
+		for(int32_t i = 0; i < block->successors.current_index; i++){
+			basic_block_t* successor = dynamic_array_get_at(&(block->successors), i);
+
+			remaining_predecessors[successor->function_block_index]--;
+
+			if(remaining_predecessors[successor->function_block_index] == 0){
+				dynamic_array_add(&worklist, successor);
+			}
+		}
+	}
+
+	free(remaining_predecessors);
+	dynamic_array_dealloc(&worklist);
+
+	return removed_count != function->function_blocks.current_index ? TRUE : FALSE;
+}
+
+
+/**
+ * Look over everything that a function's own body does
+ */
+static void summarize_function_body(function_attribute_summary_t* summary){
+	symtab_function_record_t* function = summary->function;
+	function_type_t* signature = function->signature->internal_types.function_type;
+	memory_location_t destination;
+	memory_location_t source;
+
+	summary->callees = dynamic_array_alloc();
+	summary->has_cycle = does_function_have_cycle(function);
+
+	//Parameters that come in on the stack are the caller's memory, so these read it no matter what
+	if(signature->contains_stack_params == TRUE || signature->contains_elaborative_stack_param == TRUE){
+		summary->reads_visible_memory = TRUE;
+	}
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			switch(cursor->statement_type){
+				case THREE_ADDR_CODE_LOAD_STATEMENT:
+				case THREE_ADDR_CODE_STORE_STATEMENT:
+					get_memory_location_for_instruction(cursor, &destination);
+					summarize_memory_access(summary, &destination, cursor->statement_type == THREE_ADDR_CODE_STORE_STATEMENT);
+					break;
+
+				case THREE_ADDR_CODE_MEMORY_COPY_STATEMENT:
+					get_memory_locations_for_memory_copy(cursor, &destination, &source);
+					summarize_memory_access(summary, &destination, TRUE);
+					summarize_memory_access(summary, &source, FALSE);
+					break;
+
+				//Region initializations are always of a local region
+				case THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION:
+					break;
+
+				//The counters are globals that the runtime writes out
+				case THREE_ADDR_CODE_PROFILE_COUNTER_STMT:
+					summary->writes_visible_memory = TRUE;
+					break;
+
+				case THREE_ADDR_CODE_FUNC_CALL:
+					if(cursor->called_function == NULL){
+						summary->has_unknown_effects = TRUE;
+					} else if(dynamic_array_contains(&(summary->callees), cursor->called_function) == NOT_FOUND){
+						dynamic_array_add(&(summary->callees), cursor->called_function);
+					}
+
+					break;
+
+				case THREE_ADDR_CODE_INDIRECT_FUNC_CALL:
+				case THREE_ADDR_CODE_ASM_INLINE_STMT:
+					summary->has_unknown_effects = TRUE;
+					break;
+
+				case THREE_ADDR_CODE_RAISE_STMT:
+					summary->raises = TRUE;
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+}
+
+
+/**
+ * Infer the pure, const, always returns, leaf and never raises attributes for every function. Whether
+ * a function is pure, const or always returns depends on the functions that it calls, so these go bottom
+ * up over the call graph: we start out assuming that nothing has them, and keep going until nothing new
+ * can be proven. A function picks one up once its own body allows it and every callee already has it. Callees
+ * in a recursive cycle never get there first, so every function in the cycle stays without them, which is safe
+ *
+ * This reads every function's body, so it must be run before any of them are optimized
+ */
+static void infer_function_attributes(cfg_t* cfg){
+	u_int32_t function_count = cfg->function_entry_blocks.current_index;
+	function_attribute_summary_t* summaries = calloc(function_count + 1, sizeof(function_attribute_summary_t));
+
+	for(u_int32_t i = 0; i < function_count; i++){
+		basic_block_t* entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+		function_attribute_summary_t* summary = &(summaries[i]);
+
+		summary->function = entry_block->function_defined_in;
+		summarize_function_body(summary);
+
+		//These only rely on the body itself
+		summary->function->is_leaf = summary->callees.current_index == 0 && summary->has_unknown_effects == FALSE;
+		summary->function->never_raises = summary->function->signature->internal_types.function_type->raises_errors == TRUE && summary->raises == FALSE;
+	}
+
+	u_int8_t changed;
+
+	do {
+		changed = FALSE;
+
+		for(u_int32_t i = 0; i < function_count; i++){
+			function_attribute_summary_t* summary = &(summaries[i]);
+			symtab_function_record_t* function = summary->function;
+
+			//Nothing can be said about these
+			if(summary->has_unknown_effects == TRUE){
+				continue;
+			}
+
+			u_int8_t callees_pure = TRUE;
+			u_int8_t callees_const = TRUE;
+			u_int8_t callees_return = TRUE;
+
+			for(int32_t j = 0; j < summary->callees.current_index; j++){
+				symtab_function_record_t* callee = dynamic_array_get_at(&(summary->callees), j);
+
+				callees_pure &= callee->is_pure;
+				callees_const &= callee->is_const;
+				callees_return &= callee->always_returns;
+			}
+
+			if(function->is_pure == FALSE && callees_pure == TRUE && summary->writes_visible_memory == FALSE){
+				function->is_pure = TRUE;
+				changed = TRUE;
+			}
+
+			if(function->is_const == FALSE && function->is_pure == TRUE && callees_const == TRUE && summary->reads_visible_memory == FALSE){
+				function->is_const = TRUE;
+				changed = TRUE;
+			}
+
+			if(function->always_returns == FALSE && callees_return == TRUE && summary->has_cycle == FALSE){
+				function->always_returns = TRUE;
+				changed = TRUE;
+			}
+		}
+	} while(changed == TRUE);
+
+	for(u_int32_t i = 0; i < function_count; i++){
+		dynamic_array_dealloc(&(summaries[i].callees));
+	}
+
+	free(summaries);
+}
+
+
+/**
+ * Inline every call that we're able to across the whole program
+ */
+static void inline_function_calls(cfg_t* cfg){
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		inline_calls_in_function(dynamic_array_get_at(&(cfg->function_entry_blocks), i), dynamic_array_get_at(&(cfg->function_exit_blocks), i));
+	}
+}
+
+
+/**
+ * Run every pass that works across function boundaries. Calls are inlined, constants are propagated
+ * into the calls that are left, and then we work out which parameters every function captures along
+ * with what attributes every function has. All of these read other function's bodies, so this must
+ * run by itself before any function is optimized
+ */
+void run_interprocedural_passes(cfg_t* cfg){
+	cfg_reference = cfg;
+
+	//Prepopulate these global variables so that we don't need to pass them around
+	stack_pointer_variable = cfg->stack_pointer;
+	instruction_pointer_variable = cfg->instruction_pointer;
+	set_alias_analysis_stack_pointer(cfg->stack_pointer);
+
+	inline_function_calls(cfg);
+
+	//Constants go into whatever calls were not inlined. This may add specialized functions
+	propagate_interprocedural_constants(cfg);
+
+	//The calls that are left are what scalar replacement has to reason about
+	summarize_parameter_captures(cfg);
+
+	//And what the optimizer is allowed to do with those calls
+	infer_function_attributes(cfg);
+}
+
+
+/**
+ * Run every optimization pass over a single function. Functions are independent units
+ * that do not have interlocking dependencies, so this may be run on a worker thread. All
+ * state that a function's optimization needs(the control flow update log, etc.) lives
+ * in here and not in the file-level globals
+ */
+static void optimize_function(void* shared_state, u_int32_t function_index){
+	//The shared state is just the CFG
+	cfg_t* cfg = shared_state;
+
+	/**
+	 * Every CFG edge edit that we make is logged here so that the dominance relations
+	 * can be updated incrementally instead of being recomputed from scratch
+	 */
+	control_flow_update_log_t control_flow_updates = control_flow_update_log_alloc();
+
+	//Extract the entry and exit blocks
+	basic_block_t* function_entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), function_index);
+	basic_block_t* function_exit_block = dynamic_array_get_at(&(cfg->function_exit_blocks), function_index);
+
+	//What function are we in?
+	symtab_function_record_t* current_function = function_entry_block->function_defined_in;
+
+	//The current function blocks are stored in the symtab
+	dynamic_array_t* current_function_blocks = &(current_function->function_blocks);
+
+	/**
+	 * Once we get here, we have an array that is full of all of the blocks belonging
+	 * to the function that we wish to optimize. Now we will go through all of the 
+	 * optimization steps for this function
+	 */
+
+	/**
+	 * PASS 0: Scalar replacement of aggregates
+	 * Any local aggregate that never has its address leak out is split up into separate variables. This
+	 * goes first so that everything after it gets to treat the fields like any other variable
+	 */
+	scalar_replace_aggregates(function_entry_block, current_function_blocks);
+
+	/**
+	 * PASS 0.5: Sparse conditional constant propagation
+	 * We run this before the rest so that mark and sweep gets to clean up after it. Any
+	 * branch that it found to always go one way is now a jump, so if that happened we have
+	 * unreachable blocks to delete and dominance relations to update before mark can run
+	 */
+	u_int8_t constant_branches_folded = sparse_conditional_constant_propagation(function_entry_block, function_exit_block, current_function_blocks, &control_flow_updates);
+
+	if(constant_branches_folded == TRUE){
+		delete_all_unreachable_blocks(function_entry_block, current_function_blocks, &control_flow_updates);
+		update_all_control_flow_relations_for_function(function_entry_block, function_exit_block, current_function_blocks, &control_flow_updates);
+	}
+
+	/**
+	 * Now we'll reset the visited status of the CFG. This just ensures
+	 * that we won't have any issues with the CFG in terms of traversal. This is
+	 * O(1) because the visited flags live in the function's side table
+	 */
+	reset_block_visits_for_function(current_function);
+
+	/**
+	 * PASS 1: Mark algorithm
+	 * The mark algorithm marks all useful operations. It will perform one full pass of the program
+	 */
+	mark(current_function_blocks);
+
+	/**
+	 * PASS 2: Sweep algorithm
+	 * Sweep follows directly after mark because it eliminates anything that is unmarked. If sweep
+	 * comes across branch ending statements that are unmarked, it will replace them with a jump to the
+	 * nearest marked postdominator
+	 */
+	sweep(current_function_blocks, function_entry_block, &control_flow_updates);
+
+	/**
+	 * PASS 3: always true/false optimization
+	 * Now that we've swept everything, let's figure out if there are
+	 * any branches that are always true or always false. We'll need to 
+	 * elminate these before we go through and do anything with conditional
+	 * movement
+	 */
+	u_int8_t found_branches_to_optimize = optimize_always_true_false_paths(current_function_blocks, &control_flow_updates);
+
+	/**
+	 * PASS 3.5: if we did find branches to optimize, we now potentially have a lot
+	 * of orphaned code that is no longer useful. This would not have been picked up by
+	 * the original mark and sweep, but it will be now. So, we will rerun mark/sweep
+	 * *if* we've found branches that were optimzied. Otherwise, this would just be a waste
+	 */
+	if(found_branches_to_optimize == TRUE){
+		//Reset all of the marks in the function
+		reset_all_marks(current_function);
+
+		/**
+		 * Optimizing branches and and then trying to run mark & sweep will not work because
+		 * we have fundamentally changed the structure & dominance in the CFG by doing
+		 * that. 
+		 *
+		 * We are going to need to delete all unreachable blocks *at this stage* and
+		 * then we are going to have to update all of the dominance relations. Mark
+		 * specifically relies on the "RDF"(reverse dominance frontier). Every edge
+		 * that we've touched since the last computation is in the log, so the graph
+		 * analyzer only needs to redo the parts of the dominator trees that changed
+		 */
+		delete_all_unreachable_blocks(function_entry_block, current_function_blocks, &control_flow_updates);
+
+		//Bring all dominance relations up to date
+		update_all_control_flow_relations_for_function(function_entry_block, function_exit_block, current_function_blocks, &control_flow_updates);
+
+		//Invoke the marker
+		mark(current_function_blocks);
+
+		//Invoke the sweeper
+		sweep(current_function_blocks, function_entry_block, &control_flow_updates);
+	}
+
+	/**
+	 * PASS 4: certain common if-else assignments are good candidates for conditional moves in Ollie. We have
+	 * a dedicated pass that will crawl the function once and look for them. If it is able to find them, then
+	 * it will optimize them into a conditional move pattern. If this is to happen, it will require a full
+	 * redo of the mark, sweep, block deletion and control flow recalculation passes
+	 */
+	u_int8_t branching_assignments_optimized = optimize_branching_assignments_where_possible(current_function_blocks, &control_flow_updates);
+
+	/**
+	 * If these ended up being optimized, we will have unreachable blocks
+	 * that need to be cleaned up. We will also go through and
+	 * do a mark-and-sweep run to make sure that no straggler variables
+	 * are still around
+	 */
+	if(branching_assignments_optimized == TRUE){
+		//Reset all of the marks in the function
+		reset_all_marks(current_function);
+
+		/**
+		 * Optimizing branches and and then trying to run mark & sweep will not work because
+		 * we have fundamentally changed the structure & dominance in the CFG by doing
+		 * that. 
+		 *
+		 * We are going to need to delete all unreachable blocks *at this stage* and
+		 * then we are going to have to update all of the dominance relations. Mark
+		 * specifically relies on the "RDF"(reverse dominance frontier). Every edge
+		 * that we've touched since the last computation is in the log, so the graph
+		 * analyzer only needs to redo the parts of the dominator trees that changed
+		 */
+		delete_all_unreachable_blocks(function_entry_block, current_function_blocks, &control_flow_updates);
+
+		//Bring all dominance relations up to date
+		update_all_control_flow_relations_for_function(function_entry_block, function_exit_block, current_function_blocks, &control_flow_updates);
+
+		//Invoke the marker
+		mark(current_function_blocks);
+
+		//Invoke the sweeper
+		sweep(current_function_blocks, function_entry_block, &control_flow_updates);
+	}
+
+	/**
+	 * PASS 5: Clean algorithm
+	 * Clean follows after sweep because during the sweep process, we will likely delete the contents of
+	 * entire blocks. Clean uses 4 different steps in a specific order to eliminate control flow
+	 * that has been made useless by sweep()
+	 */
+	clean(cfg, function_entry_block);
+
+	/**
+	 * PASS 6: Delete all unreachable blocks
+	 * There is a chance that we have some blocks who are now unreachable. We will
+	 * remove them now. This step is absolutely essential. If we do not do this,
+	 * then the dominance relation computation will not work
+	 */
+	delete_all_unreachable_blocks(function_entry_block, current_function_blocks, NULL);
+
+	/**
+	 * PASS 7: Recalculate everything
+	 * Now that we've marked, sweeped and cleaned, odds are that all of our control relations will be off due to deletions of blocks, statements,
+	 * etc. So, to remedy this, we will recalculate everything in the CFG. There is no advantage in splitting this section up by function, as 
+	 * all blocks are going to be traversed regardless. Due to this, we will be doing it over the entire CFG at the end
+	 */
+	recompute_all_control_flow_relations_for_function(current_function_blocks, function_entry_block, function_exit_block);
+
+	/**
+	 * PASS 8: Loop optimizations
+	 * This needs up to date dominators to find the loops, so it comes after everything is recomputed. It
+	 * brings the control flow relations back up to date itself if it has to add any preheaders
+	 */
+	u_int8_t loops_changed = optimize_loops(function_entry_block, function_exit_block, current_function_blocks);
+
+	/**
+	 * PASS 9: Global value numbering
+	 * This goes after the loop optimizations so that it sees every copy that unrolling made. The
+	 * dominator tree is up to date by this point either way
+	 */
+	u_int8_t redundancies_removed = global_value_numbering(function_entry_block, current_function_blocks);
+
+	/**
+	 * PASS 10: Jump threading
+	 * Value numbering has made any conditionals that compute the same thing look the same, so
+	 * this is where we can best tell that a branch was already decided further up
+	 */
+	u_int8_t jumps_threaded = thread_jumps(function_entry_block, function_exit_block, current_function_blocks);
+
+	/**
+	 * PASS 11: Dead store elimination
+	 * Value numbering will have turned plenty of loads into copies by now, so a lot more of
+	 * the stores are never read
+	 */
+	u_int8_t stores_removed = eliminate_dead_stores(function_entry_block, current_function_blocks);
+
+	/**
+	 * PASS 12: if any exit tests were moved over to a strength reduced variable, the old induction
+	 * variable may now only be keeping itself alive. Unrolling, value numbering, jump threading and dead
+	 * store elimination can leave values behind that nothing reads as well. One more round of mark & sweep
+	 * will take them out
+	 */
+	if(loops_changed == TRUE || redundancies_removed == TRUE || jumps_threaded == TRUE || stores_removed == TRUE){
+		//Reset all of the marks in the function
+		reset_all_marks(current_function);
+
+		//Any stack region whose stores were all removed can now go too
+		if(stores_removed == TRUE){
+			reset_stack_data_area_marks(&(current_function->local_stack));
+		}
+
+		//Invoke the marker
+		mark(current_function_blocks);
+
+		//Invoke the sweeper
+		sweep(current_function_blocks, function_entry_block, NULL);
+
+		//Sweeping can turn branches into jumps, so we need to clean up after it
+		delete_all_unreachable_blocks(function_entry_block, current_function_blocks, NULL);
+		recompute_all_control_flow_relations_for_function(current_function_blocks, function_entry_block, function_exit_block);
+	}
+
+	//The scheduler asks alias analysis about this function later on, so the exposure needs to match what's left
+	compute_address_exposure(current_function);
+
+	//We're done with the log
+	control_flow_update_log_dealloc(&control_flow_updates);
+}
+
+
+/**
+ * Optimize only the function at the given index. Local constants are not swept here,
+ * because other functions may still be holding references to them
+ */
+void optimize_single_function(cfg_t* cfg, u_int32_t function_index, u_int32_t unroll_factor){
+	cfg_reference = cfg;
+	loop_unroll_factor = unroll_factor;
+
+	//Prepopulate these global variables so that we don't need to pass them around
+	stack_pointer_variable = cfg->stack_pointer;
+	instruction_pointer_variable = cfg->instruction_pointer;
+	set_alias_analysis_stack_pointer(cfg->stack_pointer);
+
+	//Run every pass on it
+	optimize_function(cfg, function_index);
+}
+
+
+/**
+ * The generic optimize function. Every function is optimized on its own, and we will use up to
+ * thread_count threads to do it
+*/
+cfg_t* optimize(cfg_t* cfg, u_int32_t thread_count, u_int32_t unroll_factor){
+	cfg_reference = cfg;
+	loop_unroll_factor = unroll_factor;
+
+	//Prepopulate these global variables so that we don't need to pass them around. These
+	//are never written to once we start, so every worker is able to share them
+	stack_pointer_variable = cfg->stack_pointer;
+	instruction_pointer_variable = cfg->instruction_pointer;
+	set_alias_analysis_stack_pointer(cfg->stack_pointer);
+
+	/**
+	 * The interprocedural passes look at the bodies of other functions, so they have to be
+	 * done for the whole program before any of the workers start changing them
+	 */
+	run_interprocedural_passes(cfg);
+
+	/**
+	 * We will optimize on a function by function basis. This is because functions are independent units 
+	 * that do not have interlocking dependencies. Us doing this allows for more efficient operation because
+	 * there may be instances where we need to use our "while changed" type processing, causing us to iterate
+	 * over entire sets of blocks repeatedly. It also means that we can hand each function off to its own
+	 * worker
+	 */
+	thread_pool_run(thread_count, cfg->function_entry_blocks.current_index, optimize_function, cfg);
+
+	/**
+	 * Now that all of our marking and sweeping is done, it is possible that we'll
+	 * have some orphaned local constants. We will go through now and sweep them all up if 
+	 * any of them end up being completely unused. Local constants are shared by every
+	 * function, so this can only be done once all of the workers are done
+	 */
+	sweep_local_constants(cfg);
+
 	//Give back the CFG
 	return cfg;
 }
@@ -3,8 +3,8 @@
  *
  * The compiler "middle-end", known as the ollie optimizer
  *
- * This subsystem is very closed off compared to the others. Nothing in it will need
- * to be used besides the generic "optimize" function. Any actual dependencies that are needed
+ * This subsystem is very closed off compared to the others. Besides the generic "optimize" function,
+ * only the per-function hooks used for streaming are exposed. Any actual dependencies that are needed
  * will be included in the implementation .c file
 */
 
@@ -17,8 +17,30 @@
 #include <sys/types.h>
 
 /**
- * Invoke the ollie optimizer
+ * Invoke the ollie optimizer. Functions are optimized independently of one
+ * another using up to thread_count threads. Loops are unrolled by up to
+ * loop_unroll_factor, where a factor of 1 turns unrolling off
  */
-cfg_t* optimize(cfg_t* cfg);
+cfg_t* optimize(cfg_t* cfg, u_int32_t thread_count, u_int32_t loop_unroll_factor);
+
+/**
+ * Run every whole program pass: inlining, interprocedural constant propagation(which may
+ * add specialized functions), parameter capture summaries and function attribute inference.
+ * This is done for us by optimize(), but when streaming it needs to be done up front, before
+ * any function has been optimized
+ */
+void run_interprocedural_passes(cfg_t* cfg);
+
+/**
+ * Optimize just one function. This is used when functions are streamed through
+ * the back end one at a time
+ */
+void optimize_single_function(cfg_t* cfg, u_int32_t function_index, u_int32_t loop_unroll_factor);
+
+/**
+ * Remove any local constants that nothing references anymore. This may only
+ * be done once every function has been optimized
+ */
+void sweep_local_constants(cfg_t* cfg);
 
 #endif /* OPTIMIZER_H */
@@ -19,9 +19,6 @@
 static three_addr_var_t* stack_pointer_variable;
 static three_addr_var_t* instruction_pointer_variable;
 
-// A reusable queue for our traversals
-static heap_queue_t bfs_queue;
-
 /**
  * We only want to perform ret-hoisting for small enough
  * blocks. If we have gigantic ret blocks, hoisting them
@@ -100,7 +97,7 @@ static instruction_t* combine_blocks(cfg_t* cfg, basic_block_t* a, basic_block_t
 	}
 
 	//Block b no longer exists
-	dynamic_array_delete(&(cfg->created_blocks), b);
+	remove_from_created_blocks(cfg, b);
 
 	//Always return b's leader
 	return b->leader_statement;
@@ -789,7 +786,7 @@ static u_int8_t branch_reduce_postprocess(cfg_t* cfg, dynamic_array_t* postorder
  * 	 compute Postorder of CFG
  * 	 branch_reduce_postprocess()
  */
-static void condense(cfg_t* cfg, dynamic_array_t* function_blocks, basic_block_t* function_entry_block){
+static void condense(cfg_t* cfg, basic_block_t* function_entry_block){
 	//Have we seen change(modification) at all?
 	u_int8_t changed;
 
@@ -805,7 +802,7 @@ static void condense(cfg_t* cfg, dynamic_array_t* function_blocks, basic_block_t
 		 * Compute the new postorder. Remember that this API
 		 * puts the result inside of the array that we've allocated
 		 */
-		get_post_order_traversal(function_blocks, function_entry_block, &postorder);
+		get_post_order_traversal(function_entry_block, &postorder);
 
 		//Call onepass() for the reduction
 		changed = branch_reduce_postprocess(cfg, &postorder);
@@ -818,139 +815,553 @@ static void condense(cfg_t* cfg, dynamic_array_t* function_blocks, basic_block_t
 }
 
 
+/**
+ * Get the conditional jump that jumps when the given one does not. Jumps that
+ * can't be inverted(JP) give back JMP as a sentinel
+ */
+static inline instruction_type_t get_inverse_conditional_jump(instruction_type_t jump_type){
+	switch(jump_type){
+		case JE:
+			return JNE;
+		case JNE:
+			return JE;
+		case JZ:
+			return JNZ;
+		case JNZ:
+			return JZ;
+		case JG:
+			return JLE;
+		case JLE:
+			return JG;
+		case JL:
+			return JGE;
+		case JGE:
+			return JL;
+		case JA:
+			return JBE;
+		case JBE:
+			return JA;
+		case JB:
+			return JAE;
+		case JAE:
+			return JB;
+		default:
+			return JMP;
+	}
+}
+
+
+/**
+ * If a block ends in:
+ * 	jcc .L(next block)
+ * 	jmp .L(other block)
+ *
+ * Then we can flip the condition and have the taken path fall through instead:
+ * 	jncc .L(other block)
+ *
+ * Floating point comparisons are left alone, because a NaN makes every
+ * condition false and so flipping them is not the same as negating them
+ */
+static void invert_branch_into_fall_through(basic_block_t* block){
+	instruction_t* jump_to_else = block->exit_statement;
+	instruction_t* jump_to_if = jump_to_else->previous_statement;
+
+	if(jump_to_if == NULL || jump_to_if->if_block != block->direct_successor){
+		return;
+	}
+
+	//The if jump must be the only conditional jump in here
+	if(jump_to_if->previous_statement != NULL && is_jump_instruction(jump_to_if->previous_statement) == TRUE){
+		return;
+	}
+
+	if(jump_to_if->relies_on == NULL || jump_to_if->relies_on->comes_from_fp_comparison == TRUE){
+		return;
+	}
+
+	instruction_type_t inverse = get_inverse_conditional_jump(jump_to_if->instruction_type);
+	if(inverse == JMP){
+		return;
+	}
+
+	//The conditional jump now goes where the unconditional one did
+	jump_to_if->instruction_type = inverse;
+	jump_to_if->if_block = jump_to_else->if_block;
+
+	delete_statement(jump_to_else);
+}
+
+
 /**
  * Once we've done all of the reduction that we see fit to do, we'll need to 
  * find a way to reorder the blocks since it is likely that the control flow
- * changed
+ * changed. The layout itself is shared with the instruction selector, all that we
+ * need to do here is get rid of the jumps that the new order makes useless
  */
 static void reorder_blocks(basic_block_t* function_entry_block){
 	//We'll first wipe the visited status on this CFG
 	reset_function_visited_status(function_entry_block, TRUE);
 
-	//Clear out our reusable queue
-	heap_queue_clear(&bfs_queue);
-	
-	//We will perform a breadth first search and use the "direct successor" area
-	//of the blocks to store them all in one chain
-	
-	//These are reset for every function we deal with
-	basic_block_t* previous = NULL;
+	//Build the chain
+	lay_out_function_blocks(function_entry_block, BLOCK_LAYOUT_AFTER_INSTRUCTION_SELECTION);
 
-	//This function start block is the begging of our BFS	
-	enqueue(&bfs_queue, function_entry_block);
-	
-	//So long as the queue is not empty
-	while(queue_is_empty(&bfs_queue) == FALSE){
-		//Grab this block off of the queue
-		basic_block_t* current = dequeue(&bfs_queue);
-
-		//If previous is NULL, this is the first block
-		if(previous == NULL){
-			//Set the previous block
-			previous = current;
-
-		//We need to handle the rare case where we reach two of the same blocks(maybe the block points
-		//to itself) but neither have been visited. We make sure that, in this event, we do not set the
-		//block to be it's own direct successor
-		} else if(previous != current && current->visited == FALSE){
-			//We'll add this in as a direct successor
-			previous->direct_successor = current;
-
-			//Do we end in a jump? If so grab the block
-			basic_block_t* end_jumps_to = get_jumping_to_block_if_exists(previous);
-
-			//If we do AND what we're jumping to is the direct successor, then we'll
-			//delete the jump statement as it is now unnecessary
-			if(end_jumps_to == previous->direct_successor){
-				//Get rid of this jump as it's no longer needed
-				delete_statement(previous->exit_statement);
+	//Now run through it and clean up the jumps
+	for(basic_block_t* current = function_entry_block; current != NULL; current = current->direct_successor){
+		//Nothing to fall through to, or nothing to get rid of
+		if(current->direct_successor == NULL || current->exit_statement == NULL || current->exit_statement->instruction_type != JMP){
+			continue;
+		}
+
+		/**
+		 * If we jump straight to what comes next, the jump is unnecessary. Otherwise,
+		 * we may still be able to flip the branch so that its taken side falls through
+		 */
+		if(current->exit_statement->if_block == current->direct_successor){
+			delete_statement(current->exit_statement);
+		} else {
+			invert_branch_into_fall_through(current);
+		}
+	}
+}
+
+
+/**
+ * Is the given variable the stack pointer? We check both the variable itself and
+ * the register that it was given, in case we're looking at a copy of it
+ */
+static inline u_int8_t is_stack_pointer(three_addr_var_t* variable){
+	if(variable == NULL){
+		return FALSE;
+	}
+
+	if(variable == stack_pointer_variable){
+		return TRUE;
+	}
+
+	live_range_t* live_range = variable->associated_live_range;
+
+	if(live_range != NULL
+		&& live_range->live_range_class == LIVE_RANGE_CLASS_GEN_PURPOSE
+		&& live_range->reg.gen_purpose == RSP){
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Do these two variables end up in the same register?
+ */
+static inline u_int8_t are_variables_in_same_register(three_addr_var_t* a, three_addr_var_t* b){
+	live_range_t* a_range = a->associated_live_range;
+	live_range_t* b_range = b->associated_live_range;
+
+	if(a_range == NULL || b_range == NULL || a_range->live_range_class != b_range->live_range_class){
+		return FALSE;
+	}
+
+	switch(a_range->live_range_class){
+		case LIVE_RANGE_CLASS_GEN_PURPOSE:
+			return a_range->reg.gen_purpose == b_range->reg.gen_purpose ? TRUE : FALSE;
+		case LIVE_RANGE_CLASS_SSE:
+			return a_range->reg.sse_reg == b_range->reg.sse_reg ? TRUE : FALSE;
+		default:
+			return FALSE;
+	}
+}
+
+
+/**
+ * Could the address of anything inside of this function's stack frame be handed out? If
+ * so, a callee may be relying on our frame still being there, so no call in this function
+ * can be turned into a tail call. The only ways to hand out a frame address are to
+ * compute one off of the stack pointer or to copy the stack pointer somewhere else
+ */
+static u_int8_t does_function_expose_stack_frame(dynamic_array_t* function_blocks){
+	for(int32_t i = 0; i < function_blocks->current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			switch(cursor->instruction_type){
+				case LEAW:
+				case LEAL:
+				case LEAQ:
+					if(is_stack_pointer(cursor->operands.x86.address_register1) == TRUE
+						|| is_stack_pointer(cursor->operands.x86.address_register2) == TRUE){
+						return TRUE;
+					}
+
+					break;
+
+				default:
+					//Stack pointer adjustments themselves are fine
+					if(is_stack_pointer(cursor->operands.x86.destination_register) == TRUE){
+						break;
+					}
+
+					if(is_stack_pointer(cursor->operands.x86.source_register1) == TRUE
+						|| is_stack_pointer(cursor->operands.x86.source_register2) == TRUE){
+						return TRUE;
+					}
+
+					break;
 			}
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * How large is the local stack that the register allocator allocated for this function? This
+ * mirrors what the allocator does when it finalizes the stack
+ */
+static inline u_int32_t get_allocated_local_stack_size(symtab_function_record_t* function){
+	u_int32_t local_stack_size = function->local_stack.total_size;
+
+	//Functions that need initial alignment always allocate at least 8 bytes
+	if(function->requires_initial_alignment == TRUE && local_stack_size == 0){
+		local_stack_size = 8;
+	}
+
+	return local_stack_size;
+}
+
+
+/**
+ * Get the call that is in tail position for the block ending in the given ret, if there is one. A
+ * call is in tail position when the only things between it and the ret are the epilogue(the stack
+ * deallocation and callee saved pops), and the ret gives back exactly what the call gave us
+ *
+ * Calls that need anything from the caller's frame(stack passed params, pass by copy params) or that
+ * deal with errors are never in tail position
+ */
+static instruction_t* get_tail_call_for_ret(symtab_function_record_t* function, instruction_t* ret){
+	//Did we pop into anything that isn't callee saved?
+	u_int8_t pops_parameter_register = FALSE;
+
+	//Crawl up over all of the pops
+	instruction_t* cursor = ret->previous_statement;
+	while(cursor != NULL && cursor->is_callee_saving_instruction == TRUE){
+		//The dummy pop for alignment uses %r8, which is the fifth parameter register
+		if(cursor->instruction_type == POP_DIRECT_GP
+			&& cursor->push_or_pop_reg.gen_purpose == R8){
+			pops_parameter_register = TRUE;
+		}
+
+		cursor = cursor->previous_statement;
+	}
+
+	/**
+	 * If we have a local stack, the deallocation needs to be right here and it needs to be
+	 * exactly our stack size. If it's anything else, it's been merged with some other stack
+	 * adjustment that the call relies on
+	 */
+	u_int32_t local_stack_size = get_allocated_local_stack_size(function);
+
+	if(local_stack_size != 0){
+		if(cursor == NULL
+			|| cursor->instruction_type != ADDQ
+			|| is_stack_pointer(cursor->operands.x86.destination_register) == FALSE
+			|| cursor->operands.x86.source_immediate == NULL
+			|| cursor->operands.x86.source_immediate->constant_value.unsigned_long_constant != local_stack_size){
+			return NULL;
+		}
+
+		cursor = cursor->previous_statement;
+	}
+
+	//We can only do this for direct calls
+	if(cursor == NULL || cursor->instruction_type != CALL){
+		return NULL;
+	}
+
+	function_type_t* callee_signature = cursor->called_function->signature->internal_types.function_type;
+
+	//Anything that needs our frame or deals with errors is out
+	if(callee_signature->contains_stack_params == TRUE
+		|| callee_signature->contains_elaborative_stack_param == TRUE
+		|| callee_signature->pass_by_copy_param_count > 0
+		|| callee_signature->raises_errors == TRUE
+		|| cursor->operands.x86.destination_register2 != NULL){
+		return NULL;
+	}
+
+	//The dummy pop would wipe out the fifth parameter
+	if(pops_parameter_register == TRUE
+		&& callee_signature->general_purpose_param_count + callee_signature->returns_by_copy >= 5){
+		return NULL;
+	}
+
+	/**
+	 * If we return something, it has to be exactly what the call gave back. Anything else
+	 * would have needed an instruction between the call and the ret to set it up
+	 */
+	three_addr_var_t* returned = ret->operands.x86.source_register1;
+	three_addr_var_t* call_result = cursor->operands.x86.destination_register;
+
+	if(returned != NULL
+		&& (call_result == NULL || are_variables_in_same_register(returned, call_result) == FALSE)){
+		return NULL;
+	}
+
+	return cursor;
+}
+
+
+/**
+ * Split the function entry block right after its prologue(the callee saving pushes and the
+ * stack allocation), so that self tail calls have somewhere to jump back to. Returns NULL if we
+ * can't find the prologue's end with certainty
+ */
+static basic_block_t* split_function_entry_after_prologue(cfg_t* cfg, basic_block_t* function_entry_block){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
+
+	//The last instruction of the prologue, if there is one
+	instruction_t* prologue_end = NULL;
+	instruction_t* cursor = function_entry_block->leader_statement;
+
+	while(cursor != NULL && cursor->is_callee_saving_instruction == TRUE){
+		prologue_end = cursor;
+		cursor = cursor->next_statement;
+	}
+
+	/**
+	 * Just like with the deallocation, the allocation has to be exactly our stack size. If it's
+	 * been merged with something else, jumping past it would skip something that we need
+	 */
+	u_int32_t local_stack_size = get_allocated_local_stack_size(function);
+
+	if(local_stack_size != 0){
+		if(cursor == NULL
+			|| cursor->instruction_type != SUBQ
+			|| is_stack_pointer(cursor->operands.x86.destination_register) == FALSE
+			|| cursor->operands.x86.source_immediate == NULL
+			|| cursor->operands.x86.source_immediate->constant_value.unsigned_long_constant != local_stack_size){
+			return NULL;
+		}
 
-			//Add this in as well
-			previous = current;
+		prologue_end = cursor;
+		cursor = cursor->next_statement;
+	}
+
+	//Everything from the cursor onward is the body
+	basic_block_t* body = basic_block_alloc_in_function(cfg, function, function_entry_block->estimated_execution_frequency);
+
+	if(cursor != NULL){
+		body->leader_statement = cursor;
+		body->exit_statement = function_entry_block->exit_statement;
+
+		//Cut the links between the two halves
+		cursor->previous_statement = NULL;
+
+		if(prologue_end != NULL){
+			prologue_end->next_statement = NULL;
+			function_entry_block->exit_statement = prologue_end;
+		} else {
+			function_entry_block->leader_statement = NULL;
+			function_entry_block->exit_statement = NULL;
+		}
+
+		//Everything that moved needs to know where it is now
+		for(instruction_t* moved = cursor; moved != NULL; moved = moved->next_statement){
+			moved->block_contained_in = body;
+			body->number_of_instructions++;
+			function_entry_block->number_of_instructions--;
 		}
+	}
+
+	//A switch in the entry block goes with the indirect jump
+	body->jump_table = function_entry_block->jump_table;
+	function_entry_block->jump_table = NULL;
+
+	//The body takes over all of the entry's successors
+	while(function_entry_block->successors.current_index > 0){
+		basic_block_t* successor = dynamic_array_get_at(&(function_entry_block->successors), 0);
+
+		delete_successor(function_entry_block, successor);
+		add_successor(body, successor);
+	}
+
+	//And the entry now just falls through into the body
+	add_successor(function_entry_block, body);
+
+	return body;
+}
+
+
+/**
+ * Turn every call in tail position into a jump. A call to the function itself becomes a jump
+ * back to the start of the function body, reusing the current frame entirely. Any other call
+ * runs our epilogue first and then jumps to the callee, which returns directly to our caller
+ *
+ * We need to be sure that nothing in our frame is still needed once the callee runs, so if
+ * the address of anything in our frame could have been handed out we skip the function
+ */
+static void optimize_tail_calls(cfg_t* cfg, basic_block_t* function_entry_block){
+	symtab_function_record_t* function = function_entry_block->function_defined_in;
 
-		//Make sure that we flag this as visited
-		current->visited = TRUE;
+	//Anything that raises errors manages them around the ret, so leave it alone
+	if(function->signature->internal_types.function_type->raises_errors == TRUE){
+		return;
+	}
 
-		//Let's first check for our special case - us jumping to a given block as the very last statement. If
-		//this turns back something that isn't null, it'll be the first thing we add in
-		basic_block_t* direct_end_jump = get_jumping_to_block_if_exists(current);
+	//Grab everything that we can reach
+	dynamic_array_t blocks = dynamic_array_alloc();
+	get_post_order_traversal(function_entry_block, &blocks);
 
-		//If this is the case, we'll add it in first
-		if(direct_end_jump != NULL && direct_end_jump->visited == FALSE){
-			//Add it into the queue
-			enqueue(&bfs_queue, direct_end_jump);
+	if(does_function_expose_stack_frame(&blocks) == TRUE){
+		dynamic_array_dealloc(&blocks);
+		return;
+	}
+
+	//Find every call that is in tail position
+	dynamic_array_t tail_calls = dynamic_array_alloc();
+	u_int8_t has_self_tail_call = FALSE;
+
+	for(int32_t i = 0; i < blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&blocks, i);
+
+		if(block->exit_statement == NULL || block->exit_statement->instruction_type != RET){
+			continue;
 		}
 
-		//Now we'll go through each of the successors in this node
-		for(int32_t idx = 0; idx < current->successors.current_index; idx++){
-			//Now as we go through here, if the direct end jump wasn't NULL, we'll have already added it in. We don't
-			//want to have that happen again, so we'll make sure that if it's not NULL we don't double add it
+		instruction_t* tail_call = get_tail_call_for_ret(function, block->exit_statement);
 
-			//Grab the successor
-			basic_block_t* successor = dynamic_array_get_at(&(current->successors), idx);
+		if(tail_call != NULL){
+			dynamic_array_add(&tail_calls, tail_call);
 
-			//If we had that jumping to block case happen, make sure we skip over it to avoid double adding
-			if(successor == direct_end_jump){
-				continue;
+			if(tail_call->called_function == function){
+				has_self_tail_call = TRUE;
 			}
+		}
+	}
 
-			//If the block is completely empty(function end block), we'll also skip
-			if(successor->leader_statement == NULL){
-				successor->visited = TRUE;
-				continue;
+	//Self tail calls need somewhere to jump back to
+	basic_block_t* body = NULL;
+	if(has_self_tail_call == TRUE){
+		body = split_function_entry_after_prologue(cfg, function_entry_block);
+	}
+
+	for(int32_t i = 0; i < tail_calls.current_index; i++){
+		instruction_t* tail_call = dynamic_array_get_at(&tail_calls, i);
+
+		//This may have moved if we split the entry
+		basic_block_t* block = tail_call->block_contained_in;
+
+		/**
+		 * Self recursion: everything that the prologue set up is still exactly as we need it, so
+		 * we skip the epilogue entirely and go back to the top of the body
+		 */
+		if(tail_call->called_function == function && body != NULL){
+			//Wipe out the call, the epilogue and the ret
+			while(block->exit_statement != tail_call){
+				delete_statement(block->exit_statement);
 			}
 
-			//Otherwise it's not, so we'll add it in
-			if(successor->visited == FALSE){
-				enqueue(&bfs_queue, successor);
+			delete_statement(tail_call);
+
+			add_statement(block, emit_jump_instruction_directly(body, JMP));
+			add_successor(block, body);
+
+			continue;
+		}
+
+		/**
+		 * Otherwise the epilogue runs as normal, and then we jump to the callee in place of
+		 * the ret. The callee's ret will go right back to our caller
+		 */
+		instruction_t* ret = block->exit_statement;
+
+		ret->instruction_type = TAIL_CALL;
+		ret->called_function = tail_call->called_function;
+		ret->operands.x86.source_register1 = NULL;
+
+		delete_statement(tail_call);
+	}
+
+	/**
+	 * If all that a function did was a tail call, its stack allocation and deallocation
+	 * are now right next to each other and do nothing
+	 */
+	for(int32_t i = 0; i < blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&blocks, i);
+
+		instruction_t* cursor = block->leader_statement;
+
+		while(cursor != NULL && cursor->next_statement != NULL){
+			instruction_t* next = cursor->next_statement;
+
+			if(cursor->instruction_type == SUBQ
+				&& next->instruction_type == ADDQ
+				&& is_stack_pointer(cursor->operands.x86.destination_register) == TRUE
+				&& is_stack_pointer(next->operands.x86.destination_register) == TRUE
+				&& cursor->operands.x86.source_immediate != NULL
+				&& next->operands.x86.source_immediate != NULL
+				&& cursor->operands.x86.source_immediate->constant_value.unsigned_long_constant == next->operands.x86.source_immediate->constant_value.unsigned_long_constant){
+
+				instruction_t* after = next->next_statement;
+
+				delete_statement(cursor);
+				delete_statement(next);
+
+				cursor = after;
+				continue;
 			}
+
+			cursor = next;
 		}
 	}
+
+	dynamic_array_dealloc(&tail_calls);
+	dynamic_array_dealloc(&blocks);
 }
 
 
 /**
- * The postprocess function performs all post-allocation cleanup/optimization 
- * tasks and returns the ordered CFG in file-ready form
+ * Run every postprocessing pass over a single function
  */
-/**
- * In the postprocess step, we will run through every statement and perform a few
- * optimizations:
- */
-void postprocess(cfg_t* cfg){
+void postprocess_function(cfg_t* cfg, basic_block_t* function_entry_block){
 	//Cache these two special variables
 	stack_pointer_variable = cfg->stack_pointer;
 	instruction_pointer_variable = cfg->instruction_pointer;
 
-	//Allocate the reusable queue
-	bfs_queue = heap_queue_alloc();
+	/**
+	 * PASS 1: remove any/all useless move operations from the CFG
+	 */
+	remove_useless_moves(function_entry_block);
 
-	//Run through every function block here separately
-	for(int32_t i = 0 ; i < cfg->function_entry_blocks.current_index; i++){
-		//Extract the given function block
-		basic_block_t* function_entry_block = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+	/**
+	 * PASS 2: perform a modified branch reduction to condense the code
+	*/
+	condense(cfg, function_entry_block);
 
-		//We'll need the list of all function blocks too
-		dynamic_array_t* function_blocks = &(function_entry_block->function_defined_in->function_blocks);
+	/**
+	 * PASS 3: turn calls in tail position into jumps
+	 */
+	optimize_tail_calls(cfg, function_entry_block);
 
-		/**
-		 * PASS 1: remove any/all useless move operations from the CFG
-		 */
-		remove_useless_moves(function_entry_block);
+	/**
+	 * PASS 4: final reordering
+	*/
+	reorder_blocks(function_entry_block);
+}
 
-		/**
-		 * PASS 2: perform a modified branch reduction to condense the code
-		*/
-		condense(cfg, function_blocks, function_entry_block);
 
-		/**
-		 * PASS 3: final reordering
-		*/
-		reorder_blocks(function_entry_block);
+/**
+ * The postprocess function performs all post-allocation cleanup/optimization 
+ * tasks and returns the ordered CFG in file-ready form
+ */
+/**
+ * In the postprocess step, we will run through every statement and perform a few
+ * optimizations:
+ */
+void postprocess(cfg_t* cfg){
+	//Run through every function block here separately
+	for(int32_t i = 0 ; i < cfg->function_entry_blocks.current_index; i++){
+		//Extract the given function block and let the helper do the work
+		postprocess_function(cfg, dynamic_array_get_at(&(cfg->function_entry_blocks), i));
 	}
-
-	//We can now destroy the output queue
-	heap_queue_dealloc(&bfs_queue);
 }
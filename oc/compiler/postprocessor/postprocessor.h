@@ -19,4 +19,9 @@
  */
 void postprocess(cfg_t* cfg);
 
+/**
+ * Run every postprocessing pass over a single function
+ */
+void postprocess_function(cfg_t* cfg, basic_block_t* function_entry_block);
+
 #endif /* OLLIE_POSTPROCESSOR_H */
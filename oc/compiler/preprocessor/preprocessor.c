@@ -474,7 +474,8 @@ static u_int8_t validate_and_skip_ounit_directive(ollie_token_stream_t* stream,
 	 * types:
 	 * 	1.) exit_status = <constant> - this tells OUNIT that it should compile and then run the program
 	 * 		and expect to get an exit status(echo $?) of the value provided. This is a quick and easy
-	 * 		to validate all sorts of things without relying on printing to the console
+	 * 		to validate all sorts of things without relying on printing to the console. It may be
+	 * 		followed by , flags = "<compiler flags>" to have oc run with extra flags
 	 * 	2.) failtocompile - this tells OUNIT that it should expect compilation to fail in some way. It
 	 * 		does not have the granularity to tell how it fails
 	 */
@@ -508,6 +509,43 @@ static u_int8_t validate_and_skip_ounit_directive(ollie_token_stream_t* stream,
 				return print_and_return_preprocessor_failure(info_message, token->line_num);
 			}
 			
+			token->ignore = TRUE;
+
+			/**
+			 * An exit status test may also give the flags that oc should be run with:
+			 * , flags = <str_const>
+			 */
+			if(token_array_get_pointer_at(&(stream->token_stream), *stream_index)->tok != COMMA){
+				break;
+			}
+
+			token = get_next_token_pointer(&(stream->token_stream), stream_index);
+			token->ignore = TRUE;
+
+			token = get_next_token_pointer(&(stream->token_stream), stream_index);
+
+			//flags is not a keyword, so it's just an identifier
+			if(token->tok != IDENT || strcmp(token->lexeme.string, "flags") != 0){
+				sprintf(info_message, "Expected \"flags\" in OUNIT directive but got %s instead", lexitem_to_string(token));
+				return print_and_return_preprocessor_failure(info_message, token->line_num);
+			}
+
+			token->ignore = TRUE;
+			token = get_next_token_pointer(&(stream->token_stream), stream_index);
+
+			if(token->tok != EQUALS){
+				sprintf(info_message, "Expected \"=\" but got %s instead", lexitem_to_string(token));
+				return print_and_return_preprocessor_failure(info_message, token->line_num);
+			}
+
+			token->ignore = TRUE;
+			token = get_next_token_pointer(&(stream->token_stream), stream_index);
+
+			if(token->tok != STR_CONST){
+				sprintf(info_message, "Expected string of compiler flags in OUNIT directive but got %s instead", lexitem_to_string(token));
+				return print_and_return_preprocessor_failure(info_message, token->line_num);
+			}
+
 			token->ignore = TRUE;
 			break;
 
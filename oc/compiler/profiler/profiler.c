@@ -0,0 +1,435 @@
+/**
+ * Author: Jack Robbins
+ * This C file contains the implementations for APIs defined inside of the header file
+ * of the same name
+ */
+
+#include "profiler.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../instruction/instruction.h"
+#include "../utils/constants.h"
+#include "../utils/error_management.h"
+
+/**
+ * The FNV-1a offset basis and prime. This is what we hash
+ * function names with
+ */
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325UL
+#define FNV_PRIME 0x100000001b3UL
+
+//For any error printing
+static char info[ERROR_SIZE];
+
+/**
+ * A function record that has been read out of a profile
+ */
+typedef struct {
+	//The counts for every block, in block order
+	u_int64_t* counts;
+	//The hash of the function's name
+	u_int64_t name_hash;
+	//How many blocks were counted
+	u_int64_t block_count;
+} profile_record_t;
+
+
+/**
+ * Print a profiler message in the same format that the rest of the compiler uses
+ */
+static void print_profiler_message(error_message_type_t message_type, char* info){
+	//Now print it
+	const char* type[] = {"WARNING", "ERROR", "INFO", "DEBUG"};
+
+	//Print this out on a single line
+	fprintf(stdout, "\n[COMPILER %s]: %s\n", type[message_type], info);
+}
+
+
+/**
+ * Hash a function's name. This needs to be the exact same from one compile to the
+ * next, so we can't use anything like the symtab's hash here
+ */
+static u_int64_t hash_function_name(char* name){
+	u_int64_t hash = FNV_OFFSET_BASIS;
+
+	for(char* cursor = name; *cursor != '\0'; cursor++){
+		hash ^= (u_int8_t)(*cursor);
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+
+/**
+ * Is this block given its own counter? The exit block is always
+ * reached exactly as often as the entry is, and inlining requires
+ * that it stays empty, so it isn't counted
+ */
+static inline u_int8_t is_block_profiled(basic_block_t* block){
+	return block->block_type != BLOCK_TYPE_FUNC_EXIT;
+}
+
+
+/**
+ * How many blocks in the function will be given counters
+ */
+static u_int64_t get_profiled_block_count(symtab_function_record_t* function){
+	u_int64_t block_count = 0;
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		if(is_block_profiled(dynamic_array_get_at(&(function->function_blocks), i)) == TRUE){
+			block_count++;
+		}
+	}
+
+	return block_count;
+}
+
+
+/**
+ * Free every record that we've read in
+ */
+static void profile_records_dealloc(dynamic_array_t* records){
+	for(int32_t i = 0; i < records->current_index; i++){
+		profile_record_t* record = dynamic_array_get_at(records, i);
+		free(record->counts);
+		free(record);
+	}
+
+	dynamic_array_dealloc(records);
+}
+
+
+/**
+ * Read every function record out of the profile. If the file is not a profile
+ * or has been cut short, we give back FAILURE
+ */
+static u_int8_t read_profile_records(FILE* profile, dynamic_array_t* records){
+	char magic[sizeof(PROFILE_FILE_MAGIC) - 1];
+	u_int64_t function_count;
+
+	//Is this even a profile?
+	if(fread(magic, 1, sizeof(magic), profile) != sizeof(magic)
+		|| memcmp(magic, PROFILE_FILE_MAGIC, sizeof(magic)) != 0
+		|| fread(&function_count, sizeof(u_int64_t), 1, profile) != 1){
+		return FAILURE;
+	}
+
+	for(u_int64_t i = 0; i < function_count; i++){
+		profile_record_t* record = calloc(1, sizeof(profile_record_t));
+		dynamic_array_add(records, record);
+
+		if(fread(&(record->name_hash), sizeof(u_int64_t), 1, profile) != 1
+			|| fread(&(record->block_count), sizeof(u_int64_t), 1, profile) != 1){
+			return FAILURE;
+		}
+
+		//Guard against a garbage count before we go allocating anything
+		if(record->block_count > UINT32_MAX){
+			return FAILURE;
+		}
+
+		record->counts = calloc(record->block_count, sizeof(u_int64_t));
+
+		if(fread(record->counts, sizeof(u_int64_t), record->block_count, profile) != record->block_count){
+			return FAILURE;
+		}
+	}
+
+	return SUCCESS;
+}
+
+
+/**
+ * Find the record for a given function. The records are written out in the same order that
+ * the functions are in, so we try the function's own index first before searching
+ */
+static profile_record_t* get_profile_record(dynamic_array_t* records, int32_t function_index, u_int64_t name_hash){
+	if(function_index < records->current_index){
+		profile_record_t* record = dynamic_array_get_at(records, function_index);
+
+		if(record->name_hash == name_hash){
+			return record;
+		}
+	}
+
+	for(int32_t i = 0; i < records->current_index; i++){
+		profile_record_t* record = dynamic_array_get_at(records, i);
+
+		if(record->name_hash == name_hash){
+			return record;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Convert a block's count into a frequency. Everything is relative to how many times the
+ * function was entered, which is worth PROFILE_ENTRY_FREQUENCY. A block that ran at all is
+ * worth at least 1, and only a block that never ran is worth 0
+ */
+static inline u_int32_t profile_count_to_frequency(u_int64_t count, u_int64_t entry_count){
+	if(count == 0){
+		return 0;
+	}
+
+	//Round up so that rarely run blocks aren't confused for ones that never ran
+	u_int64_t frequency = (count * PROFILE_ENTRY_FREQUENCY + entry_count - 1) / entry_count;
+
+	if(frequency > PROFILE_MAX_FREQUENCY){
+		return PROFILE_MAX_FREQUENCY;
+	}
+
+	return frequency;
+}
+
+
+/**
+ * Overwrite the estimated frequencies in a function with the measured ones
+ */
+static void apply_profile_record_to_function(symtab_function_record_t* function, profile_record_t* record){
+	/**
+	 * If the function was never called, we know nothing about how its blocks
+	 * relate to each other. The estimates are the best that we have
+	 */
+	if(record->counts[0] == 0){
+		return;
+	}
+
+	u_int64_t entry_count = record->counts[0];
+	u_int64_t counter_index = 0;
+
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		//The exit is reached as often as the entry is
+		if(is_block_profiled(block) == FALSE){
+			block->estimated_execution_frequency = PROFILE_ENTRY_FREQUENCY;
+			continue;
+		}
+
+		block->estimated_execution_frequency = profile_count_to_frequency(record->counts[counter_index], entry_count);
+		counter_index++;
+	}
+}
+
+
+/**
+ * Read the profile that an instrumented build of this program wrote out, and replace the
+ * estimated execution frequency of every block with what was actually measured. Functions
+ * with no matching record keep their estimates
+ *
+ * This must be run before the optimizer touches the CFG. At that point, the blocks are exactly what
+ * the instrumented build saw when it handed out counters, so the Nth counter in a function's record
+ * belongs to the Nth block in that function
+ */
+u_int8_t apply_profile_to_cfg(cfg_t* cfg, char* profile_file_name, u_int32_t* num_warnings){
+	FILE* profile = fopen(profile_file_name, "rb");
+
+	//A missing profile isn't fatal, we just don't get to use it
+	if(profile == NULL){
+		sprintf(info, "Unable to open the profile \"%s\". Estimated block frequencies will be used instead", profile_file_name);
+		print_profiler_message(MESSAGE_TYPE_WARNING, info);
+		(*num_warnings)++;
+		return FAILURE;
+	}
+
+	dynamic_array_t records = dynamic_array_alloc();
+
+	u_int8_t read_result = read_profile_records(profile, &records);
+	fclose(profile);
+
+	if(read_result == FAILURE){
+		sprintf(info, "\"%s\" is not a valid Ollie profile. Estimated block frequencies will be used instead", profile_file_name);
+		print_profiler_message(MESSAGE_TYPE_WARNING, info);
+		(*num_warnings)++;
+		profile_records_dealloc(&records);
+		return FAILURE;
+	}
+
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+		symtab_function_record_t* function = function_entry->function_defined_in;
+
+		profile_record_t* record = get_profile_record(&records, i, hash_function_name(function->func_name.string));
+
+		/**
+		 * If the function is new or its blocks have changed since the profile was taken, the counts
+		 * no longer line up with anything. It's safer to just use the estimates
+		 */
+		if(record == NULL || record->block_count != get_profiled_block_count(function)){
+			sprintf(info, "The profile \"%s\" does not match function \"%s\". Was the source changed since it was generated? Estimated block frequencies will be used for this function",
+		   			profile_file_name, function->func_name.string);
+			print_profiler_message(MESSAGE_TYPE_WARNING, info);
+			(*num_warnings)++;
+			continue;
+		}
+
+		//Empty records have nothing to give
+		if(record->block_count == 0){
+			continue;
+		}
+
+		apply_profile_record_to_function(function, record);
+	}
+
+	profile_records_dealloc(&records);
+
+	return SUCCESS;
+}
+
+
+/**
+ * Give the block a counter at the given offset. The counter must come after
+ * any phi functions, since those always have to lead the block
+ */
+static void add_profile_counter_to_block(basic_block_t* block, u_int64_t profile_counter_offset){
+	instruction_t* counter = emit_profile_counter_instruction(profile_counter_offset, 0);
+
+	instruction_t* cursor = block->leader_statement;
+	while(cursor != NULL && cursor->statement_type == THREE_ADDR_CODE_PHI_FUNC){
+		cursor = cursor->next_statement;
+	}
+
+	//The block is empty or only has phi functions, so this goes on the end
+	if(cursor == NULL){
+		add_statement(block, counter);
+	} else {
+		insert_instruction_before_given(counter, cursor);
+	}
+}
+
+
+/**
+ * Does the given function have any inline assembly in it?
+ */
+static u_int8_t does_function_contain_inline_assembly(symtab_function_record_t* function){
+	for(int32_t i = 0; i < function->function_blocks.current_index; i++){
+		basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), i);
+
+		for(instruction_t* cursor = block->leader_statement; cursor != NULL; cursor = cursor->next_statement){
+			if(cursor->statement_type == THREE_ADDR_CODE_ASM_INLINE_STMT){
+				return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Give every block in the program a profile counter. The instrumented program will write all
+ * of these counters out to the given file when main returns
+ *
+ * NOTE: The counters are only ever written out once main returns. A program that ends itself some other
+ * way(an exit syscall in inline assembly) never writes a profile, so we warn about any inline assembly
+ *
+ * This must be run before the optimizer touches the CFG. The counters are just like any other
+ * instruction after this, so they get copied along with their blocks if those blocks are inlined
+ * or unrolled. No matter where a copy ends up, it still counts the block that it came from
+ */
+void instrument_cfg_for_profiling(cfg_t* cfg, char* profile_file_name, u_int32_t* num_warnings){
+	cfg->profile_file_name = profile_file_name;
+	cfg->profiled_functions = dynamic_array_alloc();
+
+	//The first function record comes right after the file header
+	u_int64_t profile_counter_offset = PROFILE_HEADER_SIZE;
+
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
+		symtab_function_record_t* function = function_entry->function_defined_in;
+
+		//If this ends the program, the counters never make it out
+		if(does_function_contain_inline_assembly(function) == TRUE){
+			sprintf(info, "Function \"%s\" contains inline assembly. If it exits the program before main returns, no profile will be written", function->func_name.string);
+			print_profiler_message(MESSAGE_TYPE_WARNING, info);
+			(*num_warnings)++;
+		}
+
+		profiled_function_t* profiled_function = calloc(1, sizeof(profiled_function_t));
+		profiled_function->name_hash = hash_function_name(function->func_name.string);
+		dynamic_array_add(&(cfg->profiled_functions), profiled_function);
+
+		//Skip over the record's header
+		profile_counter_offset += PROFILE_FUNCTION_HEADER_SIZE;
+
+		for(int32_t j = 0; j < function->function_blocks.current_index; j++){
+			basic_block_t* block = dynamic_array_get_at(&(function->function_blocks), j);
+
+			if(is_block_profiled(block) == FALSE){
+				continue;
+			}
+
+			add_profile_counter_to_block(block, profile_counter_offset);
+
+			profile_counter_offset += PROFILE_COUNTER_SIZE;
+			profiled_function->block_count++;
+		}
+	}
+}
+
+
+/**
+ * Print out the profile data area and the profile file name for an instrumented program. The
+ * layout here has to match up exactly with what the counters were given in instrument_cfg_for_profiling
+ */
+void print_profile_data_section(FILE* fl, cfg_t* cfg){
+	//Nothing was instrumented
+	if(cfg->profile_file_name == NULL){
+		return;
+	}
+
+	//The runtime needs to see all of these, so they're global
+	fprintf(fl, "\t.globl %s\n", PROFILE_DATA_SYMBOL);
+	fprintf(fl, "\t.globl %s\n", PROFILE_DATA_END_SYMBOL);
+	fprintf(fl, "\t.globl %s\n", PROFILE_FILE_NAME_SYMBOL);
+
+	//The counters are written to, so this is all .data
+	fprintf(fl, "\t.data\n");
+	fprintf(fl, "\t.align 8\n");
+	fprintf(fl, "\t.type %s, @object\n", PROFILE_DATA_SYMBOL);
+	fprintf(fl, "%s:\n", PROFILE_DATA_SYMBOL);
+
+	//The file header
+	fprintf(fl, "\t.ascii \"%s\"\n", PROFILE_FILE_MAGIC);
+	fprintf(fl, "\t.quad %d\n", cfg->profiled_functions.current_index);
+
+	//Then every function's record
+	for(int32_t i = 0; i < cfg->profiled_functions.current_index; i++){
+		profiled_function_t* profiled_function = dynamic_array_get_at(&(cfg->profiled_functions), i);
+
+		fprintf(fl, "\t.quad 0x%lx\n", profiled_function->name_hash);
+		fprintf(fl, "\t.quad %lu\n", profiled_function->block_count);
+
+		//All of the counters start out at 0
+		if(profiled_function->block_count > 0){
+			fprintf(fl, "\t.zero %lu\n", profiled_function->block_count * PROFILE_COUNTER_SIZE);
+		}
+	}
+
+	//The runtime writes out everything up to here
+	fprintf(fl, "%s:\n", PROFILE_DATA_END_SYMBOL);
+
+	//Where it all goes
+	fprintf(fl, "\t.section .rodata\n");
+	fprintf(fl, "\t.type %s, @object\n", PROFILE_FILE_NAME_SYMBOL);
+	fprintf(fl, "%s:\n", PROFILE_FILE_NAME_SYMBOL);
+
+	/**
+	 * The name comes straight from the command line, so it could have quotes or backslashes
+	 * in it. Writing it out byte by byte means that nothing ever needs to be escaped
+	 */
+	fprintf(fl, "\t.byte ");
+	for(char* cursor = cfg->profile_file_name; *cursor != '\0'; cursor++){
+		fprintf(fl, "%u, ", (u_int8_t)(*cursor));
+	}
+
+	//And the null terminator
+	fprintf(fl, "0\n");
+}
@@ -0,0 +1,72 @@
+/**
+ * Author: Jack Robbins
+ * The profiler handles everything needed for profile guided optimization. An instrumented
+ * build(--profile-generate) gives every basic block a counter that the runtime writes out
+ * when the program exits. A profile consuming build(--profile-use) reads those counts back
+ * in and uses them in place of the estimated execution frequencies
+ */
+
+//Include guards
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include "../cfg/cfg.h"
+
+/**
+ * The symbols that the profile runtime(oc/builtins/precompiled_builtins/__ostl_profile_runtime.s)
+ * expects an instrumented program to define
+ */
+#define PROFILE_DATA_SYMBOL "__ostl_profile_data"
+#define PROFILE_DATA_END_SYMBOL "__ostl_profile_data_end"
+#define PROFILE_FILE_NAME_SYMBOL "__ostl_profile_file_name"
+
+/**
+ * Every profile starts with this 8 byte magic number followed by the number of function
+ * records. Each function record is its name hash, its block count and then one 8 byte
+ * counter per block
+ */
+#define PROFILE_FILE_MAGIC "OLPROF01"
+#define PROFILE_HEADER_SIZE 16
+#define PROFILE_FUNCTION_HEADER_SIZE 16
+#define PROFILE_COUNTER_SIZE 8
+
+//A function that has been given profile counters
+typedef struct profiled_function_t profiled_function_t;
+
+/**
+ * Everything that we need to know to lay out a function's record
+ * inside of the profile data
+ */
+struct profiled_function_t{
+	//The hash of the function's name. Profile records are matched up by this
+	u_int64_t name_hash;
+	//How many blocks in this function are counted
+	u_int64_t block_count;
+};
+
+/**
+ * Read the profile that an instrumented build of this program wrote out, and replace the
+ * estimated execution frequency of every block with what was actually measured. Functions
+ * with no matching record keep their estimates
+ *
+ * This must be run before the optimizer touches the CFG
+ */
+u_int8_t apply_profile_to_cfg(cfg_t* cfg, char* profile_file_name, u_int32_t* num_warnings);
+
+/**
+ * Give every block in the program a profile counter. The instrumented program will write all
+ * of these counters out to the given file when main returns. A program that exits any other
+ * way writes nothing, so any inline assembly gets a warning
+ *
+ * This must be run before the optimizer touches the CFG
+ */
+void instrument_cfg_for_profiling(cfg_t* cfg, char* profile_file_name, u_int32_t* num_warnings);
+
+/**
+ * Print out the profile data area and the profile file name for an instrumented program
+ */
+void print_profile_data_section(FILE* fl, cfg_t* cfg);
+
+#endif /* PROFILER_H */
@@ -16,6 +16,7 @@
 #include "../utils/queue/max_priority_queue.h"
 #include "../graph_analyzer/graph_analyzer.h"
 #include "../cfg/cfg.h"
+#include "../utils/thread_pool/thread_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -40,6 +41,12 @@ const general_purpose_register_t dummy_callee_saving_push_register = R8;
 //Spill a live range
 static void spill_in_function(basic_block_t* function_entry_block, dynamic_array_t* live_ranges, live_range_t* spill_range);
 
+/**
+ * These are all set up once before any function is allocated, and are
+ * never written to after that. Every worker is able to share them. Notably,
+ * the stack & instruction pointer LRs are shared by every function, so nothing
+ * in the function-level allocator is allowed to modify them
+ */
 //Just hold the stack pointer live range
 static live_range_t* stack_pointer_lr;
 //Holds the instruction pointer LR
@@ -51,6 +58,17 @@ static type_symtab_t* type_symtab;
 //The u64 type for reference
 static generic_type_t* u64_type;
 
+/**
+ * Everything that the function-level allocation
+ * jobs need to know about
+ */
+typedef struct{
+	//The options that we were invoked with
+	compiler_options_t* options;
+	//The CFG that we're allocating
+	cfg_t* cfg;
+} register_allocator_work_t;
+
 
 /**
  * What is the result of our live range coalescing run?
@@ -95,14 +113,14 @@ static void print_block_with_live_ranges(basic_block_t* block){
 	}
 
 	//If we have some assigned variables, we will dislay those for debugging
-	if(block->assigned_variables.internal_array != NULL){
+	if(block->analysis->assigned_variables.internal_array != NULL){
 		printf("Assigned: (");
 
-		for(u_int16_t i = 0; i < block->assigned_variables.current_index; i++){
-			print_live_range(stdout, dynamic_array_get_at(&(block->assigned_variables), i));
+		for(u_int16_t i = 0; i < block->analysis->assigned_variables.current_index; i++){
+			print_live_range(stdout, dynamic_array_get_at(&(block->analysis->assigned_variables), i));
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->assigned_variables.current_index - 1){
+			if(i != block->analysis->assigned_variables.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -110,14 +128,14 @@ static void print_block_with_live_ranges(basic_block_t* block){
 	}
 
 	//If we have some used variables, we will dislay those for debugging
-	if(block->used_before_definition.internal_array != NULL){
+	if(block->analysis->used_before_definition.internal_array != NULL){
 		printf("Used: (");
 
-		for(u_int16_t i = 0; i < block->used_before_definition.current_index; i++){
-			print_live_range(stdout, dynamic_array_get_at(&(block->used_before_definition), i));
+		for(u_int16_t i = 0; i < block->analysis->used_before_definition.current_index; i++){
+			print_live_range(stdout, dynamic_array_get_at(&(block->analysis->used_before_definition), i));
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->used_before_definition.current_index - 1){
+			if(i != block->analysis->used_before_definition.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -125,14 +143,14 @@ static void print_block_with_live_ranges(basic_block_t* block){
 	}
 
 	//If we have some assigned variables, we will dislay those for debugging
-	if(block->live_in.internal_array != NULL){
+	if(block->analysis->live_in.internal_array != NULL){
 		printf("LIVE IN: (");
 
-		for(u_int16_t i = 0; i < block->live_in.current_index; i++){
-			print_live_range(stdout, dynamic_array_get_at(&(block->live_in), i));
+		for(u_int16_t i = 0; i < block->analysis->live_in.current_index; i++){
+			print_live_range(stdout, dynamic_array_get_at(&(block->analysis->live_in), i));
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->live_in.current_index - 1){
+			if(i != block->analysis->live_in.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -140,14 +158,14 @@ static void print_block_with_live_ranges(basic_block_t* block){
 	}
 
 	//If we have some assigned variables, we will dislay those for debugging
-	if(block->live_out.internal_array != NULL){
+	if(block->analysis->live_out.internal_array != NULL){
 		printf("LIVE OUT: (");
 
-		for(u_int16_t i = 0; i < block->live_out.current_index; i++){
-			print_live_range(stdout, dynamic_array_get_at(&(block->live_out), i));
+		for(u_int16_t i = 0; i < block->analysis->live_out.current_index; i++){
+			print_live_range(stdout, dynamic_array_get_at(&(block->analysis->live_out), i));
 
 			//If it isn't the very last one, we need a comma
-			if(i != block->live_out.current_index - 1){
+			if(i != block->analysis->live_out.current_index - 1){
 				printf(", ");
 			}
 		}
@@ -545,10 +563,11 @@ static inline instruction_t* emit_stack_deallocation_statement(three_addr_var_t*
 
 
 /**
- * Increment and return the live range ID
+ * Increment and return the live range ID. Functions may be allocated on
+ * several threads at once, so this must be atomic
  */
 static inline u_int32_t increment_and_get_live_range_id(){
-	return live_range_id++;
+	return __atomic_fetch_add(&live_range_id, 1, __ATOMIC_RELAXED);
 }
 
 
@@ -579,21 +598,6 @@ static live_range_t* live_range_alloc(symtab_function_record_t* function_defined
 }
 
 
-/**
- * Free all the memory that's reserved by a live range
- */
-static void live_range_dealloc(live_range_t* live_range){
-	//First we'll destroy the array that it has
-	dynamic_array_dealloc((&live_range->variables));
-
-	//Destroy the neighbors array as well
-	dynamic_array_dealloc((&live_range->neighbors));
-
-	//Then we can destroy the live range itself
-	free(live_range);
-}
-
-
 /**
  * Create the stack pointer live range
  */
@@ -605,6 +609,8 @@ static inline live_range_t* construct_stack_pointer_live_range(three_addr_var_t*
 	stack_pointer_live_range->reg.gen_purpose = RSP;
 	//And we absolutely *can not* spill it
 	stack_pointer_live_range->spill_cost = UINT32_MAX;
+	//This is always the very first GP live range in every function
+	stack_pointer_live_range->interference_graph_index = 0;
 
 	//Add the stack pointer to the dynamic array
 	dynamic_array_add(&(stack_pointer_live_range->variables), stack_pointer);
@@ -631,6 +637,8 @@ static inline live_range_t* construct_instruction_pointer_live_range(three_addr_
 	instruction_pointer_live_range->reg.gen_purpose = RIP;
 	//And we absolutely *can not* spill it
 	instruction_pointer_live_range->spill_cost = UINT32_MAX;
+	//This is always the second GP live range in every function(right after the stack pointer)
+	instruction_pointer_live_range->interference_graph_index = 1;
 
 	//Add the stack pointer to the dynamic array
 	dynamic_array_add(&(instruction_pointer_live_range->variables), instruction_pointer);
@@ -696,8 +704,8 @@ static void add_live_range_to_def_set(live_range_t* live_range, basic_block_t* b
 	 * Assigning a live range to a variable means that this variable was *assigned* in the block
 	 * Do note that it may very well have also been used, but we do not handle that here
 	 */
-	if(dynamic_array_contains(&(block->assigned_variables), live_range) == NOT_FOUND){
-		dynamic_array_add(&(block->assigned_variables), live_range);
+	if(dynamic_array_contains(&(block->analysis->assigned_variables), live_range) == NOT_FOUND){
+		dynamic_array_add(&(block->analysis->assigned_variables), live_range);
 	}
 
 	/**
@@ -734,7 +742,7 @@ static void add_live_range_to_use_set(live_range_t* live_range, basic_block_t* b
 	 * As part of the criteria, we need to ensure that this live range is
 	 * *not* inside of the set of all ranges assigned by that block b
 	 */
-	if(dynamic_array_contains(&(block->assigned_variables), live_range) != NOT_FOUND){
+	if(dynamic_array_contains(&(block->analysis->assigned_variables), live_range) != NOT_FOUND){
 		return;
 	}
 
@@ -743,8 +751,8 @@ static void add_live_range_to_use_set(live_range_t* live_range, basic_block_t* b
 	 * is check that this LR isn't already accounted for in the set. If it's not,
 	 * then we'll add it
 	 */
-	if(dynamic_array_contains(&(block->used_before_definition), live_range) == NOT_FOUND){
-		dynamic_array_add(&(block->used_before_definition), live_range);
+	if(dynamic_array_contains(&(block->analysis->used_before_definition), live_range) == NOT_FOUND){
+		dynamic_array_add(&(block->analysis->used_before_definition), live_range);
 	}
 }
 
@@ -766,27 +774,27 @@ static inline void add_live_now_live_range(live_range_t* live_range, dynamic_arr
 static inline void reset_block_variable_tracking(basic_block_t* block){
 	//Let's first wipe everything regarding this block's used and assigned variables. If they don't exist,
 	//we'll allocate them fresh
-	if(block->assigned_variables.internal_array == NULL){
-		block->assigned_variables = dynamic_array_alloc();
+	if(block->analysis->assigned_variables.internal_array == NULL){
+		block->analysis->assigned_variables = dynamic_array_alloc();
 	} else {
-		clear_dynamic_array(&(block->assigned_variables));
+		clear_dynamic_array(&(block->analysis->assigned_variables));
 	}
 
 	//Do the same with the used variables
-	if(block->used_before_definition.internal_array == NULL){
-		block->used_before_definition = dynamic_array_alloc();
+	if(block->analysis->used_before_definition.internal_array == NULL){
+		block->analysis->used_before_definition = dynamic_array_alloc();
 	} else {
-		clear_dynamic_array(&(block->used_before_definition));
+		clear_dynamic_array(&(block->analysis->used_before_definition));
 	}
 
 	//Reset live in completely
-	if(block->live_in.internal_array != NULL){
-		dynamic_array_dealloc(&(block->live_in));
+	if(block->analysis->live_in.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->live_in));
 	}
 
 	//Reset live out completely
-	if(block->live_out.internal_array != NULL){
-		dynamic_array_dealloc(&(block->live_out));
+	if(block->analysis->live_out.internal_array != NULL){
+		dynamic_array_dealloc(&(block->analysis->live_out));
 	}
 }
 
@@ -820,6 +828,19 @@ static inline live_range_t* find_live_range_with_variable(dynamic_array_t* live_
  * Insert a variable into the Live Range and do any bookkeeping required
  */
 static inline void add_variable_to_live_range(live_range_t* live_range, three_addr_var_t* variable){
+	/**
+	 * The stack and instruction pointer LRs are shared by every function, so we can't modify them. They
+	 * already hold the one variable that we need to match against, so we only need to make the link.
+	 * We avoid the write if the link is already there, since the stack pointer variable itself is shared too
+	 */
+	if(live_range == stack_pointer_lr || live_range == instruction_pointer_lr){
+		if(variable->associated_live_range != live_range){
+			variable->associated_live_range = live_range;
+		}
+
+		return;
+	}
+
 	//Add the variable into the set of all variables 
 	if(dynamic_array_contains(&(live_range->variables), variable) == NOT_FOUND){
 		dynamic_array_add(&(live_range->variables), variable);
@@ -1212,8 +1233,8 @@ static inline void reset_function_blocks_for_liveness(dynamic_array_t* function_
 		basic_block_t* block = dynamic_array_get_at(function_blocks, i);
 
 		//Also reset the liveness sets
-		clear_dynamic_array(&(block->live_in));
-		clear_dynamic_array(&(block->live_out));
+		clear_dynamic_array(&(block->analysis->live_in));
+		clear_dynamic_array(&(block->analysis->live_out));
 	}
 }
 
@@ -1247,7 +1268,7 @@ static void calculate_live_range_liveness_sets(dynamic_array_t* function_blocks,
 	 * Then let the graph utility compute it for this function
 	 */
 	dynamic_array_t reverse_post_order_reverse_cfg = dynamic_array_alloc();
-	get_reverse_post_order_reverse_cfg_traversal(function_blocks, function_exit_block, &reverse_post_order_reverse_cfg);
+	get_reverse_post_order_reverse_cfg_traversal(function_exit_block, &reverse_post_order_reverse_cfg);
 
 	//Did we find a difference
 	u_int8_t difference_found;
@@ -1274,11 +1295,11 @@ static void calculate_live_range_liveness_sets(dynamic_array_t* function_blocks,
 			current = dynamic_array_get_at(&reverse_post_order_reverse_cfg, _);
 
 			//Transfer the pointers over
-			in_prime = current->live_in;
-			out_prime = current->live_out;
+			in_prime = current->analysis->live_in;
+			out_prime = current->analysis->live_out;
 
 			//Set live out to be a new array
-			current->live_out = dynamic_array_alloc();
+			current->analysis->live_out = dynamic_array_alloc();
 
 			//Run through all of the successors
 			for(int32_t k = 0; k < current->successors.current_index; k++){
@@ -1286,13 +1307,13 @@ static void calculate_live_range_liveness_sets(dynamic_array_t* function_blocks,
 				basic_block_t* successor = dynamic_array_get_at(&(current->successors), k);
 
 				//Add everything in his live_in set into the live_out set
-				for(int32_t l = 0; l < successor->live_in.current_index; l++){
+				for(int32_t l = 0; l < successor->analysis->live_in.current_index; l++){
 					//Let's check to make sure we haven't already added this
-					live_range_t* successor_live_in_var = dynamic_array_get_at(&(successor->live_in), l);
+					live_range_t* successor_live_in_var = dynamic_array_get_at(&(successor->analysis->live_in), l);
 
 					//If it doesn't already contain this variable, we'll add it in
-					if(dynamic_array_contains(&(current->live_out), successor_live_in_var) == NOT_FOUND){
-						dynamic_array_add(&(current->live_out), successor_live_in_var);
+					if(dynamic_array_contains(&(current->analysis->live_out), successor_live_in_var) == NOT_FOUND){
+						dynamic_array_add(&(current->analysis->live_out), successor_live_in_var);
 					}
 				}
 			}
@@ -1301,21 +1322,21 @@ static void calculate_live_range_liveness_sets(dynamic_array_t* function_blocks,
 			 * Since we need all of the used variables, we'll just clone this
 			 * dynamic array so that we start off with them all
 			 */
-			current->live_in = clone_dynamic_array(&(current->used_before_definition));
+			current->analysis->live_in = clone_dynamic_array(&(current->analysis->used_before_definition));
 
 			//Now we need to add every variable that is in LIVE_OUT but NOT in assigned
-			for(int32_t j = 0; j  < current->live_out.current_index; j++){
+			for(int32_t j = 0; j  < current->analysis->live_out.current_index; j++){
 				//Grab a reference for our use
-				live_range_t* live_out_var = dynamic_array_get_at(&(current->live_out), j);
+				live_range_t* live_out_var = dynamic_array_get_at(&(current->analysis->live_out), j);
 
 				/**
 				 * Now we need this block to be not in "assigned" also. If it is in assigned we can't
 				 * add it. Additionally, we'll want to make sure we aren't adding duplicate live ranges
 				 */
-				if(dynamic_array_contains(&(current->assigned_variables), live_out_var) == NOT_FOUND 
-					&& dynamic_array_contains(&(current->live_in), live_out_var) == NOT_FOUND){
+				if(dynamic_array_contains(&(current->analysis->assigned_variables), live_out_var) == NOT_FOUND 
+					&& dynamic_array_contains(&(current->analysis->live_in), live_out_var) == NOT_FOUND){
 					//If this is true we can add
-					dynamic_array_add(&(current->live_in), live_out_var);
+					dynamic_array_add(&(current->analysis->live_in), live_out_var);
 				}
 			}
 			
@@ -1328,8 +1349,8 @@ static void calculate_live_range_liveness_sets(dynamic_array_t* function_blocks,
 			//For efficiency - if there was a difference in one block, it's already done - no use in comparing
 			if(difference_found == FALSE){
 				//So we haven't found a difference so far - let's see if we can find one now
-				if(dynamic_arrays_equal(&in_prime, &(current->live_in)) == FALSE
-				  || dynamic_arrays_equal(&out_prime, &(current->live_out)) == FALSE){
+				if(dynamic_arrays_equal(&in_prime, &(current->analysis->live_in)) == FALSE
+				  || dynamic_arrays_equal(&out_prime, &(current->analysis->live_out)) == FALSE){
 					//We have in fact found a difference
 					difference_found = TRUE;
 				}
@@ -1357,6 +1378,11 @@ static void reset_all_live_ranges(dynamic_array_t* live_ranges){
 		//Grab the live range out
 		live_range_t* current = dynamic_array_get_at(live_ranges, i);
 
+		//These are shared by every function and never change, so they're left alone
+		if(current == stack_pointer_lr || current == instruction_pointer_lr){
+			continue;
+		}
+
 		//Set the degree to be 0 as well
 		current->degree = 0;
 
@@ -1395,7 +1421,7 @@ static dynamic_array_t calculate_live_after_for_block(basic_block_t* block, inst
 	 * out as LIVE_OUT. For this reason, we will just use the LIVE_OUT
 	 * set by a different name for our calculation
 	 */
-	dynamic_array_t live_after = clone_dynamic_array(&(block->live_out));
+	dynamic_array_t live_after = clone_dynamic_array(&(block->analysis->live_out));
 
 	//For later use
 	dynamic_array_t operation_function_parameters;
@@ -1602,8 +1628,8 @@ static void calculate_all_interference_in_block(basic_block_t* block){
 	 * distinction between float and non float live ranges though, so we
 	 * will maintain 2 separate live now buckets
 	 */
-	dynamic_array_t live_now_general_purpose = get_live_ranges_from_given_class(&(block->live_out), LIVE_RANGE_CLASS_GEN_PURPOSE);
-	dynamic_array_t live_now_sse = get_live_ranges_from_given_class(&(block->live_out), LIVE_RANGE_CLASS_SSE);
+	dynamic_array_t live_now_general_purpose = get_live_ranges_from_given_class(&(block->analysis->live_out), LIVE_RANGE_CLASS_GEN_PURPOSE);
+	dynamic_array_t live_now_sse = get_live_ranges_from_given_class(&(block->analysis->live_out), LIVE_RANGE_CLASS_SSE);
 
 	//We will crawl our way up backwards through the CFG
 	instruction_t* operation = block->exit_statement;
@@ -1765,6 +1791,10 @@ static void calculate_all_interference_in_block(basic_block_t* block){
 		//Crawl back up by 1
 		operation = operation->previous_statement;
 	}
+
+	//These were only ever needed for this block
+	dynamic_array_dealloc(&live_now_general_purpose);
+	dynamic_array_dealloc(&live_now_sse);
 }
 
 
@@ -1820,7 +1850,7 @@ static inline void calculate_all_interferences_in_function(basic_block_t* functi
  */
 static void calculate_target_interference_in_block(basic_block_t* block, live_range_class_t target_class){
 	//Get the specific live_now bucket based on the target class
-	dynamic_array_t target_live_now = get_live_ranges_from_given_class(&(block->live_out), target_class);
+	dynamic_array_t target_live_now = get_live_ranges_from_given_class(&(block->analysis->live_out), target_class);
 
 	//We will crawl our way up backwards through the CFG
 	instruction_t* operation = block->exit_statement;
@@ -1952,6 +1982,9 @@ static void calculate_target_interference_in_block(basic_block_t* block, live_ra
 		//Crawl back up by 1
 		operation = operation->previous_statement;
 	}
+
+	//This was only ever needed for this block
+	dynamic_array_dealloc(&target_live_now);
 }
 
 
@@ -2278,8 +2311,8 @@ static void precolor_function(basic_block_t* function_entry, dynamic_array_t* ge
  */
 static void compute_block_level_used_and_assigned_sets(basic_block_t* block){
 	//We can reset these completely
-	clear_dynamic_array(&(block->used_before_definition));
-	clear_dynamic_array(&(block->assigned_variables));
+	clear_dynamic_array(&(block->analysis->used_before_definition));
+	clear_dynamic_array(&(block->analysis->assigned_variables));
 
 	//Instruction cursor
 	instruction_t* cursor = block->leader_statement;
@@ -3795,10 +3828,12 @@ static instruction_t* insert_caller_saved_logic_for_direct_call(symtab_function_
 
 				/**
 				 * Once we get past here, we know that we need to save this
-				 * register because the callee will also assign it, so whatever
-				 * value it has that we're relying on would not survive the call
+				 * register because the callee(or something that it calls) will also
+				 * assign it, so whatever value it has that we're relying on would not
+				 * survive the call. If the callee has not been colored yet(it is further
+				 * down the stream), we have to assume that it clobbers everything
 				 */
-				if(get_bitmap_at_index(callee->assigned_general_purpose_registers, general_purpose_reg - 1) == TRUE){
+				if(callee->registers_assigned == FALSE || get_bitmap_at_index(callee->clobbered_general_purpose_registers, general_purpose_reg - 1) == TRUE){
 					//Allocate here if need be
 					if(general_purpose_lrs_to_save.internal_array == NULL){
 						general_purpose_lrs_to_save = dynamic_array_alloc();
@@ -3831,10 +3866,11 @@ static instruction_t* insert_caller_saved_logic_for_direct_call(symtab_function_
 
 				/**
 				 * Once we get past here, we know that we need to save this
-				 * register because the callee will also assign it, so whatever
-				 * value it has that we're relying on would not survive the call
+				 * register because the callee(or something that it calls) will also
+				 * assign it, so whatever value it has that we're relying on would not
+				 * survive the call
 				 */
-				if(get_bitmap_at_index(callee->assigned_sse_registers, sse_reg - 1) == TRUE){
+				if(callee->registers_assigned == FALSE || get_bitmap_at_index(callee->clobbered_sse_registers, sse_reg - 1) == TRUE){
 					//Allocate here if need be
 					if(SSE_lrs_to_save.internal_array == NULL){
 						SSE_lrs_to_save = dynamic_array_alloc();
@@ -4683,7 +4719,7 @@ static inline void finalize_local_and_parameter_stack_logic(cfg_t* cfg, basic_bl
 /**
  * Perform our function level allocation process
  */
-static void allocate_registers_for_function(compiler_options_t* options, cfg_t* cfg, basic_block_t* function_entry, basic_block_t* function_exit){
+static void allocate_registers_for_function(compiler_options_t* options, basic_block_t* function_entry, basic_block_t* function_exit){
 	//Extract the function blocks
 	dynamic_array_t* function_blocks = &(function_entry->function_defined_in->function_blocks);
 
@@ -4845,6 +4881,7 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 				calculate_target_interferences_in_function(function_entry, LIVE_RANGE_CLASS_GEN_PURPOSE);
 
 				//Now construct the specific interference graph that we need
+				interference_graph_dealloc(general_purpose_graph);
 				general_purpose_graph = construct_interference_graph_from_adjacency_lists(&general_purpose_live_ranges);
 
 				//Now we coalesce for the GP result only. We do this because in theory, we should not
@@ -4872,6 +4909,7 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 				calculate_target_interferences_in_function(function_entry, LIVE_RANGE_CLASS_SSE);
 
 				//Now construct the specific interference graph that we need
+				interference_graph_dealloc(sse_graph);
 				sse_graph = construct_interference_graph_from_adjacency_lists(&sse_live_ranges);
 
 				//Now we coalesce for the SSE result only. We do this because in theory, we should not
@@ -4901,7 +4939,9 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 				calculate_all_interferences_in_function(function_entry);
 
 				//Now rebuild both of the graphs
+				interference_graph_dealloc(general_purpose_graph);
 				general_purpose_graph = construct_interference_graph_from_adjacency_lists(&general_purpose_live_ranges);
+				interference_graph_dealloc(sse_graph);
 				sse_graph = construct_interference_graph_from_adjacency_lists(&sse_live_ranges);
 
 				//And finally - invoke the coalescer again to see what we get
@@ -4986,6 +5026,7 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 		 * Once the liveness sets have been recalculated, we're able
 		 * to go through and compute all of the interference again
 		 */
+		interference_graph_dealloc(general_purpose_graph);
 		general_purpose_graph = construct_interference_graph_from_adjacency_lists(&general_purpose_live_ranges);
 
 		//Show our live ranges once again if requested
@@ -5063,6 +5104,7 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 			/**
 			 * Now we can rebuild our graph from what we had before
 			 */
+			interference_graph_dealloc(sse_graph);
 			sse_graph = construct_interference_graph_from_adjacency_lists(&sse_live_ranges);
 
 			//Show our live ranges once again if requested
@@ -5083,10 +5125,42 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 		}
 	}
 
+	//The graphs are no longer needed once everything is colored
+	interference_graph_dealloc(general_purpose_graph);
+	interference_graph_dealloc(sse_graph);
+
+	/**
+	 * The live ranges themselves have to stay around until the function is written out, because
+	 * that's where the registers come from. The function holds onto them until it's deallocated.
+	 * The stack and instruction pointer ranges are shared by everything, so those aren't handed over
+	 */
+	dynamic_array_t* function_live_ranges = &(function_entry->function_defined_in->live_ranges);
+	for(int32_t i = 0; i < general_purpose_live_ranges.current_index; i++){
+		live_range_t* live_range = dynamic_array_get_at(&general_purpose_live_ranges, i);
+
+		if(live_range != stack_pointer_lr && live_range != instruction_pointer_lr){
+			dynamic_array_add(function_live_ranges, live_range);
+		}
+	}
+
+	for(int32_t i = 0; i < sse_live_ranges.current_index; i++){
+		dynamic_array_add(function_live_ranges, dynamic_array_get_at(&sse_live_ranges, i));
+	}
+
 	//Destroy both of these now that we're done
 	dynamic_array_dealloc(&general_purpose_live_ranges);
 	dynamic_array_dealloc(&sse_live_ranges);
 
+	//The assigned register bitmaps are now final, so callers may rely on them
+	function_entry->function_defined_in->registers_assigned = TRUE;
+}
+
+
+/**
+ * Insert all saving logic and finalize the stack for a function that has already
+ * been colored. This must only be run once *every* function has been colored
+ */
+static void finalize_registers_for_function(cfg_t* cfg, basic_block_t* function_entry, basic_block_t* function_exit){
 	/**
 	 * STEP 8: caller/callee saving logic
 	 *
@@ -5095,7 +5169,8 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 	 * when appropriate
 	 *
 	 * NOTE: We cannot do this at the individual function step because it does require
-	 * that we have all functions completely allocated before going forward.
+	 * that we have all functions completely allocated before going forward. The caller
+	 * saving logic needs to know which registers every callee ends up using
 	 */
 	insert_saving_logic(function_entry, function_exit);
 
@@ -5114,13 +5189,183 @@ static void allocate_registers_for_function(compiler_options_t* options, cfg_t*
 
 
 /**
- * Perform our register allocation algorithm on the entire cfg
+ * Work out every register that a call to this already colored function could overwrite. That's
+ * whatever the function is assigned itself, plus whatever everything that it calls clobbers. A callee
+ * that hasn't been colored, an indirect call or inline assembly could overwrite anything at all
+ *
+ * Callees that are colored but not summarized yet only give back part of the answer, so when
+ * there is recursion this needs to be rerun until nothing changes. We give back TRUE if the
+ * function's bitmaps grew
  */
-void allocate_all_registers(compiler_options_t* options, cfg_t* cfg){
-	//Save whether or not we want to actually print IRs
-	u_int8_t print_irs = options->print_irs;
-	u_int8_t print_post_allocation = options->print_post_allocation;
+static u_int8_t summarize_function_clobbers(basic_block_t* function_entry){
+	symtab_function_record_t* function = function_entry->function_defined_in;
+
+	//Whatever this function is assigned itself is always clobbered
+	u_int32_t general_purpose_clobbers = function->clobbered_general_purpose_registers | function->assigned_general_purpose_registers;
+	u_int32_t sse_clobbers = function->clobbered_sse_registers | function->assigned_sse_registers;
+
+	//Run through every block in the function
+	basic_block_t* cursor = function_entry;
+	while(cursor != NULL && cursor->function_defined_in == function){
+		for(instruction_t* instruction = cursor->leader_statement; instruction != NULL; instruction = instruction->next_statement){
+			switch(instruction->instruction_type){
+				case CALL:
+					//Nothing is known about this one yet, so it could be anything
+					if(instruction->called_function->registers_assigned == FALSE){
+						general_purpose_clobbers = UINT32_MAX;
+						sse_clobbers = UINT32_MAX;
+						break;
+					}
+
+					general_purpose_clobbers |= instruction->called_function->clobbered_general_purpose_registers;
+					sse_clobbers |= instruction->called_function->clobbered_sse_registers;
+					break;
+
+				//We have no idea what either of these touch
+				case INDIRECT_CALL:
+				case ASM_INLINE:
+					general_purpose_clobbers = UINT32_MAX;
+					sse_clobbers = UINT32_MAX;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		//Advance down to the direct successor
+		cursor = cursor->direct_successor;
+	}
+
+	//Did anything new show up?
+	u_int8_t changed = general_purpose_clobbers != function->clobbered_general_purpose_registers
+						|| sse_clobbers != function->clobbered_sse_registers;
+
+	function->clobbered_general_purpose_registers = general_purpose_clobbers;
+	function->clobbered_sse_registers = sse_clobbers;
+
+	return changed;
+}
+
+
+/**
+ * Add the function at the given index to the order after every function that it calls
+ */
+static void add_function_in_bottom_up_order(cfg_t* cfg, int32_t function_index, u_int8_t* visited, dynamic_integer_array_t* order){
+	visited[function_index] = TRUE;
+
+	basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), function_index);
+	symtab_function_record_t* function = function_entry->function_defined_in;
+
+	//All of the callees go first
+	for(u_int16_t i = 0; i < function->called_functions.current_index; i++){
+		symtab_function_record_t* callee = dynamic_set_get_at(&(function->called_functions), i);
+
+		//There's no body for this one, so there's nothing to put in the order
+		if(callee->function_entry_block == NULL){
+			continue;
+		}
+
+		int16_t callee_index = dynamic_array_contains(&(cfg->function_entry_blocks), callee->function_entry_block);
+
+		//Either not in the cfg at all or already handled(this is where recursion gets cut off)
+		if(callee_index == -1 || visited[callee_index] == TRUE){
+			continue;
+		}
+
+		add_function_in_bottom_up_order(cfg, callee_index, visited, order);
+	}
+
+	dynamic_integer_array_add(order, function_index);
+}
+
+
+/**
+ * Get the indices of every function in the cfg ordered so that callees come before
+ * their callers wherever the call graph allows it
+ */
+dynamic_integer_array_t get_bottom_up_function_order(cfg_t* cfg){
+	dynamic_integer_array_t order = dynamic_integer_array_alloc_initial_size(cfg->function_entry_blocks.current_index);
+
+	u_int8_t* visited = calloc(cfg->function_entry_blocks.current_index, sizeof(u_int8_t));
+
+	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
+		if(visited[i] == FALSE){
+			add_function_in_bottom_up_order(cfg, i, visited, &order);
+		}
+	}
+
+	free(visited);
+
+	return order;
+}
+
+
+/**
+ * Once every function has been colored, work out what a call to each one clobbers. Going bottom up
+ * means that callees are all summarized before their callers, so this only needs to go around
+ * more than once when there is recursion
+ */
+static void summarize_all_function_clobbers(cfg_t* cfg){
+	dynamic_integer_array_t order = get_bottom_up_function_order(cfg);
+
+	u_int8_t changed;
+	do {
+		changed = FALSE;
+
+		for(int32_t i = 0; i < order.current_index; i++){
+			basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), dynamic_integer_array_get_at(&order, i));
+
+			if(summarize_function_clobbers(function_entry) == TRUE){
+				changed = TRUE;
+			}
+		}
+	} while(changed == TRUE);
+
+	dynamic_integer_array_dealloc(&order);
+}
+
+
+/**
+ * Color a single function. This is the unit of work that we hand
+ * off to the thread pool
+ */
+static void allocate_registers_job(void* shared_state, u_int32_t function_index){
+	register_allocator_work_t* work = shared_state;
+
+	//Extract the given function entry
+	basic_block_t* function_entry = dynamic_array_get_at(&(work->cfg->function_entry_blocks), function_index);
+
+	//Also extract the function exit block
+	basic_block_t* function_exit = dynamic_array_get_at(&(work->cfg->function_exit_blocks), function_index);
+
+	//Invoke the function-level allocator
+	allocate_registers_for_function(work->options, function_entry, function_exit);
+}
+
 
+/**
+ * Insert the saving logic for a single function. This is the unit of work
+ * that we hand off to the thread pool once every function has been colored
+ */
+static void finalize_registers_job(void* shared_state, u_int32_t function_index){
+	register_allocator_work_t* work = shared_state;
+
+	//Extract the given function entry
+	basic_block_t* function_entry = dynamic_array_get_at(&(work->cfg->function_entry_blocks), function_index);
+
+	//Also extract the function exit block
+	basic_block_t* function_exit = dynamic_array_get_at(&(work->cfg->function_exit_blocks), function_index);
+
+	//Invoke the function-level finalizer
+	finalize_registers_for_function(work->cfg, function_entry, function_exit);
+}
+
+
+/**
+ * Load up all of the global state that the allocator shares between functions
+ */
+static void initialize_register_allocator(cfg_t* cfg){
 	//Save these in global state
 	stack_pointer = cfg->stack_pointer;
 	type_symtab = cfg->type_symtab;
@@ -5131,20 +5376,70 @@ void allocate_all_registers(compiler_options_t* options, cfg_t* cfg){
 	//globally
 	stack_pointer_lr = construct_stack_pointer_live_range(stack_pointer);
 	instruction_pointer_lr = construct_instruction_pointer_live_range(cfg->instruction_pointer);
+}
 
-	//Run through every function entry block individually and invoke the allocator on
-	//all of them separately
-	for(int32_t i = 0; i < cfg->function_entry_blocks.current_index; i++){
-		//Extract the given function entry
-		basic_block_t* function_entry = dynamic_array_get_at(&(cfg->function_entry_blocks), i);
-
-		//Also extract the function exit block
-		basic_block_t* function_exit = dynamic_array_get_at(&(cfg->function_exit_blocks), i);
 
-		//Invoke the function-level allocator
-		allocate_registers_for_function(options, cfg, function_entry, function_exit);
+/**
+ * Perform the entire register allocation algorithm, including the final
+ * postprocessing, on one function by itself. Any function that this one calls
+ * that has not been allocated yet is assumed to clobber every caller-saved register,
+ * so functions should be handed in with get_bottom_up_function_order
+ */
+void allocate_registers_in_function(compiler_options_t* options, cfg_t* cfg, u_int32_t function_index){
+	//The evergreen live ranges are only ever built once
+	if(stack_pointer_lr == NULL){
+		initialize_register_allocator(cfg);
 	}
 
+	//Package up what the jobs need
+	register_allocator_work_t work = {options, cfg};
+
+	//Color it first
+	allocate_registers_job(&work, function_index);
+
+	//Everything that this calls is as done as it's going to get, so its clobbers are final
+	summarize_function_clobbers(dynamic_array_get_at(&(cfg->function_entry_blocks), function_index));
+
+	//Now that we know everything that this function assigns, the saving logic can go in
+	finalize_registers_job(&work, function_index);
+
+	//Final cleanup pass for this function only
+	postprocess_function(cfg, dynamic_array_get_at(&(cfg->function_entry_blocks), function_index));
+}
+
+
+/**
+ * Perform our register allocation algorithm on the entire cfg
+ */
+void allocate_all_registers(compiler_options_t* options, cfg_t* cfg){
+	//Save whether or not we want to actually print IRs
+	u_int8_t print_irs = options->print_irs;
+	u_int8_t print_post_allocation = options->print_post_allocation;
+
+	//Set up all of the shared state
+	initialize_register_allocator(cfg);
+
+	//Package up what every job needs
+	register_allocator_work_t work = {options, cfg};
+
+	/**
+	 * Run through every function individually and invoke the allocator on all of them
+	 * separately. Every function's coloring is independent, so this is done in parallel
+	 */
+	thread_pool_run(options->thread_count, cfg->function_entry_blocks.current_index, allocate_registers_job, &work);
+
+	/**
+	 * With every function colored, we can work out everything that a call to each one
+	 * clobbers. The caller saving logic only needs to save those registers
+	 */
+	summarize_all_function_clobbers(cfg);
+
+	/**
+	 * Once every function has been colored, we're able to go through and insert
+	 * all of the saving logic. Again this is function by function
+	 */
+	thread_pool_run(options->thread_count, cfg->function_entry_blocks.current_index, finalize_registers_job, &work);
+
 	/**
 	 * STEP 10: final cleanup pass
 	 *
@@ -11,9 +11,21 @@
 #include "../cfg/cfg.h"
 
 /**
- * Perform our register allocation algorithm on the entire cfg. This is the only
- * API that is exposed to the rest of the compiler
+ * Perform our register allocation algorithm on the entire cfg
  */
 void allocate_all_registers(compiler_options_t* options, cfg_t* cfg);
 
+/**
+ * Allocate registers for, and postprocess, the function at the given index all on its own. This
+ * is used when functions are streamed through the back end one at a time
+ */
+void allocate_registers_in_function(compiler_options_t* options, cfg_t* cfg, u_int32_t function_index);
+
+/**
+ * Get the indices of every function in the cfg ordered so that callees come before
+ * their callers wherever the call graph allows it. Allocating in this order means that
+ * callers know exactly which registers a call can clobber
+ */
+dynamic_integer_array_t get_bottom_up_function_order(cfg_t* cfg);
+
 #endif /* REGISTER_ALLOCATOR_H */
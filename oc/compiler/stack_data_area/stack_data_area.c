@@ -20,11 +20,12 @@ static u_int32_t current_stack_region_id = 0;
 
 /**
  * Returns the current region Id, then increments
- * holder
+ * holder. The register allocator may create regions from
+ * several threads at once, so this must be atomic
  */
 static u_int32_t increment_and_get_stack_region_id(){
 	//Get the old value and then increment
-	return current_stack_region_id++;
+	return __atomic_fetch_add(&current_stack_region_id, 1, __ATOMIC_RELAXED);
 }
 
 
@@ -114,6 +115,19 @@ void mark_stack_region(stack_region_t* region){
 }
 
 
+/**
+ * Clear the mark on every region in the data area. Anything that is still used will be
+ * marked again by the next mark pass, and whatever is left unmarked can then be swept
+ */
+void reset_stack_data_area_marks(stack_data_area_t* area){
+	for(int32_t i = 0; i < area->stack_regions.current_index; i++){
+		stack_region_t* region = dynamic_array_get_at(&(area->stack_regions), i);
+
+		region->mark = FALSE;
+	}
+}
+
+
 /**
  * Create a stack region for the type provided. This will handle alignment and addition
  * of this stack region
@@ -34,6 +34,12 @@ stack_region_t* create_stack_region_for_type(stack_data_area_t* area, generic_ty
  */
 void mark_stack_region(stack_region_t* region);
 
+/**
+ * Clear the mark on every region in the data area so that the next
+ * mark and sweep can find the regions that are no longer used
+ */
+void reset_stack_data_area_marks(stack_data_area_t* area);
+
 /**
  * Remove a given region from the stack
  */
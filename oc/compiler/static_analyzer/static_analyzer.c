@@ -69,40 +69,17 @@ static void print_static_analyzer_message(error_message_type_t message_type, cha
 
 
 /**
- * Run through an entire array of function blocks and reset the status for
- * every single one. We assume that the caller knows what they are doing, and
- * that the blocks inside of the array are really the correct blocks
+ * Reset the "visited"(ever on the worklist) and "already has a phi function" flags
+ * for every block in a function. Both of these live in the function's side tables,
+ * so this is O(1) no matter how many blocks there are. We use the visited table for
+ * the worklist flag and the mark table for the phi function flag
  */
-static inline void reset_visited_status_for_function(dynamic_array_t* function_blocks){
-	//Run through all of the blocks
-	for(int32_t i = 0; i < function_blocks->current_index; i++){
-		//Extract the current block
-		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
-
-		//Flag it as false
-		current->visited = FALSE;
-	}
-}
-
-
-/**
- * Run through an entire array of function blocks and reset the status and 
- * "already_has_phi_func" fields for every single one. We assume that 
- * the caller knows what they are doing, and that the blocks inside of 
- * the array are really the correct blocks
- */
-static inline void reset_status_for_phi_function_insertion(dynamic_array_t* function_blocks){
-	//Run through all of the blocks
-	for(int32_t i = 0; i < function_blocks->current_index; i++){
-		//Extract the current block
-		basic_block_t* current = dynamic_array_get_at(function_blocks, i);
+static inline void reset_status_for_phi_function_insertion(symtab_function_record_t* function){
+	//Unvisit everything
+	reset_block_visits_for_function(function);
 
-		//Flag it as false
-		current->visited = FALSE;
-
-		//Remove the phi function flag
-		current->already_has_phi_func = FALSE;
-	}
+	//Remove every phi function flag
+	reset_block_marks_for_function(function);
 }
 
 
@@ -133,8 +110,8 @@ static inline u_int8_t does_block_assign_variable(basic_block_t* block, symtab_v
 	/**
 	 * If the linked variable to this var is ours, we do assign
 	 */
-	for(int32_t i = 0; i < block->assigned_variables.current_index; i++){
-		three_addr_var_t* var = dynamic_array_get_at(&(block->assigned_variables), i);
+	for(int32_t i = 0; i < block->analysis->assigned_variables.current_index; i++){
+		three_addr_var_t* var = dynamic_array_get_at(&(block->analysis->assigned_variables), i);
 		
 		//Now we'll compare the linked variable to the record
 		if(var->linked_var == variable){
@@ -177,7 +154,7 @@ static inline void add_variable_to_def_set(three_addr_var_t* variable, basic_blo
 	}
 
 	//Extract the set that we'll be working with
-	dynamic_array_t* def_set = &(block->assigned_variables);
+	dynamic_array_t* def_set = &(block->analysis->assigned_variables);
 
 	//Otherwise, let's make sure it's not also in DEF
 	for(int32_t i = 0; i < def_set->current_index; i++){
@@ -584,7 +561,7 @@ static inline u_int8_t does_block_dominate_target(basic_block_t* block, basic_bl
 		}
 
 		//Crawl up the dominator chain
-		current = current->dominator_info.immediate_dominator;
+		current = current->analysis->dominator_info.immediate_dominator;
 	}
 
 	//We could not find it in the IDOM chain, so it does not dominate the target
@@ -651,7 +628,7 @@ static inline void pruned_phi_function_insertion(symtab_variable_record_t* varia
 	 * Reset the "has_phi_function" tag on all of our blocks
 	 * for the next go around
 	 */
-	reset_status_for_phi_function_insertion(function_blocks);
+	reset_status_for_phi_function_insertion(variable_function);
 
 	/**
 	 * Queue up every block that we have on record as assigning this
@@ -668,7 +645,7 @@ static inline void pruned_phi_function_insertion(symtab_variable_record_t* varia
 			dynamic_array_add(worklist, block);
 
 			//Visited acts as our "Ever on worklist" flag
-			block->visited = TRUE;
+			mark_block_visited(block);
 		}
 	}
 
@@ -682,13 +659,13 @@ static inline void pruned_phi_function_insertion(symtab_variable_record_t* varia
 		 * every block in that block's dominance frontier(just barely
 		 * not dominated by that block)
 		 */
-		for(int32_t l = 0; l < node->dominance_frontier.current_index; l++){
-			basic_block_t* df_node = dynamic_array_get_at(&(node->dominance_frontier), l);
+		for(int32_t l = 0; l < node->analysis->dominance_frontier.current_index; l++){
+			basic_block_t* df_node = dynamic_array_get_at(&(node->analysis->dominance_frontier), l);
 
 			/**
 			 * If this already has a phi function for this run we skip it
 			 */
-			if(df_node->already_has_phi_func == TRUE){
+			if(does_block_contain_mark(df_node) == TRUE){
 				continue;
 			}
 
@@ -699,7 +676,7 @@ static inline void pruned_phi_function_insertion(symtab_variable_record_t* varia
 			 * being LIVE_IN at the block and most of the time, this is all we need to 
 			 * insert
 			 */
-			if(does_variable_dynamic_array_contain_symtab_variable(&(df_node->live_in), variable) == FALSE){
+			if(does_variable_dynamic_array_contain_symtab_variable(&(df_node->analysis->live_in), variable) == FALSE){
 				continue;
 			}
 
@@ -708,15 +685,15 @@ static inline void pruned_phi_function_insertion(symtab_variable_record_t* varia
 			add_phi_statement(df_node, phi_stmt);
 
 			//Flag that this now already has a phi function
-			df_node->already_has_phi_func = TRUE;
+			mark_block(df_node);
 
 			/**
 			 * If the dominance frontier node has never been on the worklist before, we'll
 			 * need to add it to the worklist now and flag that it's been here
 			 * to avoid reprocessing
 			 */
-			if(df_node->visited == FALSE){
-				df_node->visited = TRUE;
+			if(is_block_visited(df_node) == FALSE){
+				mark_block_visited(df_node);
 				dynamic_array_add(worklist, df_node);
 			}
 		}
@@ -790,7 +767,7 @@ static inline void non_pruned_phi_function_insertion(symtab_variable_record_t* v
 	 * Reset the "has_phi_function" tag on all of our blocks
 	 * for the next go around
 	 */
-	reset_status_for_phi_function_insertion(function_blocks);
+	reset_status_for_phi_function_insertion(variable_function);
 
 	/**
 	 * Queue up every block that we have on record as assigning this
@@ -807,7 +784,7 @@ static inline void non_pruned_phi_function_insertion(symtab_variable_record_t* v
 			dynamic_array_add(worklist, block);
 
 			//Visited acts as our "Ever on worklist" flag
-			block->visited = TRUE;
+			mark_block_visited(block);
 		}
 	}
 
@@ -821,13 +798,13 @@ static inline void non_pruned_phi_function_insertion(symtab_variable_record_t* v
 		 * every block in that block's dominance frontier(just barely
 		 * not dominated by that block).
 		 */
-		for(int32_t l = 0; l < node->dominance_frontier.current_index; l++){
-			basic_block_t* df_node = dynamic_array_get_at(&(node->dominance_frontier), l);
+		for(int32_t l = 0; l < node->analysis->dominance_frontier.current_index; l++){
+			basic_block_t* df_node = dynamic_array_get_at(&(node->analysis->dominance_frontier), l);
 
 			/**
 			 * If this already has a phi function for this run we skip it
 			 */
-			if(df_node->already_has_phi_func == TRUE){
+			if(does_block_contain_mark(df_node) == TRUE){
 				continue;
 			}
 
@@ -846,15 +823,15 @@ static inline void non_pruned_phi_function_insertion(symtab_variable_record_t* v
 			add_phi_statement(df_node, phi_stmt);
 
 			//Flag that this now already has a phi function
-			df_node->already_has_phi_func = TRUE;
+			mark_block(df_node);
 
 			/**
 			 * If the dominance frontier node has never been on the worklist before, we'll
 			 * need to add it to the worklist now and flag that it's been here
 			 * to avoid reprocessing
 			 */
-			if(df_node->visited == FALSE){
-				df_node->visited = TRUE;
+			if(is_block_visited(df_node) == FALSE){
+				mark_block_visited(df_node);
 				dynamic_array_add(worklist, df_node);
 			}
 		}
@@ -967,12 +944,12 @@ static inline void insert_phi_functions(variable_symtab_t* var_symtab){
  */
 static void rename_block(basic_block_t* entry){
 	//If we've previously visited this block, then return
-	if(entry->visited == TRUE){
+	if(is_block_visited(entry) == TRUE){
 		return;
 	}
 
 	//Flag that we've visited
-	entry->visited = TRUE;
+	mark_block_visited(entry);
 
 	/**
 	 * If this is a function entry block, then all of it's
@@ -1104,8 +1081,8 @@ static void rename_block(basic_block_t* entry){
 	 * Now that we're done with the renaming, we'll go through each dominator child in this node
 	 * and perform the same operation
 	 */
-	for(int32_t i = 0; i < entry->dominator_children.current_index; i++){
-		rename_block(dynamic_array_get_at(&(entry->dominator_children), i));
+	for(int32_t i = 0; i < entry->analysis->dominator_children.current_index; i++){
+		rename_block(dynamic_array_get_at(&(entry->analysis->dominator_children), i));
 	}
 
 	/**
@@ -1147,8 +1124,8 @@ static void rename_block(basic_block_t* entry){
  * Rename all of the variables in the CFG
  */
 static inline void rename_all_variables(cfg_t* cfg){
-	//Before we do this - let's reset the entire CFG(all created blocks)
-	reset_visited_status_for_function(&(cfg->created_blocks));
+	//Before we do this - let's reset the visited status for every function
+	reset_visited_status(cfg, FALSE);
 
 	/**
 	 * We will call the rename block function on the first block
@@ -1380,7 +1357,7 @@ static inline void perform_dataflow_analysis_for_function(basic_block_t* functio
 	 * Get the post order traversal for this function. We will iterate over
 	 * it backwards to get the reverse post order traversal(level order)
 	 */
-	get_post_order_traversal(&(function_entry->function_defined_in->function_blocks), function_entry, postorder_traversal);
+	get_post_order_traversal(function_entry, postorder_traversal);
 
 	/**
 	 * Before we can perform the actual dataflow analysis, we need to go through and populate the initialization
@@ -1702,8 +1679,8 @@ static u_int8_t perform_initialization_and_mutability_analysis_for_block(basic_b
 	 * For all dominator children of this block, go through and perform the
 	 * definite assignment analysis
 	 */
-	for(int32_t i = 0; i < block->dominator_children.current_index; i++){
-		basic_block_t* child = dynamic_array_get_at(&(block->dominator_children), i);
+	for(int32_t i = 0; i < block->analysis->dominator_children.current_index; i++){
+		basic_block_t* child = dynamic_array_get_at(&(block->analysis->dominator_children), i);
 
 		/**
 		 * If anything in this child fails, our overall result is failure. We will
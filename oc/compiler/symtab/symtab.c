@@ -1105,6 +1105,13 @@ symtab_function_record_t* create_function_record(dynamic_string_t* name, depende
 	//Allocate the array for all function blocks
 	record->function_blocks = dynamic_array_alloc();
 
+	//Allocate the array for all of the live ranges
+	record->live_ranges = dynamic_array_alloc();
+
+	//Allocate the side tables for the per-block analysis flags
+	record->visited_blocks = epoch_table_alloc(0);
+	record->marked_blocks = epoch_table_alloc(0);
+
 	//Allocate space for the function parameter
 	record->function_parameters = dynamic_array_alloc();
 
@@ -2928,6 +2935,13 @@ void function_symtab_dealloc(function_symtab_t* symtab){
 				//Destroy the block storage
 				dynamic_array_dealloc(&(temp->function_blocks));
 
+				//Destroy the live range storage. The live ranges themselves go with the function
+				dynamic_array_dealloc(&(temp->live_ranges));
+
+				//Destroy the per-block side tables
+				epoch_table_dealloc(&(temp->visited_blocks));
+				epoch_table_dealloc(&(temp->marked_blocks));
+
 				//Destroy the parameters
 				dynamic_array_dealloc(&(temp->function_parameters));
 
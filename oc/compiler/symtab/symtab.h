@@ -15,6 +15,7 @@
 #include "../utils/dynamic_set/dynamic_set.h"
 #include "../utils/dynamic_array/dynamic_array.h"
 #include "../utils/dynamic_integer_array/dynamic_integer_array.h"
+#include "../utils/epoch_table/epoch_table.h"
 #include "../utils/constants.h"
 #include "../utils/visibility.h"
 #include "../dependency_graph/dependency_graph.h"
@@ -118,6 +119,18 @@ typedef enum variable_membership_t {
 } variable_membership_t;
 
 
+/**
+ * Has a stack variable's address been exposed? This is filled in by
+ * alias analysis. Until it's been worked out, we have to assume that
+ * it has been
+ */
+typedef enum address_exposure_t {
+	ADDRESS_EXPOSURE_UNKNOWN = 0,
+	ADDRESS_NOT_EXPOSED,
+	ADDRESS_EXPOSED
+} address_exposure_t;
+
+
 /**
  * The symtab function record. This stores data about the function's name, parameter
  * numbers, parameter types, return types, etc.
@@ -137,6 +150,15 @@ struct symtab_function_record_t{
 	function_namespace_t* namespace_contained_in;
 	//All of the basic blocks that make up this function
 	dynamic_array_t function_blocks;
+	//Every live range that the register allocator made for this function
+	dynamic_array_t live_ranges;
+	/**
+	 * Side tables for the per-block flags that analyses need. Blocks index into these
+	 * using their dense function block index, so every function has its own flags and
+	 * clearing them is just a matter of starting a new epoch
+	 */
+	epoch_table_t visited_blocks;
+	epoch_table_t marked_blocks;
 	//The parameters for the function
 	dynamic_array_t function_parameters;
 	//The name of the function
@@ -161,8 +183,24 @@ struct symtab_function_record_t{
 	u_int32_t assigned_general_purpose_registers;
 	//A bitmap for all assigned SSE registers
 	u_int32_t assigned_sse_registers;
+	/**
+	 * Bitmaps of every register that a call to this function may overwrite. This is what
+	 * the function is assigned itself, plus everything that its callees clobber. Like the
+	 * assigned bitmaps, these mean nothing until registers_assigned is set
+	 */
+	u_int32_t clobbered_general_purpose_registers;
+	u_int32_t clobbered_sse_registers;
+	/**
+	 * A bitmap of the parameters that never outlive a call to this function. A pointer
+	 * passed in one of these is only ever loaded from or stored to by the callee
+	 */
+	u_int32_t non_capturing_parameters;
+	//A bitmap of the non capturing parameters that the function may store through
+	u_int32_t written_through_parameters;
 	//How many functions call this function?
 	u_int32_t called_by_count;
+	//How many dense block indices have been handed out to this function's blocks
+	u_int32_t number_of_block_indices;
 	//Unique identifier that is not a name
 	u_int32_t function_id;
 	/**
@@ -174,6 +212,27 @@ struct symtab_function_record_t{
 	u_int8_t defined;
 	//Has it ever been called?
 	u_int8_t called;
+	/**
+	 * Has the register allocator colored this function yet? Until it has, the
+	 * assigned register bitmaps are meaningless, and any caller must assume
+	 * that every caller-saved register gets clobbered
+	 */
+	u_int8_t registers_assigned;
+	/**
+	 * Attributes that are inferred over the whole program before anything is optimized. They all
+	 * start out FALSE, which is always the safe answer:
+	 *
+	 * 	1.) A pure function never writes to any memory that its caller could see
+	 * 	2.) A const function is pure, and doesn't read any memory that its caller could see either
+	 * 	3.) A function that always returns has no loops and only calls functions that always return
+	 * 	4.) A leaf function makes no calls at all
+	 */
+	u_int8_t is_pure;
+	u_int8_t is_const;
+	u_int8_t always_returns;
+	u_int8_t is_leaf;
+	//A function that is declared as raising errors, but that can never actually raise one
+	u_int8_t never_raises;
 	/**
 	 * Does the given function require an initial alignment? Functions that
 	 * require initial alignments may meet the following cirteria:
@@ -286,6 +345,8 @@ struct symtab_variable_record_t{
 	u_int8_t stack_variable;
 	//Is this a function parameter that is passed via stack?
 	u_int8_t passed_by_stack;
+	//Could a pointer reach this variable's memory?(see alias analysis)
+	address_exposure_t address_exposure;
 	//What's the visibility of this(only used for global variables)
 	visibilty_type_t visibility;
 };
@@ -0,0 +1,81 @@
+/**
+ * Author: Jack Robbins
+ * This file is meant to stress test the epoch table implementation. This will
+ * be run as a CI/CD job upon each push
+*/
+
+#include "../utils/epoch_table/epoch_table.h"
+#include "../utils/constants.h"
+#include <stdio.h>
+#include <sys/types.h>
+#include <stdlib.h>
+
+/**
+ * Run the test for the entire epoch table
+*/
+int main(){
+	//Allocate a deliberately small table so that we're forced to grow
+	epoch_table_t table = epoch_table_alloc(4);
+
+	//Nothing should be marked in a brand new table
+	for(u_int32_t i = 0; i < 100; i++){
+		if(epoch_table_is_marked(&table, i) == TRUE){
+			fprintf(stderr, "Index %d is marked in a brand new table\n", i);
+			exit(1);
+		}
+	}
+
+	//Mark every even index. Most of these are past the initial size
+	for(u_int32_t i = 0; i < 30000; i += 2){
+		epoch_table_mark(&table, i);
+	}
+
+	//Only the even indices should be marked
+	for(u_int32_t i = 0; i < 30000; i++){
+		u_int8_t expected = (i % 2 == 0) ? TRUE : FALSE;
+
+		if(epoch_table_is_marked(&table, i) != expected){
+			fprintf(stderr, "Expected index %d to have marked status %d\n", i, expected);
+			exit(1);
+		}
+	}
+
+	//Unmarking should only affect the one index
+	epoch_table_unmark(&table, 10);
+	if(epoch_table_is_marked(&table, 10) == TRUE || epoch_table_is_marked(&table, 12) == FALSE){
+		fprintf(stderr, "Unmarking index 10 did not work as expected\n");
+		exit(1);
+	}
+
+	//A new epoch should wipe out everything at once
+	epoch_table_begin_new_epoch(&table, 30000);
+	for(u_int32_t i = 0; i < 30000; i++){
+		if(epoch_table_is_marked(&table, i) == TRUE){
+			fprintf(stderr, "Index %d is still marked after a new epoch\n", i);
+			exit(1);
+		}
+	}
+
+	//Force the epoch counter to wrap around. Stale stamps must not come back to life
+	epoch_table_mark(&table, 5);
+	table.current_epoch = 0xFFFFFFFF;
+	epoch_table_mark(&table, 7);
+	epoch_table_begin_new_epoch(&table, 30000);
+	if(epoch_table_is_marked(&table, 5) == TRUE || epoch_table_is_marked(&table, 7) == TRUE){
+		fprintf(stderr, "Stale marks survived an epoch wraparound\n");
+		exit(1);
+	}
+
+	//And we should still be able to mark after wrapping
+	epoch_table_mark(&table, 7);
+	if(epoch_table_is_marked(&table, 7) == FALSE){
+		fprintf(stderr, "Could not mark after an epoch wraparound\n");
+		exit(1);
+	}
+
+	//Destroy it
+	epoch_table_dealloc(&table);
+
+	fprintf(stdout, "Epoch table test passed\n");
+	return 0;
+}
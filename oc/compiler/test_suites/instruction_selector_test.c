@@ -188,7 +188,7 @@ int main(int argc, char** argv){
 	}
 
 	//Once we build the CFG, we'll pass this along to the optimizer
-	cfg = optimize(cfg);
+	cfg = optimize(cfg, 1, DEFAULT_LOOP_UNROLL_FACTOR);
 
 	//Run the instruction selector. This simplifies and selects instructions
 	select_all_instructions(options, cfg);
@@ -187,7 +187,7 @@ int main(int argc, char** argv){
 	}
 
 	//Once we build the CFG, we'll pass this along to the optimizer
-	cfg = optimize(cfg);
+	cfg = optimize(cfg, 1, DEFAULT_LOOP_UNROLL_FACTOR);
 
 	//And once we're done - for the front end test, we'll want all of this printed
 	print_all_cfg_blocks(cfg);
@@ -36,6 +36,8 @@
 #define DEFAULT_ARRAY_SIZE 1000
 //The maximum console output value in UNIX
 #define MAX_EXIT_STATUS_VALUE 255
+//The longest set of extra compiler flags that a test may ask for
+#define MAX_COMPILER_FLAGS_LENGTH 256
 
 /**
  * There are 4 potential things that we need to lock. To avoid holding
@@ -105,6 +107,8 @@ struct thread_parameters_t {
 typedef struct test_parameters_t test_parameters_t;
 struct test_parameters_t {
 	int32_t expected_exit_status;
+	//Any extra flags that the test wants oc to be run with. Empty if there are none
+	char compiler_flags[MAX_COMPILER_FLAGS_LENGTH];
 };
 
 
@@ -234,6 +238,65 @@ static inline ounit_type_t parse_exit_status_OUNIT_directive(ollie_token_array_t
 }
 
 
+/**
+ * The flags option lets an exit_status test ask for oc to be run with extra flags. The
+ * flags are given as a string, and they are passed along to oc exactly as written
+ *
+ * OUNIT: [exit_status = <integer_constant>, flags = "<compiler flags>"]
+ *
+ * NOTE: By the time we get here we've already seen the comma
+ */
+static inline u_int8_t parse_flags_OUNIT_option(ollie_token_array_t* tokens, int32_t* index, test_parameters_t* parameters){
+	lexitem_t* lexitem;
+
+	//Advance up to the next token in the stream
+	(*index)++;
+	lexitem = token_array_get_pointer_at(tokens, *index);
+
+	/**
+	 * flags is not a keyword, so it comes through as an identifier
+	 */
+	if(lexitem->tok != IDENT || strcmp(lexitem->lexeme.string, "flags") != 0){
+		pthread_mutex_lock(&stdout_mutex);
+		fprintf(stdout, "Expected \"flags\" but got \"%s\" instead\n", lexitem_to_string(lexitem));
+		pthread_mutex_unlock(&stdout_mutex);
+
+		return FALSE;
+	}
+
+	//Advance to the next token
+	(*index)++;
+	lexitem = token_array_get_pointer_at(tokens, *index);
+
+	if(lexitem->tok != EQUALS){
+		pthread_mutex_lock(&stdout_mutex);
+		fprintf(stdout, "Expected \"=\" but got \"%s\" instead\n", lexitem_to_string(lexitem));
+		pthread_mutex_unlock(&stdout_mutex);
+
+		return FALSE;
+	}
+
+	//Advance to the next token
+	(*index)++;
+	lexitem = token_array_get_pointer_at(tokens, *index);
+
+	/**
+	 * The flags themselves must be a string that fits in our buffer
+	 */
+	if(lexitem->tok != STR_CONST || lexitem->lexeme.current_length >= MAX_COMPILER_FLAGS_LENGTH){
+		pthread_mutex_lock(&stdout_mutex);
+		fprintf(stdout, "Expected a string of at most %d characters after the =, instead saw \"%s\"\n", MAX_COMPILER_FLAGS_LENGTH - 1, lexitem_to_string(lexitem));
+		pthread_mutex_unlock(&stdout_mutex);
+
+		return FALSE;
+	}
+
+	strcpy(parameters->compiler_flags, lexitem->lexeme.string);
+
+	return TRUE;
+}
+
+
 /**
  * Parser the OUNIT test command. If the command is found to be invalid, we return a state 
  * that represents said invalidity. Otherwise, we will store the result that we expect(must
@@ -311,6 +374,18 @@ static inline ounit_type_t parse_OUNIT_test_command(ollie_token_array_t* tokens,
 	index++;
 	lexitem = token_array_get_pointer_at(tokens, index);
 
+	/**
+	 * An exit_status test may also ask for extra compiler flags
+	 */
+	if(ounit_type == OUNIT_TYPE_EXIT_STATUS_VALIDATION && lexitem->tok == COMMA){
+		if(parse_flags_OUNIT_option(tokens, &index, parameters) == FALSE){
+			return OUNIT_TYPE_INVALID;
+		}
+
+		index++;
+		lexitem = token_array_get_pointer_at(tokens, index);
+	}
+
 	/**
 	 * Again another fail case here, we need to see an ]
 	 */
@@ -335,6 +410,9 @@ static inline ounit_type_t parse_OUNIT_test_command(ollie_token_array_t* tokens,
  * expect the actual result of the test to be
  */
 static ounit_type_t is_test_OUNIT_compatible(ollie_token_stream_t* stream, test_parameters_t* parameters){
+	//No extra flags unless the test asks for them
+	parameters->compiler_flags[0] = '\0';
+
 	//Run through and see if we can find the OUNIT token
 	for(int32_t i = 0; i < stream->token_stream.current_index; i++){
 		//Extract the token pointer
@@ -439,7 +517,7 @@ static inline void handle_exit_status_validation(u_int32_t thread_id, char* file
 	 * Otherwise it is compatible so we will begin our testing
 	 * here by first compiling the actual item
 	 */
-	sprintf(command_buffer, "%s/oc -f %s -o %s > /dev/null 2>&1", output_directory, file_name, output_file_name);
+	sprintf(command_buffer, "%s/oc %s -f %s -o %s > /dev/null 2>&1", output_directory, parameters->compiler_flags, file_name, output_file_name);
 
 	/**
 	 * Run the compilation command. The compiler relies on a shared temporary output file, so we 
@@ -40,6 +40,36 @@
  */
 #define MIN_IN_MEMBERS 3
 
+/**
+ * The minimum number of case statements that a sparse switch must have before
+ * we lower it as a decision tree of clusters instead of a plain if-else chain
+ */
+#define SWITCH_DECISION_TREE_MIN_CASES 4
+
+/**
+ * The minimum number of cases that a cluster inside of a sparse switch needs
+ * to be given its own jump table
+ */
+#define SWITCH_JUMP_TABLE_MIN_CASES 4
+
+/**
+ * The minimum percentage of a jump table's slots that must be filled by real
+ * case values for that cluster to be worth the table
+ */
+#define SWITCH_JUMP_TABLE_MIN_DENSITY_PERCENT 40
+
+/**
+ * The widest span of values that a bit test cluster may cover. The masks are
+ * emitted as 32 bit immediates, so we cannot go past that
+ */
+#define SWITCH_BIT_TEST_MAX_RANGE 32
+
+/**
+ * The maximum number of distinct destinations that a bit test cluster may have.
+ * Each destination costs one mask test
+ */
+#define SWITCH_BIT_TEST_MAX_TARGETS 3
+
 //All error sizes are 2000
 #define ERROR_SIZE 2000
 
@@ -59,6 +89,61 @@
 //The number of colors that we have for XMM floating point registers
 #define K_COLORS_SSE 16
 
+/**
+ * Inlining thresholds, all in OIR instructions. A function that the user marked
+ * as inline is a strong hint, so it gets a much larger budget than an unmarked
+ * leaf function does. Once a caller grows past the cap, we stop inlining unmarked
+ * functions into it
+ */
+#define INLINE_FUNCTION_MAX_INSTRUCTIONS 100
+#define LEAF_FUNCTION_MAX_INSTRUCTIONS 12
+#define INLINING_MAX_CALLER_INSTRUCTIONS 2000
+
+/**
+ * Loop unrolling limits. Loops are unrolled by the factor given with --unroll-factor
+ * unless the unrolled body would grow past the instruction cap. A loop with a constant
+ * trip count this small is unrolled all the way instead
+ */
+#define DEFAULT_LOOP_UNROLL_FACTOR 4
+#define LOOP_FULL_UNROLL_MAX_TRIP_COUNT 8
+#define LOOP_UNROLL_MAX_INSTRUCTIONS 64
+
+/**
+ * Scalar replacement will only split an aggregate into this many
+ * separate variables. Anything with more fields stays in memory
+ */
+#define SCALAR_REPLACEMENT_MAX_FIELDS 16
+
+/**
+ * Jump threading will only copy a block with at most this many instructions(not counting
+ * its phi functions and branch). No function ever has more than JUMP_THREADING_MAX_THREADS
+ * jumps threaded
+ */
+#define JUMP_THREADING_MAX_INSTRUCTIONS 8
+#define JUMP_THREADING_MAX_THREADS 32
+
+/**
+ * Function specialization only copies functions with at most SPECIALIZATION_MAX_INSTRUCTIONS
+ * instructions, and only for calls that are estimated to run at least SPECIALIZATION_MIN_CALL_FREQUENCY
+ * times. The constants need to fold away at least SPECIALIZATION_MIN_BENEFIT instructions, where every
+ * branch that gets decided counts for SPECIALIZATION_BRANCH_BENEFIT. No more than SPECIALIZATION_MAX_CLONES
+ * copies are made for the whole program
+ */
+#define SPECIALIZATION_MAX_INSTRUCTIONS 150
+#define SPECIALIZATION_MIN_CALL_FREQUENCY 10
+#define SPECIALIZATION_MIN_BENEFIT 6
+#define SPECIALIZATION_BRANCH_BENEFIT 4
+#define SPECIALIZATION_MAX_CLONES 16
+
+/**
+ * When block counts come from a profile(--profile-use), they are scaled so that
+ * entering the function is worth PROFILE_ENTRY_FREQUENCY. This leaves room for blocks
+ * that run less often than the entry to still be told apart. No block is ever worth
+ * more than PROFILE_MAX_FREQUENCY
+ */
+#define PROFILE_ENTRY_FREQUENCY 16
+#define PROFILE_MAX_FREQUENCY 1000000
+
 //A load and a store generate 2 instructions when we load
 //from the stack
 #define LOAD_COST 2
@@ -0,0 +1,146 @@
+/**
+ * Author: Jack Robbins
+ * Implementation file for the epoch-stamped side table
+*/
+
+//Link to header
+#include "epoch_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "../constants.h"
+
+
+/**
+ * Grow the stamp array so that it can hold the given index. All newly
+ * exposed stamps are zeroed, and 0 is never a valid epoch, so nothing
+ * new ends up flagged
+ */
+static void epoch_table_resize_to_fit_index(epoch_table_t* table, u_int32_t index){
+	//Nothing to do here
+	if(index < table->current_max_size){
+		return;
+	}
+
+	//Double the requested index just like any other resize
+	u_int32_t new_max_size = (index + 1) * 2;
+
+	//Reallocate the stamps
+	table->stamps = realloc(table->stamps, sizeof(u_int32_t) * new_max_size);
+
+	//Zero out everything that's new
+	memset(table->stamps + table->current_max_size, 0, sizeof(u_int32_t) * (new_max_size - table->current_max_size));
+
+	//And store the new size
+	table->current_max_size = new_max_size;
+}
+
+
+/**
+ * Allocate an epoch table that has room for the given
+ * number of indices. The resulting control structure will
+ * be stack allocated
+ */
+epoch_table_t epoch_table_alloc(u_int32_t initial_size){
+	//Stack allocate the control structure
+	epoch_table_t table;
+
+	//Use the sane default if we weren't given anything
+	if(initial_size == 0){
+		initial_size = DYNAMIC_ARRAY_DEFAULT_SIZE;
+	}
+
+	//Zeroed stamps means nothing is flagged
+	table.stamps = calloc(initial_size, sizeof(u_int32_t));
+	table.current_max_size = initial_size;
+
+	//Start off at the first valid epoch
+	table.current_epoch = 1;
+
+	//Give it back
+	return table;
+}
+
+
+/**
+ * Begin a new epoch. This unflags every single index in O(1) time. The table is
+ * grown if needed so that it can hold at least number_of_indices indices
+ */
+void epoch_table_begin_new_epoch(epoch_table_t* table, u_int32_t number_of_indices){
+	//Make sure that we have enough room for everything up front
+	if(number_of_indices > 0){
+		epoch_table_resize_to_fit_index(table, number_of_indices - 1);
+	}
+
+	//Move the epoch up by one
+	table->current_epoch++;
+
+	/**
+	 * If we've wrapped all the way around then old stamps could
+	 * end up matching again. In this extremely rare case we pay for
+	 * one full wipe and start over
+	 */
+	if(table->current_epoch == 0){
+		memset(table->stamps, 0, sizeof(u_int32_t) * table->current_max_size);
+		table->current_epoch = 1;
+	}
+}
+
+
+/**
+ * Flag the given index for the current epoch
+ */
+void epoch_table_mark(epoch_table_t* table, u_int32_t index){
+	//Items could have been created after the epoch began
+	epoch_table_resize_to_fit_index(table, index);
+
+	table->stamps[index] = table->current_epoch;
+}
+
+
+/**
+ * Unflag the given index for the current epoch
+ */
+void epoch_table_unmark(epoch_table_t* table, u_int32_t index){
+	//If we never had room for it, it was never flagged
+	if(index >= table->current_max_size){
+		return;
+	}
+
+	//0 is never a valid epoch
+	table->stamps[index] = 0;
+}
+
+
+/**
+ * Is the given index flagged in the current epoch? Indices that the table
+ * has never had room for are never flagged
+ */
+u_int8_t epoch_table_is_marked(epoch_table_t* table, u_int32_t index){
+	//If we never had room for it, it was never flagged
+	if(index >= table->current_max_size){
+		return FALSE;
+	}
+
+	//Only the current epoch counts
+	if(table->stamps[index] == table->current_epoch){
+		return TRUE;
+	} else {
+		return FALSE;
+	}
+}
+
+
+/**
+ * Deallocate the internal stamp array for an epoch table
+ */
+void epoch_table_dealloc(epoch_table_t* table){
+	//Free the stamps
+	free(table->stamps);
+
+	//Wipe everything out so that this can't be reused by mistake
+	table->stamps = NULL;
+	table->current_max_size = 0;
+	table->current_epoch = 0;
+}
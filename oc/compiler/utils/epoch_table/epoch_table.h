@@ -0,0 +1,74 @@
+/**
+ * Author: Jack Robbins
+ * An epoch-stamped side table. Analyses that need a per-item flag(visited, marked, etc.)
+ * keep it in one of these instead of on the item itself. Every item is given a dense
+ * index, and an item counts as flagged only if its stamp matches the current epoch. Clearing
+ * every flag is then just a matter of moving to the next epoch, so no reset pass is needed
+ */
+
+//Include guards
+#ifndef EPOCH_TABLE_H
+#define EPOCH_TABLE_H
+
+#include <sys/types.h>
+
+//The overall epoch table structure
+typedef struct epoch_table_t epoch_table_t;
+
+/**
+ * The stamp array is indexed by the dense index of each
+ * item. A stamp of 0 is never a valid epoch, so a freshly
+ * allocated(zeroed) table has nothing flagged
+ */
+struct epoch_table_t{
+	//The stamps themselves, one per index
+	u_int32_t* stamps;
+	//How many indices we have room for
+	u_int32_t current_max_size;
+	//The current epoch. Anything stamped with this is flagged
+	u_int32_t current_epoch;
+};
+
+/**
+ * Macro to initialize a NULL stack allocated epoch table
+ */
+#define INITIALIZE_NULL_EPOCH_TABLE(epoch_table)\
+	epoch_table.stamps = NULL;\
+	epoch_table.current_max_size = 0;\
+	epoch_table.current_epoch = 0;\
+
+/**
+ * Allocate an epoch table that has room for the given
+ * number of indices. The resulting control structure will
+ * be stack allocated
+ */
+epoch_table_t epoch_table_alloc(u_int32_t initial_size);
+
+/**
+ * Begin a new epoch. This unflags every single index in O(1) time. The table is
+ * grown if needed so that it can hold at least number_of_indices indices
+ */
+void epoch_table_begin_new_epoch(epoch_table_t* table, u_int32_t number_of_indices);
+
+/**
+ * Flag the given index for the current epoch
+ */
+void epoch_table_mark(epoch_table_t* table, u_int32_t index);
+
+/**
+ * Unflag the given index for the current epoch
+ */
+void epoch_table_unmark(epoch_table_t* table, u_int32_t index);
+
+/**
+ * Is the given index flagged in the current epoch? Indices that the table
+ * has never had room for are never flagged
+ */
+u_int8_t epoch_table_is_marked(epoch_table_t* table, u_int32_t index);
+
+/**
+ * Deallocate the internal stamp array for an epoch table
+ */
+void epoch_table_dealloc(epoch_table_t* table);
+
+#endif /* EPOCH_TABLE_H */
@@ -142,7 +142,9 @@ typedef enum {
 	//Specialized offset statement for elaborative params
 	THREE_ADDR_CODE_ELABORATIVE_PARAM_OFFSET,
 	//Specialized synthetic initialization for memory regions
-	THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION
+	THREE_ADDR_CODE_MEMORY_REGION_INITIALIZATION,
+	//Bump a block's execution counter(--profile-generate only)
+	THREE_ADDR_CODE_PROFILE_COUNTER_STMT
 } instruction_stmt_type_t;
 
 #endif /* OLLIE_INTERMEDIARY_REPRESENTATION_H */
@@ -0,0 +1,126 @@
+/**
+ * Author: Jack Robbins
+ * Implementation file for the thread pool
+*/
+
+//Link to header
+#include "thread_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "../constants.h"
+
+//The control structure that every worker thread shares
+typedef struct thread_pool_work_t thread_pool_work_t;
+
+/**
+ * All workers pull from the same counter. Whoever gets the lock
+ * takes the next unclaimed item
+ */
+struct thread_pool_work_t{
+	//Guards the next item index
+	pthread_mutex_t next_item_mutex;
+	//What are we running
+	thread_pool_job_t job;
+	//Whatever state the job needs
+	void* shared_state;
+	//The next item that has not been claimed
+	u_int32_t next_item;
+	//How many items there are in total
+	u_int32_t item_count;
+};
+
+
+/**
+ * Claim the next unprocessed item. Returns FALSE once
+ * everything has been claimed
+ */
+static u_int8_t claim_next_item(thread_pool_work_t* work, u_int32_t* item_index){
+	//Assume we got nothing
+	u_int8_t claimed = FALSE;
+
+	pthread_mutex_lock(&(work->next_item_mutex));
+
+	//If there's anything left, we'll take it
+	if(work->next_item < work->item_count){
+		*item_index = work->next_item;
+		(work->next_item)++;
+		claimed = TRUE;
+	}
+
+	pthread_mutex_unlock(&(work->next_item_mutex));
+
+	return claimed;
+}
+
+
+/**
+ * Every worker just keeps claiming items until there
+ * are none left
+ */
+static void* thread_pool_worker(void* argument){
+	thread_pool_work_t* work = argument;
+
+	//The item that we're working on
+	u_int32_t item_index;
+
+	//Keep going so long as we're able to grab something
+	while(claim_next_item(work, &item_index) == TRUE){
+		work->job(work->shared_state, item_index);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * Run the job once for every item index in [0, item_count) using up to thread_count
+ * threads. This does not return until every item has been processed. If we're given
+ * a thread count of 1 or less, everything is done on the calling thread in index order
+ */
+void thread_pool_run(u_int32_t thread_count, u_int32_t item_count, thread_pool_job_t job, void* shared_state){
+	//There's no point in having more threads than items
+	if(thread_count > item_count){
+		thread_count = item_count;
+	}
+
+	//Serial case - no threads needed at all
+	if(thread_count <= 1){
+		for(u_int32_t i = 0; i < item_count; i++){
+			job(shared_state, i);
+		}
+
+		return;
+	}
+
+	//Set up the shared work
+	thread_pool_work_t work;
+	pthread_mutex_init(&(work.next_item_mutex), NULL);
+	work.job = job;
+	work.shared_state = shared_state;
+	work.next_item = 0;
+	work.item_count = item_count;
+
+	//The calling thread is a worker too, so we only need to spawn one less thread
+	pthread_t* workers = calloc(thread_count - 1, sizeof(pthread_t));
+
+	//Spawn all of the workers
+	for(u_int32_t i = 0; i < thread_count - 1; i++){
+		if(pthread_create(&(workers[i]), NULL, thread_pool_worker, &work) != 0){
+			fprintf(stderr, "Fatal internal compiler error: unable to create worker thread\n");
+			exit(1);
+		}
+	}
+
+	//Do our share of the work
+	thread_pool_worker(&work);
+
+	//Wait for everyone else to finish
+	for(u_int32_t i = 0; i < thread_count - 1; i++){
+		pthread_join(workers[i], NULL);
+	}
+
+	//Clean up
+	free(workers);
+	pthread_mutex_destroy(&(work.next_item_mutex));
+}
@@ -0,0 +1,26 @@
+/**
+ * Author: Jack Robbins
+ * A very small thread pool for running the same job over a set of independent work items. The
+ * middle and back end use this to process functions in parallel. Every job is handed the index of
+ * the item that it needs to work on, so whatever a job produces is attached to that item and the
+ * final output order never depends on which thread happened to run which job
+ */
+
+//Include guards
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <sys/types.h>
+#include <pthread.h>
+
+//The job that is run for every single work item
+typedef void (*thread_pool_job_t)(void* shared_state, u_int32_t item_index);
+
+/**
+ * Run the job once for every item index in [0, item_count) using up to thread_count
+ * threads. This does not return until every item has been processed. If we're given
+ * a thread count of 1 or less, everything is done on the calling thread in index order
+ */
+void thread_pool_run(u_int32_t thread_count, u_int32_t item_count, thread_pool_job_t job, void* shared_state);
+
+#endif /* THREAD_POOL_H */
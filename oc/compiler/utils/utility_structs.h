@@ -41,8 +41,20 @@ struct compiler_options_t {
 	u_int8_t module_specific_timing;
 	//Print intermediate representations
 	u_int8_t print_irs;
+	//Send each function through the whole back end on its own(--stream)
+	u_int8_t stream_functions;
 	//What kind of output have we been told to generate
 	compiler_output_type_t output_type;
+	//How many threads can the middle and back end use(-j)
+	u_int32_t thread_count;
+	//How many copies of a loop body the optimizer may make(--unroll-factor)
+	u_int32_t loop_unroll_factor;
+	//Where an instrumented build writes its profile out to(--profile-generate)
+	char* profile_generate_file;
+	//The profile that block frequencies are read from(--profile-use)
+	char* profile_use_file;
+	//Was an instrumented build asked for
+	u_int8_t profile_generate;
 };
 
 
@@ -1,9 +1,11 @@
 /**
  * Author: Jack Robbins
- * This file contains the implementations for the APIs laid out in hashtable.h
+ * This file contains the implementations for the APIs laid out in value_numbering_table.h
  */
 
 #include "value_numbering_table.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <sys/types.h>
 
 //The starting offset basis for FNV-1a64
@@ -16,9 +18,23 @@
 #define FINALIZER_CONSTANT_1 0xff51afd7ed558ccdULL
 #define FINALIZER_CONSTANT_2 0xc4ceb9fe1a85ec53ULL
 
+//How many scope records do we start with
+#define DEFAULT_SCOPE_RECORD_COUNT 16
+
+
+/**
+ * Mix one value into an FNV-1a 64 bit hash
+ */
+static inline u_int64_t hash_in(u_int64_t hash, u_int64_t value){
+	hash ^= value;
+	hash *= FNV_PRIME;
+
+	return hash;
+}
+
 
 /**
- * Hash a name before entry/search into the hash table
+ * Hash a key before entry/search into the hash table
  *
  * FNV-1a 64 bit hash:
  * 	hash <- FNV_prime
@@ -26,24 +42,32 @@
  * 	for each hashable value:
  * 		hash ^= value
  * 		hash *= FNV_PRIME
- * 		
+ *
  * 	key % keyspace
  *
  * 	return key
 */
-static inline u_int64_t hash(char* textual_key, u_int32_t keyspace){
-	//Char pointer for the name
-	char* cursor = textual_key;
-
+static inline u_int64_t hash(value_number_key_t* key, u_int32_t keyspace){
 	//The hash we have
 	u_int64_t hash = OFFSET_BASIS;
 
-	//Iterate through the cursor here
-	for(; *cursor != '\0'; cursor++){
-		hash ^= *cursor;
-		hash *= FNV_PRIME;
+	//Hash in everything that makes up the key
+	hash = hash_in(hash, key->key_type);
+	hash = hash_in(hash, key->op);
+
+	for(u_int16_t i = 0; i < 2; i++){
+		hash = hash_in(hash, (u_int64_t)(key->operands[i].identity));
+		hash = hash_in(hash, key->operands[i].number);
+		hash = hash_in(hash, key->operands[i].variable_type);
 	}
 
+	hash = hash_in(hash, key->constant_bits);
+	hash = hash_in(hash, key->constant_adjustment);
+	hash = hash_in(hash, key->constant_type);
+
+	//Instructions go by their structure, never by where they are
+	hash = hash_in(hash, key->instruction_hash);
+
 	//We will perform avalanching here by shifting, multiplying and shifting. The shifting
 	//itself ensures that the higher order bits effect all of the lower order ones
 	hash ^= hash >> 33;
@@ -57,77 +81,211 @@ static inline u_int64_t hash(char* textual_key, u_int32_t keyspace){
 }
 
 
+/**
+ * Are two operands inside of a key the same?
+ */
+static inline u_int8_t value_number_operands_equal(value_number_operand_t* a, value_number_operand_t* b){
+	if(a->identity == b->identity
+		&& a->number == b->number
+		&& a->variable_type == b->variable_type){
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * Are two keys the same?
+ */
+static inline u_int8_t value_number_keys_equal(value_numbering_table_t* table, value_number_key_t* a, value_number_key_t* b){
+	if(a->key_type != b->key_type || a->op != b->op || a->instruction_hash != b->instruction_hash){
+		return FALSE;
+	}
+
+	//The table's owner knows what makes two of its instructions the same
+	if(a->key_type == VALUE_NUMBER_KEY_INSTRUCTION){
+		return table->instructions_equal(a->instruction, b->instruction);
+	}
+
+	if(value_number_operands_equal(&(a->operands[0]), &(b->operands[0])) == FALSE
+		|| value_number_operands_equal(&(a->operands[1]), &(b->operands[1])) == FALSE){
+		return FALSE;
+	}
+
+	if(a->constant_bits != b->constant_bits
+		|| a->constant_adjustment != b->constant_adjustment
+		|| a->constant_type != b->constant_type){
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+/**
+ * Put a key into the first empty slot along its probe sequence. The caller
+ * is responsible for making sure that there is room
+ */
+static inline void insert_into_table(value_numbering_entry_t* table, u_int32_t keyspace, value_number_key_t* key, three_addr_var_t* result){
+	u_int64_t index = hash(key, keyspace);
+
+	//Linear probe until we hit something empty
+	while(table[index].status != VALUE_NUMBERING_SLOT_EMPTY){
+		index = (index + 1) & (keyspace - 1);
+	}
+
+	table[index].key = *key;
+	table[index].result_value = result;
+	table[index].status = VALUE_NUMBERING_SLOT_OCCUPIED;
+}
+
+
+/**
+ * Double the size of the table and rehash everything that is still in it. Deleted
+ * slots are dropped along the way
+ */
+static void grow_value_numbering_table(value_numbering_table_t* table){
+	u_int32_t new_keyspace = table->keyspace * 2;
+	value_numbering_entry_t* new_table = calloc(new_keyspace, sizeof(value_numbering_entry_t));
+
+	//The new table only has the live entries in it
+	table->used_slots = 0;
+
+	for(u_int32_t i = 0; i < table->keyspace; i++){
+		if(table->table[i].status == VALUE_NUMBERING_SLOT_OCCUPIED){
+			insert_into_table(new_table, new_keyspace, &(table->table[i].key), table->table[i].result_value);
+			table->used_slots++;
+		}
+	}
+
+	free(table->table);
+
+	table->table = new_table;
+	table->keyspace = new_keyspace;
+}
+
+
 /**
  * Allocate a hash table with the given keyspace. The keyspace
- * is always given by the user
+ * is always given by the user, and will be rounded up to a power of 2
  */
 value_numbering_table_t value_numbering_table_alloc(u_int32_t keyspace){
 	//Stack allocate it
-	value_numbering_table_t table = {NULL, keyspace};
+	value_numbering_table_t table = {NULL, NULL, NULL, 1, 0, 0, DEFAULT_SCOPE_RECORD_COUNT};
+
+	//Round up to the nearest power of 2 so that we can mask instead of mod
+	while(table.keyspace < keyspace){
+		table.keyspace <<= 1;
+	}
 
 	//We'll need to allocate the actual table now
-	table.table = calloc(keyspace, sizeof(value_numbering_node_t));
+	table.table = calloc(table.keyspace, sizeof(value_numbering_entry_t));
+
+	//And the scope records
+	table.scope_records = calloc(table.scope_record_max, sizeof(value_numbering_scope_record_t));
 
 	return table;
 }
 
 
 /**
- * Add a given value into the hash table. Note that once this happens the memory for the dynamic string
- * is owned by this hash table 
+ * Add a given value into the hash table. This value will stay
+ * in the table until the table is deallocated
  */
-void add_value_number_expression(value_numbering_table_t* table, three_addr_var_t* result, dynamic_string_t* textual_key){
-	//First we'll need to hash this
-	u_int64_t textual_key_hash = hash(textual_key->string, table->keyspace);
+void add_value_number_expression(value_numbering_table_t* table, three_addr_var_t* result, value_number_key_t* key){
+	//Keep the load factor under 3/4 so that probe sequences stay short
+	if((table->used_slots + 1) * 4 > table->keyspace * 3){
+		grow_value_numbering_table(table);
+	}
 
-	//Allocate the fresh node here and populate it
-	value_numbering_node_t* new_node = calloc(1, sizeof(value_numbering_node_t));
-	new_node->result_value = result;
-	new_node->textual_key = *textual_key;
+	insert_into_table(table->table, table->keyspace, key, result);
+	table->used_slots++;
+}
 
-	//Flag that this variable was itself value named
-	result->was_value_named = TRUE;
 
-	//Grab a pointer to the current value
-	value_numbering_node_t* cursor = table->table[textual_key_hash];
+/**
+ * Add a given value into the hash table, and record it so that it is taken
+ * back out when the enclosing scope is ended
+ */
+void add_scoped_value_number_expression(value_numbering_table_t* table, three_addr_var_t* result, value_number_key_t* key){
+	add_value_number_expression(table, result, key);
 
-	//If there's no collision then we can just add as is
-	if(cursor == NULL){
-		table->table[textual_key_hash] = new_node;
-		return;
+	//Make room for the record if we need it
+	if(table->scope_record_count == table->scope_record_max){
+		table->scope_record_max *= 2;
+		table->scope_records = realloc(table->scope_records, sizeof(value_numbering_scope_record_t) * table->scope_record_max);
 	}
 
-	//Otherwise we'll need to drill down here
-	while(cursor->next != NULL){
-		//Bump it up
-		cursor = cursor->next;
-	}
+	table->scope_records[table->scope_record_count].key = *key;
+	table->scope_records[table->scope_record_count].result_value = result;
+	table->scope_record_count++;
+}
 
-	//Connect this to the chain
-	cursor->next = new_node;
+
+/**
+ * Begin a new scope. The value that is given back must be passed to
+ * value_numbering_scope_end when the scope is over
+ */
+u_int32_t value_numbering_scope_begin(value_numbering_table_t* table){
+	return table->scope_record_count;
 }
 
 
 /**
- * Lookup a value number expression based on the textual string. This returns the three_addr_var_t that holds the result if it
+ * End a scope by removing every scoped value that was added since
+ * the scope began
+ */
+void value_numbering_scope_end(value_numbering_table_t* table, u_int32_t scope_start){
+	//Go through in reverse order
+	while(table->scope_record_count > scope_start){
+		table->scope_record_count--;
+
+		value_numbering_scope_record_t* record = &(table->scope_records[table->scope_record_count]);
+
+		u_int64_t index = hash(&(record->key), table->keyspace);
+
+		//Find the exact slot that holds this key and result
+		while(table->table[index].status != VALUE_NUMBERING_SLOT_EMPTY){
+			if(table->table[index].status == VALUE_NUMBERING_SLOT_OCCUPIED
+				&& table->table[index].result_value == record->result_value
+				&& value_number_keys_equal(table, &(table->table[index].key), &(record->key)) == TRUE){
+				break;
+			}
+
+			index = (index + 1) & (table->keyspace - 1);
+		}
+
+		//This should never happen
+		if(table->table[index].status == VALUE_NUMBERING_SLOT_EMPTY){
+			fprintf(stderr, "Fatal internal compiler error: scoped value number was not found in the value numbering table\n");
+			exit(1);
+		}
+
+		//The slot is deleted, not empty, so that anything after it can still be found
+		table->table[index].status = VALUE_NUMBERING_SLOT_DELETED;
+	}
+}
+
+
+/**
+ * Lookup a value number expression based on the key. This returns the three_addr_var_t that holds the result if it
  * was found, or NULL if it was not
  */
-three_addr_var_t* lookup_value_number_expression(value_numbering_table_t* table, dynamic_string_t* textual_key){
+three_addr_var_t* lookup_value_number_expression(value_numbering_table_t* table, value_number_key_t* key){
 	//First we'll need to hash this
-	u_int64_t textual_key_hash = hash(textual_key->string, table->keyspace);
-
-	//Grab a cursor to the node
-	value_numbering_node_t* cursor = table->table[textual_key_hash];
+	u_int64_t index = hash(key, table->keyspace);
 
 	//So long as we have values occupied
-	while(cursor != NULL){
+	while(table->table[index].status != VALUE_NUMBERING_SLOT_EMPTY){
 		//If we have an exact match then we're good
-		if(strcmp(cursor->textual_key.string, textual_key->string) == 0){
-			return cursor->result_value;
+		if(table->table[index].status == VALUE_NUMBERING_SLOT_OCCUPIED
+			&& value_number_keys_equal(table, &(table->table[index].key), key) == TRUE){
+			return table->table[index].result_value;
 		}
 
-		//Bump it 
-		cursor = cursor->next;
+		//Bump it
+		index = (index + 1) & (table->keyspace - 1);
 	}
 
 	//If we made it down here then we found nothing
@@ -139,33 +297,7 @@ three_addr_var_t* lookup_value_number_expression(value_numbering_table_t* table,
  * Deallocate the internal storage for the hash table
  */
 void value_numbering_table_dealloc(value_numbering_table_t* table){
-	/**
-	 * Because of the way that the table works with collisions, we will need to traverse the
-	 * entire thing and free anything that is a second level or below node as these will
-	 * have been dynamically allocated
-	 */
-
-	//Run through everything
-	for(u_int32_t i = 0; i < table->keyspace; i++){
-		//Extract the node
-		value_numbering_node_t* node = table->table[i];
-
-		//Since we're now in the second node, this one was dynamically allocated
-		while(node != NULL){
-			//Temp pointer is needed
-			value_numbering_node_t* temp = node;
-
-			//Deallocate the string if we even have one
-			dynamic_string_dealloc(&(node->textual_key));
-
-			//Bump up the cursor pointer
-			node = node->next;
-
-			//Free the temp holder
-			free(temp);
-		}
-	}
-
-	//Once we get down here we can deallocate the underlying table
+	//Everything lives inline, so this is all that we need to free
 	free(table->table);
+	free(table->scope_records);
 }
@@ -1,10 +1,11 @@
 /**
  * Author: Jack Robbins
- * This module contains the API definitions for a hashtable used by the global value numberer
+ * This module contains the API definitions for a hashtable used by the global value numberers
+ * in both the optimizer and the instruction selector
  */
 
 //Include guards
-#ifndef VALUE_NUMBERING_TABLE_H 
+#ifndef VALUE_NUMBERING_TABLE_H
 #define VALUE_NUMBERING_TABLE_H
 
 #include <sys/types.h>
@@ -21,56 +22,170 @@
 
 //Predeclare the value numbering table struct
 typedef struct value_numbering_table_t value_numbering_table_t;
-//The individual nodes within the value numbering table
-typedef struct value_numbering_node_t value_numbering_node_t;
+//The individual entries within the value numbering table
+typedef struct value_numbering_entry_t value_numbering_entry_t;
+//The structural key that we hash on
+typedef struct value_number_key_t value_number_key_t;
+//One variable inside of a key
+typedef struct value_number_operand_t value_number_operand_t;
+//What we remember so that a scope can be undone
+typedef struct value_numbering_scope_record_t value_numbering_scope_record_t;
+
 
 /**
- * The hash table struct contains everything that we need to keep
- * track of our hash table, including the keyspace and actual array
- * itself
+ * What kind of thing does a key describe?
  */
-struct value_numbering_table_t {
-	//Array of value numbering nodes
-	value_numbering_node_t** table;
-	//How large is the internal array for the hash table
-	u_int32_t keyspace;
+typedef enum {
+	VALUE_NUMBER_KEY_VARIABLE = 1, //The value name of a single variable
+	VALUE_NUMBER_KEY_BIN_OP, //A binary operation between 2 variables
+	VALUE_NUMBER_KEY_BIN_OP_WITH_CONST, //A binary operation between a variable and a constant
+	VALUE_NUMBER_KEY_INSTRUCTION, //A whole instruction, compared with the table's instruction equality function
+} value_number_key_type_t;
+
+
+/**
+ * The status of any given slot in the table. Deleted slots
+ * need to stay distinct from empty ones so that lookups keep
+ * probing past them
+ */
+typedef enum {
+	VALUE_NUMBERING_SLOT_EMPTY = 0,
+	VALUE_NUMBERING_SLOT_OCCUPIED,
+	VALUE_NUMBERING_SLOT_DELETED,
+} value_numbering_slot_status_t;
+
+
+/**
+ * A variable is uniquely identified by what it refers to(symtab record, local constant
+ * or function), along with its SSA generation. Variables that don't refer to anything
+ * like temps use their temp number instead
+ */
+struct value_number_operand_t {
+	//The record that this variable refers to. NULL for temps
+	void* identity;
+	//The SSA generation, or the temp number if there is no identity
+	u_int32_t number;
+	//The type of variable that this is
+	variable_type_t variable_type;
+};
+
+
+/**
+ * A fixed size key that describes an expression. Anything that a given
+ * key type does not use is left zeroed out
+ */
+struct value_number_key_t {
+	//The variables in the expression
+	value_number_operand_t operands[2];
+	//The raw bits of the constant if we have one
+	u_int64_t constant_bits;
+	//Any adjustment that the constant has
+	int64_t constant_adjustment;
+	//The type of constant
+	ollie_token_t constant_type;
+	//The operator
+	ollie_token_t op;
+	//What kind of key is it
+	value_number_key_type_t key_type;
+	//The instruction for an instruction key. This is compared structurally, never by its address
+	instruction_t* instruction;
+	//The structural hash of that instruction. Equal instructions must always hash the same
+	u_int64_t instruction_hash;
 };
 
 
 /**
- * Value numbering node exists to store the textual string
- * and the result value. It also holds a next pointer should
- * we need to traverse
+ * Every slot in the table holds the key and the variable
+ * that the result of it is stored in
  */
-struct value_numbering_node_t {
-	//The textual string that we use as the key
-	dynamic_string_t textual_key;
+struct value_numbering_entry_t {
+	//The key for this slot
+	value_number_key_t key;
 	//What variable is the result value stored in?
 	three_addr_var_t* result_value;
-	//If we have collisions, this is the next pointer
-	value_numbering_node_t* next;
+	//Is this slot in use?
+	value_numbering_slot_status_t status;
+};
+
+
+/**
+ * Every scoped addition is recorded so that it can be taken back
+ * out of the table once the scope is over
+ */
+struct value_numbering_scope_record_t {
+	//The key that was added
+	value_number_key_t key;
+	//And the result that went with it
+	three_addr_var_t* result_value;
+};
+
+
+/**
+ * The hash table struct contains everything that we need to keep
+ * track of our hash table, including the keyspace and actual array
+ * itself. This table uses open addressing with linear probing
+ */
+struct value_numbering_table_t {
+	//Array of value numbering entries
+	value_numbering_entry_t* table;
+	//Everything that has been added in a scope
+	value_numbering_scope_record_t* scope_records;
+	//Are two instructions the same computation? Only needed if instruction keys are used
+	u_int8_t (*instructions_equal)(instruction_t* a, instruction_t* b);
+	//How large is the internal array for the hash table. This is always a power of 2
+	u_int32_t keyspace;
+	//How many slots are not empty(this includes deleted ones)
+	u_int32_t used_slots;
+	//How many scope records we have
+	u_int32_t scope_record_count;
+	//And how many we can hold
+	u_int32_t scope_record_max;
 };
 
 
 /**
  * Allocate a hash table with the given keyspace. The keyspace
- * is always given by the user
+ * is always given by the user, and will be rounded up to a power of 2
  */
 value_numbering_table_t value_numbering_table_alloc(u_int32_t keyspace);
 
 
 /**
- * Add a given value into the hash table. Note that once this happens the memory for the dynamic string
- * is owned by this hash table 
+ * Add a given value into the hash table. This value will stay
+ * in the table until the table is deallocated
+ *
+ * NOTE: The result will now be used in more than one place. It's up to the caller
+ * to flag that with was_value_named if the instruction selector needs to know
+ */
+void add_value_number_expression(value_numbering_table_t* table, three_addr_var_t* result, value_number_key_t* key);
+
+
+/**
+ * Add a given value into the hash table, and record it so that it is taken
+ * back out when the enclosing scope is ended
+ */
+void add_scoped_value_number_expression(value_numbering_table_t* table, three_addr_var_t* result, value_number_key_t* key);
+
+
+/**
+ * Begin a new scope. The value that is given back must be passed to
+ * value_numbering_scope_end when the scope is over
+ */
+u_int32_t value_numbering_scope_begin(value_numbering_table_t* table);
+
+
+/**
+ * End a scope by removing every scoped value that was added since
+ * the scope began
  */
-void add_value_number_expression(value_numbering_table_t* table, three_addr_var_t* result, dynamic_string_t* textual_string);
+void value_numbering_scope_end(value_numbering_table_t* table, u_int32_t scope_start);
 
 
 /**
- * Lookup a value number expression based on the textual string. This returns the three_addr_var_t that holds the result if it
+ * Lookup a value number expression based on the key. This returns the three_addr_var_t that holds the result if it
  * was found, or NULL if it was not
  */
-three_addr_var_t* lookup_value_number_expression(value_numbering_table_t* table, dynamic_string_t* textual_string);
+three_addr_var_t* lookup_value_number_expression(value_numbering_table_t* table, value_number_key_t* key);
 
 
 /**
@@ -60,6 +60,7 @@ typedef enum{
 	RAISE_INSTRUCTION, //Not really an instruction - we use it to represent error raising. When printed, these become "ret"
 	CALL,
 	INDIRECT_CALL, //For function pointers
+	TAIL_CALL, //A call in tail position, which jumps straight to the callee
 	MOVB,
 	MOVW, //Regular register-to-register or immediate to register
 	MOVL,